@@ -49,13 +49,11 @@ void LongUI::UIXmlRich::SetSelectionColor() noexcept {
 /// <returns></returns>
 template<typename T>
 void LongUI::UIXmlRich::set_selection_helper(T call) noexcept {
-    LongUI::CUIDxgiAutoLocker locker;
-    if (const auto layout = m_text.RefLayout()) {
-        auto range = m_text.GetSelectionRange();
-        if (range.length) {
-            call(range, layout);
-            this->InvalidateThis();
-        }
+    auto range = m_text.GetSelectionRange();
+    if (range.length) {
+        // 段落重建后依然有效
+        m_text.FormatRange(range, std::move(call));
+        this->InvalidateThis();
     }
 }
 
@@ -65,8 +63,8 @@ void LongUI::UIXmlRich::set_selection_helper(T call) noexcept {
 /// <param name="u">if set to <c>true</c> [u].</param>
 /// <returns></returns>
 void LongUI::UIXmlRich::SetSelectionUnderline(bool u) noexcept {
-    this->set_selection_helper([=](DWRITE_TEXT_RANGE range,
-        IDWriteTextLayout* layout) noexcept {
+    this->set_selection_helper([=](IDWriteTextLayout* layout,
+        DWRITE_TEXT_RANGE range) noexcept {
         layout->SetUnderline(u, range);
     });
 }
@@ -77,8 +75,8 @@ void LongUI::UIXmlRich::SetSelectionUnderline(bool u) noexcept {
 /// <param name="u">if set to <c>true</c> [u].</param>
 /// <returns></returns>
 void LongUI::UIXmlRich::SetSelectionStrikethrough(bool u) noexcept {
-    this->set_selection_helper([=](DWRITE_TEXT_RANGE range,
-        IDWriteTextLayout* layout)noexcept {
+    this->set_selection_helper([=](IDWriteTextLayout* layout,
+        DWRITE_TEXT_RANGE range) noexcept {
         layout->SetStrikethrough(u, range);
     });
 }
@@ -89,8 +87,8 @@ void LongUI::UIXmlRich::SetSelectionStrikethrough(bool u) noexcept {
 /// <param name="s">The s.</param>
 /// <returns></returns>
 void LongUI::UIXmlRich::SetSelectionStyle(DWRITE_FONT_STYLE s) noexcept {
-    this->set_selection_helper([=](DWRITE_TEXT_RANGE range,
-        IDWriteTextLayout* layout)noexcept {
+    this->set_selection_helper([=](IDWriteTextLayout* layout,
+        DWRITE_TEXT_RANGE range) noexcept {
         layout->SetFontStyle(s, range);
     });
 }
@@ -102,8 +100,8 @@ void LongUI::UIXmlRich::SetSelectionStyle(DWRITE_FONT_STYLE s) noexcept {
 /// <param name="c">The c.</param>
 /// <returns></returns>
 void LongUI::UIXmlRich::SetSelectionColor(const D2D1_COLOR_F& c) noexcept {
-    this->set_selection_helper([=](DWRITE_TEXT_RANGE range,
-        IDWriteTextLayout* layout)noexcept {
+    this->set_selection_helper([=](IDWriteTextLayout* layout,
+        DWRITE_TEXT_RANGE range) noexcept {
         if (auto color = CUIColorEffect::Create(c)) {
             layout->SetDrawingEffect(color, range);
             color->Release();
@@ -117,8 +115,8 @@ void LongUI::UIXmlRich::SetSelectionColor(const D2D1_COLOR_F& c) noexcept {
 /// <param name="w">The w.</param>
 /// <returns></returns>
 void LongUI::UIXmlRich::SetSelectionWeight(DWRITE_FONT_WEIGHT w) noexcept {
-    this->set_selection_helper([=](DWRITE_TEXT_RANGE range,
-        IDWriteTextLayout* layout)noexcept {
+    this->set_selection_helper([=](IDWriteTextLayout* layout,
+        DWRITE_TEXT_RANGE range) noexcept {
         layout->SetFontWeight(w, range);
     });
 }
@@ -0,0 +1,55 @@
+﻿// LayoutCompiler: compile LongUI window xml into binary layout
+// usage: LayoutCompiler <window.xml> <output> [template.xml] [-lz4]
+#define _CRT_SECURE_NO_WARNINGS
+#define LONGUI_WITH_DEFAULT_HEADER
+#include <LongUI/luiUiLayout.h>
+#include <Platonly/luiPoFile.h>
+#include <cstdio>
+#include <cwchar>
+
+
+// entry
+int wmain(int argc, wchar_t* argv[]) {
+    if (argc < 3) {
+        std::fwprintf(stderr, L"usage: %ls <window.xml> <output> [template.xml] [-lz4]\n", argv[0]);
+        return 1;
+    }
+    // 参数
+    const wchar_t* template_file = nullptr;
+    uint32_t flags = LongUI::Layout::Flag_None;
+    for (int i = 3; i < argc; ++i) {
+        if (!std::wcscmp(argv[i], L"-lz4")) flags |= LongUI::Layout::Flag_LZ4;
+        else template_file = argv[i];
+    }
+    // 载入窗口
+    pugi::xml_document window, templates;
+    auto code = window.load_file(argv[1]);
+    if (code.status) {
+        std::fwprintf(stderr, L"failed to load '%ls': %hs\n", argv[1], code.description());
+        return 2;
+    }
+    // 载入模板
+    if (template_file) {
+        code = templates.load_file(template_file);
+        if (code.status) {
+            std::fwprintf(stderr, L"failed to load '%ls': %hs\n", template_file, code.description());
+            return 2;
+        }
+    }
+    // 编译
+    LongUI::EzContainer::EzVector<uint8_t> output;
+    auto hr = LongUI::Layout::Compile(window.first_child(), templates.first_child(), flags, output);
+    if (FAILED(hr)) {
+        std::fwprintf(stderr, L"failed to compile '%ls': 0x%08X\n", argv[1], unsigned(hr));
+        return 3;
+    }
+    // 写入
+    using LongUI::CUIFile;
+    CUIFile file(argv[2], CUIFile::Flag_Write | CUIFile::Flag_CreateAlways);
+    if (!file.IsOk() || file.Write(output.data(), output.size()) != output.size()) {
+        std::fwprintf(stderr, L"failed to write '%ls'\n", argv[2]);
+        return 4;
+    }
+    std::wprintf(L"%ls -> %ls: %u bytes\n", argv[1], argv[2], unsigned(output.size()));
+    return 0;
+}
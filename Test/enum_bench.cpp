@@ -0,0 +1,90 @@
+// enum attribute decoding: sorted table lookup vs linear scan, see GetEnumFromString in luiUiXml.cpp
+#include "Platless/luiPlEnum.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using LongUI::EnumTable;
+    // clock
+    using Clock = std::chrono::steady_clock;
+    // ns per op
+    double ns_per(Clock::time_point a, Clock::time_point b, size_t n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / double(n);
+    }
+    // attribute of layout xml
+    struct Attribute { EnumTable table; std::string value; };
+    // linear scan like the unsorted tables before
+    uint32_t linear(const char* value, EnumTable table, uint32_t bad_match) {
+        if (!value || !*value) return bad_match;
+        if (*value >= '0' && *value <= '9') return uint32_t(std::atoi(value));
+        uint32_t count = 0;
+        const auto list = LongUI::GetEnumTable(table, count);
+        for (uint32_t i = 0; i != count; ++i) if (!std::strcmp(list[i].name, value)) return list[i].value;
+        return bad_match;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t rounds = argc > 1 ? uint32_t(std::atoi(argv[1])) : 100;
+    const uint32_t tables = uint32_t(EnumTable::TABLE_COUNT);
+    std::mt19937 rng(42);
+    int failed = 0;
+    // 每个名称都能找到, 数字原样返回
+    for (uint32_t t = 0; t != tables; ++t) {
+        uint32_t count = 0;
+        const auto list = LongUI::GetEnumTable(EnumTable(t), count);
+        for (uint32_t i = 0; i != count; ++i) {
+            if (LongUI::LookupEnum(list[i].name, EnumTable(t), ~0u) != list[i].value) ++failed;
+            if (i && std::strcmp(list[i - 1].name, list[i].name) >= 0) ++failed;
+        }
+        if (LongUI::LookupEnum(" 17", EnumTable(t), ~0u) != 17) ++failed;
+        if (LongUI::LookupEnum("", EnumTable(t), 99) != 99) ++failed;
+        if (LongUI::LookupEnum(nullptr, EnumTable(t), 99) != 99) ++failed;
+    }
+    // 大量属性: 名称按表大小加权, 少量数字
+    std::vector<Attribute> attrs(1 << 16);
+    for (auto& a : attrs) {
+        a.table = EnumTable(rng() % tables);
+        uint32_t count = 0;
+        const auto list = LongUI::GetEnumTable(a.table, count);
+        if (rng() % 16) a.value = list[rng() % count].name;
+        else a.value = std::to_string(rng() % 32);
+    }
+    uint64_t sum1 = 0, sum2 = 0;
+    auto t0 = Clock::now();
+    for (uint32_t r = 0; r != rounds; ++r)
+        for (const auto& a : attrs) sum1 += LongUI::LookupEnum(a.value.c_str(), a.table, 0);
+    auto t1 = Clock::now();
+    const auto sorted = ns_per(t0, t1, size_t(rounds) * attrs.size());
+    t0 = Clock::now();
+    for (uint32_t r = 0; r != rounds; ++r)
+        for (const auto& a : attrs) sum2 += linear(a.value.c_str(), a.table, 0);
+    t1 = Clock::now();
+    const auto scan = ns_per(t0, t1, size_t(rounds) * attrs.size());
+    if (sum1 != sum2) ++failed;
+    // 最大的表单独计
+    std::vector<const char*> anim;
+    for (const auto& a : attrs) if (a.table == EnumTable::Table_AnimationType) anim.push_back(a.value.c_str());
+    sum1 = sum2 = 0;
+    t0 = Clock::now();
+    for (uint32_t r = 0; r != rounds; ++r)
+        for (const auto v : anim) sum1 += LongUI::LookupEnum(v, EnumTable::Table_AnimationType, 0);
+    t1 = Clock::now();
+    const auto sorted_anim = ns_per(t0, t1, size_t(rounds) * anim.size());
+    t0 = Clock::now();
+    for (uint32_t r = 0; r != rounds; ++r)
+        for (const auto v : anim) sum2 += linear(v, EnumTable::Table_AnimationType, 0);
+    t1 = Clock::now();
+    const auto scan_anim = ns_per(t0, t1, size_t(rounds) * anim.size());
+    if (sum1 != sum2) ++failed;
+    std::printf("%-16s %8s %12s %12s\n", "attributes", "count", "lookup ns", "linear ns");
+    std::printf("%-16s %8u %12.1f %12.1f\n", "all tables", uint32_t(attrs.size()), sorted, scan);
+    std::printf("%-16s %8u %12.1f %12.1f\n", "animation type", uint32_t(anim.size()), sorted_anim, scan_anim);
+    if (failed) std::printf("FAILED: %d lookups differ\n", failed);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,241 @@
+// EzVector vs std::vector on ControlVector/IndexVector workloads, inline buffer checks first
+#include "Platless/luiPlEzC.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    namespace Ez = LongUI::EzContainer;
+    // clock
+    using Clock = std::chrono::steady_clock;
+    // ns per op
+    double ns_per(Clock::time_point a, Clock::time_point b, size_t n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / double(n);
+    }
+    // count of failure
+    uint32_t s_fail = 0;
+    // check
+    void check(bool ok, const char* what) {
+        if (ok) return;
+        if (++s_fail < 16) std::printf("FAILED: %s\n", what);
+    }
+    // same content
+    template<typename V, typename T> bool same(const V& v, const std::vector<T>& ref) {
+        if (v.size() != ref.size()) return false;
+        for (uint32_t i = 0; i != ref.size(); ++i) if (!(v.data()[i] == ref[i])) return false;
+        return true;
+    }
+    // in inline buffer?
+    template<typename V> bool in_object(const V& v) {
+        const auto p = reinterpret_cast<const char*>(v.data()), o = reinterpret_cast<const char*>(&v);
+        return p >= o && p < o + sizeof(v);
+    }
+    // inline <-> heap transitions of move_from and shrink_to_fit
+    void test_inline() {
+        using V4 = Ez::EzVector<uint32_t, 4>;
+        std::vector<uint32_t> ref;
+        {
+            // 内联数据移动: 复制, 源回到空的内联状态
+            V4 a; for (uint32_t i = 0; i != 3; ++i) { a.push_back(i); ref.push_back(i); }
+            check(in_object(a) && a.capacity() == 4, "inline push");
+            V4 b(std::move(a));
+            check(same(b, ref) && in_object(b) && b.capacity() == 4, "move inline");
+            check(a.empty() && in_object(a) && a.capacity() == 4 && a.isok(), "moved-from inline");
+            a.push_back(7);
+            check(a.size() == 1 && a[0] == 7, "reuse moved-from inline");
+        }
+        {
+            // 堆数据移动: 窃取指针
+            V4 a; ref.clear();
+            for (uint32_t i = 0; i != 100; ++i) { a.push_back(i); ref.push_back(i); }
+            check(!in_object(a) && a.capacity() >= 100, "heap push");
+            const auto p = a.data();
+            V4 b(std::move(a));
+            check(same(b, ref) && b.data() == p, "move heap steals");
+            check(a.empty() && in_object(a) && a.capacity() == 4, "moved-from heap");
+            // 移动赋值: 释放目标的堆数据
+            V4 c; for (uint32_t i = 0; i != 50; ++i) c.push_back(i);
+            c = std::move(b);
+            check(same(c, ref) && c.data() == p && b.empty() && in_object(b), "move assign heap");
+            V4 d; d.push_back(1); d.push_back(2);
+            c = std::move(d);
+            check(c.size() == 2 && c[1] == 2 && in_object(c) && c.capacity() == 4, "move assign inline over heap");
+        }
+        {
+            // shrink_to_fit: 堆 -> 内联
+            V4 a; ref.clear();
+            for (uint32_t i = 0; i != 20; ++i) a.push_back(i);
+            a.erase(3, 17);
+            ref = { 0, 1, 2 };
+            a.shrink_to_fit();
+            check(same(a, ref) && in_object(a) && a.capacity() == 4, "shrink heap to inline");
+            a.shrink_to_fit();
+            check(same(a, ref) && in_object(a), "shrink inline noop");
+            // 堆 -> 较小的堆
+            for (uint32_t i = 3; i != 40; ++i) a.push_back(i);
+            a.erase(10, 30);
+            ref.clear(); for (uint32_t i = 0; i != 10; ++i) ref.push_back(i);
+            a.shrink_to_fit();
+            check(same(a, ref) && !in_object(a) && a.capacity() == 10, "shrink heap to heap");
+            // 刚好等于内联容量
+            a.erase(4, 6); ref.resize(4);
+            a.shrink_to_fit();
+            check(same(a, ref) && in_object(a) && a.capacity() == 4, "shrink to exactly inline");
+            a.reserve(5);
+            check(same(a, ref) && !in_object(a) && a.capacity() == 5, "reserve exactly");
+        }
+        {
+            // 无内联缓冲区
+            Ez::EzVector<uint32_t> a;
+            for (uint32_t i = 0; i != 10; ++i) a.push_back(i);
+            a.erase(0, 10);
+            a.shrink_to_fit();
+            check(!a.capacity() && a.empty(), "shrink empty no inline");
+            a.push_back(5);
+            check(a.isok() && a.size() == 1 && a[0] == 5, "push after shrink empty");
+            Ez::EzVector<uint32_t> b(std::move(a));
+            check(b.size() == 1 && !a.capacity() && a.empty(), "move no inline");
+        }
+        {
+            // 区间插入/删除跨越内联边界
+            V4 a; ref.clear();
+            const uint32_t src[] = { 10, 11, 12, 13, 14, 15 };
+            a.insert(0, src, 2); ref.insert(ref.begin(), src, src + 2);
+            a.insert(1, src + 2, 4); ref.insert(ref.begin() + 1, src + 2, src + 6);
+            check(same(a, ref) && !in_object(a), "range insert to heap");
+            a.erase(1, 3); ref.erase(ref.begin() + 1, ref.begin() + 4);
+            check(same(a, ref), "range erase");
+        }
+    }
+    // selected range of UIList
+    struct Range { uint32_t first, last; bool operator==(const Range& r) const { return first == r.first && last == r.last; } };
+    // insert adapter
+    template<typename T> void ins(std::vector<T>& v, uint32_t pos, const T& x) { v.insert(v.begin() + pos, x); }
+    template<typename T, uint32_t N> void ins(Ez::EzVector<T, N>& v, uint32_t pos, const T& x) { v.insert(pos, x); }
+    // range insert adapter
+    template<typename T> void ins(std::vector<T>& v, uint32_t pos, const T* x, uint32_t n) { v.insert(v.begin() + pos, x, x + n); }
+    template<typename T, uint32_t N> void ins(Ez::EzVector<T, N>& v, uint32_t pos, const T* x, uint32_t n) { v.insert(pos, x, n); }
+    template<typename T> void ins(Ez::PointerVector<T>& v, uint32_t pos, T* const* x, uint32_t n) { v.insert(pos, x, n); }
+    // range erase adapter
+    template<typename T> void del(std::vector<T>& v, uint32_t pos, uint32_t n) { v.erase(v.begin() + pos, v.begin() + pos + n); }
+    template<typename V> void del(V& v, uint32_t pos, uint32_t n) { v.erase(pos, n); }
+    // first range whose last not less than index, like UIList::find_range
+    template<typename V> uint32_t find_range(const V& v, uint32_t index) {
+        const auto bn = v.data(), ed = bn + v.size();
+        return uint32_t(std::lower_bound(bn, ed, index, [](const Range& r, uint32_t i) { return r.last < i; }) - bn);
+    }
+    // like UIList::add_select_range
+    template<typename V> void add_range(V& v, uint32_t a, uint32_t b) {
+        const auto i = a ? find_range(v, a - 1) : 0;
+        auto j = i;
+        while (j < v.size() && uint64_t(v[j].first) <= uint64_t(b) + 1) ++j;
+        if (i == j) return ins(v, i, Range{ a, b });
+        v[i].first = std::min(v[i].first, a);
+        v[i].last = std::max(v[j - 1].last, b);
+        if (j - i > 1) del(v, i + 1, j - i - 1);
+    }
+    // like UIList::remove_select
+    template<typename V> void remove_one(V& v, uint32_t index) {
+        const auto i = find_range(v, index);
+        if (i >= v.size() || v[i].first > index) return;
+        auto& r = v[i];
+        if (r.first == r.last) del(v, i, 1);
+        else if (r.first == index) ++r.first;
+        else if (r.last == index) --r.last;
+        else { const Range back{ index + 1, r.last }; r.last = index - 1; ins(v, i + 1, back); }
+    }
+    // selection operations: ctrl-click, shift-click
+    struct SelOp { uint32_t a, b; bool add; };
+    // selection change workload
+    template<typename V> double bench_selection(V& v, const std::vector<SelOp>& ops, uint32_t rounds) {
+        const auto t0 = Clock::now();
+        for (uint32_t r = 0; r != rounds; ++r) {
+            v.clear();
+            for (const auto& op : ops) op.add ? add_range(v, op.a, op.b) : remove_one(v, op.a);
+        }
+        return ns_per(t0, Clock::now(), size_t(rounds) * ops.size());
+    }
+    // block insert/erase of lines, like UIList insert/remove of many lines
+    struct BlockOp { uint32_t pos, len; bool insert; };
+    // range insert/erase workload
+    template<typename V, typename P> double bench_blocks(V& v, const std::vector<BlockOp>& ops, const P* src, uint32_t rounds) {
+        const auto t0 = Clock::now();
+        for (uint32_t r = 0; r != rounds; ++r) {
+            v.clear();
+            for (const auto& op : ops) {
+                if (op.insert) ins(v, std::min(op.pos, uint32_t(v.size())), src, op.len);
+                else if (v.size()) {
+                    const auto pos = op.pos % uint32_t(v.size());
+                    del(v, pos, std::min(op.len, uint32_t(v.size()) - pos));
+                }
+            }
+        }
+        return ns_per(t0, Clock::now(), size_t(rounds) * ops.size());
+    }
+    // push back workload: count vectors of n indices
+    template<typename V> double bench_push(uint32_t count, uint32_t n, uint64_t& sum) {
+        const auto t0 = Clock::now();
+        for (uint32_t c = 0; c != count; ++c) {
+            V v;
+            for (uint32_t i = 0; i != n; ++i) v.push_back(i ^ c);
+            sum += v[n / 2] + v.size();
+        }
+        return ns_per(t0, Clock::now(), size_t(count) * n);
+    }
+    // control stand-in
+    struct Control { uint32_t id; };
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t rounds = argc > 1 ? uint32_t(std::atoi(argv[1])) : 200;
+    test_inline();
+    std::mt19937 rng(42);
+    std::printf("%-22s %8s %12s %12s\n", "workload", "size", "EzVector ns", "std ns");
+    // 选择变化: 区间增删
+    for (const uint32_t lines : { 64u, 1024u, 16384u }) {
+        std::vector<SelOp> ops(2048);
+        for (auto& op : ops) {
+            op.a = rng() % lines;
+            op.b = std::min(lines - 1, op.a + uint32_t(rng() % 4 ? 0 : rng() % 16));
+            op.add = rng() % 3 != 0;
+        }
+        Ez::EzVector<Range> ez; std::vector<Range> sv;
+        const auto e = bench_selection(ez, ops, rounds);
+        const auto s = bench_selection(sv, ops, rounds);
+        check(same(ez, sv), "selection result");
+        std::printf("%-22s %8u %12.1f %12.1f\n", "selection change", lines, e, s);
+    }
+    // 区间插入/删除: ControlVector
+    std::vector<Control> controls(256);
+    std::vector<Control*> src(controls.size());
+    for (uint32_t i = 0; i != src.size(); ++i) { controls[i].id = i; src[i] = &controls[i]; }
+    for (const uint32_t block : { 1u, 16u, 256u }) {
+        std::vector<BlockOp> ops(1024);
+        for (auto& op : ops) {
+            op.pos = rng() % 4096;
+            op.len = rng() % block + 1;
+            op.insert = rng() % 5 < 3;
+        }
+        Ez::PointerVector<Control> ez; std::vector<Control*> sv;
+        const auto e = bench_blocks(ez, ops, src.data(), rounds / 4 + 1);
+        const auto s = bench_blocks(sv, ops, src.data(), rounds / 4 + 1);
+        check(same(ez, sv), "block result");
+        std::printf("%-22s %8u %12.1f %12.1f\n", "range insert/erase", block, e, s);
+    }
+    // 尾部追加: IndexVector, 小数组使用内联缓冲区
+    uint64_t sum1 = 0, sum2 = 0, sum3 = 0;
+    for (const uint32_t n : { 4u, 64u, 4096u }) {
+        const uint32_t count = std::max(1u, rounds * 4096 / n);
+        const auto e = bench_push<Ez::EzVector<uint32_t>>(count, n, sum1);
+        const auto i = bench_push<Ez::EzVector<uint32_t, 8>>(count, n, sum2);
+        const auto s = bench_push<std::vector<uint32_t>>(count, n, sum3);
+        std::printf("%-22s %8u %12.1f %12.1f\n", "push_back", n, e, s);
+        std::printf("%-22s %8u %12.1f %12s\n", "push_back inline 8", n, i, "-");
+    }
+    check(sum1 == sum3 && sum2 == sum3, "push_back result");
+    std::printf("ezvector_bench: %u failed\n", s_fail);
+    return s_fail ? 1 : 0;
+}
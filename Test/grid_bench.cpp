@@ -0,0 +1,125 @@
+// hit-test grid vs linear scan, see LongUIHitTestGridThreshold in luiconf.h
+#include "Platless/luiPlGrid.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    // control stand-in: linked list node of control size, rect inside
+    struct Node {
+        Node*                       next;
+        char                        pad1[200];
+        LongUI::CUIHitTestGrid::Rect rect;
+        char                        pad2[300];
+    };
+    // clock
+    using Clock = std::chrono::steady_clock;
+    // ns per op
+    double ns_per(Clock::time_point a, Clock::time_point b, size_t n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / double(n);
+    }
+    // layout: 0 for vertical list, 1 for tiles
+    std::vector<Node*> make_nodes(uint32_t n, int layout) {
+        std::vector<Node*> nodes(n);
+        const uint32_t cols = layout ? uint32_t(std::max(1.0, std::sqrt(double(n)))) : 1;
+        for (uint32_t i = 0; i < n; ++i) {
+            const auto node = new Node;
+            const float x = float(i % cols) * 82.f, y = float(i / cols) * 26.f;
+            node->rect = { x, y, x + 80.f, y + 24.f };
+            nodes[i] = node;
+        }
+        for (uint32_t i = 0; i + 1 < n; ++i) nodes[i]->next = nodes[i + 1];
+        nodes[n - 1]->next = nullptr;
+        return nodes;
+    }
+    // linear scan like UIContainerBuiltIn::FindChild
+    Node* find_linear(Node* head, float x, float y) {
+        for (auto node = head; node; node = node->next) {
+            const auto& rc = node->rect;
+            if (x >= rc.left && y >= rc.top && x < rc.right && y < rc.bottom) return node;
+        }
+        return nullptr;
+    }
+    // rebuild like UIContainerBuiltIn::rebuild_hittest_grid
+    bool rebuild(LongUI::CUIHitTestGrid& grid, Node* head, uint32_t n) {
+        auto item = grid.Prepare(n);
+        if (!item) return false;
+        for (auto node = head; node; node = node->next, ++item) {
+            item->rect = node->rect;
+            item->data = node;
+        }
+        return grid.Build(256);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t queries = argc > 1 ? uint32_t(std::atoi(argv[1])) : 1u << 20;
+    const uint32_t counts[] = { 8, 16, 24, 32, 48, 64, 128, 512, 2048 };
+    const char* names[] = { "list", "tiles" };
+    std::mt19937 rng(42);
+    int failed = 0;
+    std::printf("%-6s %6s %12s %12s %12s %10s\n",
+        "layout", "count", "linear ns", "grid ns", "rebuild ns", "break-even");
+    for (int layout = 0; layout < 2; ++layout) {
+        for (const auto n : counts) {
+            auto nodes = make_nodes(n, layout);
+            const auto head = nodes[0];
+            // 包围盒内的随机点
+            float right = 0.f, bottom = 0.f;
+            for (auto node : nodes) {
+                right = std::max(right, node->rect.right);
+                bottom = std::max(bottom, node->rect.bottom);
+            }
+            std::uniform_real_distribution<float> dx(0.f, right), dy(0.f, bottom);
+            std::vector<float> pts(queries * 2);
+            for (uint32_t i = 0; i < queries; ++i) {
+                pts[i * 2] = dx(rng);
+                pts[i * 2 + 1] = dy(rng);
+            }
+            LongUI::CUIHitTestGrid grid;
+            // rebuild
+            const uint32_t rounds = 2000;
+            auto t0 = Clock::now();
+            for (uint32_t i = 0; i < rounds; ++i) {
+                if (!rebuild(grid, head, n)) { std::puts("OOM"); return 1; }
+            }
+            auto t1 = Clock::now();
+            const auto rebuild_ns = ns_per(t0, t1, rounds);
+            // 结果必须与线性查找一致
+            for (uint32_t i = 0; i < queries; ++i) {
+                const auto x = pts[i * 2], y = pts[i * 2 + 1];
+                if (grid.Find(x, y) != find_linear(head, x, y)) {
+                    std::printf("MISMATCH layout=%s count=%u at (%g, %g)\n", names[layout], n, x, y);
+                    ++failed;
+                    break;
+                }
+            }
+            // linear
+            uintptr_t sink = 0;
+            t0 = Clock::now();
+            for (uint32_t i = 0; i < queries; ++i) {
+                sink += uintptr_t(find_linear(head, pts[i * 2], pts[i * 2 + 1]));
+            }
+            t1 = Clock::now();
+            const auto linear_ns = ns_per(t0, t1, queries);
+            // grid
+            t0 = Clock::now();
+            for (uint32_t i = 0; i < queries; ++i) {
+                sink -= uintptr_t(grid.Find(pts[i * 2], pts[i * 2 + 1]));
+            }
+            t1 = Clock::now();
+            const auto grid_ns = ns_per(t0, t1, queries);
+            if (sink) std::puts("");
+            char even[32] = "never";
+            if (linear_ns > grid_ns) std::snprintf(even, sizeof even, "%.0f", rebuild_ns / (linear_ns - grid_ns));
+            std::printf("%-6s %6u %12.1f %12.1f %12.1f %10s\n",
+                names[layout], n, linear_ns, grid_ns, rebuild_ns, even);
+            for (auto node : nodes) delete node;
+        }
+    }
+    return failed;
+}
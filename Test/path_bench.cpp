@@ -0,0 +1,95 @@
+// svg path: compile vs cached acquire, and flatten, see LongUIPathCacheBudget in luiconf.h
+#include "Platless/luiPlPath.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace LongUI::SVG;
+    // clock
+    using Clock = std::chrono::steady_clock;
+    // ns per op
+    double ns_per(Clock::time_point a, Clock::time_point b, size_t n) {
+        return std::chrono::duration<double, std::nano>(b - a).count() / double(n);
+    }
+    // random icon-like path with segments
+    std::string make_path(std::mt19937& rng, uint32_t segments) {
+        std::uniform_real_distribution<float> pos(0.f, 64.f);
+        const char cmds[] = "LlHhVvCcSsQqTtAa";
+        char buf[256];
+        std::string path = "M32 32";
+        for (uint32_t i = 0; i < segments; ++i) {
+            const char ch = cmds[rng() % (sizeof(cmds) - 1)];
+            const float a = pos(rng), b = pos(rng), c = pos(rng), d = pos(rng), e = pos(rng), f = pos(rng);
+            switch (ch | 0x20) {
+            case 'l': case 't': std::snprintf(buf, sizeof(buf), "%c%.2f,%.2f", ch, a, b); break;
+            case 'h': case 'v': std::snprintf(buf, sizeof(buf), "%c%.3f", ch, a); break;
+            case 'c': std::snprintf(buf, sizeof(buf), "%c%.2f %.2f %.2f %.2f %.2f %.2f", ch, a, b, c, d, e, f); break;
+            case 's': case 'q': std::snprintf(buf, sizeof(buf), "%c%.2f-%.2f %.2f-%.2f", ch, a, b, c, d); break;
+            default: std::snprintf(buf, sizeof(buf), "%c%.1f %.1f 0 %u 1 %.2f %.2f", ch, a + 1.f, b + 1.f, unsigned(rng() & 1), e, f); break;
+            }
+            path += buf;
+            if (rng() % 8 == 0) path += 'Z';
+        }
+        return path;
+    }
+    // same ir?
+    bool same(const PathIR& a, const PathIR& b) {
+        return a.commands.size() == b.commands.size() && a.data.size() == b.data.size()
+            && !std::memcmp(a.commands.data(), b.commands.data(), a.commands.size() * sizeof(PathCommand))
+            && !std::memcmp(a.data.data(), b.data.data(), a.data.size() * sizeof(float));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t rounds = argc > 1 ? uint32_t(std::atoi(argv[1])) : 200;
+    const uint32_t sizes[] = { 4, 16, 64, 256 };
+    std::mt19937 rng(42);
+    int failed = 0;
+    std::printf("%8s %6s %12s %12s %12s %12s\n",
+        "segments", "paths", "compile ns", "acquire ns", "flatten ns", "points");
+    for (const auto segments : sizes) {
+        std::vector<std::string> paths(64);
+        for (auto& p : paths) p = make_path(rng, segments);
+        const size_t n = size_t(rounds) * paths.size();
+        PathIR ir;
+        // 每次重新解析
+        auto t0 = Clock::now();
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (const auto& p : paths) CompilePath(p.c_str(), ir);
+        auto t1 = Clock::now();
+        const auto compile = ns_per(t0, t1, n);
+        // 缓存命中: 设备重建时的路径
+        CUIPathCache cache(1024 * 1024 * 16);
+        for (const auto& p : paths) {
+            CompilePath(p.c_str(), ir);
+            const auto cached = cache.Acquire(p.c_str());
+            if (!cached || !same(*cached, ir)) ++failed;
+            cache.Release(cached);
+        }
+        t0 = Clock::now();
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (const auto& p : paths) cache.Release(cache.Acquire(p.c_str()));
+        t1 = Clock::now();
+        const auto acquire = ns_per(t0, t1, n);
+        // 展平
+        LongUI::EzContainer::EzVector<PathPoint> points;
+        LongUI::EzContainer::EzVector<PathContour> contours;
+        std::vector<PathIR> irs(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) CompilePath(paths[i].c_str(), irs[i]);
+        size_t total = 0;
+        t0 = Clock::now();
+        for (uint32_t r = 0; r < rounds; ++r)
+            for (const auto& x : irs) { FlattenPath(x, .25f, points, contours); total += points.size(); }
+        t1 = Clock::now();
+        const auto flatten = ns_per(t0, t1, n);
+        std::printf("%8u %6u %12.1f %12.1f %12.1f %12.1f\n", segments, uint32_t(paths.size()),
+            compile, acquire, flatten, double(total) / double(n));
+    }
+    if (failed) std::printf("FAILED: %d cached paths differ\n", failed);
+    return failed ? 1 : 0;
+}
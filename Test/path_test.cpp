@@ -0,0 +1,174 @@
+// svg path compiler, flattener and cache test
+#include "Platless/luiPlPath.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+    using namespace LongUI::SVG;
+    // count of failure
+    uint32_t s_fail = 0;
+    // check
+    void check(bool ok, const char* what) {
+        if (ok) return;
+        if (++s_fail < 16) std::printf("FAILED: %s\n", what);
+    }
+    // float equal
+    bool feq(float a, float b) { return std::abs(a - b) <= 1e-4f * std::max(1.f, std::abs(a)); }
+    // compile and compare with commands and data
+    void expect(const char* path, std::vector<PathCommand> cmds, std::vector<float> data) {
+        PathIR ir;
+        check(CompilePath(path, ir), path);
+        bool ok = ir.commands.size() == cmds.size() && ir.data.size() == data.size();
+        for (uint32_t i = 0; ok && i != cmds.size(); ++i) ok = ir.commands.data()[i] == cmds[i];
+        for (uint32_t i = 0; ok && i != data.size(); ++i) ok = feq(ir.data.data()[i], data[i]);
+        check(ok, path);
+    }
+    // sink counting commands
+    struct CountSink {
+        uint32_t count[6] = {};
+        float last[2] = {};
+        void Move(const float* a) { ++count[0]; last[0] = a[0]; last[1] = a[1]; }
+        void Line(const float* a) { ++count[1]; last[0] = a[0]; last[1] = a[1]; }
+        void Bezier(const float* a) { ++count[2]; last[0] = a[4]; last[1] = a[5]; }
+        void Quadratic(const float* a) { ++count[3]; last[0] = a[2]; last[1] = a[3]; }
+        void Arc(const float* a) { ++count[4]; last[0] = a[5]; last[1] = a[6]; }
+        void Close() { ++count[5]; }
+    };
+    // compiler
+    void test_compile() {
+        const auto M = PathCommand::Command_Move, L = PathCommand::Command_Line;
+        const auto C = PathCommand::Command_Bezier, Q = PathCommand::Command_Quadratic;
+        const auto A = PathCommand::Command_Arc, Z = PathCommand::Command_Close;
+        expect("", {}, {});
+        expect("M10 20 L30 40 Z", { M, L, Z }, { 10, 20, 30, 40 });
+        expect("M10,20l5-5h10v.5", { M, L, L, L }, { 10, 20, 15, 15, 25, 15, 25, 15.5f });
+        expect("M1e1 -2.5E-1H3V-4", { M, L, L }, { 10, -.25f, 3, -.25f, 3, -4 });
+        expect("m1 1 m2 2", { M, M }, { 1, 1, 3, 3 });
+        // 三次与二次贝塞尔的控制点镜像
+        expect("M0 0C1 2 3 4 5 6S9 10 11 12", { M, C, C },
+            { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 });
+        expect("M0 0c1 2 3 4 5 6s4 4 6 6", { M, C, C },
+            { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 });
+        expect("M0 0Q1 1 2 0T4 0", { M, Q, Q }, { 0, 0, 1, 1, 2, 0, 3, -1, 4, 0 });
+        expect("M0 0q1 1 2 0t2 0", { M, Q, Q }, { 0, 0, 1, 1, 2, 0, 3, -1, 4, 0 });
+        // 弧的标志归一
+        expect("M0 0A5 5 0 1 0 10 0a5 5 30 0 7 -10 0", { M, A, A },
+            { 0, 0, 5, 5, 0, 1, 0, 10, 0, 5, 5, 30, 0, 1, 0, 0 });
+        // 回放
+        PathIR ir; CountSink sink;
+        CompilePath("M0 0L1 1C1 2 3 4 5 6Q1 1 2 2A1 1 0 0 1 3 3ZM7 8", ir);
+        ir.Replay(sink);
+        const uint32_t count[] = { 2, 1, 1, 1, 1, 1 };
+        check(!std::memcmp(sink.count, count, sizeof(count)), "replay count");
+        check(sink.last[0] == 7.f && sink.last[1] == 8.f, "replay args");
+    }
+    // flattener
+    void test_flatten() {
+        PathIR ir;
+        LongUI::EzContainer::EzVector<PathPoint> points;
+        LongUI::EzContainer::EzVector<PathContour> contours;
+        // 折线原样输出
+        CompilePath("M0 0L10 0L10 10ZM20 20L30 30", ir);
+        check(FlattenPath(ir, .25f, points, contours), "flatten lines");
+        check(contours.size() == 2 && points.size() == 5, "lines count");
+        if (contours.size() == 2) {
+            const auto c0 = contours.data()[0], c1 = contours.data()[1];
+            check(c0.first == 0 && c0.count == 3 && c0.closed, "closed contour");
+            check(c1.first == 3 && c1.count == 2 && !c1.closed, "open contour");
+        }
+        // 圆: 弦上各点到圆的距离不超过容差
+        const float tolerances[] = { 1.f, .25f, .01f };
+        for (const auto t : tolerances) {
+            CompilePath("M100 50A50 50 0 1 1 0 50A50 50 0 1 1 100 50Z", ir);
+            FlattenPath(ir, t, points, contours);
+            bool ok = contours.size() == 1 && points.size() > 8;
+            const auto p = points.data();
+            for (uint32_t i = 0; ok && i < points.size(); ++i) {
+                const auto r = std::hypot(p[i].x - 50.f, p[i].y - 50.f);
+                ok = std::abs(r - 50.f) < 1e-3f;
+                if (i) {
+                    const auto mx = (p[i].x + p[i - 1].x) * .5f, my = (p[i].y + p[i - 1].y) * .5f;
+                    ok = ok && 50.f - std::hypot(mx - 50.f, my - 50.f) <= t * 1.01f + 1e-3f;
+                }
+            }
+            check(ok, "arc tolerance");
+        }
+        // 三次贝塞尔: 折线顶点在曲线上, 容差越小点越多
+        uint32_t last = 0;
+        for (const auto t : tolerances) {
+            CompilePath("M0 0C0 100 100 100 100 0", ir);
+            FlattenPath(ir, t, points, contours);
+            const auto p = points.data();
+            bool ok = points.size() > last && p[0].x == 0.f && p[points.size() - 1].x == 100.f;
+            for (uint32_t i = 1; ok && i < points.size(); ++i) {
+                // x(t) = 300t^2 - 200t^3 单调递增
+                ok = p[i].x > p[i - 1].x;
+            }
+            last = points.size();
+            check(ok, "bezier flatten");
+        }
+    }
+    // cache
+    void test_cache() {
+        {
+            CUIPathCache cache(1024 * 1024);
+            const auto a = cache.Acquire("M0 0L1 1");
+            const auto b = cache.Acquire("M0 0L1 1");
+            check(a && a == b, "cache hit");
+            check(cache.GetCount() == 1 && cache.GetBytes() > 0, "cache count");
+            const auto c = cache.Acquire("M0 0L2 2");
+            check(c && c != a && cache.GetCount() == 2, "cache miss");
+            cache.Release(a); cache.Release(b); cache.Release(c);
+            // 已获取的路径清空后依然有效
+            const auto d = cache.Acquire("M0 0L3 3");
+            cache.Clear();
+            check(!cache.GetCount() && !cache.GetBytes(), "cache clear");
+            check(d && d->commands.size() == 2 && d->data.data()[3] == 3.f, "acquired after clear");
+            cache.Release(d);
+        }
+        {
+            // 预算只够一个: 最久未使用的被淘汰, 使用中的路径依然有效
+            CUIPathCache cache(1);
+            const auto a = cache.Acquire("M0 0L1 1");
+            const auto b = cache.Acquire("M0 0L2 2");
+            check(cache.GetCount() == 1, "cache evict");
+            check(a->data.data()[2] == 1.f && b->data.data()[2] == 2.f, "evicted still valid");
+            const auto c = cache.Acquire("M0 0L2 2");
+            check(c == b, "newest kept");
+            cache.Release(a); cache.Release(b); cache.Release(c);
+            const auto d = cache.Acquire("M0 0L1 1");
+            check(d && d->data.data()[2] == 1.f && cache.GetCount() == 1, "recompile after evict");
+            cache.Release(d);
+        }
+        {
+            // 多线程获取与释放
+            CUIPathCache cache(512);
+            std::vector<std::thread> threads;
+            uint32_t bad[4] = {};
+            for (uint32_t i = 0; i != 4; ++i) threads.emplace_back([&cache, &bad, i]() {
+                char buf[64];
+                for (uint32_t j = 0; j != 20000; ++j) {
+                    const auto v = (j * 7 + i) % 37;
+                    std::snprintf(buf, sizeof(buf), "M0 0L%u %u", v, v);
+                    const auto ir = cache.Acquire(buf);
+                    if (!ir || ir->data.size() != 4 || ir->data.data()[2] != float(v)) ++bad[i];
+                    cache.Release(ir);
+                }
+            });
+            for (auto& t : threads) t.join();
+            check(!(bad[0] | bad[1] | bad[2] | bad[3]), "cache threads");
+            check(cache.GetBytes() <= 512 || cache.GetCount() == 1, "cache budget");
+        }
+    }
+}
+
+int main() {
+    test_compile();
+    test_flatten();
+    test_cache();
+    std::printf("path_test: %u failed\n", s_fail);
+    return s_fail ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+// text layout cache test with mock backend: hit/miss, lru order and byte budget
+#include "Platless/luiPlText.h"
+#include <cstdio>
+#include <cwchar>
+#include <vector>
+
+namespace {
+    // count of failure
+    uint32_t s_fail = 0;
+    // check
+    void check(bool ok, const char* what) {
+        if (ok) return;
+        if (++s_fail < 16) std::printf("FAILED: %s\n", what);
+    }
+    // ref-counted mock object, layout or format
+    struct Object { int refs; bool layout; };
+    // mock backend, tracks references of all objects
+    struct MockBackend final : LongUI::XUITextLayoutBackend {
+        // objects
+        std::vector<Object*>    objects;
+        // bytes of each layout
+        uint32_t                bytes = 1000;
+        // created
+        uint32_t                created = 0;
+        // dtor
+        ~MockBackend() { for (auto obj : objects) delete obj; }
+        // new object with one reference
+        Object* make(bool layout) { objects.push_back(new Object{ 1, layout }); return objects.back(); }
+        // create layout
+        auto CreateLayout(const LongUI::TextLayoutKey& key) noexcept -> void* override {
+            check(key.format && static_cast<Object*>(key.format)->refs > 0, "format alive");
+            ++created;
+            return this->make(true);
+        }
+        // add reference
+        void Acquire(void* obj) noexcept override { ++static_cast<Object*>(obj)->refs; }
+        // release reference
+        void Release(void* obj) noexcept override {
+            const auto o = static_cast<Object*>(obj);
+            check(o->refs > 0, "over release");
+            --o->refs;
+        }
+        // measure
+        auto MeasureLayout(void*, const LongUI::TextLayoutKey&) noexcept -> uint32_t override { return bytes; }
+        // count of alive layouts
+        uint32_t alive() const {
+            uint32_t n = 0;
+            for (auto obj : objects) n += obj->layout && obj->refs > 0;
+            return n;
+        }
+    };
+    // refs of layout
+    int refs(void* obj) { return static_cast<Object*>(obj)->refs; }
+    // make key
+    LongUI::TextLayoutKey key(const wchar_t* text, void* format, float width = 100.f, uint32_t flags = 0) {
+        return LongUI::TextLayoutKey{ text, uint32_t(std::wcslen(text)), flags, format, width, 100.f };
+    }
+    // hit and miss
+    void test_hit_miss() {
+        MockBackend backend;
+        const auto fmt1 = backend.make(false), fmt2 = backend.make(false);
+        {
+            LongUI::CUITextLayoutCache cache(backend, 1024 * 1024);
+            const auto a = cache.Get(key(L"hello", fmt1));
+            check(a && cache.GetMissCount() == 1 && !cache.GetHitCount(), "first miss");
+            check(refs(a) == 2 && fmt1->refs == 2, "cache holds references");
+            // 内容相同即命中, 与指针无关
+            wchar_t copy[] = L"hello";
+            const auto b = cache.Get(key(copy, fmt1));
+            check(b == a && cache.GetHitCount() == 1 && refs(a) == 3, "hit by content");
+            // 任一键值不同都不命中
+            const auto c = cache.Get(key(L"hello", fmt2));
+            const auto d = cache.Get(key(L"hello", fmt1, 50.f));
+            const auto e = cache.Get(key(L"hello", fmt1, 100.f, 1));
+            const auto f = cache.Get(key(L"hell", fmt1));
+            check(c != a && d != a && e != a && f != a, "miss by key");
+            check(cache.GetMissCount() == 5 && cache.GetCount() == 5 && backend.created == 5, "miss count");
+            check(cache.GetUsage() > 5 * backend.bytes, "usage");
+            cache.ResetCounters();
+            check(!cache.GetHitCount() && !cache.GetMissCount(), "reset counters");
+            for (auto x : { a, b, c, d, e, f }) backend.Release(x);
+            check(backend.alive() == 5, "cache keeps layouts");
+            // 空文本
+            const auto g = cache.Get(key(L"", fmt1));
+            check(g && cache.Get(key(L"", fmt1)) == g && refs(g) == 3, "empty text");
+            backend.Release(g); backend.Release(g);
+            cache.Clear();
+            check(!cache.GetCount() && !cache.GetUsage() && !backend.alive(), "clear");
+            check(fmt1->refs == 1 && fmt2->refs == 1, "formats released");
+            // 析构时释放
+            backend.Release(cache.Get(key(L"dtor", fmt2)));
+            check(fmt2->refs == 2 && backend.alive() == 1, "before dtor");
+        }
+        check(fmt2->refs == 1 && !backend.alive(), "dtor");
+    }
+    // lru order and byte budget
+    void test_lru_budget() {
+        MockBackend backend;
+        const auto fmt = backend.make(false);
+        LongUI::CUITextLayoutCache cache(backend, 1024 * 1024);
+        backend.Release(cache.Get(key(L"a", fmt)));
+        const auto unit = cache.GetUsage();
+        check(unit > backend.bytes, "entry bytes");
+        // 只够三个
+        cache.SetBudget(unit * 3);
+        const auto b = cache.Get(key(L"b", fmt)); backend.Release(b);
+        const auto c = cache.Get(key(L"c", fmt)); backend.Release(c);
+        check(cache.GetCount() == 3 && cache.GetUsage() == unit * 3, "full");
+        // a 变为最近使用, 淘汰最久未用的 b
+        backend.Release(cache.Get(key(L"a", fmt)));
+        backend.Release(cache.Get(key(L"d", fmt)));
+        check(cache.GetCount() == 3 && cache.GetUsage() <= cache.GetBudget(), "evict to budget");
+        check(refs(b) == 0 && refs(c) == 1, "oldest evicted");
+        cache.ResetCounters();
+        backend.Release(cache.Get(key(L"a", fmt)));
+        backend.Release(cache.Get(key(L"c", fmt)));
+        backend.Release(cache.Get(key(L"d", fmt)));
+        check(cache.GetHitCount() == 3 && !cache.GetMissCount(), "recent kept");
+        // 被淘汰的布局调用者仍持有时依然有效
+        const auto e = cache.Get(key(L"e", fmt));
+        const auto f = cache.Get(key(L"f", fmt));
+        const auto g = cache.Get(key(L"g", fmt));
+        const auto h = cache.Get(key(L"h", fmt));
+        check(refs(e) == 1 && refs(h) == 2, "evicted held by caller");
+        for (auto x : { e, f, g, h }) backend.Release(x);
+        // 缩小预算立即淘汰
+        cache.SetBudget(unit);
+        check(cache.GetCount() == 1 && cache.GetUsage() == unit && refs(h) == 1, "shrink budget");
+        // 超出预算的布局不缓存, 只交给调用者
+        backend.bytes = uint32_t(unit * 2);
+        const auto big = cache.Get(key(L"big", fmt));
+        check(big && refs(big) == 1 && cache.GetCount() == 1 && refs(h) == 1, "too big not cached");
+        backend.Release(big);
+        backend.bytes = 1000;
+        cache.SetBudget(0);
+        check(!cache.GetCount() && !cache.GetUsage() && !backend.alive(), "zero budget");
+        check(fmt->refs == 1, "format refs");
+    }
+    // many entries across rehash, usage never over budget
+    void test_rehash() {
+        MockBackend backend;
+        const auto fmt = backend.make(false);
+        LongUI::CUITextLayoutCache cache(backend, 1024 * 1024 * 64);
+        wchar_t buf[32];
+        std::vector<void*> layouts;
+        for (uint32_t i = 0; i != 1000; ++i) {
+            std::swprintf(buf, 32, L"text %u", i);
+            layouts.push_back(cache.Get(key(buf, fmt)));
+            backend.Release(layouts.back());
+        }
+        bool ok = cache.GetCount() == 1000;
+        for (uint32_t i = 0; ok && i != 1000; ++i) {
+            std::swprintf(buf, 32, L"text %u", i);
+            const auto l = cache.Get(key(buf, fmt));
+            ok = l == layouts[i];
+            backend.Release(l);
+        }
+        check(ok && cache.GetHitCount() == 1000, "rehash keeps entries");
+        cache.SetBudget(cache.GetUsage() / 2);
+        check(cache.GetUsage() <= cache.GetBudget() && backend.alive() == cache.GetCount(), "half budget");
+        // 淘汰的是前一半
+        std::swprintf(buf, 32, L"text %u", 999u);
+        cache.ResetCounters();
+        backend.Release(cache.Get(key(buf, fmt)));
+        std::swprintf(buf, 32, L"text %u", 0u);
+        backend.Release(cache.Get(key(buf, fmt)));
+        check(cache.GetHitCount() == 1 && cache.GetMissCount() == 1, "older half evicted");
+    }
+}
+
+int main() {
+    test_hit_miss();
+    test_lru_budget();
+    test_rehash();
+    std::printf("text_cache_test: %u failed\n", s_fail);
+    return s_fail ? 1 : 0;
+}
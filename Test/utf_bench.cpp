@@ -0,0 +1,71 @@
+// UTF-8/UTF-16 conversion: SIMD ascii fast path vs scalar build
+#include "Platless/luiPlUtf.h"
+#include "utf_scalar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    namespace S = LongUIScalar;
+    // clock
+    using Clock = std::chrono::steady_clock;
+    // sink against dead code elimination
+    volatile uint32_t s_sink = 0;
+    // text: ascii with one non-ascii code point every 'gap' chars
+    std::vector<char16_t> make_text(uint32_t len, uint32_t gap) {
+        std::mt19937 rng(gap);
+        std::vector<char16_t> text(len + 16, 0);
+        for (uint32_t i = 0; i < len; ++i) {
+            text[i] = gap && rng() % gap == 0 ? char16_t(0x4E00 + rng() % 0x5000) : char16_t(' ' + rng() % 95);
+        }
+        return text;
+    }
+    // ns per char16
+    template<typename F> double measure(F&& f, uint32_t len, uint32_t loops) {
+        const auto a = Clock::now();
+        for (uint32_t i = 0; i < loops; ++i) f();
+        const auto b = Clock::now();
+        return std::chrono::duration<double, std::nano>(b - a).count() / (double(len) * loops);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t loops = argc > 1 ? uint32_t(std::atoi(argv[1])) : 2000;
+    const uint32_t len = 1 << 14;
+    std::printf("%-10s %-10s %10s %10s %8s\n", "gap", "op", "scalar", "simd", "speedup");
+    for (const uint32_t gap : { 0u, 256u, 32u, 4u }) {
+        const auto text16 = make_text(len, gap);
+        std::vector<char> text8(len * 3 + 16, 0);
+        std::vector<char16_t> out16(len + 16, 0);
+        const auto end = S::UTF16toUTF8(text16.data(), text8.data(), uint32_t(text8.size()));
+        *end = 0;
+        // 结果必须一致
+        if (LongUI::UTF16toUTF8GetBufLen(text16.data()) != S::UTF16toUTF8GetBufLen(text16.data())
+            || LongUI::UTF8toUTF16GetBufLen(text8.data()) != S::UTF8toUTF16GetBufLen(text8.data())) {
+            std::printf("FAILED: result mismatch\n");
+            return 1;
+        }
+        const auto p16 = text16.data(); const auto p8 = text8.data();
+        const auto bl8 = uint32_t(text8.size()); const auto bl16 = uint32_t(out16.size());
+        const auto d16 = out16.data();
+        std::vector<char> tmp8(text8.size());
+        const auto t8 = tmp8.data();
+        struct Row { const char* name; double scalar, simd; } rows[] = {
+            { "u16->u8", measure([&] { s_sink += uint32_t(S::UTF16toUTF8(p16, t8, bl8) - t8); }, len, loops),
+                measure([&] { s_sink += uint32_t(LongUI::UTF16toUTF8(p16, t8, bl8) - t8); }, len, loops) },
+            { "u8->u16", measure([&] { s_sink += uint32_t(S::UTF8toUTF16(p8, d16, bl16) - d16); }, len, loops),
+                measure([&] { s_sink += uint32_t(LongUI::UTF8toUTF16(p8, d16, bl16) - d16); }, len, loops) },
+            { "u16 len", measure([&] { s_sink += S::UTF16toUTF8GetBufLen(p16); }, len, loops),
+                measure([&] { s_sink += LongUI::UTF16toUTF8GetBufLen(p16); }, len, loops) },
+            { "u8 len", measure([&] { s_sink += S::UTF8toUTF16GetBufLen(p8); }, len, loops),
+                measure([&] { s_sink += LongUI::UTF8toUTF16GetBufLen(p8); }, len, loops) },
+        };
+        for (const auto& row : rows) {
+            std::printf("%-10u %-10s %8.3fns %8.3fns %7.2fx\n",
+                gap, row.name, row.scalar, row.simd, row.scalar / row.simd);
+        }
+    }
+    return 0;
+}
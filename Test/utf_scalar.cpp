@@ -0,0 +1,4 @@
+// scalar build of luiPlUtf.cpp in its own namespace, reference of utf_test/utf_bench
+#define LONGUI_UTF_NO_SIMD
+#define LongUI LongUIScalar
+#include "../src/luiPlUtf.cpp"
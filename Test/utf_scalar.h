@@ -0,0 +1,12 @@
+// scalar build of luiPlUtf.cpp, see utf_scalar.cpp
+#pragma once
+#include <cstdint>
+
+namespace LongUIScalar {
+    auto UTF16toUTF8(const char16_t* src, char* des, uint32_t buflen) noexcept -> char*;
+    auto UTF8toUTF16(const char* src, char16_t* des, uint32_t buflen) noexcept -> char16_t*;
+    auto UTF16toUTF8GetBufLen(const char16_t* src) noexcept -> uint32_t;
+    auto UTF8toUTF16GetBufLen(const char* src) noexcept -> uint32_t;
+    auto UTF8FindInvalid(const char* src) noexcept -> const char*;
+    auto UTF16FindInvalid(const char16_t* src) noexcept -> const char16_t*;
+}
@@ -0,0 +1,145 @@
+// randomized differential test: UTF helpers(SIMD if available) vs scalar build
+#include "Platless/luiPlUtf.h"
+#include "utf_scalar.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    namespace S = LongUIScalar;
+    // random generator
+    std::mt19937 s_rng(20161018);
+    // random in [0, n)
+    uint32_t rnd(uint32_t n) { return uint32_t(s_rng() % n); }
+    // padded buffer: aligned loads may read past the null in same 16 bytes
+    template<typename T> struct Buffer {
+        std::vector<T> data;
+        T* ptr(uint32_t offset, uint32_t len) {
+            data.assign(offset + len + 64, T(0));
+            return data.data() + offset;
+        }
+    };
+    // random utf-8 with long ascii runs, valid/invalid sequences, no null
+    void make_utf8(std::vector<char>& out, uint32_t len) {
+        out.clear();
+        while (out.size() < len) {
+            switch (rnd(8)) {
+            case 0: case 1: case 2: {
+                const auto run = rnd(64) + 1;
+                for (uint32_t i = 0; i < run; ++i) out.push_back(char(rnd(0x7F) + 1));
+                break;
+            }
+            case 3: {
+                // valid code point of 2-4 bytes
+                char16_t buf16[4] = {}; char buf8[8] = {};
+                char32_t ch;
+                do { ch = rnd(0x110000 - 0x80) + 0x80; } while (ch >= 0xD800 && ch <= 0xDFFF);
+                LongUI::Char32toChar16(ch, buf16);
+                const auto end = S::UTF16toUTF8(buf16, buf8, sizeof(buf8));
+                out.insert(out.end(), buf8, end);
+                break;
+            }
+            case 4:
+                // any non-null byte
+                out.push_back(char(rnd(0xFF) + 1));
+                break;
+            case 5:
+                // lead byte then continuation bytes
+                out.push_back(char(0xC0 + rnd(0x40)));
+                for (uint32_t i = rnd(4); i; --i) out.push_back(char(0x80 + rnd(0x40)));
+                break;
+            default:
+                out.push_back(char(0x80 + rnd(0x80)));
+                break;
+            }
+        }
+        out.resize(len);
+    }
+    // random utf-16 with long ascii runs, surrogates paired or not, no null
+    void make_utf16(std::vector<char16_t>& out, uint32_t len) {
+        out.clear();
+        while (out.size() < len) {
+            switch (rnd(6)) {
+            case 0: case 1: case 2: {
+                const auto run = rnd(40) + 1;
+                for (uint32_t i = 0; i < run; ++i) out.push_back(char16_t(rnd(0x7F) + 1));
+                break;
+            }
+            case 3:
+                out.push_back(char16_t(0xD800 + rnd(0x400)));
+                out.push_back(char16_t(0xDC00 + rnd(0x400)));
+                break;
+            case 4:
+                out.push_back(char16_t(0xD800 + rnd(0x800)));
+                break;
+            default:
+                out.push_back(char16_t(rnd(0xFFFF) + 1));
+                break;
+            }
+        }
+        out.resize(len);
+    }
+    // count of failure
+    uint32_t s_fail = 0;
+    // check
+    void check(bool ok, const char* what, uint32_t round) {
+        if (ok) return;
+        if (++s_fail < 16) std::printf("FAILED: %s @ round %u\n", what, round);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const uint32_t rounds = argc > 1 ? uint32_t(std::atoi(argv[1])) : 20000;
+    std::vector<char> text8; std::vector<char16_t> text16;
+    Buffer<char> src8, des8a, des8b;
+    Buffer<char16_t> src16, des16a, des16b;
+    for (uint32_t r = 0; r < rounds; ++r) {
+        const auto len = rnd(r & 1 ? 300 : 40);
+        // utf-8 -> utf-16, unaligned source
+        {
+            make_utf8(text8, len);
+            const auto src = src8.ptr(rnd(16), len);
+            std::memcpy(src, text8.data(), len);
+            const auto buflen = LongUI::UTF8toUTF16GetBufLen(src);
+            check(buflen == S::UTF8toUTF16GetBufLen(src), "UTF8toUTF16GetBufLen", r);
+            const auto a = des16a.ptr(rnd(8), buflen);
+            const auto b = des16b.ptr(0, buflen);
+            const auto ea = LongUI::UTF8toUTF16(src, a, buflen);
+            const auto eb = S::UTF8toUTF16(src, b, buflen);
+            check(ea - a == eb - b && uint32_t(ea - a) + 1 == buflen, "UTF8toUTF16 length", r);
+            check(!std::memcmp(a, b, (eb - b) * sizeof(char16_t)), "UTF8toUTF16 content", r);
+            const auto ia = LongUI::UTF8FindInvalid(src);
+            const auto ib = S::UTF8FindInvalid(src);
+            check(ia == ib, "UTF8FindInvalid", r);
+        }
+        // utf-16 -> utf-8, unaligned source
+        {
+            make_utf16(text16, len);
+            const auto src = src16.ptr(rnd(8), len);
+            std::memcpy(src, text16.data(), len * sizeof(char16_t));
+            const auto buflen = LongUI::UTF16toUTF8GetBufLen(src);
+            check(buflen == S::UTF16toUTF8GetBufLen(src), "UTF16toUTF8GetBufLen", r);
+            const auto a = des8a.ptr(rnd(16), buflen);
+            const auto b = des8b.ptr(0, buflen);
+            const auto ea = LongUI::UTF16toUTF8(src, a, buflen);
+            const auto eb = S::UTF16toUTF8(src, b, buflen);
+            check(ea - a == eb - b && uint32_t(ea - a) + 1 == buflen, "UTF16toUTF8 length", r);
+            check(!std::memcmp(a, b, eb - b), "UTF16toUTF8 content", r);
+            const auto ia = LongUI::UTF16FindInvalid(src);
+            const auto ib = S::UTF16FindInvalid(src);
+            check(ia == ib, "UTF16FindInvalid", r);
+            // 合法串往返不变
+            if (!ia) {
+                *ea = 0;
+                const auto back = des16a.ptr(0, len + 1);
+                const auto end = LongUI::UTF8toUTF16(a, back, LongUI::UTF8toUTF16GetBufLen(a));
+                check(uint32_t(end - back) == len && !std::memcmp(back, src, len * sizeof(char16_t)),
+                    "round trip", r);
+            }
+        }
+    }
+    std::printf("utf_test: %u rounds, %u failed\n", rounds, s_fail);
+    return s_fail ? 1 : 0;
+}
@@ -29,6 +29,8 @@
 #include "../Graphics/luiGrDwrt.h"
 #include "../Core/luiString.h"
 #include "../Platless/luiPlEzC.h"
+#include "../Platless/luiPlText.h"
+#include "../Core/luiInterface.h"
 #include "../LongUI/luiUiTxtRdr.h"
 #include "../Core/luiMenu.h"
 #include <cstdint>
@@ -41,6 +43,21 @@ namespace LongUI { namespace Component {
         using HitTestMetrics = DWRITE_HIT_TEST_METRICS;
         // 缓冲区
         using MetricsBuffer = EzContainer::SmallBuffer<HitTestMetrics, 8>;
+    public:
+        // format call, with layout of paragraph and range in the paragraph
+        using FormatCall = CUIFunction<void(IDWriteTextLayout*, DWRITE_TEXT_RANGE)>;
+    private:
+        // range format, kept across relayout
+        struct FormatSpan : CUISingleSmallObject {
+            // ctor
+            FormatSpan(FormatCall&& c, uint32_t s, uint32_t l) noexcept : call(std::move(c)), start(s), length(l) {}
+            // format call
+            FormatCall      call;
+            // start position in text
+            uint32_t        start;
+            // length of range
+            uint32_t        length;
+        };
     public:
         // the mode of text selection zone 选择区模式
         enum SelectionMode : uint32_t {
@@ -96,6 +113,21 @@ namespace LongUI { namespace Component {
         // set attribute to false
         template<EditaleTextType T>
         inline auto SetAttributeFalse() noexcept { this->type = EditaleTextType(uint32_t(this->type) & (~uint32_t(T))); };
+        // undo/redo command of editable text
+        class Command final : public IUICommand {
+        public:
+            // ctor
+            Command(EditableText* text) noexcept : m_pText(text) {}
+            // basic interface
+            LONGUI_BASIC_INTERFACE_IMPL;
+            // undo
+            void Undo() noexcept override { m_pText->Undo(); }
+            // redo
+            void Redo() noexcept override { m_pText->Redo(); }
+        private:
+            // text
+            EditableText*       m_pText;
+        };
     public:
         // copy the global properties for layout
         static void CopyGlobalProperties(IDWriteTextLayout*, IDWriteTextLayout*) noexcept;
@@ -112,30 +144,57 @@ namespace LongUI { namespace Component {
         auto GetHitTestMetrics() noexcept { return m_bufMetrice.GetData(); }
         // get hittest's length 
         auto GetHitTestLength() noexcept { return m_bufMetrice.GetCount(); }
-        // c-style string
-        auto c_str() const noexcept { return m_string.c_str(); }
+        // c-style string, snapshot of text buffer, valid until next edit
+        auto c_str() const noexcept -> const wchar_t*;
+        // length of text
+        auto GetLength() const noexcept { return m_buffer.GetLength(); }
         // Resizes the layout, use this after resize
         void Resize(float w, float h) noexcept;
-        /// <summary>
-        /// Recreates the layout. use this after change text
-        /// </summary>
-        /// <returns></returns>
-        void RecreateLayout() noexcept { this->recreate_layout(); }
-        // get string
-        auto&GetString() noexcept { return m_string; }
+        // get text buffer
+        auto&GetTextBuffer() const noexcept { return m_buffer; }
+        // get paragraph layouts, layout is IDWriteTextLayout
+        auto&GetParagraphs() const noexcept { return m_layouts; }
+        // undo last edit
+        bool Undo() noexcept;
+        // redo last undone edit
+        bool Redo() noexcept;
+        // get undo/redo command
+        auto GetCommand() noexcept -> IUICommand* { return &m_command; }
+        // get undo history
+        auto&GetHistory() noexcept { return m_history; }
+        // format text range, kept across relayout and applied in order
+        auto FormatRange(DWRITE_TEXT_RANGE range, FormatCall&& call) noexcept ->HRESULT;
+        // clear all range formats, relayout if any
+        void ClearFormats() noexcept;
     private:
-        // delete selection and recreate layout
+        // delete selection and relayout
         void delete_selandrelay() noexcept;
-        // copy prop on remove
-        auto copy_remove(IDWriteTextLayout*, DWRITE_TEXT_RANGE r) noexcept;
         // refresh, while layout chenged, should be refreshed
         void refresh(bool = true) const noexcept ;
-        // recreate layout
-        void recreate_layout(IDWriteTextFormat* fmt) noexcept;
-        // recreate layout without format
-        void recreate_layout() noexcept;
+        // relayout dirty paragraphs
+        void relayout() noexcept;
+        // reset whole text
+        void reset_text(const wchar_t* str, uint32_t len) noexcept;
+        // update paragraph alignment offset
+        void update_align() noexcept;
         // insert text
         auto insert(uint32_t pos, const wchar_t* str, /*in out*/uint32_t& length) noexcept ->HRESULT;
+        // insert text into buffer, record history and relayout
+        auto insert_text(uint32_t pos, const wchar_t* str, uint32_t len) noexcept ->HRESULT;
+        // remove text
+        bool remove_text(uint32_t off, uint32_t len) noexcept;
+        // move range formats after text inserted or removed
+        void move_formats(uint32_t pos, uint32_t len, bool removed) noexcept;
+        // apply range formats to new layout of paragraph
+        void apply_formats(IDWriteTextLayout* layout, uint32_t pos, uint32_t len) const noexcept;
+        // delete all range formats
+        void free_formats() noexcept;
+        // get text range of paragraph, line feed not included
+        auto paragraph_range(uint32_t i) const noexcept ->DWRITE_TEXT_RANGE;
+        // hit test text position, metrics in text coordinates
+        void hit_test_position(uint32_t pos, bool trailing, float& x, float& y, HitTestMetrics& htm) const noexcept;
+        // hit test point in text coordinates
+        void hit_test_point(float x, float y, BOOL& trailing, BOOL& inside, HitTestMetrics& htm) const noexcept;
     public: // 一般内部设置区
         // get selection range
         auto GetSelectionRange()const noexcept ->DWRITE_TEXT_RANGE;
@@ -215,11 +274,6 @@ namespace LongUI { namespace Component {
     private:
         // ensure string
         void ensure_string(CUIString& str) noexcept;
-        // remove text
-        auto remove_text(uint32_t off, uint32_t len) noexcept {
-            this->IsReadOnly() ? LongUI::BeepError() : m_string.Remove(off, len);
-            return !this->IsReadOnly();
-        }
     public:
         // set color
         void SetState(ControlState state) noexcept { m_pColor = this->color + state; };
@@ -231,13 +285,6 @@ namespace LongUI { namespace Component {
         void Init(pugi::xml_node node, const char* prefix = "text") noexcept;
         // initizlize without xml-node
         void Init() noexcept;
-        // get layout
-        auto RefLayout() const noexcept { return m_pLayout; }
-        // get layout
-        auto GetLayout() const noexcept { return LongUI::SafeAcquire(m_pLayout); }
-    private:
-        // type of text
-        IDWriteTextLayout*      m_pLayout = nullptr;
     public:
         // text render offset
         D2D1_POINT_2F           offset = D2D1_POINT_2F{0.f};
@@ -298,10 +345,24 @@ namespace LongUI { namespace Component {
         uint32_t                m_u32CaretPos = 0;
         // the pos offset of caret 光标偏移 -- 选择区大小
         uint32_t                m_u32CaretPosOffset = 0;
-        // unused
-        uint32_t                m_unused_u32;
-        // string of text
-        CUIString               m_string;
+        // offset of paragraph alignment
+        float                   m_fAlignY = 0.f;
+        // paragraph layouter
+        DX::CUIParagraphLayouter m_layouter;
+        // text buffer
+        CUITextBuffer           m_buffer;
+        // paragraph layouts, after layouter
+        CUIParagraphLayouts     m_layouts{ m_layouter };
+        // snapshot of text for c_str
+        mutable EzContainer::EzVector<wchar_t> m_bufText;
+        // snapshot out of date
+        mutable bool            m_bTextStale = true;
+        // range formats, in applied order
+        EzContainer::EzVector<FormatSpan*> m_formats;
+        // undo history
+        CUITextHistory          m_history{ LongUIEditUndoMemoryLimit };
+        // undo/redo command
+        Command                 m_command{ this };
     public:
         // basic color
         D2D1_COLOR_F            color[STATE_COUNT];
@@ -59,7 +59,7 @@ namespace LongUI { namespace Component {
         const auto&GetString() const noexcept { return m_text; }
         // c_str for stl-like
         auto c_str() const noexcept { return m_text.c_str(); }
-        // get layout
+        // get layout, maybe shared via layout cache, do not modify it
         auto GetLayout() const noexcept { return LongUI::SafeAcquire(m_pLayout); }
         // set new progress
         void SetNewProgress(float p) noexcept { m_config.progress = p; this->RecreateLayout(); }
@@ -90,5 +90,11 @@ namespace LongUI { namespace Component {
         DX::FormatTextConfig        m_config;
         // the string of text
         CUIString                   m_text;
+        // layout from cache of manager, shared
+        bool                        m_bCachedLayout = false;
+        // size set by Resize at least once
+        bool                        m_bSized = false;
+        // size changed after first Resize, use private layout
+        bool                        m_bPrivateLayout = false;
     };
 }}
\ No newline at end of file
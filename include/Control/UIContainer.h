@@ -25,6 +25,7 @@
 */
 
 #include "UIMarginalable.h"
+#include "../LongUI/luiUiProfiler.h"
 
 // LongUI namespace
 namespace LongUI {
@@ -246,8 +247,8 @@ namespace LongUI {
             // refresh children
             for (auto itr = itrbegin; itr != itrend; ++itr) {
                 auto ctrl = (*itr);
-                // set change
-                ctrl->SetControlWorldChanged();
+                // set change, no need to mark ancestors
+                ctrl->SetControlWorldChangedByParent();
                 ctrl->RefreshWorld();
                 // world change visible-rect
                 D2D1_RECT_F clip_rect; ctrl->GetClipRect(clip_rect);
@@ -261,15 +262,27 @@ namespace LongUI {
             // handed it
             this->ControlLayoutChangeHandled();
         }
-        // update marginal control
+        // update marginal control, always with this
         for (auto itr = this->MCBegin(); itr != MCEnd(); ++itr) {
             auto ctrl = (*itr);
+            LongUIProfileScopeTag(Update, ctrl->name.c_str());
+            ctrl->NeedUpdateHandled();
             ctrl->Update();
             ctrl->AfterUpdate();
         }
-        // update children
+        // update children, skip clean or culled subtree
         for (auto itr = itrbegin; itr != itrend; ++itr) {
             auto ctrl = (*itr);
+            // culled one keeps its mark, updated when visible again
+            if (!ctrl->IsNeedUpdate() || ctrl->IsUpdateCulled()) {
+#ifdef _DEBUG
+                ctrl->debug_skip_update();
+#endif
+                continue;
+            }
+            LongUIProfileScopeTag(Update, ctrl->name.c_str());
+            // clear before update, changed while updating will be kept for next frame
+            ctrl->NeedUpdateHandled();
             ctrl->Update();
             ctrl->AfterUpdate();
         }
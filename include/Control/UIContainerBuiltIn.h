@@ -25,6 +25,7 @@
 */
 
 #include "UIContainer.h"
+#include "../Platless/luiPlGrid.h"
 
 // LongUI namespace
 namespace LongUI {
@@ -123,6 +124,9 @@ namespace LongUI {
         void render_chain_main() const noexcept;
         // render chain -> foreground
         void render_chain_foreground() const noexcept { return Super::render_chain_foreground(); }
+    private:
+        // rebuild hit-test grid
+        bool rebuild_hittest_grid() noexcept;
     public: // for C++ 11
         // begin 
         auto begin() const noexcept { return Iterator(m_pHead); };
@@ -140,6 +144,11 @@ namespace LongUI {
         UIControl*              m_pHead = nullptr;
         // tail of list
         UIControl*              m_pTail = nullptr;
+    private:
+        // hit-test grid, buffers are reused while rebuilding
+        CUIHitTestGrid          m_hitGrid;
+        // hit-test grid: need rebuild
+        bool                    m_bGridDirty = true;
 #ifdef LongUIDebugEvent
     protected:
         // debug infomation
@@ -47,9 +47,9 @@ namespace LongUI {
         const char* name;
     };}
     // base control class -- 基本控件类
-    class UIControl : public CUISingleNormalObject {
+    class UIControl : public CUISinglePoolObject {
         // Super class
-        using Super = void;// CUISingleNormalObject;
+        using Super = void;// CUISinglePoolObject;
         /// <summary>
         /// Cleanups this instance.
         /// </summary>
@@ -157,6 +157,10 @@ namespace LongUI {
         ~UIControl() noexcept;
         // after update
         void AfterUpdate() noexcept;
+#ifdef _DEBUG
+        // skip update for clean subtree
+        void debug_skip_update() noexcept;
+#endif
         // delete the copy-ctor
         UIControl(const UIControl&) = delete;
         // new parent setted
@@ -212,12 +216,26 @@ namespace LongUI {
         auto GetNonContentWidth() const noexcept ->float;
         // get taking up height of control
         auto GetNonContentHeight() const noexcept ->float;
+        // mark self and ancestors need update in next frame
+        void SetNeedUpdate() noexcept;
+        // need update handled, call it before Update()
+        auto NeedUpdateHandled() noexcept { m_bNeedUpdate = false; }
+        // is need update? self or posterity changed
+        auto IsNeedUpdate() const noexcept { return m_bNeedUpdate; }
+        // is update culled? invisible with Flag_SkipUpdateInvisible
+        auto IsUpdateCulled() const noexcept {
+            return (this->flags & Flag_SkipUpdateInvisible) && (!this->GetVisible() ||
+                this->visible_rect.right <= this->visible_rect.left ||
+                this->visible_rect.bottom <= this->visible_rect.top);
+        }
         // change control layout
-        auto SetControlLayoutChanged() noexcept { m_state.SetTrue<State_ChangeLayout>(); }
+        auto SetControlLayoutChanged() noexcept { m_state.SetTrue<State_ChangeLayout>(); this->SetNeedUpdate(); }
         // handleupdate_marginal_controls control draw size changed
         auto ControlLayoutChangeHandled() noexcept { m_state.SetTrue<State_ChangeSizeHandled>(); }
         // change control world
-        auto SetControlWorldChanged() noexcept { m_state.SetTrue<State_ChangeWorld>(); }
+        auto SetControlWorldChanged() noexcept { m_state.SetTrue<State_ChangeWorld>(); this->SetNeedUpdate(); }
+        // change control world by parent in updating, ancestors are being updated already
+        auto SetControlWorldChangedByParent() noexcept { m_state.SetTrue<State_ChangeWorld>(); m_bNeedUpdate = true; }
         // handle control world changed
         auto ControlWorldChangeHandled() noexcept { m_state.SetTrue<State_ChangeWorldHandled>(); }
         // is control draw size changed?
@@ -352,6 +370,8 @@ namespace LongUI {
         Helper::BitArray16      m_state;
         // reference count. to avoid "Circular references", upper-level-control managed it
         uint8_t                 m_u8RefCount = 1;
+        // need update, self or posterity changed
+        bool                    m_bNeedUpdate = true;
     public:
         // Release
         void Release() noexcept;
@@ -363,7 +383,7 @@ namespace LongUI {
         void AddRef() noexcept { ++m_u8RefCount; }
 #endif
         // set visible
-        void SetVisible(bool visible) noexcept { m_state.SetTo<State_Visible>(visible); }
+        void SetVisible(bool visible) noexcept { m_state.SetTo<State_Visible>(visible); this->SetNeedUpdate(); }
         // get visible
         auto GetVisible() const noexcept { return m_state.Test<State_Visible>(); }
         // get visible
@@ -25,6 +25,7 @@
 */
 
 #include "UILinearLayout.h"
+#include "../Core/luiInterface.h"
 #include "../LongUI/luiUiHlper.h"
 #include "../Platless/luiPlEzC.h"
 #include "../Platonly/luiPoHlper.h"
@@ -132,6 +133,14 @@ namespace LongUI {
         virtual bool debug_do_event(const LongUI::DebugEventInformation&) const noexcept override;
 #endif
     };
+    // data source for virtualized UIList
+    class LONGUI_NOVTABLE IUIListDataSource : public IUIInterface {
+    public:
+        // get count of lines
+        virtual auto GetLineCount() noexcept ->uint32_t = 0;
+        // bind data at index to the line, line will be recycled while scrolling
+        virtual void BindLine(UIListLine* line, uint32_t index) noexcept = 0;
+    };
     // ui list, child must be UIListLine
     class UIList : public UIContainer {
         // super class
@@ -140,6 +149,12 @@ namespace LongUI {
         using LinesVector = EzContainer::PointerVector<UIListLine>;
         // line template vector
         using LineTemplateVector = EzContainer::EzVector<Helper::Cce>;
+    public:
+        // selected range, [first, last]
+        struct SelectedRange { uint32_t first; uint32_t last; };
+        // selected range vector, sorted and disjoint
+        using RangeVector = EzContainer::EzVector<SelectedRange>;
+    private:
         // clean this control 清除控件
         virtual void cleanup() noexcept override;
     public:
@@ -217,14 +232,18 @@ namespace LongUI {
     public:
         // get conttrols
         const auto&GetContainer() const noexcept { return m_vLines; }
-        // get selected lines index
-        const auto&GetSelectedIndices() const noexcept { return m_vSelectedIndex; }
+        // get selected lines as sorted and disjoint ranges
+        const auto&GetSelectedRanges() const noexcept { return m_vSelectedRange; }
+        // get count of selected lines
+        auto GetSelectedCount() const noexcept ->uint32_t;
+        // is line at index selected?
+        bool IsSelected(uint32_t index) const noexcept;
         // get height in line
         auto GetLineHeight() const noexcept { return m_fLineHeight; }
         // get last clicked line index
         auto GetLastClickedLineIndex() const noexcept { return m_ixLastClickedLine; }
-        // get last clicked line
-        auto GetLastClickedLine() const noexcept ->UIListLine* { return m_ixLastClickedLine < m_cChildrenCount ? m_vLines[m_ixLastClickedLine] : nullptr; }
+        // get last clicked line, null if not bound in virtualized mode
+        auto GetLastClickedLine() const noexcept ->UIListLine* { return this->get_bound_line(m_ixLastClickedLine); }
         // get ToBeSortedHeaderChild, used during (AddBeforSortCallBack)
         auto GetToBeSortedHeaderChild() const noexcept { return m_pToBeSortedHeaderChild; }
         // set header
@@ -237,9 +256,38 @@ namespace LongUI {
         void SelectTo(uint32_t index1, uint32_t index2) noexcept;
         // set all lines content width to 0
         void ZeroAllLinesContentWidth() noexcept;
+    public:
+        // set data source to enter virtualized mode, null to leave
+        void SetDataSource(IUIListDataSource* source) noexcept;
+        // get data source
+        auto GetDataSource() const noexcept { return m_pDataSource; }
+        // is virtualized mode?
+        auto IsVirtualized() const noexcept { return !!m_pDataSource; }
+        // notify data changed, re-query line count and re-bind lines
+        void NotifyDataChanged() noexcept;
+        // get line count, line count of data source in virtualized mode
+        auto GetLineCount() const noexcept { return m_pDataSource ? m_cVirtualLines : m_cChildrenCount; }
     private:
+        // create line with line-template
+        auto create_template_line() noexcept ->UIListLine*;
+        // insert line only
+        void insert_line(uint32_t index, UIListLine* line) noexcept;
+        // get line bound to index, null if not bound
+        auto get_bound_line(uint32_t index) const noexcept ->UIListLine*;
+        // prepare recycled line pool for virtualized mode
+        void prepare_line_pool() noexcept;
+        // bind lines in pool to data source
+        void bind_virtual_lines(bool force) noexcept;
         // reset select
         void reset_select() noexcept;
+        // find first selected range not before index
+        auto find_range(uint32_t index) const noexcept ->uint32_t;
+        // add [index1, index2] to selected ranges
+        void add_select_range(uint32_t index1, uint32_t index2) noexcept;
+        // remove index from selected ranges
+        void remove_select(uint32_t index) noexcept;
+        // set selected state of bound lines in [index1, index2]
+        void set_bound_selected(uint32_t index1, uint32_t index2, bool selected) noexcept;
         // select child
         void select_child(uint32_t index, bool new_select) noexcept;
         // select child
@@ -313,6 +361,12 @@ namespace LongUI {
         UICallBack              m_callLineDBClicked;
         // hovered line
         UIListLine*             m_pHoveredLine = nullptr;
+        // data source for virtualized mode
+        IUIListDataSource*      m_pDataSource = nullptr;
+        // line count of data source
+        uint32_t                m_cVirtualLines = 0;
+        // data index of first line in pool
+        uint32_t                m_ixFirstBound = 0;
         // last clicked line index
         uint32_t                m_ixLastClickedLine = uint32_t(-1);
         // line height
@@ -321,8 +375,8 @@ namespace LongUI {
         LineTemplateVector      m_vLineTemplate;
         // list lines vector
         LinesVector             m_vLines;
-        // selected line index vector
-        IndexVector             m_vSelectedIndex;
+        // selected line ranges
+        RangeVector             m_vSelectedRange;
 #ifdef LongUIDebugEvent
     protected:
         // debug infomation
@@ -123,6 +123,8 @@ namespace LongUI {
             Flag_RenderInAnytime = 1 << 2,
             // only one system window, like game(all child window will be logic window)
             Flag_OnlyOneSystemWindow = 1 << 3,
+            // [need Flag_RenderByCPU] system window will be headless, render into memory surface
+            Flag_RenderHeadless = 1 << 4,
             // -------------------------------------------------------------
             // [debug flag in _DEBUG] output font family infomation
             Flag_DbgOutputFontFamily = 1 << 10,
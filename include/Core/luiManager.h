@@ -38,6 +38,7 @@
 #include <d3d11.h>
 #include <dxgi1_2.h>
 #include <LongUI/luiUiTmCap.h>
+#include <LongUI/luiUiProfiler.h>
 
 struct IDropTargetHelper;
 
@@ -53,8 +54,6 @@ namespace LongUI {
     extern EndL const endl;
     // ui manager UI管理器
     class CUIManager {
-        // time capsules
-        using TimeCapsules = EzContainer::PointerVector<CUITimeCapsule>;
         // time capsule call
         using TimeCapsuleCall = CUITimeCapsule::TimeCallBack;
         // friend class
@@ -103,8 +102,14 @@ namespace LongUI {
         LongUIAPI void GetMeta(size_t index, LongUI::Meta&) noexcept;
         // get meta's icon handle by index, Meta HICON managed by this manager
         LongUIAPI auto GetMetaHICON(size_t index) noexcept ->HICON;
+        // load resources before first using, load all resources with this type if index is null
+        LongUIAPI void PrefetchResources(IUIResourceLoader::ResourceType type, const size_t index[] = nullptr, size_t count = 0) noexcept;
         // get create function via control-class name
         LongUIAPI auto GetCreateFunc(const char* clname) noexcept ->CreateControlEvent;
+        // get create function via interned control-class name, null if not found
+        auto GetCreateFunc(CUIAtom clname) const noexcept ->CreateControlEvent {
+            const auto result = m_hashAtom2CreateFunc.Find(clname); return result ? *result : nullptr;
+        }
         // create control with template id, template and function cannot be null in same time
         LongUIAPI auto CreateControl(UIContainer* cp, size_t templateid, CreateControlEvent function) noexcept ->UIControl*;
         // create text format
@@ -136,15 +141,39 @@ namespace LongUI {
             auto create_func = UIViewport::CreateFunc<T>;
             return this->create_ui_window(node, nullptr, create_func);
         }
-        // add time capsule
+        // create ui window with compiled layout(see LongUI::Layout), must include UIViewport.h first
+        auto CreateUIWindow(const void* layout, size_t length) noexcept {
+            return this->CreateUIWindow<LongUI::UIViewport>(layout, length);
+        }
+        // create ui window with compiled layout(see LongUI::Layout), must include UIViewport.h first
+        template<class T> auto CreateUIWindow(const void* layout, size_t length) noexcept ->XUIBaseWindow* {
+            auto create_func = UIViewport::CreateFunc<T>;
+            return this->create_ui_window(layout, length, create_func);
+        }
+        // add time capsule, replace the old one with same id
         template<typename T> void AddTimeCapsule(T call, void* id, float time) noexcept {
-            this->push_time_capsule(std::move(TimeCapsuleCall(call)), id, time);
+            this->push_time_capsule(std::move(TimeCapsuleCall(call)), id, time, 0.f, 0.f);
         }
-        // add time capsule
+        // add time capsule starting after delay(in sec), replace the old one with same id
+        template<typename T> void AddTimeCapsule(T call, void* id, float time, float delay) noexcept {
+            this->push_time_capsule(std::move(TimeCapsuleCall(call)), id, time, delay, 0.f);
+        }
+        // add periodic capsule, called once per period(in sec) until returns true
+        template<typename T> void AddPeriodicCapsule(T call, void* id, float period, float delay = 0.f) noexcept {
+            assert(period > 0.f && "bad period");
+            this->push_time_capsule(std::move(TimeCapsuleCall(call)), id, 0.f, delay, period);
+        }
+        // remove time capsule
         void RemoveTimeCapsule(void* id) noexcept { this->remove_time_capsule(id);  }
     private:
         // exit
-        inline void exit() noexcept { m_exitFlag = true; ::PostQuitMessage(0); }
+        inline void exit() noexcept {
+            m_exitFlag = true;
+            // 渲染线程调用(如无头窗口)时, 退出消息发给消息线程, 只投递一次
+            const auto id = m_idMsgThread;
+            if (id && id != ::GetCurrentThreadId()) ::PostThreadMessageW(id, WM_QUIT, 0, 0);
+            else ::PostQuitMessage(0);
+        }
     public:
         // custom text rich format
         auto CustomRichType(const DX::FormatTextConfig& c, const wchar_t* f) noexcept {
@@ -185,11 +214,11 @@ namespace LongUI {
         // get display frequency
         auto GetDisplayFrequency() const noexcept { return m_dDisplayFrequency; };
         // lock data
-        auto DataLock() noexcept { return m_uiDataLocker.Lock(); }
+        auto DataLock() noexcept { LongUIProfileScope(DataLock); return m_uiDataLocker.Lock(); }
         // unlock data
         auto DataUnlock() noexcept { return m_uiDataLocker.Unlock(); }
         // lock dxgi
-        auto DxgiLock() noexcept { return m_uiDxgiLocker.Lock(); }
+        auto DxgiLock() noexcept { LongUIProfileScope(DxgiLock); return m_uiDxgiLocker.Lock(); }
         // unlock dxgi
         auto DxgiUnlock() noexcept { return m_uiDxgiLocker.Unlock(); }
         // push delay cleanup
@@ -200,6 +229,10 @@ namespace LongUI {
         auto ShowError(const wchar_t * str, const wchar_t* str_b = nullptr) noexcept { this->configure->ShowError(str, str_b); }
         // GetXXX method will call AddRef if it is a COM object
         auto GetTextRenderer(int i) const noexcept { assert(i < m_uTextRenderCount && "out of range"); return LongUI::SafeAcquire(m_apTextRenderer[i]); }
+        // get text layout via cache, shared by same key, do not modify it. call AddRef, lock dxgi before calling
+        auto GetTextLayout(const TextLayoutKey& key) noexcept { return static_cast<IDWriteTextLayout*>(m_oLayoutCache.Get(key)); }
+        // get text layout cache, for budget and hit/miss counters
+        auto GetTextLayoutCache() noexcept -> CUITextLayoutCache& { return m_oLayoutCache; }
 #ifdef _DEBUG
         // exit the app
         void Exit() noexcept;
@@ -326,10 +359,14 @@ namespace LongUI {
         IUIResourceLoader*              m_pResourceLoader = nullptr;
         // default bitmap buffer
         uint8_t*                        m_pBitmap0Buffer = nullptr;
-        // map: string<->func
-        StringTable                     m_hashStr2CreateFunc;
-        // TimeCapsule vetor
-        TimeCapsules                    m_vTimeCapsules;
+        // map: class name atom<->func
+        EzContainer::EzAtomMap<CreateControlEvent> m_hashAtom2CreateFunc;
+        // time wheel for time capsules
+        CUITimeWheel                    m_oTimeWheel;
+        // text layout backend
+        DX::CUITextLayoutBackend        m_oLayoutBackend;
+        // text layout cache
+        CUITextLayoutCache              m_oLayoutCache{ m_oLayoutBackend, LongUITextLayoutCacheBudget };
         // delay cleanup vector
         ControlVector                   m_vDelayCleanup;
         // delay dispose vector
@@ -368,6 +405,8 @@ namespace LongUI {
         HICON*                          m_phMetaIcon = nullptr;
         // template node
         pugi::xml_node*                 m_pTemplateNodes = nullptr;
+        // last used tick of bitmap, ~0 for pinned(never evicted)
+        uint32_t*                       m_pBitmapTick = nullptr;
         // resource buffer for all
         void*                           m_pResourceBuffer = nullptr;
         // length of bitmap*
@@ -392,6 +431,8 @@ namespace LongUI {
         uint32_t                        m_dwWaitVSCount = 0;
         // vsync start time
         uint32_t                        m_dwWaitVSStartTime = 0;
+        // id of message thread, valid while running
+        uint32_t                        m_idMsgThread = 0;
         // textrender: normal
         CUINormalTextRender             m_normalTRenderer;
         // textrender: outline
@@ -414,19 +455,31 @@ namespace LongUI {
         // delte this method 删除移动构造函数
         CUIManager(CUIManager&&) = delete;
     private:
+        // compiled layout tree
+        struct layout_tree;
         // create ui window
         LongUIAPI auto create_ui_window(
             pugi::xml_node node, 
             XUIBaseWindow* parent,
+            callback_create_viewport call,
+            const layout_tree* tree = nullptr) noexcept ->XUIBaseWindow*;
+        // create ui window with compiled layout
+        LongUIAPI auto create_ui_window(
+            const void* layout,
+            size_t length,
             callback_create_viewport call) noexcept ->XUIBaseWindow*;
+        // make control tree with compiled layout
+        void make_control_tree(UIContainer* root, const layout_tree& tree) noexcept;
         // push time capsules
-        LongUIAPI void push_time_capsule(TimeCapsuleCall&& call, void* id, float time) noexcept;
+        LongUIAPI void push_time_capsule(TimeCapsuleCall&& call, void* id, float time, float delay, float period) noexcept;
         // create the control with xml-node
         LongUIAPI auto create_control(UIContainer* cp, CreateControlEvent function, pugi::xml_node node, size_t id) noexcept ->UIControl*;
         // create all resources
         auto create_device_resources() noexcept ->HRESULT;
         // discard resources
         void discard_resources() noexcept;
+        // evict bitmaps unused for a long time
+        void evict_bitmaps() noexcept;
         // cleanup delay-cleanup-chain
         void cleanup_delay_cleanup_chain() noexcept;
         // load the template string
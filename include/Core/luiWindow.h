@@ -28,8 +28,11 @@
 #include "../Platless/luiPlEzC.h"
 #include "../Platonly/luiPoHlper.h"
 #include "../Platless/luiPlHlper.h"
+#include "../Platless/luiPlPool.h"
+#include "../Platless/luiPlAtom.h"
 
 #include <cstdint>
+#include <cfloat>
 #include <../3rdParty/pugixml/pugixml.hpp>
 #include <Control/UIViewport.h>
 //#include <Core/luiManager.h>
@@ -131,6 +134,8 @@ namespace LongUI {
             //Index_DoCaret,
             // [RW] do full-render this frame in render?
             Index_FullRenderThisFrameRender,
+            // [RO] headless window, render into memory surface
+            Index_Headless,
             // [XX] count of this
             INDEX_COUNT,
         };
@@ -171,6 +176,8 @@ namespace LongUI {
         auto GetParent() const noexcept { return m_pParent; }
         // is popup window?
         bool IsPopup() const noexcept { return this->is_popup_window(); }
+        // is headless window?
+        bool IsHeadless() const noexcept { return m_baBoolWindow.Test<Index_Headless>(); }
         // hide caret
         void HideCaret(UIControl* ctrl) noexcept { this->SetCaret(ctrl, nullptr); }
         // hide window
@@ -191,6 +198,10 @@ namespace LongUI {
         auto GetHeight() const noexcept { return m_rcWindow.height; }
         // get viewport
         auto GetViewport() const noexcept { return m_pViewport; }
+        // get pool for controls in this window, could be null if OOM
+        auto GetControlPool() const noexcept { return m_pControlPool; }
+        // get culling rect in render, in window space
+        auto&GetCullRectRender() const noexcept { return m_rcCullRender; }
         // get text anti-mode 
         auto GetTextAntimode() const noexcept { return static_cast<D2D1_TEXT_ANTIALIAS_MODE>(m_textAntiMode); }
         // get text anti-mode 
@@ -208,6 +219,8 @@ namespace LongUI {
         void RemoveTabstop(UIControl* ctrl) noexcept;
         // find control
         auto FindControl(const char* name) noexcept ->UIControl*;
+        // find control with interned name
+        auto FindControl(CUIAtom name) const noexcept ->UIControl*;
         // find next tabstop control
         auto FindNextTabstop(UIControl* ctrl) const noexcept->UIControl*;
         // find prev tabstop control
@@ -261,6 +274,8 @@ namespace LongUI {
         void set_hidpi_supported() noexcept { m_baBoolWindow.SetTrue<Index_HiDpiSupported>(); }
         // set CloseOnFocusKilled to true
         void set_close_on_focus_killed() noexcept { m_baBoolWindow.SetTrue<Index_CloseOnFocusKilled>(); }
+        // set Headless to true
+        void set_headless() noexcept { m_baBoolWindow.SetTrue<Index_Headless>(); }
     protected:
         // set NewSize to true
         void set_new_size() noexcept { m_baBoolWindow.SetTrue<Index_NewSize>(); }
@@ -285,8 +300,23 @@ namespace LongUI {
         // clear FullRenderingThisFrame
         void clear_full_render_this_frame() noexcept { m_baBoolWindow.SetFalse<Index_FullRenderThisFrame>();  }
     protected:
+        // render unit, snapshot of merged dirty region made in update
+        struct RenderUnit {
+            // control to render, common prerender of dirty controls in region
+            const UIControl*    control;
+            // world matrix of control
+            D2D1_MATRIX_3X2_F   world;
+            // region to render, union of visible rects of dirty controls
+            D2D1_RECT_F         visible_rect;
+        };
         // resized, called from child-class
         void resized() noexcept;
+        // merge dirty controls into render units, called in update
+        void make_render_units() noexcept;
+        // render viewport or dirty controls in this frame, called from child-class
+        void render_this_frame() const noexcept;
+        // make dirty rects in this frame, rects's length must be m_uUnitLengthRender
+        void make_dirty_rects(RECT rects[]) const noexcept;
     protected:
         // longui viewport
         UIViewport*             m_pViewport = nullptr;
@@ -314,6 +344,8 @@ namespace LongUI {
         RectLTWH_L              m_rcWindow;
         // string allocator
         StrAllocator            m_oStringAllocator;
+        // pool for controls in this window
+        CUIObjectPool*          m_pControlPool = CUIObjectPool::Create();
         // will use BitArray instead of them
         Helper::BitArray16      m_baBoolWindow;
         // mode for text anti-alias
@@ -323,15 +355,19 @@ namespace LongUI {
         // data length of m_apUnits, in render
         uint16_t                m_uUnitLengthRender = 0;
         // data for unit
-        UIControl*              m_apUnit[LongUIDirtyControlSize];
-        // data for unit, in render
-        UIControl*              m_apUnitRender[LongUIDirtyControlSize];
+        UIControl*              m_apUnit[LongUIDirtyControlMaxSize];
+        // data for unit, in render: snapshot made in update
+        RenderUnit              m_aUnitRender[LongUIDirtyControlSize];
+        // world matrix of viewport, in render
+        D2D1_MATRIX_3X2_F       m_mxViewportRender = DX::Matrix3x2F::Identity();
+        // culling rect, in render: dirty rect now rendering, unlimited if not in dirty rendering
+        D2D1_RECT_F             m_rcCullRender = { -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX };
         // dirty rects
         //RECT                    m_dirtyRects[LongUIDirtyControlSize];
         // current STGMEDIUM: begin with DWORD
         STGMEDIUM               m_curMedium;
-        // control name ->map-> control pointer
-        StringTable             m_hashStr2Ctrl;
+        // control name atom ->map-> control pointer
+        EzContainer::EzAtomMap<UIControl*> m_hashAtom2Ctrl;
     public:
         // debug info
 #ifdef _DEBUG
@@ -368,4 +404,27 @@ namespace LongUI {
     };
     // create builtin window
     auto CreateBuiltinWindow(const Config::Window& config) noexcept ->XUIBaseWindow*;
+    // memory surface of headless window
+    struct HeadlessSurface {
+        // pixels in R8G8B8A8(premultiplied), valid while holding dxgi lock
+        const uint8_t*      pixels;
+        // pitch of pixels in byte
+        uint32_t            pitch;
+        // width of surface
+        uint32_t            width;
+        // height of surface
+        uint32_t            height;
+        // count of rendered frames
+        uint32_t            frame_count;
+        // count of full-rendered frames
+        uint32_t            full_render_count;
+        // count of dirty-rendered frames
+        uint32_t            dirty_render_count;
+        // count of dirty rects in last frame, 0 for full-rendering
+        uint32_t            dirty_rects_count;
+        // dirty rects in last frame
+        RECT                dirty_rects[LongUIDirtyControlSize];
+    };
+    // get memory surface of headless window, return false if not a headless window
+    bool GetHeadlessSurface(const XUIBaseWindow* window, HeadlessSurface& surface) noexcept;
 }
\ No newline at end of file
@@ -25,6 +25,8 @@
 */
 
 #include "../luibase.h"
+#include "../Platless/luiPlText.h"
+#include "../Platless/luiPlUtil.h"
 #include "../../3rdParty/pugixml/pugixml.hpp"
 #include <dwrite.h>
 #include <d2d1_3.h>
@@ -124,4 +126,54 @@ namespace LongUI { namespace DX {
         IN OPTIONAL IDWriteTextFormat* template_fmt = nullptr, 
         IN OPTIONAL const char* prefix=nullptr
     ) noexcept ->HRESULT;
+    // text layout backend for CUITextLayoutCache, key.format is IDWriteTextFormat
+    class CUITextLayoutBackend final : public XUITextLayoutBackend {
+    public:
+        // create layout with one reference, null if failed
+        auto CreateLayout(const TextLayoutKey& key) noexcept -> void* override;
+        // add reference of layout or format
+        void Acquire(void* obj) noexcept override { static_cast<IUnknown*>(obj)->AddRef(); }
+        // release reference of layout or format
+        void Release(void* obj) noexcept override { static_cast<IUnknown*>(obj)->Release(); }
+        // estimate memory used by layout in byte
+        auto MeasureLayout(void* layout, const TextLayoutKey& key) noexcept -> uint32_t override;
+    };
+    // paragraph layouter for CUIParagraphLayouts, layout is IDWriteTextLayout
+    class CUIParagraphLayouter final : public XUIParagraphLayouter {
+    public:
+        // ctor
+        CUIParagraphLayouter() noexcept = default;
+        // no copy ctor
+        CUIParagraphLayouter(const CUIParagraphLayouter&) = delete;
+        // dtor
+        ~CUIParagraphLayouter() noexcept { LongUI::SafeRelease(m_pFormat); }
+        // create layout for paragraph, null if failed
+        auto CreateLayout(const wchar_t* text, uint32_t length) noexcept -> void* override;
+        // destroy layout
+        void DestroyLayout(void* layout) noexcept override { static_cast<IUnknown*>(layout)->Release(); }
+        // get height of layout
+        auto GetLayoutHeight(void* layout) noexcept -> float override;
+        // format new layout with formatter
+        void FormatLayout(void* layout, uint32_t position, uint32_t length) noexcept override {
+            if (this->formatter.IsOK()) this->formatter(static_cast<IDWriteTextLayout*>(layout), position, length);
+        }
+        // set text format, paragraph alignment is applied by caller
+        void SetFormat(IDWriteTextFormat* fmt) noexcept;
+        // ref text format
+        auto RefFormat() const noexcept { return m_pFormat; }
+        // set max width of layout
+        void SetMaxWidth(float w) noexcept { m_fWidth = w; }
+        // set password char, 0 for normal text
+        void SetPasswordChar(wchar_t ch) noexcept { m_chPwd = ch; }
+    public:
+        // formatter for new layout, with paragraph position in buffer and length
+        CUIFunction<void(IDWriteTextLayout*, uint32_t, uint32_t)> formatter;
+    private:
+        // text format
+        IDWriteTextFormat*  m_pFormat = nullptr;
+        // max width
+        float               m_fWidth = 0.f;
+        // password char
+        wchar_t             m_chPwd = 0;
+    };
 }}
\ No newline at end of file
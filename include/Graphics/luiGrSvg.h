@@ -25,9 +25,18 @@
 */
 
 #include <d2d1_3.h>
+#include "../Platless/luiPlPath.h"
 
 // longui::svg namespace
 namespace LongUI { namespace SVG {
+    // acquire compiled path from global cache, null if out of memory
+    auto AcquireCompiledPath(const char* path) noexcept -> const PathIR*;
+    // release compiled path from AcquireCompiledPath
+    void ReleaseCompiledPath(const PathIR* ir) noexcept;
+    // clear global path cache
+    void ClearPathCache() noexcept;
+    // replay compiled path into geometry sink
+    void ReplayPath(const PathIR& ir, ID2D1GeometrySink* sink) noexcept;
     // parser path
     auto ParserPath(const char* path, /*OUT*/ID2D1PathGeometry1** out) noexcept ->HRESULT;
     // parser path
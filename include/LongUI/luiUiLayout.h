@@ -0,0 +1,127 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../luibase.h"
+#include "../luiconf.h"
+#include "../Platless/luiPlEzC.h"
+#include <cstdint>
+
+// longui namespace
+namespace LongUI {
+    // compiled layout, replace xml parsing while creating window
+    // layout: [Header][Payload][Node x n][Attribute x n][class x n][string]
+    // all data are 4-byte aligned offsets, so it could be mapped from file directly
+    namespace Layout {
+        // constant
+        enum : uint32_t {
+            // magic code: "LUIL"
+            MAGIC = 'L' | 'U' << 8 | 'I' << 16 | 'L' << 24,
+            // version
+            VERSION = 1,
+            // null index
+            NULL_INDEX = uint32_t(-1),
+            // no class for node(window node)
+            NULL_CLASS = uint16_t(-1),
+        };
+        // flag for layout
+        enum Flag : uint32_t {
+            // none
+            Flag_None = 0,
+            // payload compressed with lz4, need LONGUI_WITH_LZ4
+            Flag_LZ4 = 1 << 0,
+        };
+        // header of layout
+        struct Header {
+            // magic code
+            uint32_t    magic;
+            // version
+            uint32_t    version;
+            // flags
+            uint32_t    flags;
+            // length of payload after decompressing
+            uint32_t    raw_length;
+            // length of payload in file
+            uint32_t    payload_length;
+        };
+        // payload, offsets in byte from begin of payload
+        struct Payload {
+            // count of node
+            uint32_t    node_count;
+            // count of attribute
+            uint32_t    attribute_count;
+            // count of control class
+            uint32_t    class_count;
+            // length of string pool
+            uint32_t    string_length;
+            // offset of node array
+            uint32_t    node_offset;
+            // offset of attribute array
+            uint32_t    attribute_offset;
+            // offset of class array
+            uint32_t    class_offset;
+            // offset of string pool
+            uint32_t    string_offset;
+        };
+        // node in breadth-first order, node[0] for window
+        struct Node {
+            // name string
+            uint32_t    name;
+            // parent node index
+            uint32_t    parent;
+            // first attribute index
+            uint32_t    first_attribute;
+            // count of attribute
+            uint16_t    attribute_count;
+            // control class index
+            uint16_t    class_id;
+        };
+        // attribute, template attributes merged
+        struct Attribute {
+            // name string
+            uint32_t    name;
+            // value string
+            uint32_t    value;
+        };
+        // get data in payload
+        template<typename T> inline auto GetData(const Payload* payload, uint32_t offset) noexcept {
+            return reinterpret_cast<const T*>(reinterpret_cast<const char*>(payload) + offset);
+        }
+        // get node array
+        inline auto GetNodes(const Payload* payload) noexcept { return GetData<Node>(payload, payload->node_offset); }
+        // get attribute array
+        inline auto GetAttributes(const Payload* payload) noexcept { return GetData<Attribute>(payload, payload->attribute_offset); }
+        // get class array, string index of control class name
+        inline auto GetClasses(const Payload* payload) noexcept { return GetData<uint32_t>(payload, payload->class_offset); }
+        // get string
+        inline auto GetString(const Payload* payload, uint32_t str) noexcept { return GetData<char>(payload, payload->string_offset + str); }
+        // compile window xml node with control template node, template id will be removed
+        auto Compile(pugi::xml_node window, pugi::xml_node templates, uint32_t flags, EzContainer::EzVector<uint8_t>& output) noexcept ->HRESULT;
+        // load and check layout, buffer used for decompressing, payload will point to data if not compressed
+        auto Load(const void* data, size_t length, EzContainer::EzVector<uint8_t>& buffer, const Payload*& payload) noexcept ->HRESULT;
+        // build xml nodes under root with public pugixml api, nodes[i] for node i
+        auto BuildXml(const Payload* payload, pugi::xml_node root, pugi::xml_node* nodes) noexcept ->HRESULT;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../luibase.h"
+#include "../luiconf.h"
+
+#ifdef LONGUI_WITH_PROFILER
+#include <atomic>
+
+// longui namespace
+namespace LongUI {
+    // profile event
+    struct ProfileEvent {
+        // name of event, must be string literal
+        const char*         name;
+        // begin time in QPC tick
+        int64_t             begin;
+        // end time in QPC tick
+        int64_t             end;
+        // tag, name of control etc.
+        char                tag[LongUIProfilerTagLength];
+    };
+    // frame profiler, record scoped timings into per-thread ring buffers
+    class CUIProfiler {
+    public:
+        // enable/disable recording
+        static void Enable(bool enable) noexcept { s_bEnabled.store(enable, std::memory_order_relaxed); }
+        // is enabled?
+        static bool IsEnabled() noexcept { return s_bEnabled.load(std::memory_order_relaxed); }
+        // now in QPC tick
+        static auto Now() noexcept -> int64_t;
+        // record an event into ring buffer of this thread
+        static void Record(const char* name, const char* tag, int64_t begin, int64_t end) noexcept;
+        // export events of all threads as chrome trace-event json
+        static auto ExportChromeTrace(const wchar_t* file_name) noexcept ->HRESULT;
+        // clear all events
+        static void Clear() noexcept;
+    private:
+        // enabled
+        static std::atomic_bool s_bEnabled;
+    };
+    // profile scope
+    class CUIProfileScope {
+    public:
+        // ctor
+        CUIProfileScope(const char* name, const char* tag = nullptr) noexcept
+            : m_pName(name), m_pTag(tag), m_begin(CUIProfiler::IsEnabled() ? CUIProfiler::Now() : 0) {}
+        // dtor
+        ~CUIProfileScope() noexcept {
+            if (m_begin && CUIProfiler::IsEnabled()) {
+                CUIProfiler::Record(m_pName, m_pTag, m_begin, CUIProfiler::Now());
+            }
+        }
+        // no copy
+        CUIProfileScope(const CUIProfileScope&) = delete;
+    private:
+        // name
+        const char*         m_pName;
+        // tag
+        const char*         m_pTag;
+        // begin time
+        const int64_t       m_begin;
+    };
+}
+// profile this scope
+#define LongUIProfileScope(n) LongUI::CUIProfileScope longui_profile_scope_##n(#n)
+// profile this scope with tag
+#define LongUIProfileScopeTag(n, t) LongUI::CUIProfileScope longui_profile_scope_##n(#n, t)
+#else
+// profile this scope
+#define LongUIProfileScope(n) (void)0
+// profile this scope with tag
+#define LongUIProfileScopeTag(n, t) (void)0
+#endif
@@ -24,9 +24,10 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 
-#include "../luibase.h"
-#include "../luiconf.h"
+#include "../Platless/luiPlConf.h"
 #include <cassert>
+#include <cstring>
+#include <cwchar>
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4200)
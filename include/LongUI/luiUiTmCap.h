@@ -30,24 +30,38 @@
 
 // longui namespace
 namespace LongUI {
-    // time capsule
-    class CUITimeCapsule final : public CUISingleSmallObject {
+    // time wheel
+    class CUITimeWheel;
+    // intrusive link of time capsule list, circular with sentinel
+    struct TimeCapsuleLink {
+        // prev link
+        TimeCapsuleLink*    prev = nullptr;
+        // next link
+        TimeCapsuleLink*    next = nullptr;
+        // init as empty list
+        void InitList() noexcept { prev = next = this; }
+        // is empty list?
+        bool IsEmptyList() const noexcept { return next == this; }
+    };
+    // time capsule, pooled and scheduled by CUITimeWheel
+    class CUITimeCapsule final : TimeCapsuleLink {
+        // friend class
+        friend class CUITimeWheel;
     public:
         // time callback, return true if want to terminate time capsule
+        //   normal: called every frame with progress in [0, 1]
+        //   periodic: called once per period with elapsed time in sec
         using TimeCallBack = CUIFunction<bool(float)>;
         // ctor
-        CUITimeCapsule(TimeCallBack&& call, size_t identifier, float time);
-        // update
+        CUITimeCapsule(TimeCallBack&& call, size_t identifier, float time, float period) noexcept;
+        // update, return true if finished
         bool Update(float delta_time) noexcept;
-        // dispose
-        void Dispose() { delete this; }
+        // fire periodic capsule, return true if finished
+        bool Fire(float elapsed) noexcept { return m_call(elapsed); }
         // get id
         auto GetId() const noexcept { return m_id; }
-    public:
-        // create one
-        static auto Create(TimeCallBack&& call, size_t id, float time) noexcept {
-            return new(std::nothrow) CUITimeCapsule(std::move(call), id, time);
-        }
+        // is periodic?
+        bool IsPeriodic() const noexcept { return m_fPeriod > 0.f; }
     private:
         // identifier
         size_t              m_id;
@@ -55,7 +69,105 @@ namespace LongUI {
         TimeCallBack        m_call;
         // time total
         const float         m_fTimeTotal;
+        // period in sec, 0 for normal capsule
+        const float         m_fPeriod;
         // time done
         float               m_fTimeDone = 0.f;
+        // tick of expire in wheel
+        uint32_t            m_uExpire = 0;
+        // tick of last start/fire
+        uint32_t            m_uStart = 0;
+    };
+    // hierarchical time wheel for time capsules
+    class CUITimeWheel {
+    public:
+        // time callback
+        using TimeCallBack = CUITimeCapsule::TimeCallBack;
+        // wheel info
+        enum : uint32_t {
+            // bits of slot index in one level
+            SLOT_BITS = 6,
+            // slot count in one level
+            SLOT_COUNT = 1 << SLOT_BITS,
+            // mask of slot index
+            SLOT_MASK = SLOT_COUNT - 1,
+            // level count
+            LEVEL_COUNT = 4,
+            // max ticks could be scheduled, longer delay will be clamped
+            MAX_TICKS = (1u << (SLOT_BITS * LEVEL_COUNT)) - 1,
+        };
+    public:
+        // ctor
+        CUITimeWheel() noexcept;
+        // dtor
+        ~CUITimeWheel() noexcept;
+        // no copy, lists are self-referential
+        CUITimeWheel(const CUITimeWheel&) = delete;
+        // add capsule, start after delay(sec), periodic if period(sec) > 0, return false if OOM
+        bool Add(TimeCallBack&& call, size_t id, float time, float delay, float period) noexcept;
+        // remove capsule with id, return true if found
+        bool Remove(size_t id) noexcept;
+        // update capsules, cost is proportional to running and expiring capsules
+        void Update(float delta_time) noexcept;
+        // remove all capsules
+        void Clear() noexcept;
+        // get count of capsules
+        auto GetCount() const noexcept { return m_cCount; }
+    private:
+        // convert sec to ticks
+        static auto to_ticks(float time) noexcept { return uint32_t(time * float(LongUITimeWheelTickRate) + 0.5f); }
+        // get capsule of link
+        static auto capsule(TimeCapsuleLink* link) noexcept { return static_cast<CUITimeCapsule*>(link); }
+        // link capsule at the tail of list
+        static void link(TimeCapsuleLink& list, CUITimeCapsule* cap) noexcept;
+        // unlink capsule from list
+        static void unlink(CUITimeCapsule* cap) noexcept;
+        // move whole list to the tail of another list
+        static void splice(TimeCapsuleLink& list, TimeCapsuleLink& from) noexcept;
+        // move whole list to pending list
+        void take_pending(TimeCapsuleLink& list) noexcept;
+        // schedule capsule into wheel with m_uExpire
+        void schedule(CUITimeCapsule* cap) noexcept;
+        // advance ticks
+        void advance(uint32_t ticks) noexcept;
+        // advance one tick
+        void tick() noexcept;
+        // run capsules in pending list
+        void run_pending(float delta_time, bool expired) noexcept;
+        // alloc capsule memory from pool
+        auto alloc_capsule() noexcept ->void*;
+        // release capsule to pool
+        void free_capsule(CUITimeCapsule* cap) noexcept;
+        // find slot in hash table
+        auto hash_find(size_t id) const noexcept ->CUITimeCapsule**;
+        // insert into hash table
+        bool hash_insert(CUITimeCapsule* cap) noexcept;
+        // erase slot from hash table
+        void hash_erase(CUITimeCapsule** slot) noexcept;
+    private:
+        // wheel slots
+        TimeCapsuleLink         m_aWheel[LEVEL_COUNT][SLOT_COUNT];
+        // running capsules, updated every frame in adding order
+        TimeCapsuleLink         m_oActive;
+        // pending capsules in update
+        TimeCapsuleLink         m_oPending;
+        // now running capsule
+        CUITimeCapsule*         m_pRunning = nullptr;
+        // free capsule memory list
+        void*                   m_pFreeList = nullptr;
+        // pool chunk list
+        void*                   m_pChunkList = nullptr;
+        // hash table: id -> capsule
+        CUITimeCapsule**        m_ppHash = nullptr;
+        // capacity of hash table, power of 2
+        uint32_t                m_cHashCap = 0;
+        // count of capsules
+        uint32_t                m_cCount = 0;
+        // now tick
+        uint32_t                m_uNow = 0;
+        // running capsule removed?
+        bool                    m_bRunningRemoved = false;
+        // remained tick in float
+        float                   m_fTickRemain = 0.f;
     };
 }
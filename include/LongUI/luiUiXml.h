@@ -26,6 +26,9 @@
 
 #include "../luibase.h"
 #include "../luiconf.h"
+#include "luiUiLayout.h"
+#include "../Platless/luiPlAtom.h"
+#include <cstring>
 
 
 // longui::helper namespace, xml helper
@@ -41,6 +44,94 @@ namespace LongUI { namespace Helper {
     };
     // get value string
     auto XMLGetValue(pugi::xml_node node, const char* attribute, const char* prefix =nullptr) noexcept -> const char*;
+    /// <summary>
+    /// View of attributes with same prefix, collected in one pass without copying
+    /// 属性视图: 一次遍历收集同前缀属性, 之后按去除前缀的名称哈希查找
+    /// </summary>
+    class AttributeView {
+    public:
+        // max count of attributes indexed, others found by scanning
+        enum : uint32_t { MAX_COUNT = 32, CAPACITY = 64 };
+        // ctor with xml node, could be null
+        AttributeView(pugi::xml_node node, const char* prefix = nullptr) noexcept;
+        // ctor with node of compiled layout
+        AttributeView(const Layout::Payload* payload, uint32_t index, const char* prefix = nullptr) noexcept;
+        // no copy ctor
+        AttributeView(const AttributeView&) = delete;
+        // get value with name without prefix, null if not found
+        auto Get(const char* name) const noexcept -> const char*;
+        // get bool value, true for 't', 'T' or '1'
+        bool GetBool(const char* name, bool def) const noexcept {
+            const auto v = this->Get(name); if (!v) return def;
+            return v[0] == 't' || v[0] == 'T' || v[0] == '1';
+        }
+        // count of attributes with prefix
+        auto GetCount() const noexcept { return m_cCount; }
+        // for each attribute with prefix, call with (name without prefix, value)
+        template<typename T> void ForEach(T lam) const noexcept {
+            this->scan([&lam](const char* n, const char* v) noexcept { lam(n, v); return false; });
+        }
+    private:
+        // add attribute
+        void add(const char* name, const char* value) noexcept;
+        // scan attributes with prefix in source, stop if lam returns true
+        template<typename T> void scan(T lam) const noexcept {
+            const auto match = [this](const char* name) noexcept {
+                return name && !std::strncmp(name, m_pPrefix, m_cPrefix) ? name + m_cPrefix : nullptr;
+            };
+            // 编译布局
+            if (m_pPayload) {
+                const auto& node = Layout::GetNodes(m_pPayload)[m_uIndex];
+                const auto attributes = Layout::GetAttributes(m_pPayload) + node.first_attribute;
+                for (uint32_t i = 0; i < node.attribute_count; ++i) {
+                    const auto name = match(Layout::GetString(m_pPayload, attributes[i].name));
+                    if (name && lam(name, Layout::GetString(m_pPayload, attributes[i].value))) return;
+                }
+                return;
+            }
+            for (auto attr = m_node.first_attribute(); attr; attr = attr.next_attribute()) {
+                const auto name = match(attr.name());
+                if (name && lam(name, attr.value())) return;
+            }
+        }
+        // attribute item
+        struct Item { const char* name; const char* value; uint32_t hash; };
+        // xml node, null if compiled layout
+        pugi::xml_node          m_node;
+        // compiled layout payload
+        const Layout::Payload*  m_pPayload = nullptr;
+        // index of node in compiled layout
+        uint32_t                m_uIndex = 0;
+        // length of prefix
+        uint32_t                m_cPrefix = 0;
+        // prefix
+        const char*             m_pPrefix;
+        // count of attributes with prefix
+        uint32_t                m_cCount = 0;
+        // slots, index of items
+        uint8_t                 m_aSlots[CAPACITY];
+        // items
+        Item                    m_aItems[MAX_COUNT];
+    };
+    /// <summary>
+    /// Predefined attributes of xml node, collected in one pass and indexed by atom id
+    /// 预定义属性: 一次遍历, 按预定义原子id直接索引, 无需逐个比较属性名
+    /// </summary>
+    class PredefinedAttributes {
+    public:
+        // ctor with xml node, could be null
+        PredefinedAttributes(pugi::xml_node node) noexcept;
+        // no copy ctor
+        PredefinedAttributes(const PredefinedAttributes&) = delete;
+        // get attribute, null attribute if not found
+        auto operator[](XmlAttribute::AtomID id) const noexcept {
+            assert(id < XmlAttribute::ATOM_PREDEFINED_COUNT && "out of range");
+            return m_aAttributes[id];
+        }
+    private:
+        // attributes, index 0 for null atom
+        pugi::xml_attribute     m_aAttributes[XmlAttribute::ATOM_PREDEFINED_COUNT];
+    };
     // get value enum-int
     auto GetEnumFromString(const char* value, const GetEnumProperties& prop) noexcept ->uint32_t;
     // get longui richtype
@@ -151,4 +242,8 @@ namespace LongUI { namespace Helper {
         const char* attribute = "checkstate", const char* prefix = nullptr) noexcept {
         return GetEnumFromString(Helper::XMLGetValue(node, attribute, prefix), bad_match);
     }
+    // get enum from attribute view
+    template<typename T> inline auto GetEnumFromView(const AttributeView& view, T bad_match, const char* attribute) noexcept {
+        return GetEnumFromString(view.Get(attribute), bad_match);
+    }
 }}
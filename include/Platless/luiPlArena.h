@@ -0,0 +1,152 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../luibase.h"
+#include "../luiconf.h"
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Per-thread bump allocator for transient work, reset once per frame
+    /// 帧内存池: 每个线程一个, 每帧重置, 释放为空操作
+    /// </summary>
+    class CUIFrameArena {
+        // block, data follows
+        struct Block { Block* next; size_t capacity; };
+    public:
+        // marker for rewinding
+        struct Marker { Block* block; size_t used; };
+        // get arena of this thread
+        static auto Get() noexcept -> CUIFrameArena&;
+        // ctor
+        CUIFrameArena() noexcept = default;
+        // no copy ctor
+        CUIFrameArena(const CUIFrameArena&) = delete;
+        // dtor
+        ~CUIFrameArena() noexcept;
+        /// <summary>
+        /// Allocates memory valid until rewinding/reset, null if OOM.
+        /// </summary>
+        /// <param name="size">The size in byte.</param>
+        /// <param name="align">The alignment, power of 2.</param>
+        /// <returns></returns>
+        auto Alloc(size_t size, size_t align = alignof(double)) noexcept -> void* {
+            assert(align && !(align & (align - 1)) && "bad alignment");
+            if (m_pCurrent) {
+                const auto base = reinterpret_cast<uintptr_t>(m_pCurrent + 1);
+                const auto pos = ((base + m_cUsed + align - 1) & ~uintptr_t(align - 1)) - base;
+                if (pos + size <= m_pCurrent->capacity) {
+                    m_cUsed = pos + size;
+                    ++m_cAllocCount;
+                    m_cAllocBytes += size;
+                    return reinterpret_cast<void*>(base + pos);
+                }
+            }
+            return this->alloc_slow(size, align);
+        }
+        // allocate array of T, T should be trivial
+        template<typename T> auto AllocT(size_t count) noexcept {
+            return reinterpret_cast<T*>(this->Alloc(sizeof(T) * count, alignof(T)));
+        }
+        // get marker of now
+        auto GetMarker() const noexcept { return Marker{ m_pCurrent, m_cUsed }; }
+        // rewind to marker, memory allocated after it is invalid
+        void Rewind(const Marker& marker) noexcept { m_pCurrent = marker.block; m_cUsed = marker.used; }
+        // reset for new frame, no allocation should be alive
+        void Reset() noexcept;
+        // count of allocations in this frame
+        auto GetAllocCount() const noexcept { return m_cAllocCount; }
+        // bytes allocated in this frame
+        auto GetAllocBytes() const noexcept { return m_cAllocBytes; }
+        // count of allocations in last frame
+        auto GetLastFrameAllocCount() const noexcept { return m_cLastAllocCount; }
+        // bytes allocated in last frame
+        auto GetLastFrameAllocBytes() const noexcept { return m_cLastAllocBytes; }
+        // capacity of all blocks
+        auto GetCapacity() const noexcept { return m_cCapacity; }
+    private:
+        // allocate in next block
+        auto alloc_slow(size_t size, size_t align) noexcept -> void*;
+    private:
+        // first block
+        Block*                  m_pFirst = nullptr;
+        // current block, null for before first
+        Block*                  m_pCurrent = nullptr;
+        // used in current block
+        size_t                  m_cUsed = 0;
+        // capacity of all blocks
+        size_t                  m_cCapacity = 0;
+        // bytes allocated in this frame
+        size_t                  m_cAllocBytes = 0;
+        // bytes allocated in last frame
+        size_t                  m_cLastAllocBytes = 0;
+        // count of allocations in this frame
+        uint32_t                m_cAllocCount = 0;
+        // count of allocations in last frame
+        uint32_t                m_cLastAllocCount = 0;
+    };
+    /// <summary>
+    /// Scope of frame arena, rewinds when leaving
+    /// </summary>
+    class CUIFrameArenaScope {
+    public:
+        // ctor
+        CUIFrameArenaScope() noexcept : m_arena(CUIFrameArena::Get()), m_marker(m_arena.GetMarker()) {}
+        // no copy ctor
+        CUIFrameArenaScope(const CUIFrameArenaScope&) = delete;
+        // dtor
+        ~CUIFrameArenaScope() noexcept { m_arena.Rewind(m_marker); }
+        // operator ->
+        auto operator->() const noexcept { return &m_arena; }
+    private:
+        // arena
+        CUIFrameArena&          m_arena;
+        // marker
+        CUIFrameArena::Marker   m_marker;
+    };
+    /// <summary>
+    /// STL-compatible allocator on frame arena of this thread, null if OOM
+    /// </summary>
+    template<typename T> struct FrameAllocator {
+        // value type
+        using value_type = T;
+        // ctor
+        FrameAllocator() noexcept = default;
+        // ctor for rebind
+        template<typename U> FrameAllocator(const FrameAllocator<U>&) noexcept {}
+        // allocate
+        auto allocate(size_t n) noexcept -> T* { return CUIFrameArena::Get().AllocT<T>(n); }
+        // deallocate, do nothing
+        void deallocate(T*, size_t) noexcept {}
+        // operator ==
+        template<typename U> bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+        // operator !=
+        template<typename U> bool operator!=(const FrameAllocator<U>&) const noexcept { return false; }
+    };
+}
@@ -0,0 +1,222 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../luibase.h"
+#include "../luiconf.h"
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+// longui namespace
+namespace LongUI {
+    // xml attribute namespace
+    namespace XmlAttribute {
+        // predefined atom id of attribute keys, same order as luiconf.h
+        enum AtomID : uint32_t {
+            // null atom
+            Atom_Null = 0,
+            Atom_ControlName,
+            Atom_Script,
+            Atom_LayoutWeight,
+            Atom_LayoutContext,
+            Atom_Visible,
+            Atom_UserDefinedString,
+            Atom_BackgroudBrush,
+            Atom_AllSize,
+            Atom_Margin,
+            Atom_BorderWidth,
+            Atom_BorderRound,
+            Atom_TemplateID,
+            Atom_RenderingPriority,
+            Atom_IsRenderParent,
+            Atom_IsClipStrictly,
+            Atom_Enabled,
+            Atom_IsSkipUpdateInvisible,
+            Atom_MarginalDirection,
+            Atom_TemplateSize,
+            Atom_IsHostPosterityAlways,
+            Atom_IsZoomMarginalControl,
+            Atom_WindowClearColor,
+            Atom_WindowTitleName,
+            Atom_WindowTextAntiMode,
+            // count of predefined atom
+            ATOM_PREDEFINED_COUNT,
+        };
+    }
+    // atom entry, text follows
+    struct AtomEntry { uint32_t id; uint32_t hash; uint32_t length; };
+    /// <summary>
+    /// Interned string, unique pointer for same text during process
+    /// 驻留字符串: 相同文本只有一份, 比较即为整数比较
+    /// </summary>
+    class CUIAtom {
+    public:
+        // intern string, null atom if OOM
+        static auto Intern(const char* str) noexcept { return Intern(str, static_cast<uint32_t>(std::strlen(str))); }
+        // intern string view, null atom if OOM
+        static auto Intern(const char* str, uint32_t len) noexcept -> CUIAtom;
+        // find interned string, null atom if not interned
+        static auto Find(const char* str) noexcept { return Find(str, static_cast<uint32_t>(std::strlen(str))); }
+        // find interned string view, null atom if not interned
+        static auto Find(const char* str, uint32_t len) noexcept -> CUIAtom;
+        // count of interned strings
+        static auto GetCount() noexcept -> uint32_t;
+    public:
+        // ctor for null atom
+        CUIAtom() noexcept = default;
+        // id, 0 for null atom
+        auto GetID() const noexcept { return m_pEntry ? m_pEntry->id : 0ui32; }
+        // hash code
+        auto GetHash() const noexcept { return m_pEntry ? m_pEntry->hash : 0ui32; }
+        // length of string
+        auto GetLength() const noexcept { return m_pEntry ? m_pEntry->length : 0ui32; }
+        // c-string, "" for null atom
+        auto c_str() const noexcept { return m_pEntry ? reinterpret_cast<const char*>(m_pEntry + 1) : ""; }
+        // not null?
+        explicit operator bool() const noexcept { return !!m_pEntry; }
+        // == 操作
+        bool operator==(const CUIAtom& atom) const noexcept { return m_pEntry == atom.m_pEntry; }
+        // != 操作
+        bool operator!=(const CUIAtom& atom) const noexcept { return m_pEntry != atom.m_pEntry; }
+    private:
+        // entry
+        const AtomEntry*        m_pEntry = nullptr;
+    };
+    // ezcontainer namespace
+    namespace EzContainer {
+        // atom map, open addressing keyed by atom id
+        // 类名与控件名表均用此表, 取代了原先的 EzStringMap
+        template<typename V> class EzAtomMap {
+        public:
+            // unit, id 0 for empty
+            struct Unit { uint32_t id; V value; };
+        private:
+            // min capacity
+            enum : uint32_t { MIN_CAPACITY = 16 };
+            // ideal index of id
+            auto index_of(uint32_t id) const noexcept { return (id * 0x9e3779b1ui32) & (m_cCapacity - 1); }
+            // find unit
+            auto find(uint32_t id) const noexcept ->Unit* {
+                if (!id || !m_cCount) return nullptr;
+                const auto mask = m_cCapacity - 1;
+                for (auto index = this->index_of(id); ; index = (index + 1) & mask) {
+                    const auto unit = m_pTable + index;
+                    if (unit->id == id) return unit;
+                    if (!unit->id) return nullptr;
+                }
+            }
+            // insert unit, table must have space
+            void insert(const Unit& unit) noexcept {
+                const auto mask = m_cCapacity - 1;
+                auto index = this->index_of(unit.id);
+                while (m_pTable[index].id) index = (index + 1) & mask;
+                m_pTable[index] = unit;
+                ++m_cCount;
+            }
+        public:
+            // ctor
+            EzAtomMap() noexcept = default;
+            // copy ctor
+            EzAtomMap(const EzAtomMap&) = delete;
+            // dtor
+            ~EzAtomMap() noexcept { this->Clear(); }
+            // clear
+            void Clear() noexcept {
+                LongUI::NormalFree(m_pTable);
+                m_pTable = nullptr;
+                m_cCount = m_cCapacity = 0;
+            }
+            // for each, call with Unit*
+            template<typename T> void ForEach(T lam) noexcept {
+                for (auto itr = m_pTable; itr != m_pTable + m_cCapacity; ++itr) {
+                    if (itr->id) lam(itr);
+                }
+            }
+            // size
+            auto GetCount() const noexcept { return m_cCount; }
+            // find
+            auto Find(CUIAtom atom) const noexcept ->V* {
+                const auto unit = this->find(atom.GetID());
+                return unit ? &unit->value : nullptr;
+            }
+            // insert, atom must be not null
+            bool Insert(CUIAtom atom, const V& v) noexcept {
+                assert(atom && "bad argument");
+                assert(!this->Find(atom) && "existed!");
+                // 负载因子 3/4
+                if ((m_cCount + 1) * 4 > m_cCapacity * 3) {
+                    if (!this->Reserve(m_cCapacity ? m_cCapacity * 2 : MIN_CAPACITY)) return false;
+                }
+                this->insert(Unit{ atom.GetID(), v });
+                return true;
+            }
+            // remove, backward shift instead of tombstone
+            bool Remove(CUIAtom atom) noexcept {
+                auto unit = this->find(atom.GetID());
+                if (!unit) { assert(!"not found"); return false; }
+                const auto mask = m_cCapacity - 1;
+                auto hole = static_cast<uint32_t>(unit - m_pTable);
+                for (auto index = (hole + 1) & mask; m_pTable[index].id; index = (index + 1) & mask) {
+                    // 理想位置不在 (hole, index] 之间则前移
+                    const auto ideal = this->index_of(m_pTable[index].id);
+                    if (((index - ideal) & mask) >= ((index - hole) & mask)) {
+                        m_pTable[hole] = m_pTable[index];
+                        hole = index;
+                    }
+                }
+                m_pTable[hole].id = 0;
+                --m_cCount;
+                return true;
+            }
+            // reserve, capacity will be power of 2
+            bool Reserve(size_t newc) noexcept {
+                uint32_t cap = MIN_CAPACITY;
+                while (cap < newc) cap <<= 1;
+                if (cap <= m_cCapacity) return false;
+                auto newtable = LongUI::NormalAllocT<Unit>(cap);
+                if (!newtable) return false;
+                std::memset(newtable, 0, sizeof(Unit) * cap);
+                const auto oldtable = m_pTable;
+                const auto oldcap = m_cCapacity;
+                m_pTable = newtable;
+                m_cCapacity = cap;
+                m_cCount = 0;
+                for (auto itr = oldtable; itr != oldtable + oldcap; ++itr) {
+                    if (itr->id) this->insert(*itr);
+                }
+                LongUI::NormalFree(oldtable);
+                return true;
+            }
+        private:
+            // size
+            uint32_t                m_cCount = 0;
+            // capacity, power of 2
+            uint32_t                m_cCapacity = 0;
+            // unit table
+            Unit*                   m_pTable = nullptr;
+        };
+    }
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// 平台无关部分的配置: 内存分配与内联, 不依赖 luibase/luiconf
+#include <cstdlib>
+#include <cstddef>
+
+// dlmalloc
+#if !defined(_DEBUG) && !defined(LONGUI_NO_DLMALLOC)
+#define LONGUI_WITH_DLMALLOC
+#define USE_DL_PREFIX
+#include <../3rdParty/dlmalloc/dlmalloc.h>
+#endif
+
+#ifndef LongUIInline
+#ifdef _MSC_VER
+#define LongUIInline __forceinline
+#else
+#define LongUIInline inline __attribute__((__always_inline__))
+#endif
+#endif
+
+#ifndef LongUINoinline
+#ifdef _MSC_VER
+#define LongUINoinline __declspec(noinline)
+#else
+#define LongUINoinline __attribute__((__noinline__))
+#endif
+#endif
+
+// longui namespace
+namespace LongUI {
+    // alloc for normal space
+    inline auto NormalAlloc(size_t length) noexcept { return std::malloc(length); }
+    // free for normal space
+    inline auto NormalFree(void* address) noexcept { return std::free(address); }
+#if defined(_DEBUG)
+    // debug length
+    enum : size_t { DEBUG_LENGTH = 32 };
+    // alloc for small space
+    inline auto SmallAlloc(size_t length) noexcept -> void* { 
+        auto ptr = reinterpret_cast<char*>(std::malloc(length + DEBUG_LENGTH));
+        return ptr ? DEBUG_LENGTH + ptr : nullptr; 
+    }
+    // free for small space
+    inline auto SmallFree(void* address) noexcept { 
+        return std::free(address ? reinterpret_cast<char*>(address) - DEBUG_LENGTH : nullptr); 
+    }
+#elif defined(LONGUI_WITH_DLMALLOC)
+    // alloc for small space
+    inline auto SmallAlloc(size_t length) noexcept { return ::dlmalloc(length); }
+    // free for small space
+    inline auto SmallFree(void* address) noexcept { return ::dlfree(address); }
+#else
+    // alloc for small space
+    inline auto SmallAlloc(size_t length) noexcept { return std::malloc(length); }
+    // free for small space
+    inline auto SmallFree(void* address) noexcept { return std::free(address); }
+#endif
+    // template helper
+    template<typename T> inline auto NormalAllocT(size_t length) noexcept {
+        return reinterpret_cast<T*>(LongUI::NormalAlloc(length * sizeof(T))); 
+    }
+    // template helper
+    template<typename T> inline auto SmallAllocT(size_t length) noexcept { 
+        return reinterpret_cast<T*>(LongUI::SmallAlloc(length * sizeof(T))); 
+    }
+}
@@ -0,0 +1,75 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// 不依赖 luibase/luiconf, 可单独编译测试
+#include <cstdint>
+
+// longui namespace
+namespace LongUI {
+    // item of enum attribute value, tables sorted by name
+    struct EnumItem { const char* name; uint32_t value; };
+    // table of enum attribute values
+    enum class EnumTable : uint32_t {
+        // AnimationType
+        Table_AnimationType = 0,
+        // BitmapRenderRule
+        Table_BitmapRenderRule,
+        // RenderRule
+        Table_RenderRule,
+        // BrushType
+        Table_BrushType,
+        // RichType
+        Table_RichType,
+        // InterpolationMode
+        Table_InterpolationMode,
+        // ExtendMode
+        Table_ExtendMode,
+        // TextAntialiasMode
+        Table_TextAntialiasMode,
+        // FontStyle
+        Table_FontStyle,
+        // FontStretch
+        Table_FontStretch,
+        // FlowDirection
+        Table_FlowDirection,
+        // ReadingDirection
+        Table_ReadingDirection,
+        // WordWrapping
+        Table_WordWrapping,
+        // ParagraphAlignment
+        Table_ParagraphAlignment,
+        // TextAlignment
+        Table_TextAlignment,
+        // CheckBoxState
+        Table_CheckBoxState,
+        // count of tables
+        TABLE_COUNT,
+    };
+    // get table of enum attribute values
+    auto GetEnumTable(EnumTable table, uint32_t& count) noexcept -> const EnumItem*;
+    // get enum value from name or decimal number, bad_match if not found
+    auto LookupEnum(const char* value, EnumTable table, uint32_t bad_match) noexcept -> uint32_t;
+}
@@ -24,8 +24,32 @@
 * OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include "luiPlConf.h"
 #include "../LongUI/luiUiStrAl.h"
+#include <type_traits>
+#include <iterator>
+#include <utility>
 #include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <cwchar>
+#include <new>
+
+// longui namespace
+namespace LongUI {
+    // lengthof
+    template<typename T, size_t COUNT> constexpr auto lengthof(T (&)[COUNT]) { return COUNT; }
+    // lengthof
+    template<typename Y, typename T, size_t COUNT> constexpr auto lengthof(T (&)[COUNT]) { return Y(COUNT); }
+    // BKDR Hash
+    auto BKDRHash(const char* str) noexcept ->uint32_t;
+    // BKDR Hash
+    auto BKDRHash(const wchar_t* str) noexcept ->uint32_t;
+    // BKDR Hash
+    inline auto BKDRHash(const char* str, uint32_t size) noexcept { return BKDRHash(str) % size; }
+    // BKDR Hash
+    inline auto BKDRHash(const wchar_t* str, uint32_t size) noexcept { return BKDRHash(str) % size; }
+}
 
 // longui::ezcontainer namespace, just store EASY data(no ctor/dtor)
 namespace LongUI { namespace EzContainer {
@@ -282,6 +306,7 @@ namespace LongUI { namespace EzContainer {
                     else {
                         m_ppUnitTable[index] = unext;
                     }
+                    this->free_unit(unit);
                     --m_cCount;
                     return true;
                 }
@@ -357,8 +382,171 @@ namespace LongUI { namespace EzContainer {
         // Unit Allocator
         UnitAllocator           m_oUnitAllocator;
     };
-    // Easy Vector
-    template<typename T> class EzVector {
+    // string hash map, open addressing with robin hood probing
+    template<typename K, typename V>
+    class EzStringMap {
+    public:
+        // unit, stored in table directly
+        struct Unit { const K* key; V value; uint32_t hash; };
+    private:
+        // unsigned char type
+        using UK = typename std::make_unsigned<K>::type;
+        // hash code for empty unit, min capacity
+        enum : uint32_t { EMPTY_HASH = 0, MIN_CAPACITY = 16 };
+        // string length
+        static auto strlength(const char* str) noexcept { return static_cast<uint32_t>(std::strlen(str)); }
+        // string length
+        static auto strlength(const wchar_t* str) noexcept { return static_cast<uint32_t>(std::wcslen(str)); }
+        // hash for string view, never be EMPTY_HASH
+        static auto hash(const K* str, uint32_t len) noexcept {
+            constexpr uint32_t seed = 131;
+            uint32_t code = 0;
+            for (auto end = str + len; str != end; ++str) code = code * seed + UK(*str);
+            // BKDR 低位分布较差, 容量为2的幂时需要混合
+            code ^= code >> 16; code *= 0x85ebca6bu;
+            code ^= code >> 13; code *= 0xc2b2ae35u;
+            code ^= code >> 16;
+            return code == EMPTY_HASH ? uint32_t(1) : code;
+        }
+        // key equal to string view?
+        static bool equal(const K* key, const K* str, uint32_t len) noexcept {
+            for (uint32_t i = 0; i != len; ++i) if (key[i] != str[i]) return false;
+            return !key[len];
+        }
+        // distance from ideal position
+        auto distance(uint32_t code, uint32_t index) const noexcept { return (index - code) & (m_cCapacity - 1); }
+    public:
+        // ctor
+        EzStringMap() noexcept = default;
+        // cpoy ctor
+        EzStringMap(const EzStringMap&) = delete;
+        // dtor
+        ~EzStringMap() noexcept { this->Clear(); }
+        // clear
+        void Clear() noexcept {
+            LongUI::NormalFree(m_pTable);
+            m_pTable = nullptr;
+            m_cCount = m_cCapacity = 0;
+        }
+        // for each, call with Unit*
+        template<typename T> void ForEach(T lam) noexcept {
+            for (auto itr = m_pTable; itr != m_pTable + m_cCapacity; ++itr) {
+                if (itr->hash != EMPTY_HASH) lam(itr);
+            }
+        }
+        // size
+        auto GetCount() const noexcept { return m_cCount; }
+        // isok
+        auto IsOk() const noexcept { return !!m_pTable; }
+        // find
+        auto Find(const K* str) const noexcept ->V* { return this->Find(str, strlength(str)); }
+        // find with string view, str need not be null-terminated
+        auto Find(const K* str, uint32_t len) const noexcept ->V* {
+            const auto unit = this->find(str, len);
+            return unit ? &unit->value : nullptr;
+        }
+        // remove, backward shift instead of tombstone
+        bool Remove(const K* str) noexcept {
+            auto unit = this->find(str, strlength(str));
+            if (!unit) { assert(!"not found"); return false; }
+            const auto mask = m_cCapacity - 1;
+            auto index = static_cast<uint32_t>(unit - m_pTable);
+            while (true) {
+                const auto next = (index + 1) & mask;
+                const auto& nunit = m_pTable[next];
+                if (nunit.hash == EMPTY_HASH || !this->distance(nunit.hash, next)) break;
+                m_pTable[index] = nunit;
+                index = next;
+            }
+            m_pTable[index].hash = EMPTY_HASH;
+            --m_cCount;
+            return true;
+        }
+        // insert
+        bool Insert(const K* key, const V& v) noexcept {
+#ifdef _DEBUG
+            assert(this->Find(key) == nullptr && "existed!");
+#endif
+            // 负载因子 7/8
+            if ((m_cCount + 1) * 8 > m_cCapacity * 7) {
+                if (!this->Reserve(m_cCapacity ? m_cCapacity * 2 : MIN_CAPACITY)) return false;
+            }
+            this->insert(Unit{ key, v, hash(key, strlength(key)) });
+            return true;
+        }
+        // reserve, capacity will be power of 2
+        bool Reserve(size_t newc) noexcept {
+            uint32_t cap = MIN_CAPACITY;
+            while (cap < newc) cap <<= 1;
+            if (cap <= m_cCapacity) return false;
+            auto newtable = LongUI::NormalAllocT<Unit>(cap);
+            if (!newtable) return false;
+            std::memset(newtable, 0, sizeof(Unit) * cap);
+            const auto oldtable = m_pTable;
+            const auto oldcap = m_cCapacity;
+            const auto oldcount = m_cCount;
+            m_pTable = newtable;
+            m_cCapacity = cap;
+            m_cCount = 0;
+            for (auto itr = oldtable; itr != oldtable + oldcap; ++itr) {
+                if (itr->hash != EMPTY_HASH) this->insert(*itr);
+            }
+            LongUI::NormalFree(oldtable);
+            assert(oldcount == m_cCount && "bad action");
+            (void)oldcount;
+            return true;
+        }
+    private:
+        // find unit
+        auto find(const K* str, uint32_t len) const noexcept ->Unit* {
+            if (!m_cCount) return nullptr;
+            const auto code = hash(str, len);
+            const auto mask = m_cCapacity - 1;
+            auto index = code & mask;
+            for (uint32_t dist = 0; ; ++dist, index = (index + 1) & mask) {
+                const auto unit = m_pTable + index;
+                // 空位或者更"富有"的单元, 不存在
+                if (unit->hash == EMPTY_HASH || this->distance(unit->hash, index) < dist) return nullptr;
+                if (unit->hash == code && equal(unit->key, str, len)) return unit;
+            }
+        }
+        // insert unit, table must have space
+        void insert(Unit unit) noexcept {
+            assert(m_pTable && m_cCount < m_cCapacity && "bad action");
+            const auto mask = m_cCapacity - 1;
+            auto index = unit.hash & mask;
+            for (uint32_t dist = 0; ; ++dist, index = (index + 1) & mask) {
+                auto& now = m_pTable[index];
+                if (now.hash == EMPTY_HASH) { now = unit; ++m_cCount; return; }
+                // 劫富济贫
+                const auto nowdist = this->distance(now.hash, index);
+                if (nowdist < dist) { std::swap(now, unit); dist = nowdist; }
+            }
+        }
+    private:
+        // size
+        uint32_t                m_cCount = 0;
+        // capacity, power of 2
+        uint32_t                m_cCapacity = 0;
+        // Unit table
+        Unit*                   m_pTable = nullptr;
+    };
+    // inline buffer for EzVector
+    template<typename T, uint32_t InlineSize> struct EzVectorBuffer {
+        // inline data
+        auto inline_data() noexcept { return reinterpret_cast<T*>(m_buffer); }
+        // buffer
+        alignas(T) char     m_buffer[sizeof(T) * InlineSize];
+    };
+    // no inline buffer
+    template<typename T> struct EzVectorBuffer<T, 0> {
+        // inline data
+        auto inline_data() noexcept { return static_cast<T*>(nullptr); }
+    };
+    // Easy Vector, with inline capacity if InlineSize > 0
+    template<typename T, uint32_t InlineSize = 0> class EzVector : EzVectorBuffer<T, InlineSize> {
+        // memcpy/memmove only
+        static_assert(std::is_trivially_copyable<T>::value, "EzVector stores trivially relocatable data only");
     public:
         // iterator
         template<typename TT=T> struct Iterator {
@@ -424,17 +612,20 @@ namespace LongUI { namespace EzContainer {
         };
     public:
         // ctor
-        EzVector() noexcept = default;
+        EzVector() noexcept : m_pData(this->inline_data()), m_cCapacity(InlineSize) {}
         // dtor
         ~EzVector() noexcept { this->safe_free(); }
         // no copy ctor
-        EzVector(const EzVector<T>&) = delete;
+        EzVector(const EzVector&) = delete;
         // move ctor
-        EzVector(EzVector<T>&& v) noexcept;
+        EzVector(EzVector&& v) noexcept : EzVector() { this->move_from(v); }
         // operator =(copy)
-        auto& operator=(const EzVector<T>&) = delete;
+        auto& operator=(const EzVector&) = delete;
         // operator =(move)
-        auto operator=(EzVector<T>&& v) noexcept -> EzVector<T>&;
+        auto operator=(EzVector&& v) noexcept -> EzVector& {
+            if (this != &v) { this->safe_free(); this->move_from(v); }
+            return *this;
+        }
     public:
         // begin
         auto begin() noexcept { return Iterator<T>(m_pData); }
@@ -456,14 +647,20 @@ namespace LongUI { namespace EzContainer {
         // back
         auto&back() const noexcept { assert(m_cLength && "no elements"); return m_pData[m_cLength - 1]; }
         // insert
-        auto insert(uint32_t pos,const T& data) noexcept { this->do_insert(pos, data); }
+        auto insert(uint32_t pos,const T& data) noexcept { T tmp(data); this->insert(pos, &tmp, 1); }
+        // insert range [first, first + len), could not be inside this
+        void insert(uint32_t pos, const T* first, uint32_t len) noexcept;
         // insert
         template<typename TT>
-        auto insert(const Iterator<TT>& itr,const T& data) noexcept { this->do_insert(uint32_t(&(*itr)-m_pData), data); }
+        auto insert(const Iterator<TT>& itr,const T& data) noexcept { this->insert(uint32_t(&(*itr)-m_pData), data); }
         // push back with data
-        auto push_back(const T& data) noexcept { this->do_insert(this->size(), data); }
+        auto push_back(const T& data) noexcept { 
+            // 容量足够时直接写入, 否则走区间插入
+            if (m_cLength < m_cCapacity) m_pData[m_cLength++] = data;
+            else this->insert(this->size(), data);
+        }
         // push back
-        auto push_back() noexcept { this->do_insert(this->size(), T()); }
+        auto push_back() noexcept { this->push_back(T()); }
         // pop back
         auto pop_back() noexcept { assert(m_cLength > 0 && "no element to pop"); --m_cLength; }
         // clear
@@ -471,13 +668,13 @@ namespace LongUI { namespace EzContainer {
         // empty
         auto empty() const noexcept { return !m_cLength; }
         // newsize
-        auto newsize(uint32_t len) noexcept { this->reserve(len); m_cLength = len; }
+        auto newsize(uint32_t len) noexcept { this->grow(len); if (this->isok()) m_cLength = len; }
         // resize
         void resize(uint32_t len) noexcept;
         // erase
         auto erase(uint32_t pos) noexcept { return this->erase(pos, 1); }
         // erase with length
-        auto erase(uint32_t pos, uint32_t len) noexcept;
+        void erase(uint32_t pos, uint32_t len) noexcept;
         // erase
         template<typename TT>
         auto erase(const Iterator<TT>& itr) noexcept { return this->erase(uint32_t(&(*itr)-m_pData), 1); }
@@ -494,8 +691,10 @@ namespace LongUI { namespace EzContainer {
         auto size() const noexcept { return m_cLength; }
         // get capacity
         auto capacity() const noexcept { return m_cCapacity; }
-        // reserve length
-        void reserve(uint32_t len) noexcept;
+        // reserve length, exactly
+        void reserve(uint32_t len) noexcept { if (len > m_cCapacity) this->realloc(len); }
+        // shrink capacity to size, back to inline buffer if could
+        void shrink_to_fit() noexcept;
         // operator[]
         auto operator[](uint32_t index) noexcept -> T& { assert(index < this->size() && "out of range"); return m_pData[index]; }
         // operator[] const
@@ -508,91 +707,122 @@ namespace LongUI { namespace EzContainer {
         // capacity
         uint32_t            m_cCapacity = 0;
     private:
+        // is inline
+        inline bool is_inline() noexcept { return InlineSize && m_pData == this->inline_data(); }
         // safe free
-        inline auto safe_free() noexcept { if (m_pData) LongUI::SmallFree(m_pData); m_pData = nullptr; }
+        inline auto safe_free() noexcept { 
+            if (m_pData && !this->is_inline()) LongUI::SmallFree(m_pData); 
+            m_pData = this->inline_data(); m_cLength = 0; m_cCapacity = InlineSize;
+        }
         // alloc
         static inline auto alloc(uint32_t len) noexcept { return reinterpret_cast<T*>(LongUI::SmallAlloc(len * sizeof(T))); }
         // copy data
-        static inline auto copy_data(T* des, T* src, uint32_t len) noexcept {  if (des && len) std::memcpy(des, src, sizeof(T) * len); }
-        // nice length
-        static inline auto nice_length(uint32_t len) noexcept { return (len + (len + 9) / 2) & (~3); };
-        // do insert
-        void do_insert(uint32_t pos, const T& data) noexcept;
+        static inline auto copy_data(T* des, const T* src, uint32_t len) noexcept {  if (des && len) std::memcpy(des, src, sizeof(T) * len); }
+        // nice length, grow 1.5x at least
+        auto nice_length(uint32_t len) const noexcept { 
+            const auto geo = m_cCapacity + m_cCapacity / 2;
+            return ((len > geo ? len : geo) + 3) & (~3);
+        };
+        // grow for len
+        void grow(uint32_t len) noexcept { if (len > m_cCapacity) this->realloc(this->nice_length(len)); }
+        // realloc to capacity
+        void realloc(uint32_t cap) noexcept;
+        // move from other
+        void move_from(EzVector& v) noexcept;
     };
-    // Vector::move ctor
-    template<typename T> EzVector<T>::EzVector(EzVector<T>&& v) noexcept : 
-    m_pData(v.m_pData), m_cLength(v.m_cLength), m_cCapacity(v.m_cCapacity) {
-        v.m_pData = nullptr;
+    // Vector::move from
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::move_from(EzVector& v) noexcept {
+        // 内联数据只能复制
+        if (v.is_inline()) {
+            this->copy_data(m_pData, v.m_pData, v.m_cLength);
+            m_cLength = v.m_cLength;
+        }
+        else {
+            m_pData = v.m_pData;
+            m_cLength = v.m_cLength;
+            m_cCapacity = v.m_cCapacity;
+            v.m_pData = v.inline_data();
+            v.m_cCapacity = InlineSize;
+        }
         v.m_cLength = 0;
-        v.m_cCapacity = 0;
-    }
-    // Vector::= operator
-    template<typename T>
-    inline auto EzVector<T>::operator=(EzVector<T>&& v) noexcept -> EzVector<T>& {
-        std::swap(v.m_pData, m_pData);
-        std::swap(v.m_cLength, m_cLength);
-        std::swap(v.m_cCapacity, m_cCapacity);
-        return *this;
     }
-    // Vector::reserve
-    template<typename T> void EzVector<T>::reserve(uint32_t len) noexcept {
-        if (len <= this->capacity()) return;
-        auto nice_len = this->nice_length(len);
-        auto data = this->alloc(nice_len);
-        this->copy_data(data, m_pData, this->size());
+    // Vector::realloc
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::realloc(uint32_t cap) noexcept {
+        assert(cap >= m_cLength && "data lost");
+        auto data = this->alloc(cap);
+        const auto length = m_cLength;
+        this->copy_data(data, m_pData, length);
         this->safe_free();
         if (data) {
             m_pData = data;
-            m_cCapacity = nice_len;
+            m_cLength = length;
+            m_cCapacity = cap;
         }
         else {
+            // OOM: isok() -> false
+            m_pData = nullptr;
             m_cCapacity = 0;
-            m_cLength = 0;
         }
     }
+    // Vector::shrink_to_fit
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::shrink_to_fit() noexcept {
+        if (!m_pData || this->is_inline() || m_cLength == m_cCapacity) return;
+        // 回到内联缓冲区
+        if (m_cLength <= InlineSize) {
+            const auto old = m_pData;
+            const auto length = m_cLength;
+            m_pData = this->inline_data();
+            this->copy_data(m_pData, old, length);
+            LongUI::SmallFree(old);
+            m_cCapacity = InlineSize;
+            return;
+        }
+        auto data = this->alloc(m_cLength);
+        if (!data) return;
+        this->copy_data(data, m_pData, m_cLength);
+        LongUI::SmallFree(m_pData);
+        m_pData = data;
+        m_cCapacity = m_cLength;
+    }
     // Vector::erase
-    template<typename T> auto EzVector<T>::erase(uint32_t pos, uint32_t len) noexcept {
-        assert(pos < this->size() && pos + len <= this->size() && "out of range");
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::erase(uint32_t pos, uint32_t len) noexcept {
+        assert(pos <= this->size() && pos + len <= this->size() && "out of range");
         if (!(len && this->isok())) return;
-#ifdef _DEBUG
-        auto debug_begin = m_pData + this->size() - len;
-#endif
-        auto endofthis = this->size() - len;
+        const auto tail = m_cLength - pos - len;
+        std::memmove(m_pData + pos, m_pData + pos + len, sizeof(T) * tail);
         m_cLength -= len;
-        for (auto i = pos; i < endofthis; ++i) {
-            m_pData[i] = m_pData[i + len];
-        }
 #ifdef _DEBUG
-        std::memset(debug_begin, 0xcd, len);
+        std::memset(m_pData + m_cLength, 0xcd, sizeof(T) * len);
 #endif
     }
     // Vector::resize
-    template<typename T> void EzVector<T>::resize(uint32_t len) noexcept {
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::resize(uint32_t len) noexcept {
         if (len == m_cLength) return;
-        this->reserve(len);
+        this->grow(len);
         if (!this->isok()) return;
         auto old = m_cLength;
         m_cLength = len;
-        if (len < old) {
-            m_cLength = len;
-        }
-        else {
+        if (len > old) {
             std::memset(m_pData + old, 0, sizeof(T)* (len - old));
         }
     }
-    // Vector::do_insert
-    template<typename T> void EzVector<T>::do_insert(uint32_t pos, const T& data) noexcept {
+    // Vector::insert range
+    template<typename T, uint32_t InlineSize>
+    void EzVector<T, InlineSize>::insert(uint32_t pos, const T* first, uint32_t len) noexcept {
         auto old = m_cLength;
         assert(pos <= old && "out of range");
-        this->reserve(this->size() + 1);
+        assert((first + len <= m_pData || first >= m_pData + old) && "insert self");
+        if (!len) return;
+        this->grow(old + len);
         if (this->isok()) {
-            ++m_cLength;
-            if (pos != old) {
-                for (auto i = old; i != pos; --i) {
-                    m_pData[i] = m_pData[i-1];
-                }
-            }
-            m_pData[pos] = data;
+            std::memmove(m_pData + pos + len, m_pData + pos, sizeof(T) * (old - pos));
+            std::memcpy(m_pData + pos, first, sizeof(T) * len);
+            m_cLength = old + len;
         }
     }
 #ifdef _DEBUG
@@ -629,6 +859,8 @@ namespace LongUI { namespace EzContainer {
         auto&back() const noexcept {  return reinterpret_cast<T*&>(m_vector.back()); }
         // insert
         auto insert(uint32_t pos, T* dat) noexcept { return m_vector.insert(pos, (void*)(dat)); }
+        // insert range
+        auto insert(uint32_t pos, T* const* first, uint32_t len) noexcept { return m_vector.insert(pos, (void* const*)(first), len); }
         // insert
         template<typename TT>
         auto insert(const VectorType::Iterator<TT>& itr, T* dat) noexcept { return m_vector.insert(uint32_t(&(*itr) - this->data()), dat); }
@@ -666,6 +898,8 @@ namespace LongUI { namespace EzContainer {
         auto capacity() const noexcept { return m_vector.capacity(); }
         // reserve length
         auto reserve(uint32_t len) noexcept { return m_vector.reserve(len); }
+        // shrink capacity to size
+        auto shrink_to_fit() noexcept { return m_vector.shrink_to_fit(); }
         // operator[]
         auto operator[](uint32_t index) noexcept ->P& { return (P&)(m_vector[index]); }
         // operator[] const
@@ -679,10 +913,10 @@ namespace LongUI { namespace EzContainer {
 
 // longui namespace
 namespace LongUI { 
+    // control
+    class UIControl;
     // control vector
     using ControlVector = EzContainer::PointerVector<UIControl>;
     // index vector
     using IndexVector = EzContainer::EzVector<uint32_t>;
-    // String Hash Table
-    using StringTable = EzContainer::EzStringHash<char, void*>;
 }
\ No newline at end of file
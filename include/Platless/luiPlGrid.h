@@ -0,0 +1,97 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <cstddef>
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Uniform grid for hit-test, platform-free
+    /// 均匀网格命中测试: 每格平均一个物体, 格内按准备顺序保存
+    /// </summary>
+    class CUIHitTestGrid {
+    public:
+        // rect, same layout as D2D1_RECT_F
+        struct Rect { float left, top, right, bottom; };
+        // item to be indexed
+        struct Item { Rect rect; void* data; };
+    public:
+        // ctor
+        CUIHitTestGrid() noexcept = default;
+        // dtor
+        ~CUIHitTestGrid() noexcept;
+        // no copy
+        CUIHitTestGrid(const CUIHitTestGrid&) = delete;
+        // no copy
+        auto operator=(const CUIHitTestGrid&) -> CUIHitTestGrid& = delete;
+    public:
+        // prepare item buffer for count items, null if OOM
+        auto Prepare(uint32_t count) noexcept -> Item*;
+        // build grid over prepared items, false if OOM
+        bool Build(uint32_t max_side) noexcept;
+        // find first prepared item containing the point, null if not found
+        auto Find(float x, float y) const noexcept -> void*;
+        // get count of cells
+        auto GetCellCount() const noexcept { return uint32_t(m_cCol) * uint32_t(m_cRow); }
+    private:
+        // get column of x
+        auto col(float x) const noexcept { auto c = int((x - m_rcBound.left) * m_fInvCellWidth); return uint32_t(c < 0 ? 0 : (c < int(m_cCol) ? c : int(m_cCol) - 1)); }
+        // get row of y
+        auto row(float y) const noexcept { auto r = int((y - m_rcBound.top) * m_fInvCellHeight); return uint32_t(r < 0 ? 0 : (r < int(m_cRow) ? r : int(m_cRow) - 1)); }
+        // reserve buffer
+        static bool reserve(void*& buffer, uint32_t& capacity, uint32_t count, size_t unit) noexcept;
+    private:
+        // items, [item count]
+        Item*           m_pItem = nullptr;
+        // cell offset in m_pCell, [cell count + 1]
+        uint32_t*       m_pOffset = nullptr;
+        // fill cursor of each cell, [cell count]
+        uint32_t*       m_pCursor = nullptr;
+        // item index in each cell
+        uint32_t*       m_pCell = nullptr;
+        // capacity of m_pItem
+        uint32_t        m_cItemCapacity = 0;
+        // capacity of m_pOffset
+        uint32_t        m_cOffsetCapacity = 0;
+        // capacity of m_pCursor
+        uint32_t        m_cCursorCapacity = 0;
+        // capacity of m_pCell
+        uint32_t        m_cCellCapacity = 0;
+        // count of items
+        uint32_t        m_cItem = 0;
+        // column count
+        uint16_t        m_cCol = 0;
+        // row count
+        uint16_t        m_cRow = 0;
+        // bounding rect of all items
+        Rect            m_rcBound = { 0.f, 0.f, 0.f, 0.f };
+        // reciprocal of cell width
+        float           m_fInvCellWidth = 0.f;
+        // reciprocal of cell height
+        float           m_fInvCellHeight = 0.f;
+    };
+}
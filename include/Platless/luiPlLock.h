@@ -0,0 +1,55 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <atomic>
+#include <cstdint>
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Spin lock for short critical sections, pause then yield while contended
+    /// 自旋锁: 竞争时先 pause 指数退避, 之后让出时间片, 不依赖 luibase/luiconf
+    /// </summary>
+    class CUISpinLock {
+    public:
+        // ctor
+        CUISpinLock() noexcept = default;
+        // no copy ctor
+        CUISpinLock(const CUISpinLock&) = delete;
+        // lock
+        void Lock() noexcept { if (m_bLocked.exchange(true, std::memory_order_acquire)) this->lock_slow(); }
+        // try to lock, false if locked by others
+        bool TryLock() noexcept { return !m_bLocked.load(std::memory_order_relaxed) && !m_bLocked.exchange(true, std::memory_order_acquire); }
+        // unlock
+        void Unlock() noexcept { m_bLocked.store(false, std::memory_order_release); }
+    private:
+        // lock with backoff
+        void lock_slow() noexcept;
+    private:
+        // locked
+        std::atomic<bool>       m_bLocked{ false };
+    };
+}
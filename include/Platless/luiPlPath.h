@@ -0,0 +1,149 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "luiPlEzC.h"
+#include "luiPlLock.h"
+#include <cstdint>
+#include <cassert>
+#include <atomic>
+
+// longui::svg namespace
+namespace LongUI { namespace SVG {
+    // command of compiled path, coordinates are absolute
+    enum class PathCommand : uint8_t {
+        // move to: x, y
+        Command_Move = 0,
+        // line to: x, y
+        Command_Line,
+        // cubic bezier: x1, y1, x2, y2, x, y
+        Command_Bezier,
+        // quadratic bezier: x1, y1, x, y
+        Command_Quadratic,
+        // elliptical arc: rx, ry, rotation, large-arc, sweep, x, y
+        Command_Arc,
+        // close path
+        Command_Close,
+    };
+    // count of float for command
+    inline auto GetPathCommandFloats(PathCommand cmd) noexcept -> uint32_t {
+        const uint8_t COUNT[] = { 2, 2, 6, 4, 7, 0 };
+        assert(uint8_t(cmd) < sizeof(COUNT) && "out of range");
+        return COUNT[uint8_t(cmd)];
+    }
+    // point of flattened path
+    struct PathPoint { float x, y; };
+    // contour of flattened path
+    struct PathContour { uint32_t first, count; bool closed; };
+    /// <summary>
+    /// Compiled path, parsed once and replayed into any sink
+    /// 编译后的路径: 命令数组 + 浮点数组, 与平台无关
+    /// </summary>
+    struct PathIR {
+        // commands
+        EzContainer::EzVector<PathCommand>  commands;
+        // arguments of commands
+        EzContainer::EzVector<float>        data;
+        // clear
+        void Clear() noexcept { commands.clear(); data.clear(); }
+        /// <summary>
+        /// Replays commands into sink.
+        /// sink need: Move(const float*), Line(const float*), Bezier(const float*),
+        /// Quadratic(const float*), Arc(const float*), Close()
+        /// </summary>
+        /// <param name="sink">The sink.</param>
+        /// <returns></returns>
+        template<typename Sink> void Replay(Sink& sink) const noexcept {
+            auto args = data.data();
+            for (const auto cmd : commands) {
+                switch (cmd)
+                {
+                case PathCommand::Command_Move:      sink.Move(args); break;
+                case PathCommand::Command_Line:      sink.Line(args); break;
+                case PathCommand::Command_Bezier:    sink.Bezier(args); break;
+                case PathCommand::Command_Quadratic: sink.Quadratic(args); break;
+                case PathCommand::Command_Arc:       sink.Arc(args); break;
+                case PathCommand::Command_Close:     sink.Close(); break;
+                }
+                args += GetPathCommandFloats(cmd);
+            }
+        }
+    };
+    // compile svg path string into ir, return false if out of memory
+    bool CompilePath(const char* path, PathIR& ir) noexcept;
+    // flatten ir into polylines with tolerance, return false if out of memory
+    bool FlattenPath(const PathIR& ir, float tolerance,
+        EzContainer::EzVector<PathPoint>& points,
+        EzContainer::EzVector<PathContour>& contours) noexcept;
+    /// <summary>
+    /// Cache of compiled path, keyed by path string, thread safe
+    /// 路径缓存, 设备重建时无需重新解析; 超出预算时淘汰最久未使用的路径
+    /// </summary>
+    class CUIPathCache {
+        // entry of cache, key stored after it
+        struct Entry;
+    public:
+        // ctor
+        CUIPathCache(size_t budget) noexcept : m_cBudget(budget) {}
+        // no copy ctor
+        CUIPathCache(const CUIPathCache&) = delete;
+        // dtor
+        ~CUIPathCache() noexcept { this->Clear(); }
+        // acquire compiled path, compile and cache if not exist, null if failed
+        auto Acquire(const char* path) noexcept -> const PathIR*;
+        // release path from Acquire, evicted path is freed here
+        void Release(const PathIR* ir) noexcept;
+        // clear all, acquired paths are freed when released
+        void Clear() noexcept;
+        // count of paths cached
+        auto GetCount() const noexcept { this->lock(); const auto c = m_map.GetCount(); this->unlock(); return c; }
+        // bytes of paths cached
+        auto GetBytes() const noexcept { this->lock(); const auto c = m_cBytes; this->unlock(); return c; }
+    private:
+        // lock
+        void lock() const noexcept { m_lock.Lock(); }
+        // unlock
+        void unlock() const noexcept { m_lock.Unlock(); }
+        // evict least recently used ones over budget, keep the entry
+        void evict(Entry* keep) noexcept;
+        // drop entry from cache, free it if not acquired
+        void drop(Entry* entry) noexcept;
+        // free entry
+        static void free_entry(Entry* entry) noexcept;
+    private:
+        // path string -> entry
+        EzContainer::EzStringMap<char, Entry*>      m_map;
+        // most recently used entry
+        Entry*                                      m_pHead = nullptr;
+        // least recently used entry
+        Entry*                                      m_pTail = nullptr;
+        // bytes of entries cached
+        size_t                                      m_cBytes = 0;
+        // budget in bytes
+        size_t const                                m_cBudget;
+        // spin lock
+        mutable CUISpinLock                         m_lock;
+    };
+}}
@@ -0,0 +1,138 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../luibase.h"
+#include "../luiconf.h"
+#include "luiPlLock.h"
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Size-class slab pool for controls, owned by window
+    /// 控件内存池: 按大小分级的块分配, 窗口持有, 窗口与全部对象释放后整体归还
+    /// </summary>
+    class CUIObjectPool {
+    public:
+        // count of size classes, the last one is for large object
+        enum : uint32_t { CLASS_COUNT = 10, CLASS_LARGE = CLASS_COUNT - 1 };
+        // size of object header
+        enum : size_t { HEADER_SIZE = 16 };
+        // statistics
+        struct Statistics {
+            // count of live objects for each size class
+            uint32_t    live_count[CLASS_COUNT];
+            // count of slabs for each size class
+            uint32_t    slab_count[CLASS_COUNT];
+            // bytes requested by live objects, header excluded
+            size_t      live_bytes;
+            // bytes of slots held by live objects, header included
+            size_t      used_bytes;
+            // bytes of all slabs and large objects
+            size_t      total_bytes;
+            // fragmentation: 1 - live_bytes / total_bytes
+            float       fragmentation;
+        };
+        // slot size of size class
+        static auto GetClassSize(uint32_t index) noexcept -> size_t;
+        // create pool, null if OOM
+        static auto Create() noexcept -> CUIObjectPool*;
+        // get default pool, for objects created out of any window
+        static auto GetDefault() noexcept -> CUIObjectPool&;
+        // get current pool of this thread, default pool if not set
+        static auto GetCurrent() noexcept -> CUIObjectPool&;
+        // allocate in current pool of this thread
+        static auto AllocCurrent(size_t size) noexcept -> void* { return GetCurrent().Alloc(size); }
+        // free object allocated by any pool
+        static void Free(void* address) noexcept;
+    public:
+        // release by owner, pool freed after the last object
+        void Release() noexcept;
+        // allocate, null if OOM
+        auto Alloc(size_t size) noexcept -> void*;
+        // get statistics
+        void GetStatistics(Statistics& stat) const noexcept;
+        // get count of live objects
+        auto GetLiveCount() const noexcept -> uint32_t;
+    private:
+        // slab, slots follow
+        struct Slab;
+        // header of object
+        struct Header;
+        // ctor
+        CUIObjectPool() noexcept = default;
+        // no copy ctor
+        CUIObjectPool(const CUIObjectPool&) = delete;
+        // dtor
+        ~CUIObjectPool() noexcept;
+        // free object
+        void free_object(Header* header) noexcept;
+        // lock
+        void lock() const noexcept { m_lock.Lock(); }
+        // unlock
+        void unlock() const noexcept { m_lock.Unlock(); }
+        // release reference, destroy this if the last one
+        void release_ref() noexcept;
+    private:
+        // slab list with free slot for each size class
+        Slab*                   m_apPartial[CLASS_COUNT] = { nullptr };
+        // full slab list for each size class
+        Slab*                   m_apFull[CLASS_COUNT] = { nullptr };
+        // count of slabs for each size class, large object for last one
+        uint32_t                m_acSlab[CLASS_COUNT] = { 0 };
+        // count of live objects for each size class
+        uint32_t                m_acLive[CLASS_COUNT] = { 0 };
+        // bytes requested by live objects
+        size_t                  m_cLiveBytes = 0;
+        // bytes of slots held by live objects
+        size_t                  m_cUsedBytes = 0;
+        // bytes of all slabs and large objects
+        size_t                  m_cTotalBytes = 0;
+        // reference count: 1 for owner and 1 for each live object
+        std::atomic<uint32_t>   m_cRef{ 1 };
+        // keep last empty slab of each size class, false for default pool
+        bool                    m_bKeepSlab = true;
+        // spin lock
+        mutable CUISpinLock     m_lock;
+    };
+    /// <summary>
+    /// Set current pool of this thread in scope
+    /// </summary>
+    class CUIObjectPoolScope {
+    public:
+        // ctor, keep current pool if null
+        CUIObjectPoolScope(CUIObjectPool* pool) noexcept;
+        // no copy ctor
+        CUIObjectPoolScope(const CUIObjectPoolScope&) = delete;
+        // dtor
+        ~CUIObjectPoolScope() noexcept;
+    private:
+        // old pool
+        CUIObjectPool*          m_pOld;
+    };
+}
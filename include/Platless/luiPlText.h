@@ -0,0 +1,426 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "luiPlEzC.h"
+#include <cstdint>
+#include <cassert>
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Piece table text buffer, pieces kept in an implicit treap
+    /// 片段表文本缓冲区: 插入/删除/行号查询均为 O(log n)
+    /// </summary>
+    class CUITextBuffer {
+        // node index, 0 for null
+        using Index = uint32_t;
+        // piece node
+        struct Node {
+            // children
+            Index       left, right;
+            // treap priority
+            uint32_t    priority;
+            // start in buffer
+            uint32_t    start;
+            // length of piece
+            uint32_t    length;
+            // count of line feed in piece
+            uint32_t    lines;
+            // length of subtree
+            uint32_t    sum_length;
+            // count of line feed in subtree
+            uint32_t    sum_lines;
+            // in add buffer?
+            bool        add;
+        };
+        // buffer with line feed index
+        struct Buffer {
+            // text
+            EzContainer::EzVector<wchar_t>  text;
+            // position of line feeds, ascending
+            EzContainer::EzVector<uint32_t> feeds;
+        };
+    public:
+        // ctor
+        CUITextBuffer() noexcept;
+        // no copy ctor
+        CUITextBuffer(const CUITextBuffer&) = delete;
+        // dtor
+        ~CUITextBuffer() noexcept = default;
+        // set whole text, return false if out of memory
+        bool SetText(const wchar_t* str, uint32_t len) noexcept;
+        // insert text, return false if out of memory
+        bool Insert(uint32_t pos, const wchar_t* str, uint32_t len) noexcept;
+        // remove text
+        void Remove(uint32_t pos, uint32_t len) noexcept;
+        // clear
+        void Clear() noexcept { this->SetText(nullptr, 0); }
+        // length of text
+        auto GetLength() const noexcept { return m_nodes[m_root].sum_length; }
+        // count of lines, line feed count + 1
+        auto GetLineCount() const noexcept { return m_nodes[m_root].sum_lines + 1; }
+        // start position of line
+        auto GetLineStart(uint32_t line) const noexcept -> uint32_t;
+        // end position of line, line feed not included
+        auto GetLineEnd(uint32_t line) const noexcept -> uint32_t;
+        // line of position
+        auto GetLineFromPosition(uint32_t pos) const noexcept -> uint32_t;
+        // char at position
+        auto GetChar(uint32_t pos) const noexcept -> wchar_t;
+        // copy text in range, return count copied
+        auto CopyTo(uint32_t pos, uint32_t len, wchar_t* buf) const noexcept -> uint32_t;
+        // count of pieces
+        auto GetPieceCount() const noexcept { return m_nodes.size() - 1 - m_free.size(); }
+    private:
+        // buffer of node
+        auto buffer(const Node& n) const noexcept -> const Buffer& { return n.add ? m_add : m_original; }
+        // count line feeds in buffer range
+        static auto count_lines(const Buffer& b, uint32_t begin, uint32_t end) noexcept -> uint32_t;
+        // update sum
+        void update(Index i) noexcept;
+        // reserve nodes, new_node will not fail after this
+        bool reserve_nodes(uint32_t count) noexcept;
+        // new node, call reserve_nodes first
+        auto new_node(bool add, uint32_t start, uint32_t length) noexcept -> Index;
+        // free subtree
+        void free_tree(Index i) noexcept;
+        // split by position
+        void split(Index t, uint32_t pos, Index& l, Index& r) noexcept;
+        // merge
+        auto merge(Index l, Index r) noexcept -> Index;
+        // try to extend the last piece of tree for typing
+        bool extend_last(Index t, uint32_t start, uint32_t len, uint32_t lines) noexcept;
+        // copy text of subtree in [pos, end)
+        void copy_to(Index t, uint32_t pos, uint32_t end, wchar_t*& out) const noexcept;
+        // append to buffer
+        static bool append(Buffer& b, const wchar_t* str, uint32_t len) noexcept;
+    private:
+        // nodes, [0] is null node stored inline
+        EzContainer::EzVector<Node, 1>  m_nodes;
+        // free list
+        EzContainer::EzVector<Index>    m_free;
+        // original buffer
+        Buffer                          m_original;
+        // add buffer, append only
+        Buffer                          m_add;
+        // root
+        Index                           m_root = 0;
+        // random seed
+        uint32_t                        m_seed = 0x9E3779B9;
+    };
+    /// <summary>
+    /// Layouter for paragraph, implemented by the platform text engine
+    /// 段落布局器, 由具体文本引擎实现
+    /// </summary>
+    class XUIParagraphLayouter {
+    public:
+        // create layout for paragraph, null if failed
+        virtual auto CreateLayout(const wchar_t* text, uint32_t length) noexcept -> void* = 0;
+        // destroy layout
+        virtual void DestroyLayout(void* layout) noexcept = 0;
+        // get height of layout
+        virtual auto GetLayoutHeight(void* layout) noexcept -> float = 0;
+        // format new layout before measuring, position is start of paragraph in buffer
+        virtual void FormatLayout(void* layout, uint32_t position, uint32_t length) noexcept { }
+    };
+    /// <summary>
+    /// Paragraph layouts of text buffer, only affected paragraphs relaid out
+    /// 段落布局缓存: 编辑只使受影响的段落失效
+    /// </summary>
+    class CUIParagraphLayouts {
+        // paragraph
+        struct Paragraph {
+            // layout
+            void*       layout;
+            // top of paragraph
+            float       top;
+            // height of paragraph
+            float       height;
+            // need relayout
+            bool        dirty;
+        };
+    public:
+        // ctor
+        CUIParagraphLayouts(XUIParagraphLayouter& layouter) noexcept : m_layouter(layouter) {}
+        // no copy ctor
+        CUIParagraphLayouts(const CUIParagraphLayouts&) = delete;
+        // dtor
+        ~CUIParagraphLayouts() noexcept { this->Clear(); }
+        // clear all layouts
+        void Clear() noexcept;
+        // reset to text buffer, all paragraphs dirty
+        bool Reset(const CUITextBuffer& buffer) noexcept;
+        // insert text into buffer and invalidate affected paragraphs
+        bool Insert(CUITextBuffer& buffer, uint32_t pos, const wchar_t* str, uint32_t len) noexcept;
+        // remove text from buffer and invalidate affected paragraphs
+        void Remove(CUITextBuffer& buffer, uint32_t pos, uint32_t len) noexcept;
+        // relayout dirty paragraphs, return count of paragraphs relaid out
+        auto Relayout(const CUITextBuffer& buffer) noexcept -> uint32_t;
+        // remeasure heights of all layouts changed in place, e.g. max width
+        void Remeasure() noexcept;
+        // count of paragraphs
+        auto GetCount() const noexcept { return m_paragraphs.size(); }
+        // get layout of paragraph
+        auto GetLayout(uint32_t i) const noexcept { return m_paragraphs[i].layout; }
+        // get top of paragraph, valid after relayout
+        auto GetTop(uint32_t i) const noexcept { return m_paragraphs[i].top; }
+        // get total height, valid after relayout
+        auto GetHeight() const noexcept { return m_fHeight; }
+        // find paragraph at y, valid after relayout
+        auto HitTest(float y) const noexcept -> uint32_t;
+    private:
+        // mark range dirty
+        void mark_dirty(uint32_t begin, uint32_t end) noexcept;
+    private:
+        // layouter
+        XUIParagraphLayouter&               m_layouter;
+        // paragraphs, one for each line
+        EzContainer::EzVector<Paragraph>    m_paragraphs;
+        // scratch buffer for paragraph text
+        EzContainer::EzVector<wchar_t>      m_scratch;
+        // total height
+        float                               m_fHeight = 0.f;
+        // dirty range begin
+        uint32_t                            m_uDirtyBegin = 0;
+        // dirty range end, empty if not greater than begin
+        uint32_t                            m_uDirtyEnd = 0;
+    };
+    /// <summary>
+    /// Undo history of text, stores only inserted/removed ranges
+    /// 文本撤销历史: 只记录插入/删除的区间与文本, 不保存快照
+    /// </summary>
+    class CUITextHistory {
+    public:
+        // operation
+        enum Operation : uint16_t { Op_Insert = 0, Op_Remove };
+    private:
+        // flag of record
+        enum RecordFlag : uint16_t {
+            // none
+            Flag_None = 0,
+            // undo/redo together with previous record
+            Flag_Chained = 1 << 0,
+            // no more merging
+            Flag_Sealed = 1 << 1,
+        };
+        // record, text stored in m_text
+        struct Record { uint32_t position, length, offset; Operation op; uint16_t flags; };
+    public:
+        // ctor
+        CUITextHistory(size_t limit) noexcept : m_cLimit(limit) {}
+        // no copy ctor
+        CUITextHistory(const CUITextHistory&) = delete;
+        // record insertion, text is the inserted string
+        void RecordInsert(uint32_t pos, const wchar_t* text, uint32_t len) noexcept { this->record(Op_Insert, pos, text, len); }
+        // record removal, text is the removed string
+        void RecordRemove(uint32_t pos, const wchar_t* text, uint32_t len) noexcept { this->record(Op_Remove, pos, text, len); }
+        // stop merging into last record
+        void Seal() noexcept { if (m_uCursor) m_records[m_uCursor - 1].flags |= Flag_Sealed; }
+        // begin group, records in group undo/redo together
+        void BeginGroup() noexcept { if (!m_cGroup++) m_bGroupHead = true; }
+        // end group
+        void EndGroup() noexcept { assert(m_cGroup && "bad action"); --m_cGroup; }
+        // clear
+        void Clear() noexcept;
+        // set memory limit in byte
+        void SetLimit(size_t limit) noexcept { m_cLimit = limit; this->trim(); }
+        // can undo?
+        bool CanUndo() const noexcept { return !!m_uCursor; }
+        // can redo?
+        bool CanRedo() const noexcept { return m_uCursor < m_records.size(); }
+        // memory used in byte
+        auto GetMemoryUsage() const noexcept -> size_t {
+            return m_records.capacity() * sizeof(Record) + m_text.capacity() * sizeof(wchar_t);
+        }
+        /// <summary>
+        /// Undoes last step, calls lam(op, pos, text, len) to apply on text.
+        /// </summary>
+        /// <param name="lam">The lambda.</param>
+        /// <returns>false if nothing to undo</returns>
+        template<typename Lam> bool Undo(Lam lam) noexcept {
+            if (!m_uCursor) return false;
+            m_bApplying = true;
+            while (m_uCursor) {
+                auto& r = m_records[--m_uCursor];
+                r.flags |= Flag_Sealed;
+                lam(r.op == Op_Insert ? Op_Remove : Op_Insert, r.position, m_text.data() + r.offset, r.length);
+                if (!(r.flags & Flag_Chained)) break;
+            }
+            m_bApplying = false;
+            return true;
+        }
+        /// <summary>
+        /// Redoes next step, calls lam(op, pos, text, len) to apply on text.
+        /// </summary>
+        /// <param name="lam">The lambda.</param>
+        /// <returns>false if nothing to redo</returns>
+        template<typename Lam> bool Redo(Lam lam) noexcept {
+            if (m_uCursor >= m_records.size()) return false;
+            m_bApplying = true;
+            do {
+                const auto& r = m_records[m_uCursor++];
+                lam(r.op, r.position, m_text.data() + r.offset, r.length);
+            } while (m_uCursor < m_records.size() && (m_records[m_uCursor].flags & Flag_Chained));
+            m_bApplying = false;
+            return true;
+        }
+    private:
+        // record operation
+        void record(Operation op, uint32_t pos, const wchar_t* text, uint32_t len) noexcept;
+        // merge into last record
+        bool merge(Operation op, uint32_t pos, const wchar_t* text, uint32_t len) noexcept;
+        // drop oldest records while over limit
+        void trim() noexcept;
+    private:
+        // records
+        EzContainer::EzVector<Record>       m_records;
+        // text of records
+        EzContainer::EzVector<wchar_t>      m_text;
+        // memory limit in byte
+        size_t                              m_cLimit;
+        // count of records applied
+        uint32_t                            m_uCursor = 0;
+        // group depth
+        uint32_t                            m_cGroup = 0;
+        // next record is head of group
+        bool                                m_bGroupHead = false;
+        // applying undo/redo, do not record
+        bool                                m_bApplying = false;
+    };
+    /// <summary>
+    /// Key of text layout, text not copied by caller
+    /// </summary>
+    struct TextLayoutKey {
+        // text, no need null-terminated
+        const wchar_t*  text;
+        // length of text
+        uint32_t        length;
+        // formatting flags, e.g. rich type
+        uint32_t        flags;
+        // text format, kept alive while cached
+        void*           format;
+        // max width
+        float           width;
+        // max height
+        float           height;
+    };
+    /// <summary>
+    /// Backend of text layout cache, implemented by the platform text engine
+    /// 文本布局缓存后端, 由具体文本引擎实现
+    /// </summary>
+    class XUITextLayoutBackend {
+    public:
+        // create layout with one reference, null if failed
+        virtual auto CreateLayout(const TextLayoutKey& key) noexcept -> void* = 0;
+        // add reference of layout or format
+        virtual void Acquire(void* obj) noexcept = 0;
+        // release reference of layout or format
+        virtual void Release(void* obj) noexcept = 0;
+        // estimate memory used by layout in byte
+        virtual auto MeasureLayout(void* layout, const TextLayoutKey& key) noexcept -> uint32_t = 0;
+    };
+    /// <summary>
+    /// LRU cache of text layouts, limited by byte budget
+    /// 文本布局LRU缓存: 相同文本/格式/尺寸的布局只创建一次
+    /// </summary>
+    class CUITextLayoutCache {
+        // entry, text stored after it
+        struct Entry {
+            // next entry in bucket
+            Entry*          bucket_next;
+            // lru list, prev is newer
+            Entry*          prev;
+            // lru list, next is older
+            Entry*          next;
+            // layout
+            void*           layout;
+            // key without text
+            TextLayoutKey   key;
+            // hash code
+            uint32_t        hash;
+            // memory in byte
+            uint32_t        bytes;
+        };
+    public:
+        // ctor
+        CUITextLayoutCache(XUITextLayoutBackend& backend, size_t budget) noexcept
+            : m_backend(backend), m_cBudget(budget) {}
+        // no copy ctor
+        CUITextLayoutCache(const CUITextLayoutCache&) = delete;
+        // dtor
+        ~CUITextLayoutCache() noexcept;
+        // get layout with one reference for caller, create if not found
+        auto Get(const TextLayoutKey& key) noexcept -> void*;
+        // clear all layouts
+        void Clear() noexcept;
+        // set byte budget
+        void SetBudget(size_t budget) noexcept { m_cBudget = budget; this->evict(); }
+        // get byte budget
+        auto GetBudget() const noexcept { return m_cBudget; }
+        // memory used in byte
+        auto GetUsage() const noexcept { return m_cBytes; }
+        // count of layouts
+        auto GetCount() const noexcept { return m_cCount; }
+        // count of hit
+        auto GetHitCount() const noexcept { return m_cHit; }
+        // count of miss
+        auto GetMissCount() const noexcept { return m_cMiss; }
+        // reset hit/miss counters
+        void ResetCounters() noexcept { m_cHit = m_cMiss = 0; }
+    private:
+        // find entry
+        auto find(const TextLayoutKey& key, uint32_t hash) const noexcept -> Entry*;
+        // unlink entry from lru list
+        void unlink(Entry* entry) noexcept;
+        // push entry to lru head
+        void push_front(Entry* entry) noexcept;
+        // remove and free entry
+        void remove(Entry* entry) noexcept;
+        // evict oldest entries while over budget
+        void evict() noexcept;
+        // rehash if too full
+        void rehash() noexcept;
+    private:
+        // backend
+        XUITextLayoutBackend&               m_backend;
+        // buckets, size is power of 2
+        EzContainer::EzVector<Entry*>       m_buckets;
+        // newest entry
+        Entry*                              m_pHead = nullptr;
+        // oldest entry
+        Entry*                              m_pTail = nullptr;
+        // byte budget
+        size_t                              m_cBudget;
+        // memory used in byte
+        size_t                              m_cBytes = 0;
+        // count of entries
+        uint32_t                            m_cCount = 0;
+        // count of hit
+        uint32_t                            m_cHit = 0;
+        // count of miss
+        uint32_t                            m_cMiss = 0;
+    };
+}
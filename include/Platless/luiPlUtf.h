@@ -0,0 +1,54 @@
+﻿#pragma once
+/**
+* Copyright (c) 2014-2016 dustpg   mailto:dustpg@gmail.com
+*
+* Permission is hereby granted, free of charge, to any person
+* obtaining a copy of this software and associated documentation
+* files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use,
+* copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following
+* conditions:
+*
+* The above copyright notice and this permission notice shall be
+* included in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+* OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+* HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+
+// UTF-8/UTF-16 conversion, platform-free
+// 不依赖 luibase/luiconf, 可单独编译测试
+
+// longui namespace
+namespace LongUI {
+    // 0xD800 <= ch <= 0xDFFF
+    inline bool IsSurrogate(char16_t ch) noexcept { return (ch & 0xF800) == 0xD800; }
+    // 0xD800 <= ch <= 0xDBFF
+    inline bool IsHighSurrogate(char16_t ch) noexcept { return (ch & 0xFC00) == 0xD800; }
+    // 0xDC00 <= ch <= 0xDFFF
+    inline bool IsLowSurrogate(char16_t ch) noexcept { return (ch & 0xFC00) == 0xDC00; }
+    // UTF-32 to UTF-16 char
+    auto Char32toChar16(char32_t ch, char16_t* str) -> char16_t*;
+    // UTF-16 to UTF-8: Return end of utf8  string, unpaired surrogate -> U+FFFD
+    auto UTF16toUTF8(const char16_t* __restrict src, char* __restrict des, uint32_t buflen) noexcept -> char*;
+    // UTF-8 to UTF-16: Return end of utf16 string, illegal sequence -> U+FFFD
+    auto UTF8toUTF16(const char* __restrict src, char16_t* __restrict des, uint32_t buflen) noexcept -> char16_t*;
+    // get buffer length for UTF-16 to UTF-8(include NULL-END char)
+    auto UTF16toUTF8GetBufLen(const char16_t* src) noexcept -> uint32_t;
+    // get buffer length for UTF-8 to UTF-16(include NULL-END char)
+    auto UTF8toUTF16GetBufLen(const char* src) noexcept -> uint32_t;
+    // find first illegal sequence in UTF-8 string, return null if valid
+    auto UTF8FindInvalid(const char* src) noexcept -> const char*;
+    // find first unpaired surrogate in UTF-16 string, return null if valid
+    auto UTF16FindInvalid(const char16_t* src) noexcept -> const char16_t*;
+}
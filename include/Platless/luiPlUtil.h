@@ -26,9 +26,18 @@
 
 #include "../luibase.h"
 #include "../luiconf.h"
+#include "luiPlEzC.h"
+#include "luiPlArena.h"
+#include "luiPlPool.h"
+#include "luiPlAtom.h"
+#include "luiPlUtf.h"
+#include "luiPlFloat.h"
 #include <cstdint>
 #include <cassert>
 #include <new>
+#include <atomic>
+#include <utility>
+#include <type_traits>
 
 // longui namespace
 namespace LongUI {
@@ -36,39 +45,20 @@ namespace LongUI {
     template<typename T> inline auto white_space(T c) noexcept { return ((c) == ' ' || (c) == '\t'); }
     // valid digit
     template<typename T> inline auto valid_digit(T c) noexcept { return ((c) >= '0' && (c) <= '9'); }
-    // 0xD800 <= ch <= 0xDFFF
-    inline bool IsSurrogate(char16_t ch) noexcept { return (ch & 0xF800) == 0xD800; }
-    // 0xD800 <= ch <= 0xDBFF
-    inline bool IsHighSurrogate(char16_t ch) noexcept { return (ch & 0xFC00) == 0xD800; }
-    // 0xDC00 <= ch <= 0xDFFF
-    inline bool IsLowSurrogate(char16_t ch) noexcept { return (ch & 0xFC00) == 0xDC00; }
     // hex -> int
     unsigned int Hex2Int(char c) noexcept;
-    // lengthof
-    template<typename T, size_t COUNT> constexpr auto lengthof(T (&)[COUNT]) { return COUNT; }
-    // lengthof
-    template<typename Y, typename T, size_t COUNT> constexpr auto lengthof(T (&)[COUNT]) { return Y(COUNT); }
     // byte distanc
     template<typename T, typename Y> auto bdistance(T* a, T* b) noexcept { reinterpret_cast<const char*>(b) - reinterpret_cast<const char*>(a); };
-    // BKDR Hash
-    auto BKDRHash(const char* str) noexcept ->uint32_t;
-    // BKDR Hash
-    auto BKDRHash(const wchar_t* str) noexcept ->uint32_t;
-    // BKDR Hash
-    inline auto BKDRHash(const char* str, uint32_t size) noexcept { return BKDRHash(str) % size; }
-    // BKDR Hash
-    inline auto BKDRHash(const wchar_t* str, uint32_t size) noexcept { return BKDRHash(str) % size; }
     // is 2 power?
     inline constexpr auto Is2Power(const size_t x) noexcept { return (x & (x - 1)) == 0; }
     // round
     inline auto RoundToInt(float x) noexcept { return static_cast<int>(x + .5f); }
-    // safe buffer
+    // safe buffer, use frame arena if longer than BUFFER
     template<typename T, size_t BUFFER ,typename Lambda>
     void SafeBuffer(size_t buflen, Lambda lam) noexcept(noexcept(lam.operator()))  {
-        T fixedbuf[BUFFER]; T* buf = fixedbuf;
-        if (buflen > BUFFER) buf = LongUI::NormalAllocT<T>(buflen);
-        if (!buf) return; lam(buf);
-        if (buf != fixedbuf) LongUI::NormalFree(buf);
+        if (buflen <= BUFFER) { T fixedbuf[BUFFER]; lam(fixedbuf); return; }
+        CUIFrameArenaScope scope;
+        if (const auto buf = scope->AllocT<T>(buflen)) lam(buf);
     }
     // safe buffer
     template<typename T, typename Lambda>
@@ -83,18 +73,8 @@ namespace LongUI {
     auto AtoF(const char* __restrict) noexcept -> float;
     // std::atof diy version(float ver) overload for wchar_t
     auto AtoF(const wchar_t* __restrict) noexcept -> float;
-    // UTF-32 to UTF-16 char
-    auto Char32toChar16(char32_t ch, char16_t* str) -> char16_t*;
     // UTF-32 to UTF-32 char
     auto UTF8ChartoChar32(const char* ) -> char32_t;
-    // UTF-16 to UTF-8: Return end of utf8  string
-    auto UTF16toUTF8(const char16_t* __restrict src, char* __restrict des, uint32_t buflen) noexcept -> char*;
-    // UTF-8 to UTF-16: Return end of utf16 string
-    auto UTF8toUTF16(const char* __restrict src, char16_t* __restrict des, uint32_t buflen) noexcept -> char16_t*;
-    // get buffer length for UTF-16 to UTF-8(include NULL-END char)
-    auto UTF16toUTF8GetBufLen(const char16_t* src) noexcept -> uint32_t;
-    // get buffer length for UTF-8 to UTF-16(include NULL-END char)
-    auto UTF8toUTF16GetBufLen(const char* src) noexcept -> uint32_t;
     // get buffer length for wchar to UTF-8(not include NULL-END char)
     inline auto WideChartoUTF8GetBufLen(const wchar_t* src) noexcept {
         static_assert(sizeof(wchar_t) == sizeof(char16_t), "change UTF-16 to UTF-32");
@@ -193,30 +173,67 @@ namespace LongUI {
         // delete
         void operator delete(void* address) noexcept { LongUI::SmallFree(address); }
     };
+    // pooled single object, allocated in current object pool
+    struct CUISinglePoolObject : CUISingleObject {
+        // nothrow new 
+        void*operator new(size_t size, const std::nothrow_t&) noexcept { return CUIObjectPool::AllocCurrent(size); };
+        // nothrow delete 
+        void operator delete(void* address, const std::nothrow_t&) { CUIObjectPool::Free(address); }
+        // delete
+        void operator delete(void* address) noexcept { CUIObjectPool::Free(address); }
+    };
+#ifdef LONGUI_WITH_FUNCTION_ALLOC_COUNT
+    // count of heap allocation for CUIFunction, hook for debug
+    inline auto DebugFunctionAllocCount() noexcept ->std::atomic<uint32_t>& {
+        static std::atomic<uint32_t> s_count{ 0 };
+        return s_count;
+    }
+#endif
     // BaseFunc
     template<typename Result, typename ...Args>
     class XUIBaseFunc : public CUISingleSmallObject {
     public:
         // call
         virtual auto Call(Args... args) noexcept ->Result = 0;
+        // move to buffer or heap if null, chain moved too, return null if oom
+        virtual auto Relocate(void* buffer) noexcept ->XUIBaseFunc* = 0;
         // dtor
         virtual ~XUIBaseFunc() noexcept { if (this->chain) delete this->chain; this->chain = nullptr; };
-        // call chain
+        // call chain, always on heap
         XUIBaseFunc*        chain = nullptr;
     };
     // RealFunc
     template<typename Func, typename Result, typename ...Args>
     class CUIRealFunc final : public XUIBaseFunc<Result, Args...> {
+        // super class
+        using Super = XUIBaseFunc<Result, Args...>;
         // func data
         Func                m_func;
     public:
         // ctor
         CUIRealFunc(const Func &x) noexcept : m_func(x) {}
+        // move ctor
+        CUIRealFunc(Func&& x) noexcept : m_func(std::move(x)) {}
         // call
         auto Call(Args... args) noexcept ->Result override { 
             if (this->chain) this->chain->Call(args...);
             return m_func(args...);
         }
+        // relocate
+        auto Relocate(void* buffer) noexcept ->Super* override {
+            CUIRealFunc* obj;
+            if (buffer) {
+                obj = ::new(buffer) CUIRealFunc(std::move(m_func));
+            }
+            else {
+                obj = new(std::nothrow) CUIRealFunc(std::move(m_func));
+#ifdef LONGUI_WITH_FUNCTION_ALLOC_COUNT
+                ++LongUI::DebugFunctionAllocCount();
+#endif
+            }
+            if (obj) { obj->chain = this->chain; this->chain = nullptr; }
+            return obj;
+        }
         // dtor
         virtual ~CUIRealFunc() noexcept = default;
     };
@@ -233,10 +250,57 @@ namespace LongUI {
     class CUIFunction<Result(Args...)> {
         // this type
         using MyType = CUIFunction<Result(Args...)>;
-        // RealFunc pointer
-        XUIBaseFunc<Result, Args...>*   m_pFunction = nullptr;
+        // base func
+        using BaseFunc = XUIBaseFunc<Result, Args...>;
+        // inline buffer: vtable, chain and 3 pointers for callable
+        enum : size_t { INLINE_SIZE = sizeof(void*) * 5 };
+        // real func type
+        template<typename Func> using RealFunc = CUIRealFunc<
+            typename type_helper<typename std::decay<Func>::type>::type, Result, Args...>;
+        // RealFunc pointer, point to m_buffer if small
+        BaseFunc*                       m_pFunction = nullptr;
+        // inline buffer for small func
+        alignas(void*) char             m_buffer[INLINE_SIZE];
+        // is inline
+        bool is_inline() const noexcept { return reinterpret_cast<const char*>(m_pFunction) == m_buffer; }
         // release
-        void release() noexcept { if (m_pFunction) delete m_pFunction; m_pFunction = nullptr; }
+        void release() noexcept { 
+            if (this->is_inline()) m_pFunction->~BaseFunc();
+            else if (m_pFunction) delete m_pFunction;
+            m_pFunction = nullptr;
+        }
+        // is callable type but not this type
+        template<typename Func> using EnableFunc = typename std::enable_if<
+            !std::is_same<typename std::decay<Func>::type, MyType>::value>::type;
+        // create real func, inline if small enough
+        template<typename Func> void create(Func&& x) noexcept {
+            using Real = RealFunc<Func>;
+            this->create<Real>(std::forward<Func>(x), std::integral_constant<bool,
+                sizeof(Real) <= INLINE_SIZE && alignof(Real) <= alignof(void*)>());
+        }
+        // create real func in inline buffer
+        template<typename Real, typename Func> void create(Func&& x, std::true_type) noexcept {
+            m_pFunction = ::new(m_buffer) Real(std::forward<Func>(x));
+        }
+        // create real func on heap
+        template<typename Real, typename Func> void create(Func&& x, std::false_type) noexcept {
+            m_pFunction = new(std::nothrow) Real(std::forward<Func>(x));
+#ifdef LONGUI_WITH_FUNCTION_ALLOC_COUNT
+            ++LongUI::DebugFunctionAllocCount();
+#endif
+        }
+        // take func from other, this must be released
+        void take(MyType& obj) noexcept {
+            assert(!m_pFunction && "release first");
+            if (obj.is_inline()) {
+                m_pFunction = obj.m_pFunction->Relocate(m_buffer);
+                obj.m_pFunction->~BaseFunc();
+            }
+            else {
+                m_pFunction = obj.m_pFunction;
+            }
+            obj.m_pFunction = nullptr;
+        }
     public:
         // Ok
         auto IsOK() const noexcept { return !!m_pFunction; }
@@ -245,41 +309,48 @@ namespace LongUI {
         // ctor
         CUIFunction() noexcept = default;
         // move ctor
-        CUIFunction(MyType&& obj) noexcept : m_pFunction(obj.m_pFunction) { assert(&obj != this && "bad move"); obj.m_pFunction = nullptr; };
+        CUIFunction(MyType&& obj) noexcept { assert(&obj != this && "bad move"); this->take(obj); };
         // no copy ctor
         CUIFunction(const MyType&) = delete;
-        // and call chain
+        // and call chain, old functions are called first, then the new one
         auto AddCallChain(MyType&& chain) { 
-            if (chain.IsOK()) {
-                chain.m_pFunction->chain = m_pFunction;
-                m_pFunction = chain.m_pFunction;
-                chain.m_pFunction = nullptr;
-            }
-            else {
-                assert(!"error");
+            if (!chain.IsOK()) { assert(!"error"); return; }
+            // Call() 先调用 chain 再调用自身: 新函数作为头, 原函数整体作为其最先调用的链
+            auto old = m_pFunction;
+            if (this->is_inline()) {
+                // 链总在堆上
+                old = m_pFunction->Relocate(nullptr);
+                if (!old) { assert(!"oom"); return; }
+                m_pFunction->~BaseFunc();
             }
+            m_pFunction = nullptr;
+            this->take(chain);
+            // 新函数自带的链接在原函数之后: 原函数 -> 新函数的链 -> 新函数
+            auto first = m_pFunction;
+            while (first->chain) first = first->chain;
+            first->chain = old;
         }
         // and call chain
         auto& operator += (MyType&& chain) { this->AddCallChain(std::move(chain)); return *this; }
         // and call chain
-        template<typename Func> 
-        auto& operator += (const Func &x) { this->AddCallChain(std::move(CUIFunction(x))); return *this; }
+        template<typename Func, typename = EnableFunc<Func>>
+        auto& operator += (Func&& x) { this->AddCallChain(CUIFunction(std::forward<Func>(x))); return *this; }
         // opeator =
-        template<typename Func> auto& operator=(const Func &x) noexcept {
+        template<typename Func, typename = EnableFunc<Func>> auto& operator=(Func&& x) noexcept {
             this->release();
-            m_pFunction = new(std::nothrow) CUIRealFunc<type_helper<Func>::type, Result, Args...>(x);
+            this->create(std::forward<Func>(x));
             return *this;
         }
         // opeator =
         MyType& operator=(const MyType &x) noexcept = delete;
         // opeator =
         MyType& operator=(MyType&& x) noexcept {
-            this->release(); std::swap(m_pFunction, x.m_pFunction);
+            if (&x != this) { this->release(); this->take(x); }
             return *this;
         }
         // ctor with func
-        template<typename Func> CUIFunction(const Func& f) noexcept : 
-        m_pFunction(new(std::nothrow) CUIRealFunc<type_helper<Func>::type, Result, Args...>(f))  {}
+        template<typename Func, typename = EnableFunc<Func>>
+        CUIFunction(Func&& f) noexcept { this->create(std::forward<Func>(f)); }
         // () operator
         auto operator()(Args... args) const noexcept { assert(m_pFunction && "bad call or oom"); return m_pFunction ? m_pFunction->Call(args...) : Result(); }
     };
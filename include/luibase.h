@@ -276,6 +276,11 @@ else UIManager << DL_Error << L"alloc null" << LongUI::endl;
         // call UIViewport::RegisterOffScreenRender3D to set
         // if use Direct2D , call UIViewport::RegisterOffScreenRender2D
         Flag_OffScreen3DContent = 1 << 10,
+        // [default: false][xml attribute : "invisibleskip"@bool]
+        // if true, parent will skip update for this control while it
+        // is invisible or out of parent's visible rect, the update
+        // will be delayed until it becomes visible again
+        Flag_SkipUpdateInvisible = 1 << 11,
 #if 0
         // [default: false][auto, and xml attribute "renderparent"@bool]
         // if this control will be rendering when do dirty-rendering,
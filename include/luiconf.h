@@ -4,46 +4,12 @@
 #define LongUIAPI 
 #endif
 
-// malloc
 #include <memory>
-// dlmalloc
-#ifndef _DEBUG
-#define USE_DL_PREFIX
-#include <../3rdparty/dlmalloc/dlmalloc.h>
-#endif
+// malloc, inline
+#include "Platless/luiPlConf.h"
 
 // longui namespace
 namespace LongUI {
-    // alloc for normal space
-    inline auto NormalAlloc(size_t length) noexcept { return std::malloc(length); }
-    // free for normal space
-    inline auto NormalFree(void* address) noexcept { return std::free(address); }
-#ifdef _DEBUG
-    // debug length
-    enum : size_t { DEBUG_LENGTH = 32 };
-    // alloc for small space
-    inline auto SmallAlloc(size_t length) noexcept -> void* { 
-        auto ptr = reinterpret_cast<char*>(std::malloc(length + DEBUG_LENGTH));
-        return ptr ? DEBUG_LENGTH + ptr : nullptr; 
-    }
-    // free for small space
-    inline auto SmallFree(void* address) noexcept { 
-        return std::free(address ? reinterpret_cast<char*>(address) - DEBUG_LENGTH : nullptr); 
-    }
-#else
-    // alloc for small space
-    inline auto SmallAlloc(size_t length) noexcept { return ::dlmalloc(length); }
-    // free for small space
-    inline auto SmallFree(void* address) noexcept { return ::dlfree(address); }
-#endif
-    // template helper
-    template<typename T> inline auto NormalAllocT(size_t length) noexcept {
-        return reinterpret_cast<T*>(LongUI::NormalAlloc(length * sizeof(T))); 
-    }
-    // template helper
-    template<typename T> inline auto SmallAllocT(size_t length) noexcept { 
-        return reinterpret_cast<T*>(LongUI::SmallAlloc(length * sizeof(T))); 
-    }
     // error beep
     void BeepError() noexcept;
 }
@@ -72,18 +38,15 @@ namespace LongUI {
 // using Media Foundation to play video file?
 #define LONGUI_WITH_MMFVIDEO
 
+// using LZ4 to compress compiled layout? need lz4.lib
+//#define LONGUI_WITH_LZ4
 
-#ifndef LongUIInline
-#define LongUIInline __forceinline
-//#define LongUIInline inline __attribute__((__always_inline__))
-//#define LongUIInline __inline
-#endif
+// record frame profile(see LongUI::CUIProfiler)? works in release build
+//#define LONGUI_WITH_PROFILER
 
-#ifndef LongUINoinline
-// MSC
-#define LongUINoinline __declspec(noinline)
-// GCC
-//#define LongUINoinline __attribute__((?????))
+// count heap allocation of CUIFunction(see LongUI::DebugFunctionAllocCount)? works in release build
+#if defined(_DEBUG) && !defined(LONGUI_WITH_FUNCTION_ALLOC_COUNT)
+#define LONGUI_WITH_FUNCTION_ALLOC_COUNT
 #endif
 
 
@@ -157,16 +120,49 @@ namespace LongUI {
         LongUIMaxControlInited = (512 - 1),
         // default un-redo stack size [fixed buffer length]
         LongUIDefaultUnRedoCommandSize = 13,
+        // max memory in byte of undo history for each editable text
+        LongUIEditUndoMemoryLimit = 1024 * 256,
+        // max memory in byte of text layout cache in manager
+        LongUITextLayoutCacheBudget = 1024 * 1024 * 2,
+        // block size in byte of frame arena, larger block freed each frame
+        LongUIFrameArenaBlockSize = 1024 * 64,
+        // slot bytes of each slab in control pool, at least 4 slots
+        LongUIControlPoolSlabSize = 1024 * 16,
         // max count of longui text renderer [fixed buffer length]
         LongUITextRendererCountMax = 10,
         // max length of longui text renderer length [fixed buffer length]
         LongUITextRendererNameMaxLength = 32,
         // max count of gradient stop [fixed buffer length]
         LongUIMaxGradientStop = 128,
-        // dirty control size [fixed buffer length]
+        // dirty rect size [fixed buffer length]
+        // dirty controls will be merged into rects not more than this
+        LongUIDirtyControlSize = 15,
+        // max dirty control size [fixed buffer length]
         // if dirty control number bigger than this in one frame,
         // will do the full-rendering, not dirty-rendering
-        LongUIDirtyControlSize = 15,
+        LongUIDirtyControlMaxSize = 128,
+        // if merged dirty rects cover more than this percent of window,
+        // will do the full-rendering, not dirty-rendering
+        LongUIDirtyAreaFullRenderPercent = 75,
+        // if children count of UIContainerBuiltIn is not less than this,
+        // hit-test will be done via uniform grid, not linear search
+        LongUIHitTestGridThreshold = 32,
+        // max column/row count of hit-test grid
+        LongUIHitTestGridMaxSide = 256,
+        // bitmap(only referenced by manager) unused over this time in ms,
+        // will be released and reloaded on next UIManager.GetBitmap
+        LongUIBitmapEvictTime = 1024 * 32 - 1,
+        // bytes budget of compiled svg path cache, least recently used ones
+        // will be evicted if over this
+        LongUIPathCacheBudget = 1024 * 256,
+        // tick count per second of time wheel for time capsules
+        LongUITimeWheelTickRate = 128,
+        // time capsule count in one pool chunk
+        LongUITimeCapsulePoolChunk = 64,
+        // event count of profiler ring buffer for each thread
+        LongUIProfilerRingSize = 1024 * 16,
+        // max length of profiler event tag, include null-end char
+        LongUIProfilerTagLength = 32,
         // PlanToRender total time in sec. [fixed buffer length]
         LongUIPlanRenderingTotalTime = 5,
         // LongUI Default Window Width 
@@ -266,6 +262,8 @@ namespace LongUI {
         static constexpr char* const IsClipStrictly         = "strictclip";
         // enabled
         static constexpr char* const Enabled                = "enabled";
+        // skip update while invisible
+        static constexpr char* const IsSkipUpdateInvisible  = "invisibleskip";
 
         // marginal control direction
         static constexpr char* const MarginalDirection      = "marginal";
@@ -62,6 +62,8 @@ void LongUI::UIContainerBuiltIn::Render() const noexcept {
 
 // LongUI内建容器: 刷新
 void LongUI::UIContainerBuiltIn::Update() noexcept {
+    // 子控件可见区域将会刷新
+    if (this->IsNeedRefreshWorld()) m_bGridDirty = true;
     // 帮助器
     Super::UpdateHelper<Super>(this->begin(), this->end());
 }
@@ -88,15 +90,13 @@ auto LongUI::UIContainerBuiltIn::FindChild(const D2D1_POINT_2F& pt) noexcept ->U
     // 父类(边缘控件)
     auto mctrl = Super::FindChild(pt);
     if (mctrl) return mctrl;
-    // 性能警告
-#ifdef _DEBUG
-    if (this->GetChildrenCount() > 100) {
-        UIManager << DL_Warning
-            << "Performance Warning: O(n) algorithm"
-            << " is not fine for container that over 100 children"
-            << LongUI::endl;
+    // 子控件较多时使用网格
+    if (this->GetChildrenCount() >= LongUIHitTestGridThreshold) {
+        if (!m_bGridDirty || this->rebuild_hittest_grid()) {
+            return static_cast<UIControl*>(m_hitGrid.Find(pt.x, pt.y));
+        }
     }
-#endif
+    // 线性查找
     for (auto ctrl : (*this)) {
         // 区域内判断
         if (IsPointInRect(ctrl->visible_rect, pt)) {
@@ -106,6 +106,25 @@ auto LongUI::UIContainerBuiltIn::FindChild(const D2D1_POINT_2F& pt) noexcept ->U
     return nullptr;
 }
 
+/// <summary>
+/// Rebuild the uniform hit-test grid over children's visible rect
+/// </summary>
+/// <returns>false if out of memory</returns>
+bool LongUI::UIContainerBuiltIn::rebuild_hittest_grid() noexcept {
+    auto item = m_hitGrid.Prepare(this->GetChildrenCount());
+    if (!item) return false;
+    // 按链表顺序准备, 保持与线性查找一致
+    for (auto ctrl : (*this)) {
+        const auto& rc = ctrl->visible_rect;
+        item->rect = { rc.left, rc.top, rc.right, rc.bottom };
+        item->data = ctrl;
+        ++item;
+    }
+    if (!m_hitGrid.Build(LongUIHitTestGridMaxSide)) return false;
+    m_bGridDirty = false;
+    return true;
+}
+
 
 // UIContainerBuiltIn: 推入♂最后
 void LongUI::UIContainerBuiltIn::Push(UIControl* child) noexcept {
@@ -158,6 +177,7 @@ void LongUI::UIContainerBuiltIn::insert_only(Iterator itr, UIControl* ctrl) noex
         force_cast(itr->prev) = ctrl;
     }
     ++m_cChildrenCount;
+    m_bGridDirty = true;
 }
 
 
@@ -193,6 +213,7 @@ void LongUI::UIContainerBuiltIn::Remove(UIControl* ctrl) noexcept {
         // 减少
         force_cast(ctrl->prev) = force_cast(ctrl->next) = nullptr;
         --m_cChildrenCount;
+        m_bGridDirty = true;
         // 修改
         this->SetControlLayoutChanged();
     }
@@ -362,6 +383,7 @@ void LongUI::UIContainerBuiltIn::SwapChild(Iterator itr1, Iterator itr2) noexcep
         }
 #endif
         // 刷新
+        m_bGridDirty = true;
         this->SetControlLayoutChanged();
         this->InvalidateThis();
     }
@@ -70,6 +70,21 @@ void LongUI::UIControl::InvalidateThis() noexcept {
     if (m_pWindow) {
         m_pWindow->Invalidate(this->prerender);
     }
+    // 下一帧需要刷新
+    this->SetNeedUpdate();
+}
+
+/// <summary>
+/// Marks self and all ancestors need update,
+/// clean subtrees will be skipped in update pass
+/// 标记自己与祖先控件需要刷新, 干净的子树会被跳过
+/// </summary>
+/// <returns></returns>
+void LongUI::UIControl::SetNeedUpdate() noexcept {
+    // 不在已标记处停止: 刷新中途被清除的祖先也需要重新标记, 深度有限
+    for (UIControl* ctrl = this; ctrl; ctrl = ctrl->parent) {
+        ctrl->m_bNeedUpdate = true;
+    }
 }
 
 /// <summary>
@@ -125,8 +140,8 @@ void LongUI::UIControl::StartRender(float time) noexcept {
     const auto tt = time + 0.025f;
     // 不足再刷新
     if (m_fRenderTime < tt) m_fRenderTime = tt;
-    // 刷新再说
-    //this->InvalidateThis();
+    // 标记刷新: 干净的子树会被跳过, 否则 Update 不会消耗渲染时间
+    this->SetNeedUpdate();
 }
 
 
@@ -218,6 +233,8 @@ void LongUI::UIControl::initialize(pugi::xml_node node) noexcept {
 #endif
     // 构造默认
     auto flag = LongUIFlag::Flag_None;
+    // 预定义属性一次收集
+    const Helper::PredefinedAttributes attrs(node);
     // 有效?
     {
         // 调试
@@ -225,20 +242,20 @@ void LongUI::UIControl::initialize(pugi::xml_node node) noexcept {
         this->debug_this = node.attribute("debug").as_bool(false);
 #endif
         // 检查脚本
-        if (const auto data = node.attribute(XmlAttribute::Script).value()) {
+        if (const auto data = attrs[XmlAttribute::Atom_Script].value()) {
             if (UIManager.script) m_script = UIManager.script->AllocScript(data);
         }
         // 检查权重
-        if (const auto data = node.attribute(LongUI::XmlAttribute::LayoutWeight).value()) {
+        if (const auto data = attrs[XmlAttribute::Atom_LayoutWeight].value()) {
             force_cast(this->weight) = LongUI::AtoF(data);
         }
         // 检查布局上下文
         Helper::MakeFloats(
-            node.attribute(LongUI::XmlAttribute::LayoutContext).value(),
+            attrs[XmlAttribute::Atom_LayoutContext].value(),
             force_cast(this->context)
         );
         // 检查背景笔刷
-        if (const auto data = node.attribute(LongUI::XmlAttribute::BackgroudBrush).value()) {
+        if (const auto data = attrs[XmlAttribute::Atom_BackgroudBrush].value()) {
             m_idBackgroudBrush = uint16_t(LongUI::AtoI(data));
             if (m_idBackgroudBrush) {
                 assert(!m_pBackgroudBrush);
@@ -246,10 +263,10 @@ void LongUI::UIControl::initialize(pugi::xml_node node) noexcept {
             }
         }
         // 检查可视性
-        this->SetVisible(node.attribute(LongUI::XmlAttribute::Visible).as_bool(true));
+        this->SetVisible(attrs[XmlAttribute::Atom_Visible].as_bool(true));
         // 检查名称
         if (m_pWindow) {
-            auto basestr = node.attribute(LongUI::XmlAttribute::ControlName).value();
+            auto basestr = attrs[XmlAttribute::Atom_ControlName].value();
 #ifdef _DEBUG
             char buffer[128];
             if (!basestr) {
@@ -274,38 +291,40 @@ void LongUI::UIControl::initialize(pugi::xml_node node) noexcept {
                 basestr = buffer;
             }
 #endif
-            if (basestr) {
-                auto namestr = m_pWindow->CopyStringSafe(basestr);
-                force_cast(this->name) = namestr;
+            if (basestr && basestr[0]) {
+                force_cast(this->name) = CUIAtom::Intern(basestr).c_str();
             }
         }
         // 检查外边距
         Helper::MakeFloats(
-            node.attribute(LongUI::XmlAttribute::Margin).value(),
+            attrs[XmlAttribute::Atom_Margin].value(),
             force_cast(margin_rect)
         );
         // 检查渲染父控件
-        if (node.attribute(LongUI::XmlAttribute::IsRenderParent).as_bool(false)) {
+        if (attrs[XmlAttribute::Atom_IsRenderParent].as_bool(false)) {
             assert(this->parent && "RenderParent but no parent");
             force_cast(this->prerender) = this->parent->prerender;
         }
         // 检查裁剪规则
-        if (node.attribute(LongUI::XmlAttribute::IsClipStrictly).as_bool(true)) {
+        if (attrs[XmlAttribute::Atom_IsClipStrictly].as_bool(true)) {
             flag |= LongUI::Flag_ClipStrictly;
         }
+        // 不可见时跳过刷新
+        if (attrs[XmlAttribute::Atom_IsSkipUpdateInvisible].as_bool(false)) {
+            flag |= LongUI::Flag_SkipUpdateInvisible;
+        }
         // 边框大小
-        if (const auto data = node.attribute(LongUI::XmlAttribute::BorderWidth).value()) {
+        if (const auto data = attrs[XmlAttribute::Atom_BorderWidth].value()) {
             m_fBorderWidth = LongUI::AtoF(data);
         }
         // 边框圆角
         Helper::MakeFloats(
-            node.attribute(LongUI::XmlAttribute::BorderRound).value(),
+            attrs[XmlAttribute::Atom_BorderRound].value(),
             m_2fBorderRdius
         );
         // 检查控件大小
         {
-            auto tsz = LongUI::XmlAttribute::AllSize;
-            if (const auto str = node.attribute(tsz).value()) {
+            if (const auto str = attrs[XmlAttribute::Atom_AllSize].value()) {
                 float size[] = { 0.f, 0.f };
                 Helper::MakeFloats(str, size);
                 // 视口区宽度固定?
@@ -329,7 +348,7 @@ void LongUI::UIControl::initialize(pugi::xml_node node) noexcept {
             }
         }
         // 禁止
-        if (!node.attribute(LongUI::XmlAttribute::Enabled).as_bool(true)) {
+        if (!attrs[XmlAttribute::Atom_Enabled].as_bool(true)) {
             this->SetEnabled(false);
         }
         // 用户数据
@@ -388,8 +407,7 @@ void LongUI::UIControl::initialize() noexcept {
             };
             mystrlow(buffer);
             if (buffer[0]) {
-                auto namestr = m_pWindow->CopyStringSafe(buffer);
-                force_cast(this->name) = namestr;
+                force_cast(this->name) = CUIAtom::Intern(buffer).c_str();
             }
         }
 #endif
@@ -506,6 +524,30 @@ void LongUI::UIControl::AfterUpdate() noexcept {
     }
 }
 
+#ifdef _DEBUG
+/// <summary>
+/// Skip update for clean subtree, reset render checker of it
+/// 跳过干净的子树, 仅重置渲染检查
+/// </summary>
+/// <returns></returns>
+void LongUI::UIControl::debug_skip_update() noexcept {
+    assert(debug_updated == false && "updated but skipped");
+    this->debug_checker.SetFalse<DEBUG_CHECK_BACK>();
+    this->debug_checker.SetFalse<DEBUG_CHECK_MAIN>();
+    this->debug_checker.SetFalse<DEBUG_CHECK_FORE>();
+    // 子控件
+    if (this->flags & Flag_UIContainer) {
+        auto container = static_cast<UIContainer*>(this);
+        for (auto itr = container->MCBegin(); itr != container->MCEnd(); ++itr) {
+            (*itr)->debug_skip_update();
+        }
+        container->DebugForEach([](UIControl* ctrl) noexcept {
+            ctrl->debug_skip_update();
+        });
+    }
+}
+#endif
+
 // UI控件: 重建
 auto LongUI::UIControl::Recreate() noexcept ->HRESULT {
     // 增加计数
@@ -1000,11 +1042,13 @@ void LongUI::UIContainer::initialize(pugi::xml_node node) noexcept {
     // 保留原始外间距
     m_orgMargin = this->margin_rect;
     auto flag = this->flags | Flag_UIContainer;
+    // 预定义属性一次收集
+    const Helper::PredefinedAttributes attrs(node);
     // 有效
     {
         // 模板大小
         Helper::MakeFloats(
-            node.attribute(LongUI::XmlAttribute::TemplateSize).value(),
+            attrs[XmlAttribute::Atom_TemplateSize].value(),
             m_2fTemplateSize.width
         );
         // XXX: 渲染依赖属性
@@ -1012,11 +1056,11 @@ void LongUI::UIContainer::initialize(pugi::xml_node node) noexcept {
             flag |= LongUI::Flag_Container_HostChildrenRenderingDirectly;
         }*/
         // 渲染依赖属性
-        if (node.attribute(XmlAttribute::IsHostPosterityAlways).as_bool(false)) {
+        if (attrs[XmlAttribute::Atom_IsHostPosterityAlways].as_bool(false)) {
             flag |= LongUI::Flag_Container_HostPosterityRenderingDirectly;
         }
         // 边缘控件缩放
-        if (node.attribute(XmlAttribute::IsZoomMarginalControl).as_bool(true)) {
+        if (attrs[XmlAttribute::Atom_IsZoomMarginalControl].as_bool(true)) {
             flag |= LongUI::Flag_Container_ZoomMarginalControl;
         }
     }
@@ -1192,8 +1236,12 @@ bool LongUI::UIContainer::DoMouseEvent(const LongUI::MouseEventArgument& arg) no
 void LongUI::UIContainer::child_do_render(const UIControl* ctrl) noexcept {
     auto& vrc = ctrl->visible_rect;  bool v = ctrl->GetVisible();
     bool w = vrc.right > vrc.left;   bool h = vrc.bottom > vrc.top;
+    // 剔除: 在当前脏矩形外
+    auto& cull = ctrl->GetWindow()->GetCullRectRender();
+    bool c = vrc.left < cull.right && vrc.right > cull.left
+        && vrc.top < cull.bottom && vrc.bottom > cull.top;
     // 可渲染?
-    if (v && w && h) {
+    if (v && w && h && c) {
         // 修改世界转换矩阵
         UIManager_RenderTarget->SetTransform(&ctrl->world);
         // 检查剪切规则
@@ -1204,7 +1252,10 @@ void LongUI::UIContainer::child_do_render(const UIControl* ctrl) noexcept {
             );
         }
         // 渲染
-        ctrl->Render();
+        {
+            LongUIProfileScopeTag(Render, ctrl->name.c_str());
+            ctrl->Render();
+        }
         // 检查剪切规则
         if (ctrl->flags & Flag_ClipStrictly) {
             UIManager_RenderTarget->PopAxisAlignedClip();
@@ -1475,8 +1526,8 @@ void LongUI::UIContainer::Update() noexcept {
     if (this->IsNeedRefreshWorld()) {
         for (auto itr = this->MCBegin(); itr != this->MCEnd(); ++itr) {
             auto ctrl = *itr;
-            // 更新世界矩阵
-            ctrl->SetControlWorldChanged();
+            // 更新世界矩阵, 本控件正在刷新: 不必标记祖先
+            ctrl->SetControlWorldChangedByParent();
             ctrl->RefreshWorldMarginal();
             // 坐标转换
             D2D1_RECT_F clip_rect; ctrl->GetClipRect(clip_rect);
@@ -1523,7 +1574,7 @@ auto LongUI::UIContainer::Recreate() noexcept ->HRESULT {
 
 // 设置水平偏移值
 void LongUI::UIContainer::SetOffsetX(float value) noexcept {
-    assert(value > -1'000'000.f && value < 1'000'000.f &&
+    assert(value > -16'000'000.f && value < 16'000'000.f &&
         "maybe so many children in this container that over single float's precision");
     float target = value;
     if (target != m_2fOffset.x) {
@@ -1534,7 +1585,7 @@ void LongUI::UIContainer::SetOffsetX(float value) noexcept {
 
 // 设置垂直偏移值
 void LongUI::UIContainer::SetOffsetY(float value) noexcept {
-    assert(value > (-1'000'000.f) && value < 1'000'000.f &&
+    assert(value > (-16'000'000.f) && value < 16'000'000.f &&
         "maybe so many children in this container that over single float's precision");
     float target = value;
     if (target != m_2fOffset.y) {
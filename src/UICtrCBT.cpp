@@ -725,11 +725,11 @@ void LongUI::UIComboBox::initialize(pugi::xml_node node) noexcept {
         auto list = m_pItemList;
         m_pItemList->AddEventCall([list, this](UIControl* unused) noexcept {
             UNREFERENCED_PARAMETER(unused);
-            auto& selected = list->GetSelectedIndices();
+            auto& selected = list->GetSelectedRanges();
             // 检查选项
             if (selected.size() && m_vItems.isok()) {
                 // 选择
-                uint32_t index = uint32_t(selected.front());
+                uint32_t index = selected.front().first;
                 auto old = this->GetSelectedIndex();
                 this->SetSelectedIndex(index);
                 // 是否选择
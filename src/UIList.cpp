@@ -14,7 +14,7 @@ void LongUI::UIList::initialize(pugi::xml_node node) noexcept {
     Super::initialize(node);
     // 初始
     m_vLines.reserve(50);
-    m_vSelectedIndex.reserve(16);
+    m_vSelectedRange.reserve(16);
     m_vLineTemplate.reserve(16);
     // OOM or BAD ACTION
     if (!m_vLines.isok() && !m_vLineTemplate.isok()) {
@@ -118,12 +118,15 @@ auto LongUI::UIList::find_line_index(const D2D1_POINT_2F& pt) const noexcept ->u
     // XXX: 利用list特性优化
     for (auto ctrl : m_vLines) {
         // 区域内判断
-        if (IsPointInRect(ctrl->visible_rect, pt)) {
+        if (ctrl->GetVisible() && IsPointInRect(ctrl->visible_rect, pt)) {
             break;
         }
         ++index;
     }
-    return index;
+    // 没有找到
+    if (index >= m_vLines.size()) return this->GetLineCount();
+    // 虚拟化模式: 缓存池索引转换为数据索引
+    return m_pDataSource ? index + m_ixFirstBound : index;
 }
 
 // 依靠鼠标位置获取列表行
@@ -131,13 +134,27 @@ auto LongUI::UIList::find_line(const D2D1_POINT_2F& pt) const noexcept ->UIListL
     // XXX: 利用list特性优化
     for (auto ctrl : m_vLines) {
         // 区域内判断
-        if (IsPointInRect(ctrl->visible_rect, pt)) {
+        if (ctrl->GetVisible() && IsPointInRect(ctrl->visible_rect, pt)) {
             return ctrl;
         }
     }
     return nullptr;
 }
 
+/// <summary>
+/// Gets the line bound to index.
+/// </summary>
+/// <param name="index">The index of line(data index in virtualized mode).</param>
+/// <returns>null if out of range or not bound</returns>
+auto LongUI::UIList::get_bound_line(uint32_t index) const noexcept -> UIListLine* {
+    // 虚拟化模式: 只有缓存池中的行
+    if (m_pDataSource) {
+        if (index < m_ixFirstBound) return nullptr;
+        index -= m_ixFirstBound;
+    }
+    return index < m_vLines.size() ? m_vLines[index] : nullptr;
+}
+
 
 // UIList: 重建
 auto LongUI::UIList::Recreate() noexcept -> HRESULT {
@@ -182,30 +199,48 @@ void LongUI::UIList::Push(UIControl* child) noexcept {
 // 插入
 LongUINoinline void LongUI::UIList::Insert(uint32_t index, UIListLine* child) noexcept {
     assert(child && "bad argument");
+    assert(!m_pDataSource && "cannot insert line in virtualized mode");
     if (child) {
-        // 对齐操作
-        auto line = this->get_referent_control();
-        if (line) {
-            auto itr1 = child->begin();
-            for (auto itr2 = line->begin(); itr2 != line->end(); ++itr1, ++itr2) {
-                auto ctrl_new = *itr1, ctrl_ref = *itr2;
-                force_cast(ctrl_new->flags) = ctrl_ref->flags;
-                force_cast(ctrl_new->weight) = ctrl_ref->weight;
-                ctrl_new->SetWidth(ctrl_ref->GetWidth());
-            }
-        }
-        m_vLines.insert(index, child);
-        this->after_insert(child);
-        ++m_cChildrenCount;
+        this->insert_line(index, child);
         this->reset_select();
-        assert(m_vLines.isok());
     }
 }
 
+/// <summary>
+/// Insert line only.
+/// </summary>
+/// <param name="index">The index.</param>
+/// <param name="child">The line.</param>
+/// <returns></returns>
+void LongUI::UIList::insert_line(uint32_t index, UIListLine* child) noexcept {
+    assert(child && "bad argument");
+    // 对齐操作
+    auto line = this->get_referent_control();
+    if (line) {
+        auto itr1 = child->begin();
+        for (auto itr2 = line->begin(); itr2 != line->end(); ++itr1, ++itr2) {
+            auto ctrl_new = *itr1, ctrl_ref = *itr2;
+            force_cast(ctrl_new->flags) = ctrl_ref->flags;
+            force_cast(ctrl_new->weight) = ctrl_ref->weight;
+            ctrl_new->SetWidth(ctrl_ref->GetWidth());
+        }
+    }
+    m_vLines.insert(index, child);
+    this->after_insert(child);
+    ++m_cChildrenCount;
+    assert(m_vLines.isok());
+}
+
 // 排序
 void LongUI::UIList::Sort(uint32_t index, UIControl* child) noexcept {
     // 修改
     m_pToBeSortedHeaderChild = child;
+    // 虚拟化模式由数据源排序
+    if (m_pDataSource) {
+        m_callBeforSort(this);
+        m_pToBeSortedHeaderChild = nullptr;
+        return;
+    }
     // 有必要再说
     if ((this->list_flag & Flag_SortableLineWithUserDataPtr) 
         && m_vLines.size() > 1 
@@ -259,6 +294,8 @@ void LongUI::UIList::Sort(uint32_t index, UIControl* child) noexcept {
 void LongUI::UIList::before_deleted() noexcept {
     // 清理子控件
     this->ClearList();
+    // 释放数据源
+    LongUI::SafeRelease(m_pDataSource);
     // 链式清理
     Super::before_deleted();
 }
@@ -281,8 +318,8 @@ void LongUI::UIList::Remove(UIControl* child) noexcept {
     Super::Remove(child);
 }
 
-// 对列表插入一个行模板至指定位置
-auto LongUI::UIList::InsertLineTemplateToList(uint32_t index) noexcept ->UIListLine* {
+// 利用行模板创建列表行
+auto LongUI::UIList::create_template_line() noexcept ->UIListLine* {
     // 创建列表行
     auto ctrl = UIListLine::CreateControl(this);
     if (!ctrl) return ctrl;
@@ -292,6 +329,14 @@ auto LongUI::UIList::InsertLineTemplateToList(uint32_t index) noexcept ->UIListL
         ctrl->Insert(ctrl->end(), tmp);;
         tmp->Release();
     }
+    return ctrl;
+}
+
+// 对列表插入一个行模板至指定位置
+auto LongUI::UIList::InsertLineTemplateToList(uint32_t index) noexcept ->UIListLine* {
+    // 创建列表行
+    auto ctrl = this->create_template_line();
+    if (!ctrl) return ctrl;
     // 插入
     this->Insert(index, ctrl);
     // 释放计数
@@ -567,7 +612,7 @@ void LongUI::UIList::sort_line(bool(*cmp)(UIControl* a, UIControl* b) ) noexcept
 
 // 选择子控件(对外)
 void LongUI::UIList::SelectChild(uint32_t index, bool new_select) noexcept {
-    if (index < m_cChildrenCount) {
+    if (index < this->GetLineCount()) {
         this->select_child(index, new_select);
         this->InvalidateThis();
     }
@@ -578,7 +623,7 @@ void LongUI::UIList::SelectTo(uint32_t index1, uint32_t index2) noexcept {
     // 交换
     if (index1 > index2) std::swap(index1, index2);
     // 限制
-    index2 = std::min(index2, m_cChildrenCount - 1);
+    index2 = std::min(index2, this->GetLineCount() - 1);
     // 有效
     if (index1 < index2) {
         this->select_to(index1, index2);
@@ -588,7 +633,7 @@ void LongUI::UIList::SelectTo(uint32_t index1, uint32_t index2) noexcept {
 
 // 选择子控件
 LongUINoinline void LongUI::UIList::select_child(uint32_t index, bool new_select) noexcept {
-    assert(index < m_cChildrenCount && "out of range for selection");
+    assert(index < this->GetLineCount() && "out of range for selection");
     // 检查是否多选
     if (!new_select && !(this->list_flag & this->Flag_MultiSelect)) {
         UIManager << DL_Hint
@@ -600,28 +645,21 @@ LongUINoinline void LongUI::UIList::select_child(uint32_t index, bool new_select
     if (new_select) {
         this->reset_select();
     }
-    // 选择
-    auto line = m_vLines[index];
-    if (line->IsSelected()) {
-        line->SetSelected(false);
-        // 移除
-        auto itr = std::find(m_vSelectedIndex.cbegin(), m_vSelectedIndex.cend(), index);
-        if (itr == m_vSelectedIndex.cend()) {
-            assert(!"NOT FOUND");
-        }
-        else {
-            m_vSelectedIndex.erase(itr);
-        }
+    // 选择, 虚拟化模式下行可能未绑定
+    auto line = this->get_bound_line(index);
+    if (this->IsSelected(index)) {
+        if (line) line->SetSelected(false);
+        this->remove_select(index);
     }
     else {
-        line->SetSelected(true);
-        m_vSelectedIndex.push_back(index);
+        if (line) line->SetSelected(true);
+        this->add_select_range(index, index);
     }
 }
 
 // 选择子控件到
 LongUINoinline void LongUI::UIList::select_to(uint32_t index1, uint32_t index2) noexcept {
-    assert(index1 < m_cChildrenCount && index2 < m_cChildrenCount && "out of range for selection");
+    assert(index1 < this->GetLineCount() && index2 < this->GetLineCount() && "out of range for selection");
     // 检查是否多选
     if (!(this->list_flag & this->Flag_MultiSelect)) {
         UIManager << DL_Hint
@@ -631,15 +669,108 @@ LongUINoinline void LongUI::UIList::select_to(uint32_t index1, uint32_t index2)
     }
     // 交换
     if (index1 > index2) std::swap(index1, index2);
-    // 选择
-    auto itr_1st = m_vLines.data() + index1;
-    auto itr_lst = m_vLines.data() + index2;
-    auto i = index1;
-    for (auto itr = itr_1st; itr <= itr_lst; ++itr) {
-        auto line = *itr;
-        line->SetSelected(true);
-        m_vSelectedIndex.push_back(i);
-        ++i;
+    // 只记录区间, 只刷新已绑定的行
+    this->add_select_range(index1, index2);
+    this->set_bound_selected(index1, index2, true);
+}
+
+/// <summary>
+/// Gets the count of selected lines.
+/// </summary>
+/// <returns></returns>
+auto LongUI::UIList::GetSelectedCount() const noexcept -> uint32_t {
+    uint32_t count = 0;
+    for (const auto& range : m_vSelectedRange) count += range.last - range.first + 1;
+    return count;
+}
+
+/// <summary>
+/// Determines whether the line at index is selected.
+/// </summary>
+/// <param name="index">The index of line(data index in virtualized mode).</param>
+/// <returns></returns>
+bool LongUI::UIList::IsSelected(uint32_t index) const noexcept {
+    const auto i = this->find_range(index);
+    return i < m_vSelectedRange.size() && m_vSelectedRange[i].first <= index;
+}
+
+/// <summary>
+/// Finds the first selected range whose last index is not less than index.
+/// </summary>
+/// <param name="index">The index.</param>
+/// <returns>index of range, size of ranges if not found</returns>
+auto LongUI::UIList::find_range(uint32_t index) const noexcept -> uint32_t {
+    const auto bn = m_vSelectedRange.data();
+    const auto ed = bn + m_vSelectedRange.size();
+    const auto itr = std::lower_bound(bn, ed, index, [](const SelectedRange& r, uint32_t i) noexcept {
+        return r.last < i;
+    });
+    return static_cast<uint32_t>(itr - bn);
+}
+
+/// <summary>
+/// Adds [index1, index2] to selected ranges, merge overlapped or adjacent ones.
+/// </summary>
+/// <param name="index1">The first index.</param>
+/// <param name="index2">The last index.</param>
+/// <returns></returns>
+void LongUI::UIList::add_select_range(uint32_t index1, uint32_t index2) noexcept {
+    assert(index1 <= index2 && "bad argument");
+    auto& ranges = m_vSelectedRange;
+    // 第一个可以合并的区间: last + 1 >= index1
+    const auto i = index1 ? this->find_range(index1 - 1) : 0;
+    auto j = i;
+    // 最后一个可以合并的区间: first <= index2 + 1
+    while (j < ranges.size() && uint64_t(ranges[j].first) <= uint64_t(index2) + 1) ++j;
+    // 没有可以合并的
+    if (i == j) {
+        ranges.insert(i, SelectedRange{ index1, index2 });
+        return;
+    }
+    // 合并到第一个区间
+    ranges[i].first = std::min(ranges[i].first, index1);
+    ranges[i].last = std::max(ranges[j - 1].last, index2);
+    if (j - i > 1) ranges.erase(i + 1, j - i - 1);
+}
+
+/// <summary>
+/// Removes the index from selected ranges.
+/// </summary>
+/// <param name="index">The index.</param>
+/// <returns></returns>
+void LongUI::UIList::remove_select(uint32_t index) noexcept {
+    auto& ranges = m_vSelectedRange;
+    const auto i = this->find_range(index);
+    if (i >= ranges.size() || ranges[i].first > index) return;
+    auto& range = ranges[i];
+    // 整个区间
+    if (range.first == range.last) ranges.erase(i);
+    // 两端
+    else if (range.first == index) ++range.first;
+    else if (range.last == index) --range.last;
+    // 中间: 分割
+    else {
+        const SelectedRange back{ index + 1, range.last };
+        range.last = index - 1;
+        ranges.insert(i + 1, back);
+    }
+}
+
+/// <summary>
+/// Sets the selected state of bound lines in [index1, index2].
+/// </summary>
+/// <param name="index1">The first index.</param>
+/// <param name="index2">The last index.</param>
+/// <param name="selected">if set to <c>true</c>, set selected.</param>
+/// <returns></returns>
+void LongUI::UIList::set_bound_selected(uint32_t index1, uint32_t index2, bool selected) noexcept {
+    // 与已绑定区间求交, 非虚拟化模式下绑定区间即全部行
+    const auto bound_end = m_ixFirstBound + m_vLines.size();
+    index1 = std::max(index1, m_ixFirstBound);
+    if (index1 >= bound_end) return;
+    index2 = std::min(index2, bound_end - 1);
+    for (auto i = index1; i <= index2; ++i) {
+        m_vLines[i - m_ixFirstBound]->SetSelected(selected);
     }
 }
 
@@ -652,14 +783,139 @@ void LongUI::UIList::ZeroAllLinesContentWidth() noexcept {
     for (auto line : (*this)) line->ZeroContentWidth();
 }
 
+/// <summary>
+/// Sets the data source, enter virtualized mode.
+/// </summary>
+/// <param name="source">The data source, null to leave virtualized mode.</param>
+/// <returns></returns>
+void LongUI::UIList::SetDataSource(IUIListDataSource* source) noexcept {
+    // 清理旧的数据
+    this->reset_select();
+    this->ClearList();
+    LongUI::SafeRelease(m_pDataSource);
+    m_pDataSource = LongUI::SafeAcquire(source);
+    m_pHoveredLine = nullptr;
+    m_ixLastClickedLine = uint32_t(-1);
+    m_ixFirstBound = 0;
+    m_cVirtualLines = source ? source->GetLineCount() : 0;
+    // 刷新
+    this->SetControlLayoutChanged();
+    this->InvalidateThis();
+}
+
+/// <summary>
+/// Notifies the data changed.
+/// </summary>
+/// <returns></returns>
+void LongUI::UIList::NotifyDataChanged() noexcept {
+    assert(m_pDataSource && "only for virtualized mode");
+    if (!m_pDataSource) return;
+    // 数据变化, 选择无效
+    this->reset_select();
+    m_pHoveredLine = nullptr;
+    m_cVirtualLines = m_pDataSource->GetLineCount();
+    // 刷新
+    this->SetControlLayoutChanged();
+    this->InvalidateThis();
+}
+
+/// <summary>
+/// Prepares the recycled line pool, only visible lines(+1) will be created.
+/// </summary>
+/// <returns></returns>
+void LongUI::UIList::prepare_line_pool() noexcept {
+    assert(m_pDataSource && "only for virtualized mode");
+    // 可视行数 + 部分可视的1行
+    auto count = static_cast<uint32_t>(this->GetViewHeightZoomed() / m_fLineHeight) + 2;
+    count = std::min(count, m_cVirtualLines);
+    // 视口缩小: 收缩缓存池
+    if (m_vLines.size() > count) {
+        for (auto i = count; i < m_vLines.size(); ++i) {
+            const auto line = m_vLines[i];
+            if (line == m_pHoveredLine) m_pHoveredLine = nullptr;
+            this->release_child(line);
+        }
+        m_vLines.resize(count);
+        m_cChildrenCount = count;
+    }
+    // 扩充缓存池
+    while (m_vLines.size() < count) {
+        auto line = this->create_template_line();
+        if (!line) {
+            UIManager << DL_Error
+                << L"create line for pool failed. OOM"
+                << LongUI::endl;
+            break;
+        }
+        this->insert_line(m_vLines.size(), line);
+        line->Release();
+    }
+}
+
+/// <summary>
+/// Binds lines in pool to data source.
+/// </summary>
+/// <param name="force">if set to <c>true</c>, rebind all lines.</param>
+/// <returns></returns>
+void LongUI::UIList::bind_virtual_lines(bool force) noexcept {
+    assert(m_pDataSource && "only for virtualized mode");
+    const auto count = m_vLines.size();
+    if (!count) return;
+    // 第一个可视列表行 = (-Y偏移) / 行高
+    int first = static_cast<int>((-m_2fOffset.y) / m_fLineHeight);
+    first = std::min(first, int(m_cVirtualLines) - int(count));
+    first = std::max(first, int(0));
+    const auto new_first = static_cast<uint32_t>(first);
+    const auto old_first = m_ixFirstBound;
+    if (!force && new_first == old_first) return;
+    // 需要绑定的区间
+    uint32_t bind_begin = 0, bind_end = count;
+    const auto lines = m_vLines.data();
+    // 向下滚动: 复用前部
+    if (!force && new_first > old_first && new_first - old_first < count) {
+        const auto delta = new_first - old_first;
+        std::rotate(lines, lines + delta, lines + count);
+        bind_begin = count - delta;
+    }
+    // 向上滚动: 复用后部
+    else if (!force && new_first < old_first && old_first - new_first < count) {
+        const auto delta = old_first - new_first;
+        std::rotate(lines, lines + count - delta, lines + count);
+        bind_end = delta;
+    }
+    m_ixFirstBound = new_first;
+    // 悬浮行已经不对应原来的数据
+    m_pHoveredLine = nullptr;
+    // 选择区间
+    auto range = m_vSelectedRange.data() + this->find_range(new_first + bind_begin);
+    const auto range_end = m_vSelectedRange.data() + m_vSelectedRange.size();
+    // 重新绑定
+    for (auto i = bind_begin; i < bind_end; ++i) {
+        const auto line = lines[i];
+        const auto index = new_first + i;
+        const bool valid = index < m_cVirtualLines;
+        line->SetVisible(valid);
+        if (!valid) continue;
+        line->SetLeft(0.f);
+        line->SetTop(m_fLineHeight * float(index));
+        line->SetControlLayoutChanged();
+        // 选择状态: 索引递增, 顺序扫描区间
+        while (range < range_end && range->last < index) ++range;
+        line->SetSelected(range < range_end && range->first <= index);
+        // 绑定数据
+        m_pDataSource->BindLine(line, index);
+    }
+}
+
 // UIList: 重置选择
 void LongUI::UIList::reset_select() noexcept {
     //m_pHoveredLine = nullptr;
     //m_ixLastClickedLine = uint32_t(-1);
-    for (auto i : m_vSelectedIndex) {
-        m_vLines[i]->SetSelected(false);
+    // 只需刷新已绑定的行
+    for (const auto& range : m_vSelectedRange) {
+        this->set_bound_selected(range.first, range.last, false);
     }
-    m_vSelectedIndex.clear();
+    m_vSelectedRange.clear();
 }
 
 // UIList: 初始化布局
@@ -708,6 +964,8 @@ void LongUI::UIList::set_element_count(uint32_t length) noexcept {
 void LongUI::UIList::render_chain_background() const noexcept {
     // 独立背景- - 可视优化
     if (this->GetChildrenCount()) {
+        // 缓存池第一行对应的数据索引, 非虚拟化模式为0
+        const int first_bound = static_cast<int>(m_ixFirstBound);
         // 保留转变
         D2D1_MATRIX_3X2_F matrix;
         UIManager_RenderTarget->GetTransform(&matrix);
@@ -718,9 +976,12 @@ void LongUI::UIList::render_chain_background() const noexcept {
         // 最后一个可视列表行 = 第一个可视列表行 + 1 + 可视区域高度 / 行高
         int last_visible = static_cast<int>(this->view_size.height / m_fLineHeight);
         last_visible = last_visible + first_visible + 1;
-        last_visible = std::min(last_visible, int(this->GetChildrenCount()));
+        last_visible = std::min(last_visible, int(this->GetLineCount()));
         // 背景索引
         int bkindex1 = !(first_visible & 1);
+        // 映射到缓存池
+        first_visible = std::max(first_visible - first_bound, int(0));
+        last_visible = std::min(last_visible - first_bound, int(m_vLines.size()));
         // 循环
         const auto first_itr = m_vLines.data() + first_visible;
         const auto last_itr = m_vLines.data() + last_visible;
@@ -776,6 +1037,8 @@ void LongUI::UIList::Render() const noexcept {
 
 // UIList: 刷新
 void LongUI::UIList::Update() noexcept {
+    // 虚拟化模式: 滚动后重新绑定缓存池
+    if (m_pDataSource) this->bind_virtual_lines(false);
     // 帮助器
     Super::UpdateHelper<Super>(m_vLines.begin(), m_vLines.end());
 #ifdef _DEBUG
@@ -792,6 +1055,11 @@ void LongUI::UIList::Update() noexcept {
 
 // 更新子控件布局
 void LongUI::UIList::RefreshLayout() noexcept {
+    // 虚拟化模式: 准备缓存池
+    if (m_pDataSource) {
+        this->prepare_line_pool();
+        m_2fContentSize.height = m_fLineHeight * float(m_cVirtualLines);
+    }
     if (m_vLines.empty()) return;
     // 第二次
     float index = 0.f;
@@ -805,6 +1073,16 @@ void LongUI::UIList::RefreshLayout() noexcept {
     }
 #endif
     if (widthtt == 0.f) widthtt = this->GetViewWidthZoomed();
+    // 虚拟化模式: 位置由绑定决定
+    if (m_pDataSource) {
+        for (auto ctrl : m_vLines) {
+            ctrl->SetWidth(widthtt);
+            ctrl->SetHeight(m_fLineHeight);
+        }
+        m_2fContentSize.width = widthtt;
+        this->bind_virtual_lines(true);
+        return;
+    }
     for (auto ctrl : m_vLines) {
         // 设置控件高度
         ctrl->SetWidth(widthtt);
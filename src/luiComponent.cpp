@@ -11,6 +11,7 @@
 #include <Component/Video.h>
 #endif
 #include <algorithm>
+#include <cwchar>
 
 
 // longui::impl
@@ -103,15 +104,17 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     void ShortText::Init(pugi::xml_node node, const char* prefix) noexcept {
         assert(node && "call ShortText::Init() if no xml-node");
         LongUI::SafeRelease(m_pTextRenderer);
+        // 检查参数
+        assert(prefix && "bad arguments");
+        // 一次遍历收集属性
+        const Helper::AttributeView view(node, prefix);
         // 设置
-        m_config.rich_type = Helper::GetEnumFromXml(node, RichType::Type_None, "richtype", prefix);
+        m_config.rich_type = Helper::GetEnumFromView(view, RichType::Type_None, "richtype");
         // 颜色
         Helper::MakeStateBasedColor(node, prefix, this->color);
-        // 检查参数
-        assert(prefix && "bad arguments");
         // 属性
-        auto attribute = [&node, prefix](const char* attr) {
-            return Helper::XMLGetValue(node, attr, prefix);
+        auto attribute = [&view](const char* attr) noexcept {
+            return view.Get(attr);
         };
         const char*str = nullptr;
         // 获取进度
@@ -152,7 +155,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             LongUI::SafeRelease(fmt);
         }
         // 没有文本
-        auto text = node.attribute(prefix).value();
+        auto text = view.Get("");
         assert(m_text.length() == 0 && m_text.data()[0] == 0);
         m_text.FromUtf8(text);
         // 重建
@@ -190,8 +193,19 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     /// <param name="h">The h.</param>
     /// <returns></returns>
     void ShortText::Resize(float w, float h) noexcept {
+        if (m_config.width == w && m_config.height == h) return;
         m_config.width = w; m_config.height = h;
+        const auto sized = m_bSized;
+        m_bSized = true;
         if (!m_pLayout) return;
+        // 共享的布局不能修改
+        if (m_bCachedLayout) {
+            // 尺寸再次变化: 改用私有布局, 之后原地修改尺寸
+            if (sized) m_bPrivateLayout = true;
+            // 首次确定尺寸: 尺寸稳定的标签继续共享
+            return this->RecreateLayout();
+        }
+        CUIDxgiAutoLocker locker;
         m_pLayout->SetMaxWidth(w); m_pLayout->SetMaxHeight(h);
     }
     /// <summary>
@@ -213,6 +227,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         assert(m_config.rich_type == RichType::Type_None && "set layout must be Type_None mode");
         LongUI::SafeRelease(m_pLayout);
         m_pLayout = LongUI::SafeAcquire(layout);
+        m_bCachedLayout = false;
     }
     /// <summary>
     /// Renders the specified target.
@@ -248,7 +263,9 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         CUIDxgiAutoLocker locker;
         // 保留数据
         auto old_layout = m_pLayout;
+        const auto cached = m_bCachedLayout;
         m_pLayout = nullptr;
+        m_bCachedLayout = false;
         // 看情况
         switch (m_config.rich_type)
         {
@@ -260,17 +277,43 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             // clamp it
             if (string_length_need < 0) string_length_need = 0;
             else if (string_length_need > m_text.length()) string_length_need = m_text.length();
-            // create it
-            auto hr = UIManager_DWriteFactory->CreateTextLayout(
-                m_text.c_str(),
-                string_length_need,
-                old_layout ? old_layout : m_config.format,
-                m_config.width,
-                m_config.height,
-                &m_pLayout
-                );
-            UNREFERENCED_PARAMETER(hr);
-            assert(SUCCEEDED(hr) && m_pLayout);
+            // 外部设置的布局作为格式模板, 不使用缓存
+            if (old_layout && !cached) {
+                auto hr = UIManager_DWriteFactory->CreateTextLayout(
+                    m_text.c_str(),
+                    string_length_need,
+                    old_layout,
+                    m_config.width,
+                    m_config.height,
+                    &m_pLayout
+                    );
+                UNREFERENCED_PARAMETER(hr);
+                assert(SUCCEEDED(hr) && m_pLayout);
+            }
+            // 尺寸会变化的控件使用私有布局
+            else if (m_bPrivateLayout) {
+                auto hr = UIManager_DWriteFactory->CreateTextLayout(
+                    m_text.c_str(),
+                    string_length_need,
+                    m_config.format,
+                    m_config.width,
+                    m_config.height,
+                    &m_pLayout
+                    );
+                UNREFERENCED_PARAMETER(hr);
+                assert(SUCCEEDED(hr) && m_pLayout);
+            }
+            // 尺寸稳定: 相同文本/格式/尺寸共享布局
+            else {
+                const TextLayoutKey key {
+                    m_text.c_str(), string_length_need,
+                    static_cast<uint32_t>(m_config.rich_type), m_config.format,
+                    m_config.width, m_config.height
+                };
+                m_pLayout = UIManager.GetTextLayout(key);
+                m_bCachedLayout = !!m_pLayout;
+                assert(m_pLayout);
+            }
             m_config.text_length = static_cast<decltype(m_config.text_length)>(m_text.length());
             break;
         }
@@ -319,70 +362,149 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     void EditableText::Resize(float w, float h) noexcept {
         CUIDxgiAutoLocker locker;
         m_size.width = w; m_size.height = h; 
-        m_pLayout->SetMaxWidth(w); 
-        m_pLayout->SetMaxHeight(h);
+        m_layouter.SetMaxWidth(w);
+        // 原地修改宽度, 无需重建段落
+        for (uint32_t i = 0; i != m_layouts.GetCount(); ++i) {
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            if (layout) layout->SetMaxWidth(w);
+        }
+        m_layouts.Remeasure();
+        this->update_align();
     }
-    // 直接重建布局
-    void EditableText::recreate_layout() noexcept { 
+    /// <summary>
+    /// Relayouts the dirty paragraphs.
+    /// </summary>
+    /// <returns></returns>
+    void EditableText::relayout() noexcept {
         CUIDxgiAutoLocker locker;
-        auto fmt = m_pLayout; 
-        m_pLayout = nullptr; 
-        this->recreate_layout(fmt); 
-        LongUI::SafeRelease(fmt); 
-    }
-    // 重新创建布局
-    void EditableText::recreate_layout(IDWriteTextFormat* fmt) noexcept {
-        assert(fmt && "bad argument");
-        assert(m_pLayout == nullptr && "bad action");
         // 修改文本
         m_bTxtChanged = true;
-        // 数据
-        HRESULT hr = S_OK;
-        // 密码?
-        if (this->IsPassword()) {
-            // 双字密码字符
-            uint32_t len = m_string.length();
-            // 申请缓存
-            LongUI::SafeBuffer<wchar_t>(len, [len, this, fmt, &hr](wchar_t* const buf) {
-                // 复制字符串
-                for (auto itr = buf; itr < buf + len; ++itr) *itr = char16_t(m_chPwd);
-                // 创建文本布局
-                hr = UIManager_DWriteFactory->CreateTextLayout(
-                    buf, len, fmt,
-                    m_size.width, m_size.height,
-                    &m_pLayout
-                );
-            });
+        m_bTextStale = true;
+        m_layouts.Relayout(m_buffer);
+        this->update_align();
+    }
+    /// <summary>
+    /// Resets the whole text.
+    /// </summary>
+    /// <param name="str">The string.</param>
+    /// <param name="len">The length.</param>
+    /// <returns></returns>
+    void EditableText::reset_text(const wchar_t* str, uint32_t len) noexcept {
+        // 整体替换, 原有格式失效
+        this->free_formats();
+        const auto ok = m_buffer.SetText(str, len) && m_layouts.Reset(m_buffer);
+        assert(ok && "OOM");
+        if (!ok) { m_buffer.Clear(); m_layouts.Reset(m_buffer); }
+        this->relayout();
+    }
+    /// <summary>
+    /// Updates offset of paragraph alignment.
+    /// 段落布局不限高度, 垂直对齐在这里处理
+    /// </summary>
+    /// <returns></returns>
+    void EditableText::update_align() noexcept {
+        const auto fmt = m_layouter.RefFormat();
+        const auto space = m_size.height - m_layouts.GetHeight();
+        switch (fmt ? fmt->GetParagraphAlignment() : DWRITE_PARAGRAPH_ALIGNMENT_NEAR)
+        {
+        case DWRITE_PARAGRAPH_ALIGNMENT_FAR:    m_fAlignY = space; break;
+        case DWRITE_PARAGRAPH_ALIGNMENT_CENTER: m_fAlignY = space * 0.5f; break;
+        default:                                m_fAlignY = 0.f; break;
+        }
+    }
+    /// <summary>
+    /// Gets the text range of paragraph, line feed not included.
+    /// </summary>
+    /// <param name="i">The index of paragraph.</param>
+    /// <returns></returns>
+    auto EditableText::paragraph_range(uint32_t i) const noexcept -> DWRITE_TEXT_RANGE {
+        const auto start = m_buffer.GetLineStart(i);
+        auto end = m_buffer.GetLineEnd(i);
+        if (end > start && m_buffer.GetChar(end - 1) == L'\r') --end;
+        return { start, end - start };
+    }
+    /// <summary>
+    /// Hit test the text position.
+    /// </summary>
+    /// <param name="pos">The position.</param>
+    /// <param name="trailing">if set to <c>true</c> [trailing].</param>
+    /// <param name="x">The x.</param>
+    /// <param name="y">The y.</param>
+    /// <param name="htm">The hit test metrics.</param>
+    /// <returns></returns>
+    void EditableText::hit_test_position(uint32_t pos, bool trailing,
+        float& x, float& y, HitTestMetrics& htm) const noexcept {
+        pos = std::min(pos, m_buffer.GetLength());
+        const auto i = m_buffer.GetLineFromPosition(pos);
+        const auto range = this->paragraph_range(i);
+        const auto top = m_layouts.GetTop(i) + m_fAlignY;
+        const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+        // 换行符之间的位置视作段末
+        const auto local = std::min(pos - range.startPosition, range.length);
+        if (layout) {
+            layout->HitTestTextPosition(local, trailing, &x, &y, &htm);
         }
-        // 创建一般布局 
         else {
-            hr = UIManager_DWriteFactory->CreateTextLayout(
-                m_string.c_str(), static_cast<uint32_t>(m_string.length()),
-                fmt,
-                m_size.width, m_size.height,
-                &m_pLayout
-            );
+            x = y = 0.f;
+            std::memset(&htm, 0, sizeof(htm));
+            htm.textPosition = local;
         }
-#ifdef _DEBUG
-        if (m_pHost->debug_this) {
-            UIManager << DL_Hint << L"CODE: " << long(hr) << LongUI::endl;
-            assert(hr == S_OK);
+        htm.textPosition += range.startPosition;
+        htm.top += top;
+        y += top;
+    }
+    /// <summary>
+    /// Hit test the point.
+    /// </summary>
+    /// <param name="x">The x.</param>
+    /// <param name="y">The y.</param>
+    /// <param name="trailing">The trailing.</param>
+    /// <param name="inside">The inside.</param>
+    /// <param name="htm">The hit test metrics.</param>
+    /// <returns></returns>
+    void EditableText::hit_test_point(float x, float y,
+        BOOL& trailing, BOOL& inside, HitTestMetrics& htm) const noexcept {
+        y -= m_fAlignY;
+        const auto i = m_layouts.HitTest(y);
+        const auto start = m_buffer.GetLineStart(i);
+        const auto top = m_layouts.GetTop(i);
+        const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+        if (layout) {
+            layout->HitTestPoint(x, y - top, &trailing, &inside, &htm);
         }
-#endif
-        // 断言
-        assert(SUCCEEDED(hr));
+        else {
+            trailing = inside = FALSE;
+            std::memset(&htm, 0, sizeof(htm));
+        }
+        htm.textPosition += start;
+        htm.top += top + m_fAlignY;
+    }
+    /// <summary>
+    /// Snapshot of text.
+    /// </summary>
+    /// <returns></returns>
+    auto EditableText::c_str() const noexcept -> const wchar_t* {
+        if (m_bTextStale) {
+            const auto len = m_buffer.GetLength();
+            m_bufText.newsize(len + 1);
+            if (!m_bufText.isok()) return L"";
+            m_buffer.CopyTo(0, len, m_bufText.data());
+            m_bufText[len] = 0;
+            m_bTextStale = false;
+        }
+        return m_bufText.data();
     }
     // 插入字符(串)
     auto EditableText::insert(uint32_t pos, const wchar_t * str, uint32_t& length) noexcept -> HRESULT {
         // 第一次查错
         {
+            const auto l = m_buffer.GetLength();
             // 只读
             if (this->IsReadOnly()) {
                 length = 0;
             }
             // 限制大小
-            else if ((m_string.length() + length) > m_uMaxLength) {
-                auto l = m_string.length();
+            else if ((l + length) > m_uMaxLength) {
                 // 太长
                 length = (l < m_uMaxLength) ? (m_uMaxLength - l) : 0;
             }
@@ -392,13 +514,13 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                 return S_FALSE;
             }
         }
+        HRESULT hr = S_OK;
         // 第二次查错
         {
             // 输入数字
             if (this->IsNumber()) {
-                auto& data = m_string;
                 LongUI::SafeBuffer<wchar_t>(length + 1,
-                    [pos, str, &data, &length](wchar_t* const buf) {
+                    [this, pos, str, &length, &hr](wchar_t* const buf) noexcept {
                     auto wrt = buf;
                     for (auto itr = str; itr != str + length; ++itr) {
                         if (valid_digit(*itr)) {
@@ -410,14 +532,13 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
 #ifdef _DEBUG
                     *wrt = 0;
 #endif
-                    data.insert(pos, buf, length);
+                    hr = this->insert_text(pos, buf, length);
                 });
             }
             // 输入密码: 不能有大于0xFFFF的字符
             else if (this->IsPassword()) {
-                auto& data = m_string;
                 LongUI::SafeBuffer<wchar_t>(length + 1,
-                    [pos, str, &data, &length](wchar_t* const buf) {
+                    [this, pos, str, &length, &hr](wchar_t* const buf) noexcept {
                     auto wrt = buf;
                     for (auto itr = str; itr != str + length; ++itr) {
                         if (!LongUI::IsSurrogate(*itr)) {
@@ -429,12 +550,12 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
 #ifdef _DEBUG
                     *wrt = 0;
 #endif
-                    data.insert(pos, buf, length);
+                    hr = this->insert_text(pos, buf, length);
                 });
             }
             // 插入字符
             else {
-                m_string.insert(pos, str, length);
+                hr = this->insert_text(pos, str, length);
             }
         }
         // 没有输入
@@ -442,74 +563,144 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             LongUI::BeepError();
             return S_FALSE;
         }
-        HRESULT hr = S_OK;
-        auto old_length = static_cast<uint32_t>(m_string.length());
-        // 保留旧布局
-        auto old_layout = LongUI::SafeAcquire(m_pLayout);
-        // 重新创建布局
-        this->recreate_layout();
-        // 富文本情况下?
-        if (old_layout && this->IsRiched() && SUCCEEDED(hr)) {
-            // 复制全局属性
-            Component::EditableText::CopyGlobalProperties(old_layout, m_pLayout);
-            // 对于每种属性, 获取并应用到新布局
-            // 在首位?
-            if (pos) {
-                // 第一块
-                Component::EditableText::CopyRangedProperties(old_layout, m_pLayout, 0, pos, 0);
-                // 插入块
-                Component::EditableText::CopySinglePropertyRange(old_layout, pos - 1, m_pLayout, pos, length);
-                // 结束块
-                Component::EditableText::CopyRangedProperties(old_layout, m_pLayout, pos, old_length, length);
-            }
-            else {
-                // 插入块
-                Component::EditableText::CopySinglePropertyRange(old_layout, 0, m_pLayout, 0, length);
-                // 结束块
-                Component::EditableText::CopyRangedProperties(old_layout, m_pLayout, 0, old_length, length);
-            }
-            // 末尾
-            Component::EditableText::CopySinglePropertyRange(
-                old_layout, 
-                old_length, 
-                m_pLayout, 
-                static_cast<uint32_t>(m_string.length()), 
-                UINT32_MAX
-            );
-        }
-        LongUI::SafeRelease(old_layout);
         return hr;
     }
     /// <summary>
-    /// Copy_removes this instance.
+    /// Inserts text into buffer, only affected paragraphs relaid out.
     /// </summary>
-    /// <param name="oldLayout">The old layout.</param>
-    /// <param name="r">The r.</param>
+    /// <param name="pos">The position.</param>
+    /// <param name="str">The string.</param>
+    /// <param name="len">The length.</param>
     /// <returns></returns>
-    auto EditableText::copy_remove(IDWriteTextLayout* oldLayout, DWRITE_TEXT_RANGE r) noexcept {
-        auto newLayout = m_pLayout;
-        if (!(newLayout && oldLayout)) return;
-        if (newLayout == oldLayout) return;
-        if (!this->IsRiched()) return;
-        auto position = r.startPosition;
-        auto lengthToRemove = r.length;
-        uint32_t oldTextLength = m_string.length() + lengthToRemove;
-        Component::EditableText::CopyGlobalProperties(oldLayout, newLayout);
-
-        if (position == 0) {
-            Component::EditableText::CopyRangedProperties(
-                oldLayout, newLayout, oldTextLength, lengthToRemove, true
-            ); 
-        }
-        else {
-            Component::EditableText::CopyRangedProperties(oldLayout, newLayout, 0, position, 0, true );
-            Component::EditableText::CopyRangedProperties(
-                oldLayout, newLayout, position + lengthToRemove, oldTextLength, lengthToRemove, true
-            );
+    auto EditableText::insert_text(uint32_t pos, const wchar_t* str, uint32_t len) noexcept -> HRESULT {
+        if (!len) return S_FALSE;
+        if (!m_layouts.Insert(m_buffer, pos, str, len)) return E_OUTOFMEMORY;
+        this->move_formats(pos, len, false);
+        // 记录撤销
+        m_history.RecordInsert(pos, str, len);
+        this->relayout();
+        return S_OK;
+    }
+    /// <summary>
+    /// Removes text from buffer, only affected paragraphs relaid out.
+    /// </summary>
+    /// <param name="off">The offset.</param>
+    /// <param name="len">The length.</param>
+    /// <returns></returns>
+    bool EditableText::remove_text(uint32_t off, uint32_t len) noexcept {
+        if (this->IsReadOnly()) { LongUI::BeepError(); return false; }
+        // 记录撤销
+        LongUI::SafeBuffer<wchar_t>(len, [this, off, len](wchar_t* const buf) noexcept {
+            const auto count = m_buffer.CopyTo(off, len, buf);
+            m_history.RecordRemove(off, buf, count);
+        });
+        m_layouts.Remove(m_buffer, off, len);
+        this->move_formats(off, len, true);
+        this->relayout();
+        return true;
+    }
+    /// <summary>
+    /// Moves range formats after text inserted or removed.
+    /// </summary>
+    /// <param name="pos">The position.</param>
+    /// <param name="len">The length.</param>
+    /// <param name="removed">if set to <c>true</c> [removed].</param>
+    /// <returns></returns>
+    void EditableText::move_formats(uint32_t pos, uint32_t len, bool removed) noexcept {
+        // 删除: 区间内的位置收缩到删除点
+        const auto move = [=](uint32_t x) noexcept {
+            return x <= pos ? x : (x >= pos + len ? x - len : pos);
+        };
+        uint32_t count = 0;
+        for (const auto span : m_formats) {
+            if (removed) {
+                const auto end = move(span->start + span->length);
+                span->start = move(span->start);
+                span->length = end - span->start;
+                // 区间被删除
+                if (!span->length) { delete span; continue; }
+            }
+            // 插入: 之前的区间后移, 内部的区间扩展
+            else if (pos <= span->start) span->start += len;
+            else if (pos < span->start + span->length) span->length += len;
+            m_formats[count++] = span;
+        }
+        m_formats.resize(count);
+    }
+    /// <summary>
+    /// Applies range formats to new layout of paragraph.
+    /// </summary>
+    /// <param name="layout">The layout.</param>
+    /// <param name="pos">The start position of paragraph.</param>
+    /// <param name="len">The length of paragraph.</param>
+    /// <returns></returns>
+    void EditableText::apply_formats(IDWriteTextLayout* layout, uint32_t pos, uint32_t len) const noexcept {
+        for (const auto span : m_formats) {
+            const auto begin = std::max(span->start, pos);
+            const auto end = std::min(span->start + span->length, pos + len);
+            if (begin < end) span->call(layout, DWRITE_TEXT_RANGE{ begin - pos, end - begin });
         }
-        Component::EditableText::CopySinglePropertyRange(
-            oldLayout, oldTextLength, newLayout, static_cast<UINT32>(m_string.length()), UINT32_MAX
-        );
+    }
+    /// <summary>
+    /// Deletes all range formats.
+    /// </summary>
+    /// <returns></returns>
+    void EditableText::free_formats() noexcept {
+        for (const auto span : m_formats) delete span;
+        m_formats.clear();
+    }
+    /// <summary>
+    /// Formats the text range, kept across relayout and applied in order.
+    /// 区间格式: 段落重建后依次重新应用
+    /// </summary>
+    /// <param name="range">The range.</param>
+    /// <param name="call">The format call.</param>
+    /// <returns></returns>
+    auto EditableText::FormatRange(DWRITE_TEXT_RANGE range, FormatCall&& call) noexcept -> HRESULT {
+        assert(call.IsOK() && "bad argument");
+        const auto length = m_buffer.GetLength();
+        const auto start = std::min(range.startPosition, length);
+        const auto end = start + std::min(range.length, length - start);
+        if (start == end) return S_FALSE;
+        // 先申请空间
+        m_formats.reserve(m_formats.size() + 1);
+        if (m_formats.capacity() <= m_formats.size()) return E_OUTOFMEMORY;
+        const auto span = new(std::nothrow) FormatSpan(std::move(call), start, end - start);
+        if (!span) return E_OUTOFMEMORY;
+        m_formats.push_back(span);
+        CUIDxgiAutoLocker locker;
+        // 现有段落原地应用
+        const auto last = std::min(m_buffer.GetLineFromPosition(end) + 1, m_layouts.GetCount());
+        for (auto i = m_buffer.GetLineFromPosition(start); i < last; ++i) {
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            const auto para = this->paragraph_range(i);
+            const auto begin = std::max(start, para.startPosition);
+            const auto stop = std::min(end, para.startPosition + para.length);
+            if (layout && begin < stop) {
+                span->call(layout, DWRITE_TEXT_RANGE{ begin - para.startPosition, stop - begin });
+            }
+        }
+        m_layouts.Remeasure();
+        this->update_align();
+        this->RefreshSelectionMetrics(this->GetSelectionRange());
+        this->refresh();
+        return S_OK;
+    }
+    /// <summary>
+    /// Clears all range formats, paragraphs relaid out.
+    /// </summary>
+    /// <returns></returns>
+    void EditableText::ClearFormats() noexcept {
+        if (m_formats.empty()) return;
+        this->free_formats();
+        CUIDxgiAutoLocker locker;
+        // 文本未变, 只重建段落
+        const auto ok = m_layouts.Reset(m_buffer);
+        assert(ok && "OOM"); (void)ok;
+        m_layouts.Relayout(m_buffer);
+        this->update_align();
+        this->RefreshSelectionMetrics(this->GetSelectionRange());
+        this->refresh();
     }
     // 返回当前选择区域
     auto EditableText::GetSelectionRange() const noexcept -> DWRITE_TEXT_RANGE {
@@ -521,7 +712,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             std::swap(caretBegin, caretEnd);
         }
         // 限制范围在文本长度之内
-        auto textLength = static_cast<uint32_t>(m_string.size());
+        auto textLength = m_buffer.GetLength();
         caretBegin = std::min(caretBegin, textLength);
         caretEnd = std::min(caretEnd, textLength);
         // 返回范围
@@ -541,36 +732,38 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         {
         case SelectionMode::Mode_Left:
             m_u32CaretPos += m_u32CaretPosOffset;
+            m_u32CaretPosOffset = 0;
             if (m_u32CaretPos > 0) {
-                --m_u32CaretPos;
-                this->AlignCaretToNearestCluster(false, true);
-                absolute_position = m_u32CaretPos + m_u32CaretPosOffset;
-                // 检查换行符
-                absolute_position = m_u32CaretPos + m_u32CaretPosOffset;
-                if (absolute_position >= 1
-                    && absolute_position < m_string.size()
-                    && m_string[absolute_position - 1] == L'\r'
-                    &&  m_string[absolute_position] == L'\n')
-                {
-                    m_u32CaretPos = absolute_position - 1;
+                const auto i = m_buffer.GetLineFromPosition(m_u32CaretPos);
+                // 段首: 跳过换行符到上一段末尾
+                if (m_u32CaretPos == m_buffer.GetLineStart(i)) {
+                    const auto range = this->paragraph_range(i - 1);
+                    m_u32CaretPos = range.startPosition + range.length;
+                }
+                else {
+                    --m_u32CaretPos;
                     this->AlignCaretToNearestCluster(false, true);
                 }
             }
             break;
 
         case SelectionMode::Mode_Right:
+        {
             m_u32CaretPos = absolute_position;
-            this->AlignCaretToNearestCluster(true, true);
-            absolute_position = m_u32CaretPos + m_u32CaretPosOffset;
-            if (absolute_position >= 1
-                && absolute_position < m_string.size()
-                && m_string[absolute_position - 1] == '\r'
-                &&  m_string[absolute_position] == '\n')
-            {
-                m_u32CaretPos = absolute_position + 1;
-                this->AlignCaretToNearestCluster(false, true);
+            const auto i = m_buffer.GetLineFromPosition(m_u32CaretPos);
+            const auto range = this->paragraph_range(i);
+            // 段末: 跳过换行符到下一段开头
+            if (m_u32CaretPos >= range.startPosition + range.length) {
+                if (i + 1 < m_layouts.GetCount()) {
+                    m_u32CaretPos = m_buffer.GetLineStart(i + 1);
+                }
+                m_u32CaretPosOffset = 0;
             }
-            break;
+            else {
+                this->AlignCaretToNearestCluster(true, true);
+            }
+        }
+        break;
         case SelectionMode::Mode_LeftChar:
             m_u32CaretPos = absolute_position;
             m_u32CaretPos -= std::min(advance, absolute_position);
@@ -579,77 +772,34 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         case SelectionMode::Mode_RightChar:
             m_u32CaretPos = absolute_position + advance;
             m_u32CaretPosOffset = 0;
-            {
-                // Use hit-testing to limit text position.
-                DWRITE_HIT_TEST_METRICS hitTestMetrics;
-                float caretX, caretY;
-                m_pLayout->HitTestTextPosition(
-                    m_u32CaretPos,
-                    false,
-                    &caretX,
-                    &caretY,
-                    &hitTestMetrics
-                    );
-                m_u32CaretPos = std::min(m_u32CaretPos, hitTestMetrics.textPosition + hitTestMetrics.length);
-            }
+            // 限制在文本长度之内
+            m_u32CaretPos = std::min(m_u32CaretPos, m_buffer.GetLength());
             break;
         case SelectionMode::Mode_Up:
         case SelectionMode::Mode_Down:
         {
-            LineMetricsBuffer metrice_buffer;
-            // 获取行指标
-            m_pLayout->GetMetrics(&textMetrics);
-            metrice_buffer.NewSize(textMetrics.lineCount);
-            m_pLayout->GetLineMetrics(
-                metrice_buffer.GetData(),
-                textMetrics.lineCount,
-                &textMetrics.lineCount
-                );
-            // 获取行
-            uint32_t line, linePosition;
-            Component::EditableText::GetLineFromPosition(
-                metrice_buffer.GetData(),
-                metrice_buffer.GetCount(),
-                m_u32CaretPos,
-                &line,
-                &linePosition
-                );
-            // 下移或上移
-            if (mode == SelectionMode::Mode_Up) {
-                if (line <= 0) break;
-                line--;
-                linePosition -= metrice_buffer[line].length;
-            }
-            else {
-                linePosition += metrice_buffer[line].length;
-                line++;
-                if (line >= metrice_buffer.GetCount())  break;
-            }
             DWRITE_HIT_TEST_METRICS hitTestMetrics;
-            float caretX, caretY, dummyX;
-            // 获取当前文本X位置
-            m_pLayout->HitTestTextPosition(
+            float caretX, caretY;
+            // 获取当前文本位置, 含所在行的顶部与高度
+            this->hit_test_position(
                 m_u32CaretPos,
                 m_u32CaretPosOffset > 0, // trailing if nonzero, else leading edge
-                &caretX,
-                &caretY,
-                &hitTestMetrics
-                );
-            // 获取新位置Y坐标
-            m_pLayout->HitTestTextPosition(
-                linePosition,
-                false, // leading edge
-                &dummyX,
-                &caretY,
-                &hitTestMetrics
+                caretX,
+                caretY,
+                hitTestMetrics
                 );
+            // 上一行或下一行的中间, 可能跨越段落
+            const auto height = hitTestMetrics.height;
+            caretY = hitTestMetrics.top - m_fAlignY;
+            caretY += mode == SelectionMode::Mode_Up ? -height * 0.5f : height * 1.5f;
+            if (caretY < 0.f || caretY >= m_layouts.GetHeight()) break;
             // 获取新x, y 的文本位置
             BOOL isInside, isTrailingHit;
-            m_pLayout->HitTestPoint(
-                caretX, caretY,
-                &isTrailingHit,
-                &isInside,
-                &hitTestMetrics
+            this->hit_test_point(
+                caretX, caretY + m_fAlignY,
+                isTrailingHit,
+                isInside,
+                hitTestMetrics
                 );
             m_u32CaretPos = hitTestMetrics.textPosition;
             m_u32CaretPosOffset = isTrailingHit ? (hitTestMetrics.length > 0) : 0;
@@ -658,17 +808,37 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         case SelectionMode::Mode_LeftWord:
         case SelectionMode::Mode_RightWord:
         {
+            m_u32CaretPos = absolute_position;
+            const auto i = m_buffer.GetLineFromPosition(m_u32CaretPos);
+            const auto range = this->paragraph_range(i);
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            UINT32 oldCaretPosition = std::min(m_u32CaretPos - range.startPosition, range.length);
+            // 段首左移: 上一段末尾
+            if (mode == SelectionMode::Mode_LeftWord && !oldCaretPosition) {
+                if (i) {
+                    const auto prev = this->paragraph_range(i - 1);
+                    m_u32CaretPos = prev.startPosition + prev.length;
+                }
+                m_u32CaretPosOffset = 0;
+                break;
+            }
+            // 段末右移: 下一段开头
+            if (mode == SelectionMode::Mode_RightWord && oldCaretPosition >= range.length) {
+                if (i + 1 < m_layouts.GetCount()) {
+                    m_u32CaretPos = m_buffer.GetLineStart(i + 1);
+                }
+                m_u32CaretPosOffset = 0;
+                break;
+            }
             // 计算所需字符串集
             EzContainer::SmallBuffer<DWRITE_CLUSTER_METRICS, 64> metrice_buffer;
-            UINT32 clusterCount;
-            m_pLayout->GetClusterMetrics(nullptr, 0, &clusterCount);
+            UINT32 clusterCount = 0;
+            if (layout) layout->GetClusterMetrics(nullptr, 0, &clusterCount);
             if (clusterCount == 0) break;
             // 重置大小
             metrice_buffer.NewSize(clusterCount);
-            m_pLayout->GetClusterMetrics(metrice_buffer.GetData(), clusterCount, &clusterCount);
-            m_u32CaretPos = absolute_position;
+            layout->GetClusterMetrics(metrice_buffer.GetData(), clusterCount, &clusterCount);
             UINT32 clusterPosition = 0;
-            UINT32 oldCaretPosition = m_u32CaretPos;
             // 左移
             if (mode == SelectionMode::Mode_LeftWord) {
                 m_u32CaretPos = 0;
@@ -696,18 +866,24 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                     clusterPosition += clusterLength;
                 }
             }
-            //int a = 0;
+            // 段内位置 -> 文本位置
+            m_u32CaretPos += range.startPosition;
         }
         break;
         case SelectionMode::Mode_Home:
         case SelectionMode::Mode_End:
         {
-            // 获取预知的首位置或者末位置
+            // 获取预知的首位置或者末位置, 只在当前段落内
+            const auto i = m_buffer.GetLineFromPosition(std::min(m_u32CaretPos, m_buffer.GetLength()));
+            const auto range = this->paragraph_range(i);
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            m_u32CaretPosOffset = 0;
+            if (!layout) { m_u32CaretPos = range.startPosition; break; }
             LineMetricsBuffer metrice_buffer;
             // 获取行指标
-            m_pLayout->GetMetrics(&textMetrics);
+            layout->GetMetrics(&textMetrics);
             metrice_buffer.NewSize(textMetrics.lineCount);
-            m_pLayout->GetLineMetrics(
+            layout->GetLineMetrics(
                 metrice_buffer.GetData(),
                 textMetrics.lineCount,
                 &textMetrics.lineCount
@@ -716,11 +892,11 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             Component::EditableText::GetLineFromPosition(
                 metrice_buffer.GetData(),
                 metrice_buffer.GetCount(),
-                m_u32CaretPos,
+                std::min(m_u32CaretPos - range.startPosition, range.length),
                 &line,
                 &m_u32CaretPos
                 );
-            m_u32CaretPosOffset = 0;
+            m_u32CaretPos += range.startPosition;
             if (mode == SelectionMode::Mode_End) {
                 // 放置插入符号
                 UINT32 lineLength = metrice_buffer[line].length -
@@ -794,11 +970,11 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         BOOL isInside;
         DWRITE_HIT_TEST_METRICS caret_metrics;
         // 获取当前点击位置
-        m_pLayout->HitTestPoint(
+        this->hit_test_point(
             x, y,
-            &isTrailingHit,
-            &isInside,
-            &caret_metrics
+            isTrailingHit,
+            isInside,
+            caret_metrics
             );
         // 更新当前选择区
         this->SetSelection(
@@ -837,7 +1013,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             BOOL trailin, inside;
             DWRITE_HIT_TEST_METRICS caret_metrics;
             // 获取当前点击位置
-            m_pLayout->HitTestPoint(x, y, &trailin, &inside, &caret_metrics);
+            this->hit_test_point(x, y, trailin, inside, caret_metrics);
             bool inzone = caret_metrics.textPosition >= range.startPosition &&
                 caret_metrics.textPosition < range.startPosition + range.length;
             if (inzone) return false;
@@ -879,6 +1055,8 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                 LongUI::BeepError();
                 return;
             }
+            // 替换选择区作为一步撤销
+            m_history.BeginGroup();
             // 删除选择区字符串
             this->delete_selandrelay();
             // 长度
@@ -899,6 +1077,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     #endif
             // 插入
             this->insert(m_u32CaretPos + m_u32CaretPosOffset, chars, length);
+            m_history.EndGroup();
             // 设置选择区
             this->SetSelection(SelectionMode::Mode_Right, length, false, false);
             // 刷新
@@ -911,16 +1090,8 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         auto range = this->GetSelectionRange();
         // 有效删除范围
         if (!range.length) return;
-        // 保留旧布局
-        auto old = LongUI::SafeAcquire(m_pLayout);
-        // 删除选择区
+        // 删除选择区, 只重排受影响的段落
         this->DeleteSelection();
-        // 重建布局
-        this->recreate_layout();
-        // 复制内容
-        this->copy_remove(old, range);
-        // 释放
-        LongUI::SafeRelease(old);
     }
     // 按键时
     void EditableText::OnKey(uint32_t keycode) noexcept {
@@ -936,9 +1107,11 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             // 多行 - 键CRLF字符
             if (this->IsMultiLine()) {
                 if (!this->IsReadOnly()) {
+                    m_history.BeginGroup();
                     this->delete_selandrelay();
                     uint32_t len = 2;
                     this->insert(absolutePosition, L"\r\n", len);
+                    m_history.EndGroup();
                     this->SetSelection(SelectionMode::Mode_Leading, absolutePosition + len, false, false);
                     // 修改
                     this->refresh();
@@ -959,14 +1132,11 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                 this->delete_selandrelay();
             }
             else if (absolutePosition > 0) {
-                // 保留旧布局
-                auto old = LongUI::SafeAcquire(m_pLayout);
                 uint32_t count = 1;
                 // 双字特别处理
-                if (absolutePosition >= 2 && absolutePosition <= m_string.size()) {
-                    auto* base = m_string.data() + absolutePosition;
-                    auto ch1 = base[-2];
-                    auto ch2 = base[-1];
+                if (absolutePosition >= 2 && absolutePosition <= m_buffer.GetLength()) {
+                    auto ch1 = m_buffer.GetChar(absolutePosition - 2);
+                    auto ch2 = m_buffer.GetChar(absolutePosition - 1);
                     // 1.CR/LF
                     bool case1 = ch1 == L'\r' && ch2 == L'\n';
                     // 2.Surrogate
@@ -982,11 +1152,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                 // 左移
                 this->SetSelection(SelectionMode::Mode_LeftChar, count, false);
                 // 字符串: 删除count个字符
-                if (this->remove_text(m_u32CaretPos, count)) {
-                    this->recreate_layout();
-                    this->copy_remove(old, DWRITE_TEXT_RANGE{ m_u32CaretPos, count });
-                }
-                LongUI::SafeRelease(old);
+                this->remove_text(m_u32CaretPos, count);
             }
             // 修改
             this->refresh();
@@ -999,38 +1165,35 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             }
             // 删除下一个的字符
             else {
-                // 保留旧布局
-                auto old = LongUI::SafeAcquire(m_pLayout);
-                DWRITE_HIT_TEST_METRICS hitTestMetrics;
-                float caretX, caretY;
+                const auto i = m_buffer.GetLineFromPosition(absolutePosition);
+                const auto range = this->paragraph_range(i);
+                const auto end = range.startPosition + range.length;
+                DWRITE_TEXT_RANGE del;
+                // 段末: 删除换行符
+                if (absolutePosition >= end) {
+                    const auto next = i + 1 < m_layouts.GetCount()
+                        ? m_buffer.GetLineStart(i + 1) : m_buffer.GetLength();
+                    del = { end, next - end };
+                }
                 // 获取集群大小
-                m_pLayout->HitTestTextPosition(
-                    absolutePosition,
-                    false,
-                    &caretX,
-                    &caretY,
-                    &hitTestMetrics
-                    );
-                // CR-LF?
-                if (hitTestMetrics.textPosition + 2 < m_string.length()) {
-                    auto* base = m_string.data() + hitTestMetrics.textPosition;
-                    auto ch1 = base[0];
-                    auto ch2 = base[1];
-                    // 1.CR/LF
-                    if (ch1 == L'\r' && ch2 == L'\n') {
-                        ++hitTestMetrics.length;
-                    }
+                else {
+                    DWRITE_HIT_TEST_METRICS hitTestMetrics;
+                    float caretX, caretY;
+                    this->hit_test_position(
+                        absolutePosition,
+                        false,
+                        caretX,
+                        caretY,
+                        hitTestMetrics
+                        );
+                    del = { hitTestMetrics.textPosition, hitTestMetrics.length };
                 }
-                // 修改
-                this->SetSelection(SelectionMode::Mode_Leading, hitTestMetrics.textPosition, false);
-                // 删除字符
-                if (this->remove_text(hitTestMetrics.textPosition, hitTestMetrics.length)) {
-                    this->recreate_layout();
-                    this->copy_remove(old, 
-                        DWRITE_TEXT_RANGE{ hitTestMetrics.textPosition, hitTestMetrics.length }
-                    );
+                if (del.length) {
+                    // 修改
+                    this->SetSelection(SelectionMode::Mode_Leading, del.startPosition, false);
+                    // 删除字符
+                    this->remove_text(del.startPosition, del.length);
                 }
-                LongUI::SafeRelease(old);
             }
             // 修改
             this->refresh();
@@ -1101,10 +1264,12 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                 this->SetSelection(SelectionMode::Mode_SelectAll, 0, true);
             break;
         case 'Z':
-            // 撤销
+            // 'Z'键 Ctrl+Z 撤销, Ctrl+Shift+Z 重做
+            if (heldControl) heldShift ? this->Redo() : this->Undo();
             break;
         case 'Y':
-            // 重做
+            // 'Y'键 Ctrl+Y 重做
+            if (heldControl) this->Redo();
             break;
         default:
             break;
@@ -1130,7 +1295,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
 #ifdef _DEBUG
             UIManager << DL_Log
                 << L"Text Changed: "
-                << m_string
+                << this->c_str()
                 << LongUI::endl;
 #endif
             m_pHost->CallUiEvent(m_evChanged, SubEvent::Event_ValueChanged);
@@ -1164,7 +1329,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             BOOL trailin, inside;
             DWRITE_HIT_TEST_METRICS caret_metrics;
             // 获取当前点击位置
-            m_pLayout->HitTestPoint(x, y, &trailin, &inside, &caret_metrics);
+            this->hit_test_point(x, y, trailin, inside, caret_metrics);
             m_bClickInSelection = caret_metrics.textPosition >= range.startPosition &&
                 caret_metrics.textPosition < range.startPosition + range.length;
         }
@@ -1273,7 +1438,6 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
                     }
                     // 删除
                     if (this->remove_text(m_dragRange.startPosition, m_dragRange.length)) {
-                        this->recreate_layout();
                         this->SetSelection(Mode_Left, 1, false);
                         this->SetSelection(Mode_Right, 1, false);
                     }
@@ -1292,14 +1456,13 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     void EditableText::AlignCaretToNearestCluster(bool hit, bool skip) noexcept {
         DWRITE_HIT_TEST_METRICS hitTestMetrics;
         float caretX, caretY;
-        assert(m_pLayout);
         // 对齐最近字符集
-        m_pLayout->HitTestTextPosition(
+        this->hit_test_position(
             m_u32CaretPos,
             false,
-            &caretX,
-            &caretY,
-            &hitTestMetrics
+            caretX,
+            caretY,
+            hitTestMetrics
             );
         // 跳过0
         m_u32CaretPos = hitTestMetrics.textPosition;
@@ -1316,35 +1479,34 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     /// <param name="rect">The rect.</param>
     /// <returns></returns>
     void EditableText::GetTextBox(RectLTWH_F& rect) const noexcept {
-        impl::get_text_box(m_pLayout, rect);
+        rect.left = 0.f; rect.width = 0.f;
+        // 合并各段落
+        for (uint32_t i = 0; i != m_layouts.GetCount(); ++i) {
+            RectLTWH_F box = { 0.f };
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            impl::get_text_box(layout, box);
+            if (!i || box.left < rect.left) rect.left = box.left;
+            rect.width = std::max(rect.width, box.width);
+        }
+        rect.top = m_fAlignY;
+        rect.height = m_layouts.GetHeight();
     }
     // 获取插入符号矩形
     void EditableText::GetCaretRect(RectLTWH_F& rect) const noexcept {
         // 检查布局
-        if (m_pLayout) {
+        if (m_layouts.GetCount()) {
             // 获取 f(文本偏移) -> 坐标
             DWRITE_HIT_TEST_METRICS caretMetrics;
             float caretX, caretY;
-            m_pLayout->HitTestTextPosition(
+            this->hit_test_position(
                 m_u32CaretPos,
                 m_u32CaretPosOffset > 0,
-                &caretX,
-                &caretY,
-                &caretMetrics
+                caretX,
+                caretY,
+                caretMetrics
                 );
-            // 获取当前选择范围
-            DWRITE_TEXT_RANGE selectionRange = this->GetSelectionRange();
-            if (selectionRange.length > 0) {
-                UINT32 actualHitTestCount = 1;
-                m_pLayout->HitTestTextRange(
-                    m_u32CaretPos,
-                    0,      // length
-                    0.f,    // x
-                    0.f,    // y
-                    &caretMetrics,
-                    1,
-                    &actualHitTestCount
-                    );
+            // 有选择区时使用行顶部
+            if (this->GetSelectionRange().length > 0) {
                 caretY = caretMetrics.top;
             }
             // 获取插入符号宽度
@@ -1369,9 +1531,9 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     void EditableText::SetString(const wchar_t* str) noexcept {
         if (this->IsReadOnly()) return;
         // 不同再修改
-        if (m_string != str) {
-            m_string = str;
-            this->recreate_layout();
+        if (std::wcscmp(this->c_str(), str)) {
+            this->reset_text(str, static_cast<uint32_t>(std::wcslen(str)));
+            m_history.Clear();
             m_u32CaretPos = 0;
             m_u32CaretAnchor = 0;
             m_u32CaretPosOffset = 0;
@@ -1383,19 +1545,61 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         if (this->IsReadOnly()) return;
         i = std::min(m_iMax, i);
         i = std::max(m_iMin, i);
-        m_string.Format(L"%d", int(i));
-        this->recreate_layout();
+        wchar_t buf[16];
+        const auto len = std::swprintf(buf, lengthof(buf), L"%d", int(i));
+        this->reset_text(buf, static_cast<uint32_t>(std::max(len, 0)));
+        m_history.Clear();
         this->SetSelection(SelectionMode::Mode_End, 0, false, false);
         this->refresh(true);
     }
     // 读取数值
     auto EditableText::GetNumber() const noexcept -> int32_t {
-        return LongUI::AtoI(m_string.c_str());
+        return LongUI::AtoI(this->c_str());
+    }
+    /// <summary>
+    /// Undoes last edit.
+    /// </summary>
+    /// <returns>false if nothing to undo</returns>
+    bool EditableText::Undo() noexcept {
+        if (this->IsReadOnly()) return false;
+        uint32_t caret = 0;
+        const auto done = m_history.Undo([this, &caret](
+            CUITextHistory::Operation op, uint32_t pos, const wchar_t* str, uint32_t len) noexcept {
+            if (op == CUITextHistory::Op_Insert) { m_layouts.Insert(m_buffer, pos, str, len); caret = pos + len; }
+            else { m_layouts.Remove(m_buffer, pos, len); caret = pos; }
+            this->move_formats(pos, len, op != CUITextHistory::Op_Insert);
+        });
+        if (done) {
+            this->relayout();
+            this->SetSelection(Mode_Leading, caret, false, false);
+            this->refresh();
+        }
+        return done;
+    }
+    /// <summary>
+    /// Redoes last undone edit.
+    /// </summary>
+    /// <returns>false if nothing to redo</returns>
+    bool EditableText::Redo() noexcept {
+        if (this->IsReadOnly()) return false;
+        uint32_t caret = 0;
+        const auto done = m_history.Redo([this, &caret](
+            CUITextHistory::Operation op, uint32_t pos, const wchar_t* str, uint32_t len) noexcept {
+            if (op == CUITextHistory::Op_Insert) { m_layouts.Insert(m_buffer, pos, str, len); caret = pos + len; }
+            else { m_layouts.Remove(m_buffer, pos, len); caret = pos; }
+            this->move_formats(pos, len, op != CUITextHistory::Op_Insert);
+        });
+        if (done) {
+            this->relayout();
+            this->SetSelection(Mode_Leading, caret, false, false);
+            this->refresh();
+        }
+        return done;
     }
     // 渲染
     void EditableText::Render(ID2D1DeviceContext* target, D2D1_POINT_2F pt) const noexcept {
         assert(target && "bad argument");
-        if (!m_pLayout) return;
+        if (!m_layouts.GetCount()) return;
         float x = this->offset.x + pt.x;
         float y = this->offset.y + pt.y;
     #ifdef _DEBUG
@@ -1425,7 +1629,15 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         m_pTextRenderer->target = target;
         m_pTextRenderer->basic_color.color = *m_pColor;
         IDWriteTextRenderer1* pTextRenderer = m_pTextRenderer;
-        m_pLayout->Draw(m_pTextContext, pTextRenderer, x, y);
+        y += m_fAlignY;
+        // 只刻画可见段落
+        const auto visible = m_size.height - this->offset.y - m_fAlignY;
+        for (auto i = m_layouts.HitTest(-this->offset.y - m_fAlignY); i != m_layouts.GetCount(); ++i) {
+            const auto top = m_layouts.GetTop(i);
+            if (top > visible) break;
+            const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+            if (layout) layout->Draw(m_pTextContext, pTextRenderer, x, y + top);
+        }
         m_pTextRenderer->target = nullptr;
     }
     // 复制到 目标全局句柄
@@ -1435,16 +1647,19 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         // 有选择区域
         if (selection.length) {
             // 断言检查
-            assert(selection.startPosition < m_string.length() && "bad selection range");
-            assert((selection.startPosition + selection.length) <= m_string.length() && "bad selection range");
+            assert(selection.startPosition < m_buffer.GetLength() && "bad selection range");
+            assert((selection.startPosition + selection.length) <= m_buffer.GetLength() && "bad selection range");
             // 获取富文本数据
             if (this->IsRiched()) {
                 // TODO: 富文本
             }
             // 全局申请
-            auto str = m_string.c_str() + selection.startPosition;
-            auto len = static_cast<size_t>(selection.length);
-            return Helper::GlobalAllocString(str, len);
+            HGLOBAL global = nullptr;
+            LongUI::SafeBuffer<wchar_t>(selection.length, [this, selection, &global](wchar_t* const buf) noexcept {
+                const auto len = m_buffer.CopyTo(selection.startPosition, selection.length, buf);
+                global = Helper::GlobalAllocString(buf, static_cast<size_t>(len));
+            });
+            return global;
         }
         // TODO: 复制选中行
         return nullptr;
@@ -1489,12 +1704,14 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         // 数据有效?
         if (memory) {
             // 替换选择区
+            m_history.BeginGroup();
             this->delete_selandrelay();
             const wchar_t* text = reinterpret_cast<const wchar_t*>(memory);
             // 计算长度
             auto characterCount = static_cast<UINT32>(std::min(std::wcslen(text), byteSize / sizeof(wchar_t)));
             // 插入
             hr = this->insert(m_u32CaretPos + m_u32CaretPosOffset, text, characterCount);
+            m_history.EndGroup();
             ::GlobalUnlock(global);
             // 移动
             this->SetSelection(SelectionMode::Mode_RightChar, characterCount, true);
@@ -1561,30 +1778,40 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
             m_bufMetrice.NewSize(0);
             return;
         };
-        // 检查选择的区块数量
-        uint32_t actualHitTestCount = 0;
-        m_pLayout->HitTestTextRange(
-            selection.startPosition,
-            selection.length,
-            0.f, // x
-            0.f, // y
-            nullptr,
-            0, // metrics count
-            &actualHitTestCount
-            );
+        // 选择区涉及的段落
+        const auto first = m_buffer.GetLineFromPosition(selection.startPosition);
+        const auto last = m_buffer.GetLineFromPosition(selection.startPosition + selection.length);
+        const auto end = selection.startPosition + selection.length;
+        // 对每个段落进行点击测试, count为空时只统计数量
+        auto hit_test = [=](HitTestMetrics* metrics, uint32_t count) noexcept {
+            uint32_t total = 0;
+            for (auto i = first; i <= last; ++i) {
+                const auto layout = static_cast<IDWriteTextLayout*>(m_layouts.GetLayout(i));
+                if (!layout) continue;
+                const auto range = this->paragraph_range(i);
+                const auto begin = std::max(selection.startPosition, range.startPosition);
+                const auto finish = std::min(end, range.startPosition + range.length);
+                if (begin >= finish) continue;
+                uint32_t actualHitTestCount = 0;
+                layout->HitTestTextRange(
+                    begin - range.startPosition,
+                    finish - begin,
+                    0.f, // x
+                    m_layouts.GetTop(i) + m_fAlignY, // y
+                    metrics ? metrics + total : nullptr,
+                    metrics ? count - total : 0,
+                    &actualHitTestCount
+                    );
+                total += actualHitTestCount;
+                if (metrics && total >= count) break;
+            }
+            return total;
+        };
         // 保证数据正确
-        m_bufMetrice.NewSize(actualHitTestCount);
-        if (!actualHitTestCount) return;
+        m_bufMetrice.NewSize(hit_test(nullptr, 0));
+        if (!m_bufMetrice.GetCount()) return;
         // 正式获取
-        m_pLayout->HitTestTextRange(
-            selection.startPosition,
-            selection.length,
-            0.f, // x
-            0.f, // y
-            m_bufMetrice.GetData(),
-            m_bufMetrice.GetCount(),
-            &actualHitTestCount
-            );
+        hit_test(m_bufMetrice.GetData(), m_bufMetrice.GetCount());
     }
     /// <summary>
     /// Finalizes an instance of the 
@@ -1593,7 +1820,7 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     /// <returns></returns>
     EditableText::~EditableText() noexcept {
         ::ReleaseStgMedium(&m_recentMedium);
-        LongUI::SafeRelease(m_pLayout);
+        this->free_formats();
         LongUI::SafeRelease(m_pTextRenderer);
         LongUI::SafeRelease(m_pSelectionColor);
         //LongUI::SafeRelease(m_pDropSource);
@@ -1609,7 +1836,9 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
     /// </summary>
     /// <param name="host">The host control</param>
     EditableText::EditableText(UIControl* host) noexcept : m_pHost(host) {
-
+        m_layouter.formatter = [this](IDWriteTextLayout* layout, uint32_t pos, uint32_t len) noexcept {
+            this->apply_formats(layout, pos, len);
+        };
     }
     /// <summary>
     /// Initializes without specified xml node.
@@ -1631,10 +1860,12 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         m_pTextRenderer = UIManager.GetTextRenderer(0);
         // 检查格式
         IDWriteTextFormat* fmt = UIManager.GetTextFormat(LongUIDefaultTextFormatIndex);
-        // 创建布局
-        this->recreate_layout(fmt);
+        m_layouter.SetFormat(fmt);
+        m_layouter.SetMaxWidth(m_size.width);
         // 释放数据
         LongUI::SafeRelease(fmt);
+        // 创建布局
+        this->reset_text(L"", 0);
     }
     /// <summary>
     /// Initializes with specified xml node.
@@ -1654,15 +1885,15 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         // 颜色
         Helper::MakeStateBasedColor(node, prefix, this->color);
         std::memset(&m_recentMedium, 0, sizeof(m_recentMedium));
+        // 一次遍历收集属性
+        const Helper::AttributeView view(node, prefix);
         // 属性
-        auto attribute = [&node, prefix](const char* attr) {
-            return Helper::XMLGetValue(node, attr, prefix);
+        auto attribute = [&view](const char* attr) noexcept {
+            return view.Get(attr);
         };
         // bool属性
-        auto bool_attribute = [&node, prefix](const char* attr, bool def) {
-            auto v = Helper::XMLGetValue(node, attr, prefix);
-            if (!v) return def; auto ch = v[0];
-            return (ch == 't' || ch == 'T' || ch == '1');
+        auto bool_attribute = [&view](const char* attr, bool def) noexcept {
+            return view.GetBool(attr, def);
         };
         const char* str = nullptr;
         // 检查类型
@@ -1758,23 +1989,27 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         {
             assert(fmt && "bad action");
         }
+        // 格式与密码
+        m_layouter.SetFormat(fmt);
+        m_layouter.SetMaxWidth(m_size.width);
+        if (this->IsPassword()) m_layouter.SetPasswordChar(m_chPwd);
+        LongUI::SafeRelease(fmt);
         // 获取文本
         {
-            str = node.attribute(prefix).value();
-            assert(m_string.length() == 0 && m_string.data()[0] == 0);
-            m_string.FromUtf8(str);
+            str = view.Get("");
+            CUIString text;
+            text.FromUtf8(str);
 #ifdef _DEBUG
             if (this->IsPassword()) {
-                for (auto ch : m_string) {
+                for (auto ch : text) {
                     assert(!LongUI::IsSurrogate(ch) && "text cannot over 0xFFFF if password");
                 }
             }
 #endif
-            this->ensure_string(m_string);
+            this->ensure_string(text);
+            // 创建布局
+            this->reset_text(text.c_str(), static_cast<uint32_t>(text.length()));
         }
-        // 创建布局
-        this->recreate_layout(fmt);
-        LongUI::SafeRelease(fmt);
     }
     /// <summary>
     /// Ensure the specified string.
@@ -1941,14 +2176,15 @@ LONGUI_NAMESPACE_BEGIN namespace Component {
         // 初始化状态
         m_sttBasicNow = m_sttBasicOld = basic;
         m_sttExtraNow = m_sttExtraOld = extra;
+        const Helper::AttributeView view(node, prefix);
         // 动画类型
-        auto atype = Helper::GetEnumFromXml(
-            node, AnimationType::Type_CubicEaseIn, "animationtype", prefix
+        auto atype = Helper::GetEnumFromView(
+            view, AnimationType::Type_CubicEaseIn, "animationtype"
         );
         m_aniBasic.type = m_aniExtra.type = atype;
         // 动画持续时间
         const char* str = nullptr;
-        if ((str = Helper::XMLGetValue(node, "animationduration", prefix))) {
+        if ((str = view.Get("animationduration"))) {
             m_aniBasic.duration = m_aniExtra.duration = LongUI::AtoF(str);
         }
     }
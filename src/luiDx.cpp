@@ -7,6 +7,8 @@
 #include <LongUI/luiUiMeta.h>
 #include <LongUI/luiUiHlper.h>
 #include <dwrite_2.h>
+#include <algorithm>
+#include <cfloat>
 
 // longui::impl 命名空间
 namespace LongUI { namespace impl {
@@ -246,8 +248,10 @@ auto LongUI::DX::MakeTextFormat(
     }
     // xml 节点
     {
-        auto get_attribute = [=](const char* name) noexcept {
-            return Helper::XMLGetValue(node, name, prefix);
+        // 一次遍历收集属性
+        const Helper::AttributeView view(node, prefix);
+        auto get_attribute = [&view](const char* name) noexcept {
+            return view.Get(name);
         };
         // 字体名称
         auto str = get_attribute("family");
@@ -270,13 +274,13 @@ auto LongUI::DX::MakeTextFormat(
         }
         // 字体风格
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(node, static_cast<DWRITE_FONT_STYLE>(data.prop.style), "style", prefix));
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(view, static_cast<DWRITE_FONT_STYLE>(data.prop.style), "style"));
             create_a_new_one = tmp != data.prop.style || create_a_new_one;
             data.prop.style = tmp;
         }
         // 字体拉伸
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(node, static_cast<DWRITE_FONT_STRETCH>(data.prop.stretch), "stretch", prefix));
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(view, static_cast<DWRITE_FONT_STRETCH>(data.prop.stretch), "stretch"));
             create_a_new_one = tmp != data.prop.stretch || create_a_new_one;
             data.prop.stretch = tmp;
         }
@@ -290,45 +294,40 @@ auto LongUI::DX::MakeTextFormat(
         }
         // 阅读进行方向
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(
-                node, static_cast<DWRITE_READING_DIRECTION>(data.prop.reading), 
-                "readingdirection", prefix)
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(
+                view, static_cast<DWRITE_READING_DIRECTION>(data.prop.reading), "readingdirection")
                 );
             create_a_new_one = tmp != data.prop.reading || create_a_new_one;
             data.prop.reading = tmp;
         }
         // 段落排列方向
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(
-                node, static_cast<DWRITE_FLOW_DIRECTION>(data.prop.flow), 
-                "flowdirection", prefix)
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(
+                view, static_cast<DWRITE_FLOW_DIRECTION>(data.prop.flow), "flowdirection")
                 );
             create_a_new_one = tmp != data.prop.flow || create_a_new_one;
             data.prop.flow = tmp;
         }
         // 段落(垂直)对齐
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(
-                node, static_cast<DWRITE_PARAGRAPH_ALIGNMENT>(data.prop.valign), 
-                "valign", prefix)
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(
+                view, static_cast<DWRITE_PARAGRAPH_ALIGNMENT>(data.prop.valign), "valign")
                 );
             create_a_new_one = tmp != data.prop.valign || create_a_new_one;
             data.prop.valign = tmp;
         }
         // 文本(水平)对齐
         {
-            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromXml(
-                node, static_cast<DWRITE_TEXT_ALIGNMENT>(data.prop.halign), 
-                "align", prefix)
+            auto tmp = static_cast<uint8_t>(Helper::GetEnumFromView(
+                view, static_cast<DWRITE_TEXT_ALIGNMENT>(data.prop.halign), "align")
                 );
             create_a_new_one = tmp != data.prop.halign || create_a_new_one;
             data.prop.halign = tmp;
         }
         // 设置自动换行
         {
-            auto tmp = static_cast<uint32_t>(Helper::GetEnumFromXml(
-                node, static_cast<DWRITE_WORD_WRAPPING>(data.prop.wrapping), 
-                "wordwrapping", prefix)
+            auto tmp = static_cast<uint32_t>(Helper::GetEnumFromView(
+                view, static_cast<DWRITE_WORD_WRAPPING>(data.prop.wrapping), "wordwrapping")
                 );
             create_a_new_one = tmp != data.prop.wrapping || create_a_new_one;
             data.prop.wrapping = tmp;
@@ -345,6 +344,94 @@ auto LongUI::DX::MakeTextFormat(
     return S_FALSE;
 }
 
+/// <summary>
+/// Creates the text layout for cache.
+/// 为布局缓存创建文本布局
+/// </summary>
+/// <param name="key">The key.</param>
+/// <returns></returns>
+auto LongUI::DX::CUITextLayoutBackend::CreateLayout(const TextLayoutKey& key) noexcept -> void* {
+    IDWriteTextLayout* layout = nullptr;
+    auto hr = UIManager_DWriteFactory->CreateTextLayout(
+        key.text, key.length,
+        static_cast<IDWriteTextFormat*>(key.format),
+        key.width, key.height,
+        &layout
+    );
+    longui_debug_hr(hr, L"UIManager_DWriteFactory->CreateTextLayout faild");
+    return layout;
+}
+
+/// <summary>
+/// Estimates memory used by layout.
+/// DWrite 不提供内存占用, 按字符与行数估算
+/// </summary>
+/// <param name="layout">The layout.</param>
+/// <param name="key">The key.</param>
+/// <returns></returns>
+auto LongUI::DX::CUITextLayoutBackend::MeasureLayout(void* layout, const TextLayoutKey& key) noexcept -> uint32_t {
+    DWRITE_TEXT_METRICS metrics; metrics.lineCount = 1;
+    static_cast<IDWriteTextLayout*>(layout)->GetMetrics(&metrics);
+    // 字形/簇/行信息
+    constexpr uint32_t BASE = 512, PER_CHAR = 40;
+    return BASE + key.length * PER_CHAR + metrics.lineCount * sizeof(DWRITE_LINE_METRICS);
+}
+
+/// <summary>
+/// Sets the text format.
+/// </summary>
+/// <param name="fmt">The format.</param>
+/// <returns></returns>
+void LongUI::DX::CUIParagraphLayouter::SetFormat(IDWriteTextFormat* fmt) noexcept {
+    LongUI::SafeRelease(m_pFormat);
+    m_pFormat = LongUI::SafeAcquire(fmt);
+}
+
+/// <summary>
+/// Creates the text layout for paragraph.
+/// 为段落创建文本布局, 高度不限, 段落对齐由调用者处理
+/// </summary>
+/// <param name="text">The text.</param>
+/// <param name="length">The length.</param>
+/// <returns></returns>
+auto LongUI::DX::CUIParagraphLayouter::CreateLayout(const wchar_t* text, uint32_t length) noexcept -> void* {
+    assert(m_pFormat && "set format first");
+    IDWriteTextLayout* layout = nullptr;
+    HRESULT hr = S_OK;
+    const auto create = [&](const wchar_t* str) noexcept {
+        hr = UIManager_DWriteFactory->CreateTextLayout(
+            str, length, m_pFormat,
+            m_fWidth, FLT_MAX,
+            &layout
+        );
+    };
+    // 密码
+    if (m_chPwd) {
+        LongUI::SafeBuffer<wchar_t>(length + 1, [=, &create](wchar_t* const buf) noexcept {
+            std::fill(buf, buf + length, m_chPwd);
+            buf[length] = 0;
+            create(buf);
+        });
+    }
+    else {
+        create(text);
+    }
+    longui_debug_hr(hr, L"UIManager_DWriteFactory->CreateTextLayout faild");
+    if (layout) layout->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    return layout;
+}
+
+/// <summary>
+/// Gets the height of layout.
+/// </summary>
+/// <param name="layout">The layout.</param>
+/// <returns></returns>
+auto LongUI::DX::CUIParagraphLayouter::GetLayoutHeight(void* layout) noexcept -> float {
+    DWRITE_TEXT_METRICS metrics; metrics.height = 0.f;
+    static_cast<IDWriteTextLayout*>(layout)->GetMetrics(&metrics);
+    return metrics.height;
+}
+
 // 从 文本格式创建几何
 auto LongUI::DX::CreateTextPathGeometry(
     IN const char32_t* utf32_string,
@@ -737,10 +824,8 @@ namespace LongUI { namespace impl {
                 } ruby ;
             };
         };
-        // 构造函数
+        // 构造函数, 缓存在帧内存池上, 无需析构
         ez_xml_parser() noexcept = default;
-        // 析构函数
-        ~ez_xml_parser() noexcept;
         // 标记标签起始
         void mk_tagbegin() noexcept;
         // 标记标签起始
@@ -793,16 +878,6 @@ namespace LongUI { namespace impl {
         unit        sets_buffer[FIXED_BUF_LEN];
     };
     /// <summary>
-    /// Finalizes an instance of the <see cref="ez_xml_parser"/> class.
-    /// </summary>
-    /// <returns></returns>
-    ez_xml_parser::~ez_xml_parser() noexcept {
-        // 释放缓存
-        if (buffer != fixed_buffer) LongUI::NormalFree(buffer);
-        if (inits != init_buffer) LongUI::NormalFree(inits);
-        if (sets != sets_buffer) LongUI::NormalFree(sets);
-    }
-    /// <summary>
     /// push the specified char to this
     /// </summary>
     /// <param name="ch">The ch.</param>
@@ -834,10 +909,9 @@ namespace LongUI { namespace impl {
         // 保证空间
         if (inits_top == inits + inits_len) {
             auto oldbuf = inits; inits_len *= 2;
-            inits = LongUI::NormalAllocT<unit>(inits_len);
+            inits = CUIFrameArena::Get().AllocT<unit>(inits_len);
             if (inits) std::memcpy(inits, oldbuf, (char*)(inits_top) - (char*)(oldbuf));
             inits_top = inits + (inits_top - oldbuf);
-            if (oldbuf != init_buffer) LongUI::NormalFree(oldbuf);
             if (!inits) return;
         }
         // 标记起始位置
@@ -881,10 +955,9 @@ namespace LongUI { namespace impl {
         // 保证空间
         if (sets_top == sets + sets_len) {
             auto oldbuf = sets; sets_len *= 2;
-            sets = LongUI::NormalAllocT<unit>(sets_len);
+            sets = CUIFrameArena::Get().AllocT<unit>(sets_len);
             if (sets) std::memcpy(sets, oldbuf, (char*)(sets_top) - (char*)(oldbuf));
             sets_top = sets + (sets_top - oldbuf);
-            if (oldbuf != sets_buffer) LongUI::NormalFree(oldbuf);
             if (!sets) return;
         }
         // 图片占位符添加
@@ -920,9 +993,8 @@ namespace LongUI { namespace impl {
     /// <returns></returns>
     void ez_xml_parser::reallocstr() noexcept {
         auto oldbuf = buffer; 
-        buffer = LongUI::NormalAllocT<xmlchar_t>(buflen);
+        buffer = CUIFrameArena::Get().AllocT<xmlchar_t>(buflen);
         if (buffer) std::memcpy(buffer, oldbuf, sizeof(wchar_t) * strlen);
-        if (oldbuf != fixed_buffer) LongUI::NormalFree(oldbuf);
     }
     /// <summary>
     /// Set_attrs the specified a.
@@ -1198,8 +1270,9 @@ auto LongUI::DX::FormatTextXML(
 #ifdef _DEBUG
     assert(DX::CheckXmlValidity(format) && "bad xml, you should check it");
 #endif
-    // 简易解析器
-    auto xml_parser_ptr = LongUI::NormalAllocT<impl::ez_xml_parser>(1);
+    // 简易解析器, 临时数据都在帧内存池上
+    CUIFrameArenaScope scope;
+    auto xml_parser_ptr = scope->AllocT<impl::ez_xml_parser>(1);
     if (!xml_parser_ptr) return nullptr;
     xml_parser_ptr->impl::ez_xml_parser::ez_xml_parser();
     auto& xmlparser = *xml_parser_ptr;
@@ -1373,8 +1446,6 @@ auto LongUI::DX::FormatTextXML(
     // 结尾处理
 oom_error:
     assert(layout && "error, ignore this meesage");
-    xml_parser_ptr->impl::ez_xml_parser::~ez_xml_parser();
-    LongUI::NormalFree(xml_parser_ptr);
     return layout;
 }
 
@@ -1623,7 +1694,13 @@ namespace LongUI { namespace DX {
         cctype ch = 0;
         constexpr int CoreML_BUFFER_LENGTH = 2048;
         cctype text[CoreML_BUFFER_LENGTH]; auto text_itr = text;
-        EzContainer::FixedStack<RANGE_DATA, 1024> stack_check, stack_set;
+        // 格式栈较大, 放在帧内存池上而不是线程栈上
+        using RangeStack = EzContainer::FixedStack<RANGE_DATA, 1024>;
+        CUIFrameArenaScope scope;
+        const auto stacks = scope->AllocT<RangeStack>(2);
+        if (!stacks) return static_cast<IDWriteTextLayout*>(nullptr);
+        auto& stack_check = *new(stacks + 0) RangeStack;
+        auto& stack_set = *new(stacks + 1) RangeStack;
         // 遍历字符串
         while ((ch = *fmt)) {
             // 出现%标记
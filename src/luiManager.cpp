@@ -1,6 +1,8 @@
 ﻿#include "Core/luiManager.h"
 #include "LongUI/luiUiHlper.h"
 #include "LongUI/luiUiMeta.h"
+#include "LongUI/luiUiLayout.h"
+#include "Graphics/luiGrSvg.h"
 // 控件
 #include "Control/UIComboBox.h"
 #include "Control/UIRadioButton.h"
@@ -40,6 +42,8 @@ namespace LongUI { namespace impl{
     template<class T> inline auto destory_object(T& obj) noexcept { 
         obj.~T(); 
     }
+    // pinned bitmap tick, never evicted
+    constexpr uint32_t BITMAP_PINNED = ~uint32_t(0);
 }}
 
 #ifdef _DEBUG
@@ -70,12 +74,10 @@ auto LongUI::CUIManager::Initialize(IUIConfigure* config) noexcept ->HRESULT {
     m_vDelayCleanup.reserve(16);
     m_vDelayDispose.reserve(16);
     m_vWindows.reserve(16);
-    m_vTimeCapsules.reserve(32);
     // 内存不足
     if (!m_vDelayCleanup.isok() 
         || !m_vWindows.isok() 
         || !m_vDelayDispose.isok()
-        || !m_vTimeCapsules.isok()
         ) {
         return E_OUTOFMEMORY;
     }
@@ -221,7 +223,8 @@ auto LongUI::CUIManager::Initialize(IUIConfigure* config) noexcept ->HRESULT {
                 sizeof(void*) * m_cCountBrs +
                 sizeof(void*) * m_cCountTf +
                 sizeof(pugi::xml_node) * m_cCountCtrlTemplate +
-                (sizeof(HICON) + sizeof(LongUI::Meta)) * m_cCountMt;
+                (sizeof(HICON) + sizeof(LongUI::Meta)) * m_cCountMt +
+                sizeof(uint32_t) * m_cCountBmp;
             return buffer_length;
         };
         m_cCountBmp = m_cCountBrs = m_cCountTf = m_cCountMt = 1;
@@ -246,6 +249,7 @@ auto LongUI::CUIManager::Initialize(IUIConfigure* config) noexcept ->HRESULT {
             m_pMetasBuffer = reinterpret_cast<decltype(m_pMetasBuffer)>(m_ppTextFormats + m_cCountTf);
             m_phMetaIcon = reinterpret_cast<decltype(m_phMetaIcon)>(m_pMetasBuffer + m_cCountMt);
             m_pTemplateNodes = reinterpret_cast<decltype(m_pTemplateNodes)>(m_phMetaIcon + m_cCountMt);
+            m_pBitmapTick = reinterpret_cast<decltype(m_pBitmapTick)>(m_pTemplateNodes + m_cCountCtrlTemplate);
             // 初始化
             for (auto itr = m_pTemplateNodes; itr < m_pTemplateNodes + m_cCountCtrlTemplate; ++itr) {
                 impl::create_object(*itr);
@@ -445,11 +449,9 @@ void LongUI::CUIManager::Uninitialize() noexcept {
         LongUI::SafeRelease(renderer);
     }
     // 释放时间胶囊
-    for (auto cap : m_vTimeCapsules) {
-        assert(cap);
-        cap->Dispose();
-    }
-    m_vTimeCapsules.clear();
+    m_oTimeWheel.Clear();
+    // 释放文本布局缓存
+    m_oLayoutCache.Clear();
     // 释放公共设备无关资源
     {
         // 释放文本格式
@@ -493,7 +495,8 @@ void LongUI::CUIManager::Uninitialize() noexcept {
     }
     m_cCountMt = m_cCountTf = m_cCountBmp = m_cCountBrs = 0;
     // 清理
-    m_hashStr2CreateFunc.Clear();
+    m_hashAtom2CreateFunc.Clear();
+    SVG::ClearPathCache();
 #ifdef _DEBUG
     long time = ::timeGetTime() - m_dbgExitTime;
     UIManager << DL_Log
@@ -513,10 +516,10 @@ auto LongUI::CUIManager::do_creating_event(CreateEventType type) noexcept ->HRES
     assert(type > Type_CreateControl_NullParentPointer);
     HRESULT hr = S_OK;
     // 遍历hash表
-    m_hashStr2CreateFunc.ForEach([type, &hr](StringTable::Unit* unit) noexcept {
+    m_hashAtom2CreateFunc.ForEach([type, &hr](EzContainer::EzAtomMap<CreateControlEvent>::Unit* unit) noexcept {
         assert(unit);
         if (SUCCEEDED(hr)) {
-            auto func = reinterpret_cast<CreateControlEvent>(unit->value);
+            auto func = unit->value;
             void* ptr = func(type, pugi::xml_node(nullptr));
             size_t data = reinterpret_cast<size_t>(ptr);
             hr = static_cast<HRESULT>(data);
@@ -590,11 +593,11 @@ auto LongUI::CUIManager::GetCreateFunc(const char* clname) noexcept -> CreateCon
     // 检查 !white_space(clname[0]) && 
     assert(clname && clname[0] && "bad argment");
     // 查找
-    auto result = m_hashStr2CreateFunc.Find(clname);
+    auto result = this->GetCreateFunc(CUIAtom::Find(clname));
     // 检查
     assert(result && "class not found");
     // 返回
-    return reinterpret_cast<CreateControlEvent>(*result);
+    return result;
 }
 
 /// <summary>
@@ -707,9 +710,13 @@ void LongUI::CUIManager::Run() noexcept {
 #endif
                 }
                 // 更新时间胶囊
-                UIManager.update_time_capsules(UIManager.m_fDeltaTime);
+                {
+                    LongUIProfileScope(update_time_capsules);
+                    UIManager.update_time_capsules(UIManager.m_fDeltaTime);
+                }
                 // 刷新窗口
                 for (auto window : UIManager.m_vWindows) {
+                    LongUIProfileScopeTag(WindowUpdate, window->GetViewport()->name.c_str());
                     window->Update();
                 }
                 // 更新输入
@@ -721,6 +728,7 @@ void LongUI::CUIManager::Run() noexcept {
                 CUIDxgiAutoLocker locker;
                 // 渲染窗口
                 for (auto window : UIManager.m_vWindows) {
+                    LongUIProfileScopeTag(WindowRender, window->GetViewport()->name.c_str());
                     window->Render();
                 }
             }
@@ -730,6 +738,10 @@ void LongUI::CUIManager::Run() noexcept {
                 CUIDataAutoLocker locker;
                 // 延迟清理
                 UIManager.cleanup_delay_cleanup_chain();
+                // 位图淘汰
+                UIManager.evict_bitmaps();
+                // 重置帧内存池
+                CUIFrameArena::Get().Reset();
 #ifdef _DEBUG
                 // 计算平均FPS
                 auto& fpsc = UIManager.m_vFpsCalculator;
@@ -741,10 +753,13 @@ void LongUI::CUIManager::Run() noexcept {
                     for (auto t : fpsc) time += t;
                     time /= float(frame);
                     wchar_t buffer[1024];
+                    const auto& arena = CUIFrameArena::Get();
                     std::swprintf(
                         buffer, lengthof(buffer),
-                        L"delta: %.2fms -- %2.2f fps",
-                        time * 1000.f, 1.f / time
+                        L"delta: %.2fms -- %2.2f fps -- arena: %u allocs, %u bytes",
+                        time * 1000.f, 1.f / time,
+                        unsigned(arena.GetLastFrameAllocCount()),
+                        unsigned(arena.GetLastFrameAllocBytes())
                     );
                     auto hwnd = UIManager.m_hToolWnd;
                     UIManager.DataUnlock();
@@ -757,10 +772,15 @@ void LongUI::CUIManager::Run() noexcept {
             // 退出检查
             if (UIManager.m_exitFlag) break;
             // 等待垂直同步
-            UIManager.wait_for_vblank();
+            {
+                LongUIProfileScope(wait_for_vblank);
+                UIManager.wait_for_vblank();
+            }
         }
         return 0;
     };
+    // 消息线程: 其他线程调用Exit时向其投递WM_QUIT
+    m_idMsgThread = ::GetCurrentThreadId();
     // 需要std::thread?
 #ifdef LONGUI_RENDER_IN_STD_THREAD
     std::thread thread(render_thread_func, nullptr);
@@ -775,6 +795,8 @@ void LongUI::CUIManager::Run() noexcept {
     while (::GetMessageW(&msg, nullptr, 0, 0)) {
         ::TranslateMessage(&msg);
         ::DispatchMessageW(&msg);
+        // 消息线程的帧内存池按消息重置
+        CUIFrameArena::Get().Reset();
     }
     // 等待线程
 #ifdef LONGUI_RENDER_IN_STD_THREAD
@@ -787,6 +809,7 @@ void LongUI::CUIManager::Run() noexcept {
         thread = nullptr;
     }
 #endif
+    m_idMsgThread = 0;
     // 再次清理
     this->cleanup_delay_cleanup_chain();
     // 尝试强行关闭
@@ -896,6 +919,8 @@ auto LongUI::CUIManager::create_control(
     }
     // 检查
     assert(function && "bad idea");
+    // 在所属窗口的池中创建
+    CUIObjectPoolScope scope(cp->GetWindow() ? cp->GetWindow()->GetControlPool() : nullptr);
     return function ? function(cp->GetCET(), node) : nullptr;
 }
 
@@ -906,11 +931,13 @@ auto LongUI::CUIManager::create_control(
 /// <param name="node">The node.</param>
 /// <param name="parent">The parent.</param>
 /// <param name="call">The call.</param>
+/// <param name="tree">The compiled layout tree, null for xml.</param>
 /// <returns></returns>
 auto LongUI::CUIManager::create_ui_window(
     pugi::xml_node node,
     XUIBaseWindow* parent,
-    callback_create_viewport call) noexcept -> XUIBaseWindow* {
+    callback_create_viewport call,
+    const layout_tree* tree) noexcept -> XUIBaseWindow* {
     assert(node && call && "bad arguments");
     // 初始化
     HRESULT hr;
@@ -924,7 +951,10 @@ auto LongUI::CUIManager::create_ui_window(
     assert(window && "create system window failed");
     if (!window) return nullptr;
     // 创建视口
-    auto viewport = call(node, window);
+    auto viewport = [=]() noexcept {
+        CUIObjectPoolScope scope(window->GetControlPool());
+        return call(node, window);
+    }();
     assert(viewport && "create viewport failed");
     if (!viewport) {
         window->Dispose();
@@ -952,7 +982,11 @@ auto LongUI::CUIManager::create_ui_window(
     dbg_tmtr.MovStartEnd();
 #endif
     // 创建控件树
-    this->MakeControlTree(viewport, node);
+    {
+        LongUIProfileScope(make_control_tree);
+        if (tree) this->make_control_tree(viewport, *tree);
+        else this->MakeControlTree(viewport, node);
+    }
     // 完成创建
 #ifdef _DEBUG
     time = dbg_tmtr.Delta_ms<double>();
@@ -973,6 +1007,109 @@ auto LongUI::CUIManager::create_ui_window(
     return window;
 }
 
+// compiled layout tree
+struct LongUI::CUIManager::layout_tree {
+    // payload
+    const Layout::Payload*      payload;
+    // xml node for each layout node
+    pugi::xml_node*             nodes;
+    // create function for each control class
+    CreateControlEvent*         functions;
+};
+
+/// <summary>
+/// Create_ui_windows with the compiled layout.
+/// 利用编译后的布局创建UI窗口
+/// </summary>
+/// <param name="layout">The layout data, could be mapped from file.</param>
+/// <param name="length">The length of layout data.</param>
+/// <param name="call">The call.</param>
+/// <returns></returns>
+auto LongUI::CUIManager::create_ui_window(
+    const void* layout,
+    size_t length,
+    callback_create_viewport call) noexcept -> XUIBaseWindow* {
+    EzContainer::EzVector<uint8_t> buffer;
+    layout_tree tree = { nullptr, nullptr, nullptr };
+    // 载入布局
+    auto hr = Layout::Load(layout, length, buffer, tree.payload);
+    longui_debug_hr(hr, L"Layout::Load faild");
+    if (FAILED(hr)) return nullptr;
+    const auto payload = tree.payload;
+    const auto count = payload->node_count;
+    // 仅在创建期间使用
+    CUIFrameArenaScope scope;
+    tree.nodes = scope->AllocT<pugi::xml_node>(count);
+    tree.functions = scope->AllocT<CreateControlEvent>(payload->class_count + 1);
+    XUIBaseWindow* window = nullptr;
+    if (tree.nodes && tree.functions) {
+        // 每种控件类仅查找一次
+        const auto classes = Layout::GetClasses(payload);
+        for (uint32_t i = 0; i < payload->class_count; ++i) {
+            const auto name = Layout::GetString(payload, classes[i]);
+            tree.functions[i] = this->GetCreateFunc(CUIAtom::Find(name));
+        }
+        // 按广度优先顺序建立结点, 属性已合并模板
+        m_docWindow.reset();
+        for (uint32_t i = 0; i < count; ++i) impl::create_object(tree.nodes[i]);
+        hr = Layout::BuildXml(payload, m_docWindow, tree.nodes);
+        longui_debug_hr(hr, L"Layout::BuildXml faild");
+        // 创建窗口
+        if (SUCCEEDED(hr)) window = this->create_ui_window(tree.nodes[0], nullptr, call, &tree);
+        else this->ShowError(hr);
+    }
+    else {
+        this->ShowError(E_OUTOFMEMORY);
+    }
+    return window;
+}
+
+/// <summary>
+/// Makes the control tree with the compiled layout.
+/// 利用编译后的布局创建控件树
+/// </summary>
+/// <param name="root">The root.</param>
+/// <param name="tree">The tree.</param>
+/// <returns></returns>
+void LongUI::CUIManager::make_control_tree(UIContainer* root, const layout_tree& tree) noexcept {
+    assert(root && tree.payload && "bad argument");
+    const auto count = tree.payload->node_count;
+    const auto nodes = Layout::GetNodes(tree.payload);
+    // 结点对应的控件
+    CUIFrameArenaScope scope;
+    auto controls = scope->AllocT<UIControl*>(count);
+    if (!controls) {
+        this->ShowError(E_OUTOFMEMORY);
+        return;
+    }
+    controls[0] = root;
+    // 父结点总在子结点之前
+    for (uint32_t i = 1; i < count; ++i) {
+        controls[i] = nullptr;
+        const auto& node = nodes[i];
+        auto parent = controls[node.parent];
+        // 父控件创建失败或者不是容器则跳过
+        if (!parent || !(parent->flags & Flag_UIContainer)) continue;
+        auto container = static_cast<UIContainer*>(parent);
+        auto function = tree.functions[node.class_id];
+        UIControl* control = nullptr;
+        if (function) control = this->create_control(container, function, tree.nodes[i], 0);
+        if (!control) {
+            UIManager << DL_Error
+                << L" control class not found: "
+                << tree.nodes[i].name()
+                << L".or OOM"
+                << LongUI::endl;
+            continue;
+        }
+        // 添加子结点
+        container->Push(control);
+        // 去除引用
+        control->Release();
+        controls[i] = control;
+    }
+}
+
 /// <summary>
 /// Gets the color of the theme.
 /// 获取主题颜色
@@ -1037,10 +1174,10 @@ LongUI::CUIManager::~CUIManager() noexcept {
 auto LongUI::CUIManager::RegisterControlClass(
     CreateControlEvent func, const char* clname) noexcept ->HRESULT {
     assert(clname && clname[0] && "bad argument");
-    // 插入
-    auto result = m_hashStr2CreateFunc.Insert(m_oStringAllocator.CopyString(clname), func);
+    // 驻留类名
+    const auto atom = CUIAtom::Intern(clname);
     // 插入失败的原因只有一个->OOM
-    return result ? S_OK : E_OUTOFMEMORY;
+    return atom && m_hashAtom2CreateFunc.Insert(atom, func) ? S_OK : E_OUTOFMEMORY;
 }
 
 /// <summary>
@@ -1051,7 +1188,7 @@ auto LongUI::CUIManager::RegisterControlClass(
 /// <returns></returns>
 bool LongUI::CUIManager::IsRegisteredControlClass(const char* clname) noexcept {
     assert(clname && clname[0] && "bad argument");
-    return !!m_hashStr2CreateFunc.Find(clname);
+    return !!m_hashAtom2CreateFunc.Find(CUIAtom::Find(clname));
 }
 
 /// <summary>
@@ -1064,7 +1201,7 @@ void LongUI::CUIManager::UnregisterControlClass(const char* clname) noexcept {
     assert(clname && clname[0] && "bad argument");
     // 移除
     if (this->IsRegisteredControlClass(clname)) {
-        m_hashStr2CreateFunc.Remove(clname);
+        m_hashAtom2CreateFunc.Remove(CUIAtom::Find(clname));
     }
 #ifdef _DEBUG
     else {
@@ -1857,6 +1994,10 @@ auto LongUI::CUIManager::GetBitmap(size_t index) noexcept ->ID2D1Bitmap1* {
             );
         bitmap = m_ppBitmaps[index];
     }
+    // 记录使用时间
+    if (m_pBitmapTick[index] != impl::BITMAP_PINNED) {
+        m_pBitmapTick[index] = m_cNowTick;
+    }
     // 再没有数据则报错
     if (!bitmap) {
         UIManager << DL_Error << L"index @ " << long(index) << L"bitmap is null" << LongUI::endl;
@@ -1990,8 +2131,11 @@ void LongUI::CUIManager::GetMeta(size_t index, LongUI::Meta& meta) noexcept {
         meta.src_rect = meta_raw.src_rect;
         meta.rule = meta_raw.rule;
         meta.bitmap = this->GetBitmap(meta_raw.bitmap_index);
-        // 减少计数
+        // 减少计数: 图元不持有引用, 所以该位图不能被淘汰
         if (meta.bitmap) {
+            if (meta_raw.bitmap_index < m_cCountBmp) {
+                m_pBitmapTick[meta_raw.bitmap_index] = impl::BITMAP_PINNED;
+            }
             meta.bitmap->Release();
         }
     }
@@ -2001,6 +2145,81 @@ void LongUI::CUIManager::GetMeta(size_t index, LongUI::Meta& meta) noexcept {
     }
 }
 
+/// <summary>
+/// Prefetches the resources.
+/// 预读资源, 在首次渲染前载入
+/// </summary>
+/// <param name="type">The resource type.</param>
+/// <param name="index">The index array, null for all resources of this type.</param>
+/// <param name="count">The count of index.</param>
+/// <returns></returns>
+void LongUI::CUIManager::PrefetchResources(
+    IUIResourceLoader::ResourceType type, const size_t index[], size_t count) noexcept {
+    // 获取资源数量
+    size_t length = 0;
+    switch (type)
+    {
+    case LongUI::IUIResourceLoader::Type_Bitmap:    length = m_cCountBmp; break;
+    case LongUI::IUIResourceLoader::Type_Brush:     length = m_cCountBrs; break;
+    case LongUI::IUIResourceLoader::Type_TextFormat:length = m_cCountTf; break;
+    case LongUI::IUIResourceLoader::Type_Meta:      length = m_cCountMt; break;
+    default: assert(!"unknown resource type"); return;
+    }
+    // 全部载入: 0号为内建资源, 跳过
+    if (!index) count = length - 1;
+    for (size_t i = 0; i < count; ++i) {
+        const auto id = index ? index[i] : i + 1;
+        switch (type)
+        {
+        case LongUI::IUIResourceLoader::Type_Bitmap:
+            LongUI::SafeRelease(this->GetBitmap(id));
+            break;
+        case LongUI::IUIResourceLoader::Type_Brush:
+            LongUI::SafeRelease(this->GetBrush(id));
+            break;
+        case LongUI::IUIResourceLoader::Type_TextFormat:
+            LongUI::SafeRelease(this->GetTextFormat(id));
+            break;
+        case LongUI::IUIResourceLoader::Type_Meta:
+        {
+            LongUI::Meta meta; this->GetMeta(id, meta);
+            break;
+        }
+        }
+    }
+}
+
+/// <summary>
+/// Evicts the bitmaps unused for a long time.
+/// 淘汰长时间未使用的位图
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIManager::evict_bitmaps() noexcept {
+    // 大概每隔1秒, 检查一次
+    constexpr uint32_t CHECK_RATE = 1024 - 1;
+    if ((m_cNowTick & CHECK_RATE) > m_fDeltaTime * 1000.f) return;
+    // 0号为内建位图, 跳过
+    for (uint32_t i = 1; i < m_cCountBmp; ++i) {
+        auto& bitmap = m_ppBitmaps[i];
+        const auto tick = m_pBitmapTick[i];
+        if (!bitmap || tick == impl::BITMAP_PINNED) continue;
+        // 在Run之前载入(预读)的位图
+        if (!tick) { m_pBitmapTick[i] = m_cNowTick; continue; }
+        if (m_cNowTick - tick <= uint32_t(LongUIBitmapEvictTime)) continue;
+        // 仅由管理器持有时才能释放
+        bitmap->AddRef();
+        if (bitmap->Release() == 1) {
+            LongUI::SafeRelease(bitmap);
+#ifdef _DEBUG
+            UIManager << DL_Log
+                << L"bitmap @ " << long(i)
+                << L" evicted"
+                << LongUI::endl;
+#endif
+        }
+    }
+}
+
 /// <summary>
 /// Gets the meta hicon.
 /// 获取Meta的图标句柄
@@ -2180,48 +2399,12 @@ void LongUI::CUIManager::refresh_display_frequency() noexcept {
 
 
 /// <summary>
-/// 刷新时间胶囊
+/// 刷新时间胶囊, 只处理运行中以及到期的胶囊
 /// </summary>
-/// <param name="time">The time.</param>
+/// <param name="time">The delta time.</param>
 /// <returns></returns>
 void LongUI::CUIManager::update_time_capsules(float time) noexcept {
-    uint32_t deleted = 0;
-    // 遍历时间胶囊
-    for (auto& capsule : m_vTimeCapsules) {
-        assert(capsule && "bad time capsule");
-        if (capsule->Update(time)) {
-            capsule->Dispose();
-            capsule = nullptr;
-            ++deleted;
-        }
-    }
-    // 检查释放
-    if (deleted) {
-        uint32_t count = m_vTimeCapsules.size();
-        // 全部删除
-        if (count == deleted) {
-            m_vTimeCapsules.clear();
-        }
-        // 部分删除
-        else {
-            const auto data = m_vTimeCapsules.data();
-            auto last = data + (count - 1);
-            auto itr = data;
-            do {
-                // 空 -> 与最后一个交换
-                if (!(*itr)) {
-                    std::swap(*itr, *last);
-                    --last;
-                }
-                // 非空 -> 继续
-                else {
-                    ++itr;
-                }
-            } while (itr != last);
-            // 删除后面的
-            m_vTimeCapsules.resize(count - deleted);
-        }
-    }
+    m_oTimeWheel.Update(time);
 }
 
 /// <summary>
@@ -2231,15 +2414,7 @@ void LongUI::CUIManager::update_time_capsules(float time) noexcept {
 /// <param name="id">The identifier.</param>
 /// <returns></returns>
 void LongUI::CUIManager::remove_time_capsule(void* id) noexcept {
-    size_t realid = reinterpret_cast<size_t>(id);
-    for (auto itr = m_vTimeCapsules.begin(); itr != m_vTimeCapsules.end(); ++itr) {
-        auto capsule = *itr;
-        if (capsule->GetId() == realid) {
-            capsule->Dispose();
-            m_vTimeCapsules.erase(itr);
-            return;
-        }
-    }
+    m_oTimeWheel.Remove(reinterpret_cast<size_t>(id));
 }
 
 /// <summary>
@@ -2249,32 +2424,18 @@ void LongUI::CUIManager::remove_time_capsule(void* id) noexcept {
 /// <param name="call">The call.</param>
 /// <param name="id">The identifier.</param>
 /// <param name="time">The time.</param>
+/// <param name="delay">The delay before start.</param>
+/// <param name="period">The period, periodic capsule if greater than 0.</param>
 /// <returns></returns>
-void LongUI::CUIManager::push_time_capsule(TimeCapsuleCall && call, void* id, float time) noexcept {
+void LongUI::CUIManager::push_time_capsule(TimeCapsuleCall && call, void* id, float time, float delay, float period) noexcept {
     const size_t realid = reinterpret_cast<size_t>(id);
-    // 有效情况下
-    if (m_vTimeCapsules.isok()) {
-        // 创建胶囊
-        auto capsule = CUITimeCapsule::Create(std::move(call), realid, time);
-        // 创建失败
-        if (!capsule) return;
-        CUITimeCapsule** included = nullptr;
-        // 遍历检查是否已经拥有
-        for (auto& capsule : m_vTimeCapsules) {
-            if (capsule->GetId() == realid) {
-                included = &capsule;
-                break;
-            }
-        }
-        // 有的情况
-        if (included) {
-            (*included)->Dispose();
-            *(included) = capsule;
-            UIManager << DL_Log << "new capsule insteaded" << LongUI::endl;
-        }
-        else {
-            m_vTimeCapsules.push_back(capsule);
-        }
+    // 已经拥有则替换
+    if (m_oTimeWheel.Remove(realid)) {
+        UIManager << DL_Log << "new capsule insteaded" << LongUI::endl;
+    }
+    // 添加胶囊
+    if (!m_oTimeWheel.Add(std::move(call), realid, time, delay, period)) {
+        UIManager << DL_Error << L"OOM for time capsule" << LongUI::endl;
     }
 }
 
@@ -0,0 +1,75 @@
+﻿#include "luibase.h"
+#include "luiconf.h"
+#include "Platless/luiPlArena.h"
+
+
+/// <summary>
+/// Gets the arena of this thread.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIFrameArena::Get() noexcept -> CUIFrameArena& {
+    static thread_local CUIFrameArena s_arena;
+    return s_arena;
+}
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUIFrameArena"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUIFrameArena::~CUIFrameArena() noexcept {
+    for (auto block = m_pFirst; block; ) {
+        const auto next = block->next;
+        LongUI::NormalFree(block);
+        block = next;
+    }
+}
+
+/// <summary>
+/// Allocates in next block, creates new block if no one fits.
+/// </summary>
+/// <param name="size">The size.</param>
+/// <param name="align">The alignment.</param>
+/// <returns></returns>
+auto LongUI::CUIFrameArena::alloc_slow(size_t size, size_t align) noexcept -> void* {
+    auto& link = m_pCurrent ? m_pCurrent->next : m_pFirst;
+    // 跳过过小的块, 下一帧仍会复用
+    auto block = link;
+    while (block && size + align > block->capacity) block = block->next;
+    // 新建块, 紧接当前块
+    if (!block) {
+        size_t capacity = LongUIFrameArenaBlockSize;
+        if (size + align > capacity) capacity = size + align;
+        block = reinterpret_cast<Block*>(LongUI::NormalAlloc(sizeof(Block) + capacity));
+        if (!block) return nullptr;
+        block->capacity = capacity;
+        block->next = link;
+        link = block;
+        m_cCapacity += capacity;
+    }
+    m_pCurrent = block;
+    m_cUsed = 0;
+    return this->Alloc(size, align);
+}
+
+/// <summary>
+/// Resets for new frame, oversized blocks are freed.
+/// 重置: 超大块只为单次请求服务, 直接释放
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIFrameArena::Reset() noexcept {
+    m_cLastAllocCount = m_cAllocCount;
+    m_cLastAllocBytes = m_cAllocBytes;
+    m_cAllocCount = 0;
+    m_cAllocBytes = 0;
+    for (auto link = &m_pFirst; *link; ) {
+        const auto block = *link;
+        if (block->capacity > LongUIFrameArenaBlockSize) {
+            *link = block->next;
+            m_cCapacity -= block->capacity;
+            LongUI::NormalFree(block);
+        }
+        else link = &block->next;
+    }
+    m_pCurrent = m_pFirst;
+    m_cUsed = 0;
+}
@@ -0,0 +1,216 @@
+﻿#include "luibase.h"
+#include "luiconf.h"
+#include "Platless/luiPlAtom.h"
+#include "Platless/luiPlLock.h"
+#include <atomic>
+#include <new>
+
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // predefined atoms, same order as XmlAttribute::AtomID
+    static const char* const PREDEFINED_ATOMS[] = {
+        XmlAttribute::ControlName,
+        XmlAttribute::Script,
+        XmlAttribute::LayoutWeight,
+        XmlAttribute::LayoutContext,
+        XmlAttribute::Visible,
+        XmlAttribute::UserDefinedString,
+        XmlAttribute::BackgroudBrush,
+        XmlAttribute::AllSize,
+        XmlAttribute::Margin,
+        XmlAttribute::BorderWidth,
+        XmlAttribute::BorderRound,
+        XmlAttribute::TemplateID,
+        XmlAttribute::RenderingPriority,
+        XmlAttribute::IsRenderParent,
+        XmlAttribute::IsClipStrictly,
+        XmlAttribute::Enabled,
+        XmlAttribute::IsSkipUpdateInvisible,
+        XmlAttribute::MarginalDirection,
+        XmlAttribute::TemplateSize,
+        XmlAttribute::IsHostPosterityAlways,
+        XmlAttribute::IsZoomMarginalControl,
+        XmlAttribute::WindowClearColor,
+        XmlAttribute::WindowTitleName,
+        XmlAttribute::WindowTextAntiMode,
+    };
+    static_assert(
+        sizeof(PREDEFINED_ATOMS) / sizeof(PREDEFINED_ATOMS[0]) == XmlAttribute::ATOM_PREDEFINED_COUNT - 1,
+        "predefined atom count not matched"
+    );
+    // hash for string view
+    static inline auto hash_atom(const char* str, uint32_t len) noexcept {
+        constexpr uint32_t seed = 131;
+        uint32_t code = 0;
+        for (auto end = str + len; str != end; ++str) code = code * seed + uint8_t(*str);
+        code ^= code >> 16; code *= 0x85ebca6bui32;
+        code ^= code >> 13; code *= 0xc2b2ae35ui32;
+        code ^= code >> 16;
+        return code;
+    }
+    // atom table, entries never freed until exit
+    class atom_table {
+        // chunk of entries, data follows
+        struct chunk { chunk* next; };
+        // size of chunk
+        enum : uint32_t { CHUNK_SIZE = 1024 * 4, MIN_CAPACITY = 256 };
+    public:
+        // ctor
+        atom_table() noexcept {
+            for (auto str : PREDEFINED_ATOMS) {
+                const auto atom = this->intern(str, static_cast<uint32_t>(std::strlen(str)));
+                assert(atom && "OOM in initializing");
+                (void)atom;
+            }
+        }
+        // dtor
+        ~atom_table() noexcept {
+            for (auto itr = m_pChunk; itr; ) {
+                const auto next = itr->next;
+                LongUI::NormalFree(itr);
+                itr = next;
+            }
+            LongUI::NormalFree(m_ppTable);
+        }
+        // count of atoms
+        auto count() const noexcept { return m_cCount; }
+        // find atom
+        auto find(const char* str, uint32_t len, uint32_t code) const noexcept -> const AtomEntry* {
+            if (!m_cCapacity) return nullptr;
+            const auto mask = m_cCapacity - 1;
+            for (auto index = code & mask; ; index = (index + 1) & mask) {
+                const auto entry = m_ppTable[index];
+                if (!entry) return nullptr;
+                if (entry->hash == code && entry->length == len
+                    && !std::memcmp(entry + 1, str, len)) return entry;
+            }
+        }
+        // intern atom
+        auto intern(const char* str, uint32_t len) noexcept -> const AtomEntry* {
+            const auto code = hash_atom(str, len);
+            if (const auto entry = this->find(str, len, code)) return entry;
+            // 负载因子 1/2
+            if ((m_cCount + 1) * 2 > m_cCapacity && !this->rehash()) return nullptr;
+            const auto entry = this->alloc_entry(len);
+            if (!entry) return nullptr;
+            entry->id = ++m_cCount;
+            entry->hash = code;
+            entry->length = len;
+            const auto text = reinterpret_cast<char*>(entry + 1);
+            std::memcpy(text, str, len);
+            text[len] = 0;
+            const auto mask = m_cCapacity - 1;
+            auto index = code & mask;
+            while (m_ppTable[index]) index = (index + 1) & mask;
+            m_ppTable[index] = entry;
+            return entry;
+        }
+        // lock
+        void lock() noexcept { m_lock.Lock(); }
+        // unlock
+        void unlock() noexcept { m_lock.Unlock(); }
+    private:
+        // allocate entry in chunk
+        auto alloc_entry(uint32_t len) noexcept -> AtomEntry* {
+            const auto size = (sizeof(AtomEntry) + len + 1 + alignof(AtomEntry) - 1) & ~(alignof(AtomEntry) - 1);
+            // 新建块, 长字符串独占一块
+            if (size > m_cLeft) {
+                const auto capacity = size > CHUNK_SIZE ? size : size_t(CHUNK_SIZE);
+                const auto ptr = reinterpret_cast<chunk*>(LongUI::NormalAlloc(sizeof(chunk) + capacity));
+                if (!ptr) return nullptr;
+                ptr->next = m_pChunk;
+                m_pChunk = ptr;
+                m_pPos = reinterpret_cast<char*>(ptr + 1);
+                m_cLeft = capacity;
+            }
+            const auto entry = reinterpret_cast<AtomEntry*>(m_pPos);
+            m_pPos += size;
+            m_cLeft -= size;
+            return entry;
+        }
+        // rehash to double size
+        bool rehash() noexcept {
+            const auto cap = m_cCapacity ? m_cCapacity * 2 : uint32_t(MIN_CAPACITY);
+            const auto table = LongUI::NormalAllocT<const AtomEntry*>(cap);
+            if (!table) return false;
+            std::memset(table, 0, sizeof(table[0]) * cap);
+            for (uint32_t i = 0; i < m_cCapacity; ++i) {
+                const auto entry = m_ppTable[i];
+                if (!entry) continue;
+                auto index = entry->hash & (cap - 1);
+                while (table[index]) index = (index + 1) & (cap - 1);
+                table[index] = entry;
+            }
+            LongUI::NormalFree(m_ppTable);
+            m_ppTable = table;
+            m_cCapacity = cap;
+            return true;
+        }
+    private:
+        // hash table
+        const AtomEntry**       m_ppTable = nullptr;
+        // chunk list
+        chunk*                  m_pChunk = nullptr;
+        // position in current chunk
+        char*                   m_pPos = nullptr;
+        // bytes left in current chunk
+        size_t                  m_cLeft = 0;
+        // capacity of table, power of 2
+        uint32_t                m_cCapacity = 0;
+        // count of atoms
+        uint32_t                m_cCount = 0;
+        // spin lock
+        CUISpinLock             m_lock;
+    };
+    // get atom table
+    static auto get_atom_table() noexcept -> atom_table& {
+        static atom_table s_table;
+        return s_table;
+    }
+}}
+
+/// <summary>
+/// Interns the specified string view.
+/// </summary>
+/// <param name="str">The string, need not be null-terminated.</param>
+/// <param name="len">The length.</param>
+/// <returns>null atom if OOM</returns>
+auto LongUI::CUIAtom::Intern(const char* str, uint32_t len) noexcept -> CUIAtom {
+    assert(str && "bad argument");
+    auto& table = impl::get_atom_table();
+    CUIAtom atom;
+    table.lock();
+    atom.m_pEntry = table.intern(str, len);
+    table.unlock();
+    return atom;
+}
+
+/// <summary>
+/// Finds the interned string view.
+/// </summary>
+/// <param name="str">The string, need not be null-terminated.</param>
+/// <param name="len">The length.</param>
+/// <returns>null atom if not interned</returns>
+auto LongUI::CUIAtom::Find(const char* str, uint32_t len) noexcept -> CUIAtom {
+    assert(str && "bad argument");
+    const auto code = impl::hash_atom(str, len);
+    auto& table = impl::get_atom_table();
+    CUIAtom atom;
+    table.lock();
+    atom.m_pEntry = table.find(str, len, code);
+    table.unlock();
+    return atom;
+}
+
+/// <summary>
+/// Gets the count of interned strings.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIAtom::GetCount() noexcept -> uint32_t {
+    auto& table = impl::get_atom_table();
+    table.lock();
+    const auto count = table.count();
+    table.unlock();
+    return count;
+}
@@ -0,0 +1,256 @@
+﻿#include "Platless/luiPlEnum.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// tables not longer than this are scanned linearly
+#define LONGUI_ENUM_LINEAR_MAX 8
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // 编译期比较名称
+    static constexpr bool less_name(const char* a, const char* b) noexcept {
+        return *a == *b ? (*a && less_name(a + 1, b + 1)) : uint8_t(*a) < uint8_t(*b);
+    }
+    // 编译期检查名称严格升序
+    template<size_t N>
+    static constexpr bool sorted_items(const EnumItem(&list)[N], size_t i = 1) noexcept {
+        return i >= N || (less_name(list[i - 1].name, list[i].name) && sorted_items(list, i + 1));
+    }
+    // 动画类型属性值列表
+    constexpr EnumItem cg_listAnimationType[] = {
+        { "backin",           25 },
+        { "backinout",        27 },
+        { "backout",          26 },
+        { "bouncein",         28 },
+        { "bounceinout",      30 },
+        { "bounceout",        29 },
+        { "circularcin",      16 },
+        { "circularcout",     17 },
+        { "circularinout",    18 },
+        { "cubicin",           4 },
+        { "cubicoinout",       6 },
+        { "cubicout",          5 },
+        { "elasticin",        22 },
+        { "elasticinout",     24 },
+        { "elasticout",       23 },
+        { "exponentiacin",    19 },
+        { "exponentiainout",  21 },
+        { "exponentiaout",    20 },
+        { "linear",            0 },
+        { "quadraticin",       1 },
+        { "quadraticinout",    3 },
+        { "quadraticout",      2 },
+        { "quarticin",         7 },
+        { "quarticinout",      9 },
+        { "quarticout",        8 },
+        { "quinticcin",       10 },
+        { "quinticcout",      11 },
+        { "quinticinout",     12 },
+        { "sincin",           13 },
+        { "sincout",          14 },
+        { "sininout",         15 },
+    };
+    static_assert(sorted_items(cg_listAnimationType), "cg_listAnimationType must be sorted");
+    // 位图渲染模式 属性值列表
+    constexpr EnumItem cg_listBitmapRenderRule[] = {
+        { "button",   1 },
+        { "scale",    0 },
+    };
+    static_assert(sorted_items(cg_listBitmapRenderRule), "cg_listBitmapRenderRule must be sorted");
+    // 渲染模式 属性值列表
+    constexpr EnumItem cg_listRenderRule[] = {
+        { "button",   1 },
+        { "scale",    0 },
+    };
+    static_assert(sorted_items(cg_listRenderRule), "cg_listRenderRule must be sorted");
+    // 渲染模式 属性值列表
+    constexpr EnumItem cg_listBrushType[] = {
+        { "bitmap",   3 },
+        { "linear",   1 },
+        { "radial",   2 },
+        { "solid",    0 },
+    };
+    static_assert(sorted_items(cg_listBrushType), "cg_listBrushType must be sorted");
+    // 富文本类型 属性值列表
+    constexpr EnumItem cg_listRichType[] = {
+        { "core",     1 },
+        { "custom",   3 },
+        { "none",     0 },
+        { "xml",      2 },
+    };
+    static_assert(sorted_items(cg_listRichType), "cg_listRichType must be sorted");
+    // D2D 插值模式 属性值列表
+    constexpr EnumItem cg_listInterpolationMode[] = {
+        { "anisotropic",   4 },
+        { "cubic",         2 },
+        { "highcubic",     5 },
+        { "linear",        1 },
+        { "mslinear",      3 },
+        { "neighbor",      0 },
+    };
+    static_assert(sorted_items(cg_listInterpolationMode), "cg_listInterpolationMode must be sorted");
+    // D2D 扩展模式 属性值列表
+    constexpr EnumItem cg_listExtendMode[] = {
+        { "clamp",    0 },
+        { "mirror",   2 },
+        { "wrap",     1 },
+    };
+    static_assert(sorted_items(cg_listExtendMode), "cg_listExtendMode must be sorted");
+    // D2D 文本抗锯齿模式 属性值列表
+    constexpr EnumItem cg_listTextAntialiasMode[] = {
+        { "aliased",     3 },
+        { "cleartype",   1 },
+        { "default",     0 },
+        { "grayscale",   2 },
+    };
+    static_assert(sorted_items(cg_listTextAntialiasMode), "cg_listTextAntialiasMode must be sorted");
+    // DWrite 字体风格 属性值列表
+    constexpr EnumItem cg_listFontStyle[] = {
+        { "italic",    2 },
+        { "normal",    0 },
+        { "oblique",   1 },
+    };
+    static_assert(sorted_items(cg_listFontStyle), "cg_listFontStyle must be sorted");
+    // DWrite 字体拉伸 属性值列表
+    constexpr EnumItem cg_listFontStretch[] = {
+        { "condensed",        3 },
+        { "expanded",         7 },
+        { "extracondensed",   2 },
+        { "extraexpanded",    8 },
+        { "normal",           5 },
+        { "semicondensed",    4 },
+        { "semiexpanded",     6 },
+        { "ultracondensed",   1 },
+        { "ultraexpanded",    9 },
+        { "undefined",        0 },
+    };
+    static_assert(sorted_items(cg_listFontStretch), "cg_listFontStretch must be sorted");
+    // DWrite 排列方向 属性值列表
+    constexpr EnumItem cg_listFlowDirection[] = {
+        { "bottom2top",   1 },
+        { "left2right",   2 },
+        { "right2left",   3 },
+        { "top2bottom",   0 },
+    };
+    static_assert(sorted_items(cg_listFlowDirection), "cg_listFlowDirection must be sorted");
+    // DWrite 阅读方向 属性值列表
+    constexpr EnumItem cg_listReadingDirection[] = {
+        { "bottom2top",   3 },
+        { "left2right",   0 },
+        { "right2left",   1 },
+        { "top2bottom",   2 },
+    };
+    static_assert(sorted_items(cg_listReadingDirection), "cg_listReadingDirection must be sorted");
+    // DWrite 换行方式 属性值列表
+    constexpr EnumItem cg_listWordWrapping[] = {
+        { "break",       2 },
+        { "character",   4 },
+        { "nowrap",      1 },
+        { "word",        3 },
+        { "wrap",        0 },
+    };
+    static_assert(sorted_items(cg_listWordWrapping), "cg_listWordWrapping must be sorted");
+    // DWrite 段落对齐 属性值列表
+    constexpr EnumItem cg_listParagraphAlignment[] = {
+        { "bottom",   1 },
+        { "middle",   2 },
+        { "top",      0 },
+    };
+    static_assert(sorted_items(cg_listParagraphAlignment), "cg_listParagraphAlignment must be sorted");
+    // DWrite 文本对齐 属性值列表
+    constexpr EnumItem cg_listTextAlignment[] = {
+        { "center",    2 },
+        { "justify",   3 },
+        { "left",      0 },
+        { "right",     1 },
+    };
+    static_assert(sorted_items(cg_listTextAlignment), "cg_listTextAlignment must be sorted");
+    // 复选框状态
+    constexpr EnumItem cg_listCheckBoxState[] = {
+        { "checked",         0 },
+        { "indeterminate",   1 },
+        { "unchecked",       2 },
+    };
+    static_assert(sorted_items(cg_listCheckBoxState), "cg_listCheckBoxState must be sorted");
+    // table and count
+    struct enum_table { const EnumItem* list; uint32_t count; };
+    // tables, same order as EnumTable
+    const enum_table ENUM_TABLES[] = {
+        { cg_listAnimationType, sizeof(cg_listAnimationType) / sizeof(cg_listAnimationType[0]) },
+        { cg_listBitmapRenderRule, sizeof(cg_listBitmapRenderRule) / sizeof(cg_listBitmapRenderRule[0]) },
+        { cg_listRenderRule, sizeof(cg_listRenderRule) / sizeof(cg_listRenderRule[0]) },
+        { cg_listBrushType, sizeof(cg_listBrushType) / sizeof(cg_listBrushType[0]) },
+        { cg_listRichType, sizeof(cg_listRichType) / sizeof(cg_listRichType[0]) },
+        { cg_listInterpolationMode, sizeof(cg_listInterpolationMode) / sizeof(cg_listInterpolationMode[0]) },
+        { cg_listExtendMode, sizeof(cg_listExtendMode) / sizeof(cg_listExtendMode[0]) },
+        { cg_listTextAntialiasMode, sizeof(cg_listTextAntialiasMode) / sizeof(cg_listTextAntialiasMode[0]) },
+        { cg_listFontStyle, sizeof(cg_listFontStyle) / sizeof(cg_listFontStyle[0]) },
+        { cg_listFontStretch, sizeof(cg_listFontStretch) / sizeof(cg_listFontStretch[0]) },
+        { cg_listFlowDirection, sizeof(cg_listFlowDirection) / sizeof(cg_listFlowDirection[0]) },
+        { cg_listReadingDirection, sizeof(cg_listReadingDirection) / sizeof(cg_listReadingDirection[0]) },
+        { cg_listWordWrapping, sizeof(cg_listWordWrapping) / sizeof(cg_listWordWrapping[0]) },
+        { cg_listParagraphAlignment, sizeof(cg_listParagraphAlignment) / sizeof(cg_listParagraphAlignment[0]) },
+        { cg_listTextAlignment, sizeof(cg_listTextAlignment) / sizeof(cg_listTextAlignment[0]) },
+        { cg_listCheckBoxState, sizeof(cg_listCheckBoxState) / sizeof(cg_listCheckBoxState[0]) },
+    };
+    static_assert(sizeof(ENUM_TABLES) / sizeof(ENUM_TABLES[0]) == uint32_t(EnumTable::TABLE_COUNT), "update ENUM_TABLES");
+    // 首个非空白为数字?
+    inline bool first_digital(const char* str) noexcept {
+        while (*str == ' ' || *str == '\t') ++str;
+        return *str >= '0' && *str <= '9';
+    }
+    // 十进制数字
+    inline auto decimal(const char* str) noexcept -> uint32_t {
+        while (*str == ' ' || *str == '\t') ++str;
+        uint32_t value = 0;
+        for (; *str >= '0' && *str <= '9'; ++str) value = value * 10 + uint32_t(*str - '0');
+        return value;
+    }
+}}
+
+/// <summary>
+/// Gets the table of enum attribute values.
+/// </summary>
+/// <param name="table">The table.</param>
+/// <param name="count">The count of items.</param>
+/// <returns>items sorted by name</returns>
+auto LongUI::GetEnumTable(EnumTable table, uint32_t& count) noexcept -> const EnumItem* {
+    assert(table < EnumTable::TABLE_COUNT && "out of range");
+    const auto& t = impl::ENUM_TABLES[uint32_t(table)];
+    count = t.count;
+    return t.list;
+}
+
+/// <summary>
+/// Gets the enum value from name or decimal number.
+/// 解析属性值为枚举值: 数字直接使用, 名称二分查找
+/// </summary>
+/// <param name="value">The string value, could be null.</param>
+/// <param name="table">The table.</param>
+/// <param name="bad_match">The value if not found.</param>
+/// <returns></returns>
+auto LongUI::LookupEnum(const char* value, EnumTable table, uint32_t bad_match) noexcept -> uint32_t {
+    // 有效
+    if (value && *value) {
+        // 数字?
+        if (impl::first_digital(value)) return impl::decimal(value);
+        uint32_t count = 0;
+        const auto list = LongUI::GetEnumTable(table, count);
+        const auto end = list + count;
+        // 小表顺序查找更快, 见 Test/enum_bench
+        if (count <= LONGUI_ENUM_LINEAR_MAX) {
+            for (auto itr = list; itr != end; ++itr) if (!std::strcmp(itr->name, value)) return itr->value;
+        }
+        // 二分查找
+        else {
+            const auto itr = std::lower_bound(list, end, value, [](const EnumItem& item, const char* v) noexcept {
+                return std::strcmp(item.name, v) < 0;
+            });
+            if (itr != end && !std::strcmp(itr->name, value)) return itr->value;
+        }
+        assert(!"bad matched");
+    }
+    // 匹配无效
+    return bad_match;
+}
@@ -0,0 +1,335 @@
+﻿#include "Platless/luiPlConf.h"
+#include "Platless/luiPlFloat.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#ifdef _M_X64
+#include <intrin.h>
+#endif
+
+// 慢速通道栈上缓冲长度
+#define LONGUI_FLOAT_BUFFER 64
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // white space
+    template<typename T> inline bool white_space(T c) noexcept { return c == ' ' || c == '\t'; }
+    // valid digit
+    template<typename T> inline bool valid_digit(T c) noexcept { return c >= '0' && c <= '9'; }
+    // 5^q 的128位截断近似, q: [-65, 38], 用于 Eisel-Lemire 算法
+    static const uint64_t POWER_OF_FIVE_128[] = {
+        0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull, // 1e-65
+        0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull, // 1e-64
+        0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull, // 1e-63
+        0x83a3eeeef9153e89ull, 0x1953cf68300424acull, // 1e-62
+        0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull, // 1e-61
+        0xcdb02555653131b6ull, 0x3792f412cb06794dull, // 1e-60
+        0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull, // 1e-59
+        0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull, // 1e-58
+        0xc8de047564d20a8bull, 0xf245825a5a445275ull, // 1e-57
+        0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull, // 1e-56
+        0x9ced737bb6c4183dull, 0x55464dd69685606bull, // 1e-55
+        0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull, // 1e-54
+        0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull, // 1e-53
+        0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull, // 1e-52
+        0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull, // 1e-51
+        0xef73d256a5c0f77cull, 0x963e66858f6d4440ull, // 1e-50
+        0x95a8637627989aadull, 0xdde7001379a44aa8ull, // 1e-49
+        0xbb127c53b17ec159ull, 0x5560c018580d5d52ull, // 1e-48
+        0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull, // 1e-47
+        0x9226712162ab070dull, 0xcab3961304ca70e8ull, // 1e-46
+        0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull, // 1e-45
+        0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull, // 1e-44
+        0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull, // 1e-43
+        0xb267ed1940f1c61cull, 0x55f038b237591ed3ull, // 1e-42
+        0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull, // 1e-41
+        0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull, // 1e-40
+        0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull, // 1e-39
+        0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull, // 1e-38
+        0x881cea14545c7575ull, 0x7e50d64177da2e54ull, // 1e-37
+        0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull, // 1e-36
+        0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull, // 1e-35
+        0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull, // 1e-34
+        0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull, // 1e-33
+        0xcfb11ead453994baull, 0x67de18eda5814af2ull, // 1e-32
+        0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull, // 1e-31
+        0xa2425ff75e14fc31ull, 0xa1258379a94d028dull, // 1e-30
+        0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull, // 1e-29
+        0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull, // 1e-28
+        0x9e74d1b791e07e48ull, 0x775ea264cf55347eull, // 1e-27
+        0xc612062576589ddaull, 0x95364afe032a819eull, // 1e-26
+        0xf79687aed3eec551ull, 0x3a83ddbd83f52205ull, // 1e-25
+        0x9abe14cd44753b52ull, 0xc4926a9672793543ull, // 1e-24
+        0xc16d9a0095928a27ull, 0x75b7053c0f178294ull, // 1e-23
+        0xf1c90080baf72cb1ull, 0x5324c68b12dd6339ull, // 1e-22
+        0x971da05074da7beeull, 0xd3f6fc16ebca5e04ull, // 1e-21
+        0xbce5086492111aeaull, 0x88f4bb1ca6bcf585ull, // 1e-20
+        0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e6ull, // 1e-19
+        0x9392ee8e921d5d07ull, 0x3aff322e62439fd0ull, // 1e-18
+        0xb877aa3236a4b449ull, 0x09befeb9fad487c3ull, // 1e-17
+        0xe69594bec44de15bull, 0x4c2ebe687989a9b4ull, // 1e-16
+        0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a11ull, // 1e-15
+        0xb424dc35095cd80full, 0x538484c19ef38c95ull, // 1e-14
+        0xe12e13424bb40e13ull, 0x2865a5f206b06fbaull, // 1e-13
+        0x8cbccc096f5088cbull, 0xf93f87b7442e45d4ull, // 1e-12
+        0xafebff0bcb24aafeull, 0xf78f69a51539d749ull, // 1e-11
+        0xdbe6fecebdedd5beull, 0xb573440e5a884d1cull, // 1e-10
+        0x89705f4136b4a597ull, 0x31680a88f8953031ull, // 1e-9
+        0xabcc77118461cefcull, 0xfdc20d2b36ba7c3eull, // 1e-8
+        0xd6bf94d5e57a42bcull, 0x3d32907604691b4dull, // 1e-7
+        0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b110ull, // 1e-6
+        0xa7c5ac471b478423ull, 0x0fcf80dc33721d54ull, // 1e-5
+        0xd1b71758e219652bull, 0xd3c36113404ea4a9ull, // 1e-4
+        0x83126e978d4fdf3bull, 0x645a1cac083126eaull, // 1e-3
+        0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a4ull, // 1e-2
+        0xccccccccccccccccull, 0xcccccccccccccccdull, // 1e-1
+        0x8000000000000000ull, 0x0000000000000000ull, // 1e0
+        0xa000000000000000ull, 0x0000000000000000ull, // 1e1
+        0xc800000000000000ull, 0x0000000000000000ull, // 1e2
+        0xfa00000000000000ull, 0x0000000000000000ull, // 1e3
+        0x9c40000000000000ull, 0x0000000000000000ull, // 1e4
+        0xc350000000000000ull, 0x0000000000000000ull, // 1e5
+        0xf424000000000000ull, 0x0000000000000000ull, // 1e6
+        0x9896800000000000ull, 0x0000000000000000ull, // 1e7
+        0xbebc200000000000ull, 0x0000000000000000ull, // 1e8
+        0xee6b280000000000ull, 0x0000000000000000ull, // 1e9
+        0x9502f90000000000ull, 0x0000000000000000ull, // 1e10
+        0xba43b74000000000ull, 0x0000000000000000ull, // 1e11
+        0xe8d4a51000000000ull, 0x0000000000000000ull, // 1e12
+        0x9184e72a00000000ull, 0x0000000000000000ull, // 1e13
+        0xb5e620f480000000ull, 0x0000000000000000ull, // 1e14
+        0xe35fa931a0000000ull, 0x0000000000000000ull, // 1e15
+        0x8e1bc9bf04000000ull, 0x0000000000000000ull, // 1e16
+        0xb1a2bc2ec5000000ull, 0x0000000000000000ull, // 1e17
+        0xde0b6b3a76400000ull, 0x0000000000000000ull, // 1e18
+        0x8ac7230489e80000ull, 0x0000000000000000ull, // 1e19
+        0xad78ebc5ac620000ull, 0x0000000000000000ull, // 1e20
+        0xd8d726b7177a8000ull, 0x0000000000000000ull, // 1e21
+        0x878678326eac9000ull, 0x0000000000000000ull, // 1e22
+        0xa968163f0a57b400ull, 0x0000000000000000ull, // 1e23
+        0xd3c21bcecceda100ull, 0x0000000000000000ull, // 1e24
+        0x84595161401484a0ull, 0x0000000000000000ull, // 1e25
+        0xa56fa5b99019a5c8ull, 0x0000000000000000ull, // 1e26
+        0xcecb8f27f4200f3aull, 0x0000000000000000ull, // 1e27
+        0x813f3978f8940984ull, 0x4000000000000000ull, // 1e28
+        0xa18f07d736b90be5ull, 0x5000000000000000ull, // 1e29
+        0xc9f2c9cd04674edeull, 0xa400000000000000ull, // 1e30
+        0xfc6f7c4045812296ull, 0x4d00000000000000ull, // 1e31
+        0x9dc5ada82b70b59dull, 0xf020000000000000ull, // 1e32
+        0xc5371912364ce305ull, 0x6c28000000000000ull, // 1e33
+        0xf684df56c3e01bc6ull, 0xc732000000000000ull, // 1e34
+        0x9a130b963a6c115cull, 0x3c7f400000000000ull, // 1e35
+        0xc097ce7bc90715b3ull, 0x4b9f100000000000ull, // 1e36
+        0xf0bdc21abb48db20ull, 0x1e86d40000000000ull, // 1e37
+        0x96769950b50d88f4ull, 0x1314448000000000ull, // 1e38
+    };
+    // float 可以精确表示的10的幂
+    static const float POWER_OF_TEN_FLOAT[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+    };
+    // 128位整数
+    struct uint128 { uint64_t low, high; };
+    // 64x64 -> 128 乘法
+    inline auto full_multiplication(uint64_t a, uint64_t b) noexcept -> uint128 {
+        uint128 r;
+#ifdef _M_X64
+        r.low = _umul128(a, b, &r.high);
+#else
+        const uint64_t a0 = uint32_t(a), a1 = a >> 32, b0 = uint32_t(b), b1 = b >> 32;
+        const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const uint64_t mid = (p00 >> 32) + uint32_t(p01) + uint32_t(p10);
+        r.low = (mid << 32) | uint32_t(p00);
+        r.high = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+        return r;
+    }
+    // 前导零数量, x != 0
+    inline auto leading_zeroes(uint64_t x) noexcept -> int {
+        assert(x && "bad argument");
+#ifdef _M_X64
+        unsigned long index; ::_BitScanReverse64(&index, x);
+        return 63 - int(index);
+#else
+        int n = 0;
+        while (!(x & (uint64_t(1) << 63))) { x <<= 1; ++n; }
+        return n;
+#endif
+    }
+    /// <summary>
+    /// Eisel-Lemire algorithm, w * 10^q to float bits, round to nearest even.
+    /// Always exact for w with 19 digits or less.
+    /// </summary>
+    /// <param name="q">The decimal exponent.</param>
+    /// <param name="w">The decimal significand.</param>
+    /// <returns>bits of float, sign not included</returns>
+    inline auto eisel_lemire(int64_t q, uint64_t w) noexcept -> uint32_t {
+        enum : int {
+            MANTISSA_BITS = 23, MIN_EXPONENT = -127, INFINITE_POWER = 0xFF,
+            MIN_ROUND_TO_EVEN = -17, MAX_ROUND_TO_EVEN = 10,
+            SMALLEST_POWER = -65, LARGEST_POWER = 38,
+        };
+        if (!w || q < SMALLEST_POWER) return 0;
+        if (q > LARGEST_POWER) return uint32_t(INFINITE_POWER) << MANTISSA_BITS;
+        const int lz = leading_zeroes(w); w <<= lz;
+        // 乘以 5^q 的近似值, 高位不足以判断时补充低64位
+        const auto index = size_t(q - SMALLEST_POWER) * 2;
+        auto product = full_multiplication(w, POWER_OF_FIVE_128[index]);
+        const uint64_t precision_mask = uint64_t(-1) >> (MANTISSA_BITS + 3);
+        if ((product.high & precision_mask) == precision_mask) {
+            const auto second = full_multiplication(w, POWER_OF_FIVE_128[index + 1]);
+            product.low += second.high;
+            if (second.high > product.low) ++product.high;
+        }
+        const int upperbit = int(product.high >> 63);
+        const int shift = upperbit + 64 - MANTISSA_BITS - 3;
+        auto mantissa = product.high >> shift;
+        // floor(log2(10^q)) + 63
+        auto power2 = int32_t((((152170 + 65536) * q) >> 16) + 63) + upperbit - lz - MIN_EXPONENT;
+        // 非规格化数
+        if (power2 <= 0) {
+            if (-power2 + 1 >= 64) return 0;
+            mantissa >>= -power2 + 1;
+            mantissa += mantissa & 1;
+            mantissa >>= 1;
+            power2 = mantissa < (uint64_t(1) << MANTISSA_BITS) ? 0 : 1;
+            return uint32_t(mantissa) | (uint32_t(power2) << MANTISSA_BITS);
+        }
+        // 恰好在中间时向偶数舍入
+        if (product.low <= 1 && q >= MIN_ROUND_TO_EVEN && q <= MAX_ROUND_TO_EVEN && (mantissa & 3) == 1) {
+            if ((mantissa << shift) == product.high) mantissa &= ~uint64_t(1);
+        }
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        if (mantissa >= (uint64_t(2) << MANTISSA_BITS)) {
+            mantissa = uint64_t(1) << MANTISSA_BITS;
+            ++power2;
+        }
+        mantissa &= ~(uint64_t(1) << MANTISSA_BITS);
+        if (power2 >= INFINITE_POWER) return uint32_t(INFINITE_POWER) << MANTISSA_BITS;
+        return uint32_t(mantissa) | (uint32_t(power2) << MANTISSA_BITS);
+    }
+    // 超过19位有效数字时的慢速通道, 复制后交给CRT
+    template<typename T, typename Lambda>
+    inline auto parse_float_slow(const T* begin, const T* end, Lambda call) noexcept -> float {
+        const auto len = size_t(end - begin);
+        T fixedbuf[LONGUI_FLOAT_BUFFER]; T* buf = fixedbuf;
+        if (len >= LONGUI_FLOAT_BUFFER) buf = LongUI::NormalAllocT<T>(len + 1);
+        if (!buf) return 0.f;
+        std::memcpy(buf, begin, len * sizeof(T)); buf[len] = 0;
+        const float value = call(buf);
+        if (buf != fixedbuf) LongUI::NormalFree(buf);
+        return value;
+    }
+    // 超过19位有效数字时的慢速通道
+    inline auto parse_float_slow(const char* begin, const char* end) noexcept -> float {
+        return parse_float_slow(begin, end, [](const char* s) noexcept { return std::strtof(s, nullptr); });
+    }
+    // 超过19位有效数字时的慢速通道
+    inline auto parse_float_slow(const wchar_t* begin, const wchar_t* end) noexcept -> float {
+        return parse_float_slow(begin, end, [](const wchar_t* s) noexcept { return std::wcstof(s, nullptr); });
+    }
+    /// <summary>
+    /// Parse float in [p, end) without copy, correctly rounded.
+    /// 字符串转浮点, 就地解析, 结果正确舍入
+    /// </summary>
+    /// <param name="p">The begin of string.</param>
+    /// <param name="end">The end of string, could be null for null-terminated.</param>
+    /// <param name="value">The output value, 0 if no number.</param>
+    /// <returns>the end of number parsed, p if no number</returns>
+    template<typename T> auto parse_float(const T* p, const T* end, float& value) noexcept ->const T* {
+        assert(p && "bad argument");
+        value = 0.f;
+        const auto digit = [end](const T* x) noexcept { return x != end && valid_digit(*x); };
+        const auto is = [end](const T* x, char ch) noexcept { return x != end && *x == static_cast<T>(ch); };
+        // 跳过空白
+        while (p != end && white_space(*p)) ++p;
+        const auto start = p;
+        // 检查符号
+        const bool negative = is(p, '-');
+        if (negative || is(p, '+')) ++p;
+        // 有效数字, 最多19位
+        uint64_t w = 0; int64_t exponent = 0;
+        uint32_t count = 0; bool any = false;
+        const auto accumulate = [&](T ch) noexcept {
+            if (count < 19) {
+                w = w * 10 + uint64_t(ch - static_cast<T>('0'));
+                if (w) ++count;
+                return false;
+            }
+            return true;
+        };
+        bool truncated = false;
+        for (; digit(p); ++p) {
+            any = true;
+            if (accumulate(*p)) { truncated = true; ++exponent; }
+        }
+        // 小数部分
+        if (is(p, '.')) {
+            ++p;
+            for (; digit(p); ++p) {
+                any = true;
+                if (accumulate(*p)) truncated = true;
+                else --exponent;
+            }
+        }
+        if (!any) return start;
+        // 指数部分, 没有数字则回退
+        if (is(p, 'e') || is(p, 'E')) {
+            auto e = p + 1;
+            const bool eneg = is(e, '-');
+            if (eneg || is(e, '+')) ++e;
+            if (digit(e)) {
+                int64_t expon = 0;
+                for (; digit(e); ++e) if (expon < 0x10000) expon = expon * 10 + (*e - static_cast<T>('0'));
+                exponent += eneg ? -expon : expon;
+                p = e;
+            }
+        }
+        float result;
+        // 快速通道: 两个精确的float运算
+        if (!truncated && exponent >= -10 && exponent <= 10 && w <= (uint64_t(1) << 24)) {
+            result = static_cast<float>(w);
+            if (exponent < 0) result /= POWER_OF_TEN_FLOAT[-exponent];
+            else result *= POWER_OF_TEN_FLOAT[exponent];
+        }
+        else {
+            auto bits = impl::eisel_lemire(exponent, w);
+            // 截断后上下界结果不同则走慢速通道
+            if (truncated && bits != impl::eisel_lemire(exponent, w + 1)) {
+                result = impl::parse_float_slow(start + negative + is(start, '+'), p);
+            }
+            else {
+                std::memcpy(&result, &bits, sizeof(result));
+            }
+        }
+        value = negative ? -result : result;
+        return p;
+    }
+}}
+
+// longui namespace
+namespace LongUI {
+    /// <summary>
+    /// Parse float in range without copy, correctly rounded.
+    /// 就地解析浮点, 结果正确舍入
+    /// </summary>
+    /// <param name="begin">The begin.</param>
+    /// <param name="end">The end, could be null for null-terminated string.</param>
+    /// <param name="value">The output value.</param>
+    /// <returns>end of the number parsed, begin if failed</returns>
+    auto ParseFloat(const char* begin, const char* end, float& value) noexcept -> const char* {
+        return impl::parse_float(begin, end, value);
+    }
+    /// <summary>
+    /// Parse float in range without copy, correctly rounded.
+    /// 就地解析浮点, 结果正确舍入
+    /// </summary>
+    /// <param name="begin">The begin.</param>
+    /// <param name="end">The end, could be null for null-terminated string.</param>
+    /// <param name="value">The output value.</param>
+    /// <returns>end of the number parsed, begin if failed</returns>
+    auto ParseFloat(const wchar_t* begin, const wchar_t* end, float& value) noexcept -> const wchar_t* {
+        return impl::parse_float(begin, end, value);
+    }
+}
@@ -0,0 +1,166 @@
+﻿#include "Platless/luiPlGrid.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+// 平台无关: 不依赖 luibase/luiconf, 直接使用 malloc/free
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUIHitTestGrid"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUIHitTestGrid::~CUIHitTestGrid() noexcept {
+    std::free(m_pItem);
+    std::free(m_pOffset);
+    std::free(m_pCursor);
+    std::free(m_pCell);
+}
+
+/// <summary>
+/// Reserves the buffer, content is discarded when grown.
+/// 缓冲区只增不减, 重建时复用
+/// </summary>
+/// <param name="buffer">The buffer.</param>
+/// <param name="capacity">The capacity.</param>
+/// <param name="count">The count.</param>
+/// <param name="unit">The size of unit.</param>
+/// <returns>false if OOM</returns>
+bool LongUI::CUIHitTestGrid::reserve(void*& buffer, uint32_t& capacity, uint32_t count, size_t unit) noexcept {
+    if (count <= capacity) return true;
+    const auto newcap = std::max(count, capacity + capacity / 2);
+    const auto ptr = std::malloc(size_t(newcap) * unit);
+    if (!ptr) return false;
+    std::free(buffer);
+    buffer = ptr;
+    capacity = newcap;
+    return true;
+}
+
+/// <summary>
+/// Prepares the item buffer, fill it then call Build.
+/// </summary>
+/// <param name="count">The count of items.</param>
+/// <returns>null if OOM</returns>
+auto LongUI::CUIHitTestGrid::Prepare(uint32_t count) noexcept -> Item* {
+    m_cItem = 0;
+    auto buffer = static_cast<void*>(m_pItem);
+    const auto ok = reserve(buffer, m_cItemCapacity, count, sizeof(Item));
+    m_pItem = static_cast<Item*>(buffer);
+    if (!ok) return nullptr;
+    m_cItem = count;
+    return m_pItem;
+}
+
+/// <summary>
+/// Builds the grid over prepared items, empty rects are skipped.
+/// </summary>
+/// <param name="max_side">The max count of column/row.</param>
+/// <returns>false if OOM</returns>
+bool LongUI::CUIHitTestGrid::Build(uint32_t max_side) noexcept {
+    assert(max_side && max_side <= 0xFFFF && "bad argument");
+    // 空区域
+    auto is_empty = [](const Rect& rc) noexcept {
+        return !(rc.right > rc.left && rc.bottom > rc.top);
+    };
+    const auto items = m_pItem;
+    const auto end = items + m_cItem;
+    // 计算包围盒
+    uint32_t count = 0;
+    Rect bound = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (auto itr = items; itr != end; ++itr) {
+        const auto& rc = itr->rect;
+        if (is_empty(rc)) continue;
+        bound.left = std::min(bound.left, rc.left);
+        bound.top = std::min(bound.top, rc.top);
+        bound.right = std::max(bound.right, rc.right);
+        bound.bottom = std::max(bound.bottom, rc.bottom);
+        ++count;
+    }
+    m_cCol = m_cRow = 1;
+    m_rcBound = count ? bound : Rect{ 0.f, 0.f, 0.f, 0.f };
+    m_fInvCellWidth = m_fInvCellHeight = 0.f;
+    // 网格尺寸: 每格平均一个物体
+    if (count) {
+        const auto w = bound.right - bound.left;
+        const auto h = bound.bottom - bound.top;
+        const auto maxs = float(max_side);
+        auto c = std::min(std::max(std::sqrt(float(count) * w / h), 1.f), maxs);
+        auto r = std::min(std::max(float(count) / c, 1.f), maxs);
+        m_cCol = uint16_t(c);
+        m_cRow = uint16_t(r);
+        m_fInvCellWidth = float(m_cCol) / w;
+        m_fInvCellHeight = float(m_cRow) / h;
+    }
+    const auto cells = this->GetCellCount();
+    // 偏移与游标
+    {
+        auto offset = static_cast<void*>(m_pOffset);
+        auto cursor = static_cast<void*>(m_pCursor);
+        const auto ok1 = reserve(offset, m_cOffsetCapacity, cells + 1, sizeof(uint32_t));
+        const auto ok2 = reserve(cursor, m_cCursorCapacity, cells, sizeof(uint32_t));
+        m_pOffset = static_cast<uint32_t*>(offset);
+        m_pCursor = static_cast<uint32_t*>(cursor);
+        if (!ok1 || !ok2) return false;
+    }
+    const auto offset = m_pOffset;
+    std::memset(offset, 0, sizeof(uint32_t) * (cells + 1));
+    // 第一次遍历: 统计每格数量
+    uint32_t total = 0;
+    for (auto itr = items; itr != end; ++itr) {
+        const auto& rc = itr->rect;
+        if (is_empty(rc)) continue;
+        const auto c0 = this->col(rc.left), c1 = this->col(rc.right);
+        const auto r0 = this->row(rc.top), r1 = this->row(rc.bottom);
+        for (auto r = r0; r <= r1; ++r) {
+            for (auto c = c0; c <= c1; ++c) ++offset[r * m_cCol + c + 1];
+        }
+        total += (c1 - c0 + 1) * (r1 - r0 + 1);
+    }
+    // 前缀和
+    for (uint32_t i = 0; i != cells; ++i) offset[i + 1] += offset[i];
+    assert(offset[cells] == total && "bad grid");
+    {
+        auto cell = static_cast<void*>(m_pCell);
+        const auto ok = reserve(cell, m_cCellCapacity, total, sizeof(uint32_t));
+        m_pCell = static_cast<uint32_t*>(cell);
+        if (!ok) return false;
+    }
+    // 第二次遍历: 按准备顺序填充, 格内第一个命中即为线性查找的结果
+    const auto cursor = m_pCursor;
+    const auto cell = m_pCell;
+    std::memcpy(cursor, offset, sizeof(uint32_t) * cells);
+    for (auto itr = items; itr != end; ++itr) {
+        const auto& rc = itr->rect;
+        if (is_empty(rc)) continue;
+        const auto c0 = this->col(rc.left), c1 = this->col(rc.right);
+        const auto r0 = this->row(rc.top), r1 = this->row(rc.bottom);
+        const auto index = uint32_t(itr - items);
+        for (auto r = r0; r <= r1; ++r) {
+            for (auto c = c0; c <= c1; ++c) cell[cursor[r * m_cCol + c]++] = index;
+        }
+    }
+    return true;
+}
+
+/// <summary>
+/// Finds the first prepared item containing the point.
+/// </summary>
+/// <param name="x">The x.</param>
+/// <param name="y">The y.</param>
+/// <returns>data of item, null if not found</returns>
+auto LongUI::CUIHitTestGrid::Find(float x, float y) const noexcept -> void* {
+    // 不在包围盒内
+    const auto& bound = m_rcBound;
+    if (!(x >= bound.left && x < bound.right && y >= bound.top && y < bound.bottom)) return nullptr;
+    const auto index = this->row(y) * m_cCol + this->col(x);
+    for (auto i = m_pOffset[index]; i != m_pOffset[index + 1]; ++i) {
+        const auto& item = m_pItem[m_pCell[i]];
+        // 区域内判断
+        const auto& rc = item.rect;
+        if (x >= rc.left && x < rc.right && y >= rc.top && y < rc.bottom) return item.data;
+    }
+    return nullptr;
+}
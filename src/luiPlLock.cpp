@@ -0,0 +1,38 @@
+﻿#include "Platless/luiPlLock.h"
+// pause instruction for spin-wait loop
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LONGUI_SPIN_PAUSE() _mm_pause()
+#else
+#define LONGUI_SPIN_PAUSE() ((void)0)
+#endif
+// yield time slice
+#ifdef _WIN32
+#include <Windows.h>
+#define LONGUI_SPIN_YIELD() ::SwitchToThread()
+#else
+#include <sched.h>
+#define LONGUI_SPIN_YIELD() ::sched_yield()
+#endif
+
+
+/// <summary>
+/// Locks with backoff, pause first then yield time slice.
+/// 只读等待避免抢占缓存行; pause 次数指数增长, 超出后让出时间片
+/// </summary>
+/// <returns></returns>
+void LongUI::CUISpinLock::lock_slow() noexcept {
+    constexpr uint32_t MAX_PAUSE = 64;
+    uint32_t pause = 1;
+    do {
+        while (m_bLocked.load(std::memory_order_relaxed)) {
+            if (pause <= MAX_PAUSE) {
+                for (uint32_t i = 0; i != pause; ++i) LONGUI_SPIN_PAUSE();
+                pause *= 2;
+            }
+            else {
+                LONGUI_SPIN_YIELD();
+            }
+        }
+    } while (m_bLocked.exchange(true, std::memory_order_acquire));
+}
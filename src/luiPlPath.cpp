@@ -0,0 +1,464 @@
+﻿#include "Platless/luiPlConf.h"
+#include "Platless/luiPlFloat.h"
+#include "Platless/luiPlPath.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+// longui::impl
+namespace LongUI { namespace impl {
+    // is separator of arguments
+    inline bool is_separator(const char ch) noexcept {
+        return ch == ' ' || ch == ',' || ch == '\t' || ch == '\n' || ch == '\r';
+    }
+    // parse float, "5-5" and ".5.5" are two numbers, command char is not skipped
+    auto parse_float(const char* str, float* f, int c) noexcept {
+        for (int i = 0; i < c; ++i) {
+            while (impl::is_separator(*str)) ++str;
+            // 就地解析, 数字之后即下一参数
+            str = LongUI::ParseFloat(str, nullptr, f[i]);
+        }
+        return str;
+    }
+    // parse float
+    template<int c>
+    inline auto parse_float(const char* str, float* f) noexcept {
+        return parse_float(str, f, c);
+    }
+    // path flattener, used as sink of PathIR::Replay
+    struct path_flattener {
+        // ctor
+        path_flattener(EzContainer::EzVector<SVG::PathPoint>& p,
+            EzContainer::EzVector<SVG::PathContour>& c, float t) noexcept
+            : points(p), contours(c), tolerance(t) {}
+        // points
+        EzContainer::EzVector<SVG::PathPoint>&      points;
+        // contours
+        EzContainer::EzVector<SVG::PathContour>&    contours;
+        // tolerance
+        float                                       tolerance;
+        // current point
+        SVG::PathPoint                              current = { 0.f, 0.f };
+        // first point of current contour
+        uint32_t                                    first = 0;
+        // contour opened
+        bool                                        opened = false;
+        // out of memory
+        bool                                        oom = false;
+        // add point
+        void add(float x, float y) noexcept {
+            if (!opened) this->begin();
+            current = { x, y };
+            points.push_back(current);
+            if (!points.isok()) oom = true;
+        }
+        // begin contour at current point
+        void begin() noexcept {
+            opened = true;
+            first = points.size();
+            points.push_back(current);
+            if (!points.isok()) oom = true;
+        }
+        // end contour
+        void end(bool closed) noexcept {
+            if (!opened) return;
+            opened = false;
+            contours.push_back(SVG::PathContour{ first, points.size() - first, closed });
+            if (!contours.isok()) oom = true;
+        }
+        // segment count for second difference
+        auto segments(float dd, float scale) const noexcept -> uint32_t {
+            const auto n = std::ceil(std::sqrt(dd * scale / tolerance));
+            return n < 1.f ? 1 : (n > 1024.f ? 1024 : uint32_t(n));
+        }
+        // move to
+        void Move(const float* a) noexcept {
+            this->end(false);
+            current = { a[0], a[1] };
+            this->begin();
+        }
+        // line to
+        void Line(const float* a) noexcept { this->add(a[0], a[1]); }
+        // cubic bezier
+        void Bezier(const float* a) noexcept {
+            const auto p0 = current;
+            const auto ddx1 = p0.x - 2.f * a[0] + a[2], ddy1 = p0.y - 2.f * a[1] + a[3];
+            const auto ddx2 = a[0] - 2.f * a[2] + a[4], ddy2 = a[1] - 2.f * a[3] + a[5];
+            const auto dd = std::max(std::hypot(ddx1, ddy1), std::hypot(ddx2, ddy2));
+            // 误差 <= 3/4 * dd / n^2
+            const auto n = this->segments(dd, 0.75f);
+            for (uint32_t i = 1; i < n; ++i) {
+                const auto t = float(i) / float(n), u = 1.f - t;
+                const auto b0 = u * u * u, b1 = 3.f * u * u * t, b2 = 3.f * u * t * t, b3 = t * t * t;
+                this->add(
+                    b0 * p0.x + b1 * a[0] + b2 * a[2] + b3 * a[4],
+                    b0 * p0.y + b1 * a[1] + b2 * a[3] + b3 * a[5]
+                );
+            }
+            this->add(a[4], a[5]);
+        }
+        // quadratic bezier
+        void Quadratic(const float* a) noexcept {
+            const auto p0 = current;
+            const auto dd = std::hypot(p0.x - 2.f * a[0] + a[2], p0.y - 2.f * a[1] + a[3]);
+            // 误差 <= dd / (4 * n^2)
+            const auto n = this->segments(dd, 0.25f);
+            for (uint32_t i = 1; i < n; ++i) {
+                const auto t = float(i) / float(n), u = 1.f - t;
+                const auto b0 = u * u, b1 = 2.f * u * t, b2 = t * t;
+                this->add(b0 * p0.x + b1 * a[0] + b2 * a[2], b0 * p0.y + b1 * a[1] + b2 * a[3]);
+            }
+            this->add(a[2], a[3]);
+        }
+        // elliptical arc, endpoint to center parameterization, see SVG 1.1 F.6.5
+        void Arc(const float* a) noexcept {
+            const float PI = 3.14159265358979f;
+            const auto x1 = current.x, y1 = current.y, x2 = a[5], y2 = a[6];
+            if (x1 == x2 && y1 == y2) return;
+            auto rx = std::abs(a[0]), ry = std::abs(a[1]);
+            if (rx == 0.f || ry == 0.f) return this->add(x2, y2);
+            const auto phi = a[2] * PI / 180.f;
+            const auto cosp = std::cos(phi), sinp = std::sin(phi);
+            const auto dx2 = (x1 - x2) * 0.5f, dy2 = (y1 - y2) * 0.5f;
+            const auto x1p = cosp * dx2 + sinp * dy2, y1p = -sinp * dx2 + cosp * dy2;
+            // 半径不足时放大
+            const auto lambda = (x1p * x1p) / (rx * rx) + (y1p * y1p) / (ry * ry);
+            if (lambda > 1.f) { const auto s = std::sqrt(lambda); rx *= s; ry *= s; }
+            const auto rx2 = rx * rx, ry2 = ry * ry;
+            const auto den = rx2 * y1p * y1p + ry2 * x1p * x1p;
+            auto coef = std::sqrt(std::max(0.f, (rx2 * ry2 - den) / den));
+            const bool large = a[3] != 0.f, sweep = a[4] != 0.f;
+            if (large == sweep) coef = -coef;
+            const auto cxp = coef * rx * y1p / ry, cyp = -coef * ry * x1p / rx;
+            const auto cx = cosp * cxp - sinp * cyp + (x1 + x2) * 0.5f;
+            const auto cy = sinp * cxp + cosp * cyp + (y1 + y2) * 0.5f;
+            // 起始角与扫过角
+            const auto ux = (x1p - cxp) / rx, uy = (y1p - cyp) / ry;
+            const auto vx = (-x1p - cxp) / rx, vy = (-y1p - cyp) / ry;
+            const auto theta = std::atan2(uy, ux);
+            auto delta = std::atan2(ux * vy - uy * vx, ux * vx + uy * vy);
+            if (!sweep && delta > 0.f) delta -= 2.f * PI;
+            else if (sweep && delta < 0.f) delta += 2.f * PI;
+            // 每段弦高不超过容差
+            const auto cosv = 1.f - tolerance / std::max(rx, ry);
+            const auto step = cosv > -1.f ? 2.f * std::acos(cosv) : PI;
+            const auto count = std::ceil(std::abs(delta) / step);
+            const auto n = count < 1.f ? 1 : (count > 1024.f ? 1024 : uint32_t(count));
+            for (uint32_t i = 1; i < n; ++i) {
+                const auto t = theta + delta * float(i) / float(n);
+                const auto ex = rx * std::cos(t), ey = ry * std::sin(t);
+                this->add(cx + cosp * ex - sinp * ey, cy + sinp * ex + cosp * ey);
+            }
+            this->add(x2, y2);
+        }
+        // close path
+        void Close() noexcept {
+            if (!opened) return;
+            const auto start = points.data()[first];
+            this->end(true);
+            current = start;
+        }
+    };
+}}
+
+
+/// <summary>
+/// Compiles the path string into intermediate representation.
+/// 编译SVG路径字符串, 坐标全部转换为绝对坐标
+/// </summary>
+/// <param name="path">The path.</param>
+/// <param name="ir">The output ir.</param>
+/// <returns>false if out of memory</returns>
+bool LongUI::SVG::CompilePath(const char* path, PathIR& ir) noexcept {
+    assert(path && "bad argument");
+    ir.Clear();
+    if (!path) return false;
+    /*
+        M = moveto
+        L = lineto
+        H = horizontal lineto
+        V = vertical lineto
+        C = curveto
+        S = smooth curveto
+        Q = quadratic Bézier curve
+        T = smooth quadratic Bézier curveto
+        A = elliptical Arc
+        Z = closepath
+    */
+    bool oom = false;
+    // 添加命令
+    auto emit = [&ir, &oom](PathCommand cmd, const float* args) noexcept {
+        const auto count = SVG::GetPathCommandFloats(cmd);
+        ir.commands.push_back(cmd);
+        if (count) ir.data.insert(ir.data.size(), args, count);
+        if (!ir.commands.isok() || (count && !ir.data.isok())) oom = true;
+    };
+    // 当前XY坐标
+    float org[2] = { 0.f, 0.f };
+    // 处理参数, 三次与二次贝塞尔共享控制点: 
+    // [0, 1] 控制点1, [2, 3] 控制点2/二次终点, [4, 5] 三次终点
+    float seg[6] = { 0.f };
+    auto itr = path;
+    while (const char ch = *itr) {
+        ++itr;
+        switch (ch)
+        {
+        case 'M': org[0] = org[1] = 0.f; case 'm':
+            // M = moveto(x, y)
+            itr = impl::parse_float<2>(itr, seg);
+            org[0] += seg[0]; org[1] += seg[1];
+            emit(PathCommand::Command_Move, org);
+            break;
+        case 'L': org[0] = org[1] = 0.f; case 'l':
+            //  L = lineto(x, y)
+            itr = impl::parse_float<2>(itr, seg);
+            org[0] += seg[0]; org[1] += seg[1];
+            emit(PathCommand::Command_Line, org);
+            break;
+        case 'H': org[0] = 0.f; case 'h':
+            // H = horizontal lineto(x)
+            itr = impl::parse_float<1>(itr, seg);
+            org[0] += seg[0];
+            emit(PathCommand::Command_Line, org);
+            break;
+        case 'V': org[1] = 0.f; case 'v':
+            // vertical lineto(y)
+            itr = impl::parse_float<1>(itr, seg);
+            org[1] += seg[0];
+            emit(PathCommand::Command_Line, org);
+            break;
+        case 'C': org[0] = org[1] = 0.f; case 'c':
+            // C = curveto
+            itr = impl::parse_float<6>(itr, seg);
+            for (int i = 0; i < 6; ++i) seg[i] += org[i & 1];
+            emit(PathCommand::Command_Bezier, seg);
+            org[0] = seg[4]; org[1] = seg[5];
+            break;
+        case 'S': case 's':
+            // smooth curveto
+            seg[0] = org[0] + org[0] - seg[2];
+            seg[1] = org[1] + org[1] - seg[3];
+            if (ch == 'S') org[0] = org[1] = 0.f;
+            itr = impl::parse_float<4>(itr, seg + 2);
+            for (int i = 2; i < 6; ++i) seg[i] += org[i & 1];
+            emit(PathCommand::Command_Bezier, seg);
+            org[0] = seg[4]; org[1] = seg[5];
+            break;
+        case 'Q': org[0] = org[1] = 0.f; case 'q':
+            // Q = quadratic Bézier curve
+            itr = impl::parse_float<4>(itr, seg);
+            for (int i = 0; i < 4; ++i) seg[i] += org[i & 1];
+            emit(PathCommand::Command_Quadratic, seg);
+            org[0] = seg[2]; org[1] = seg[3];
+            break;
+        case 'T': case 't':
+            // smooth quadratic curveto
+            seg[0] = org[0] + org[0] - seg[0];
+            seg[1] = org[1] + org[1] - seg[1];
+            if (ch == 'T') org[0] = org[1] = 0.f;
+            itr = impl::parse_float<2>(itr, seg + 2);
+            seg[2] += org[0]; seg[3] += org[1];
+            emit(PathCommand::Command_Quadratic, seg);
+            org[0] = seg[2]; org[1] = seg[3];
+            break;
+        case 'A': org[0] = org[1] = 0.f; case 'a':
+            //  A rx ry x-axis-rotation large-arc-flag sweep-flag  x  y
+            //  a rx ry x-axis-rotation large-arc-flag sweep-flag dx dy
+        {
+            float arcary[7];
+            itr = impl::parse_float<7>(itr, arcary);
+            arcary[3] = arcary[3] != 0.f ? 1.f : 0.f;
+            arcary[4] = arcary[4] != 0.f ? 1.f : 0.f;
+            arcary[5] += org[0];
+            arcary[6] += org[1];
+            emit(PathCommand::Command_Arc, arcary);
+            org[0] = arcary[5]; org[1] = arcary[6];
+        }
+            break;
+        case 'Z': case 'z':
+            //  Z/z = closepath()
+            emit(PathCommand::Command_Close, nullptr);
+            break;
+        }
+        if (oom) return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Flattens the compiled path into polylines.
+/// 在CPU上将路径展平为折线
+/// </summary>
+/// <param name="ir">The compiled path.</param>
+/// <param name="tolerance">The max distance between curve and polyline.</param>
+/// <param name="points">The output points.</param>
+/// <param name="contours">The output contours.</param>
+/// <returns>false if out of memory</returns>
+bool LongUI::SVG::FlattenPath(const PathIR& ir, float tolerance,
+    EzContainer::EzVector<PathPoint>& points,
+    EzContainer::EzVector<PathContour>& contours) noexcept {
+    assert(tolerance > 0.f && "bad argument");
+    if (!(tolerance > 0.f)) tolerance = 0.25f;
+    points.clear(); contours.clear();
+    impl::path_flattener flattener(points, contours, tolerance);
+    ir.Replay(flattener);
+    flattener.end(false);
+    return !flattener.oom;
+}
+
+// entry of path cache
+struct LongUI::SVG::CUIPathCache::Entry {
+    // compiled path, must be first
+    PathIR      ir;
+    // more recently used entry
+    Entry*      prev;
+    // less recently used entry
+    Entry*      next;
+    // bytes of entry
+    size_t      bytes;
+    // count of acquired
+    uint32_t    ref;
+    // still in cache
+    bool        cached;
+    // key
+    auto key() noexcept { return reinterpret_cast<char*>(this + 1); }
+};
+
+/// <summary>
+/// Acquires the compiled path, compile and cache it if not exist.
+/// </summary>
+/// <param name="path">The path string.</param>
+/// <returns>null if out of memory</returns>
+auto LongUI::SVG::CUIPathCache::Acquire(const char* path) noexcept -> const PathIR* {
+    assert(path && "bad argument");
+    if (!path) return nullptr;
+    // 移至最近使用
+    auto use = [this](Entry* entry) noexcept {
+        ++entry->ref;
+        if (entry == m_pHead) return;
+        entry->prev->next = entry->next;
+        if (entry->next) entry->next->prev = entry->prev;
+        else m_pTail = entry->prev;
+        entry->prev = nullptr;
+        entry->next = m_pHead;
+        m_pHead->prev = entry;
+        m_pHead = entry;
+    };
+    this->lock();
+    if (const auto found = m_map.Find(path)) {
+        const auto entry = *found;
+        use(entry);
+        this->unlock();
+        return &entry->ir;
+    }
+    this->unlock();
+    // 锁外编译, 键值保存在条目之后, 一次申请
+    const auto len = std::strlen(path) + 1;
+    const auto buffer = LongUI::NormalAlloc(sizeof(Entry) + len);
+    if (!buffer) return nullptr;
+    const auto entry = new(buffer) Entry;
+    std::memcpy(entry->key(), path, len);
+    if (!SVG::CompilePath(entry->key(), entry->ir)) {
+        free_entry(entry);
+        return nullptr;
+    }
+    entry->ir.commands.shrink_to_fit();
+    entry->ir.data.shrink_to_fit();
+    entry->bytes = sizeof(Entry) + len
+        + entry->ir.commands.size() * sizeof(PathCommand)
+        + entry->ir.data.size() * sizeof(float);
+    entry->ref = 1;
+    entry->cached = true;
+    this->lock();
+    // 其他线程已经编译
+    if (const auto found = m_map.Find(path)) {
+        const auto other = *found;
+        use(other);
+        this->unlock();
+        free_entry(entry);
+        return &other->ir;
+    }
+    if (!m_map.Insert(entry->key(), entry)) {
+        this->unlock();
+        free_entry(entry);
+        return nullptr;
+    }
+    entry->prev = nullptr;
+    entry->next = m_pHead;
+    if (m_pHead) m_pHead->prev = entry;
+    else m_pTail = entry;
+    m_pHead = entry;
+    m_cBytes += entry->bytes;
+    this->evict(entry);
+    this->unlock();
+    return &entry->ir;
+}
+
+/// <summary>
+/// Releases the path from Acquire.
+/// </summary>
+/// <param name="ir">The compiled path.</param>
+/// <returns></returns>
+void LongUI::SVG::CUIPathCache::Release(const PathIR* ir) noexcept {
+    if (!ir) return;
+    const auto entry = reinterpret_cast<Entry*>(const_cast<PathIR*>(ir));
+    this->lock();
+    assert(entry->ref && "bad release");
+    const auto dead = !--entry->ref && !entry->cached;
+    this->unlock();
+    if (dead) free_entry(entry);
+}
+
+/// <summary>
+/// Evicts least recently used entries over budget.
+/// </summary>
+/// <param name="keep">The entry to keep.</param>
+/// <returns></returns>
+void LongUI::SVG::CUIPathCache::evict(Entry* keep) noexcept {
+    while (m_cBytes > m_cBudget && m_pTail && m_pTail != keep) {
+        const auto entry = m_pTail;
+        m_pTail = entry->prev;
+        m_pTail->next = nullptr;
+        const auto removed = m_map.Remove(entry->key());
+        assert(removed && "bad cache"); (void)removed;
+        this->drop(entry);
+    }
+}
+
+/// <summary>
+/// Drops the entry from cache, frees it if not acquired.
+/// </summary>
+/// <param name="entry">The entry.</param>
+/// <returns></returns>
+void LongUI::SVG::CUIPathCache::drop(Entry* entry) noexcept {
+    m_cBytes -= entry->bytes;
+    entry->cached = false;
+    if (!entry->ref) free_entry(entry);
+}
+
+/// <summary>
+/// Frees the entry.
+/// </summary>
+/// <param name="entry">The entry.</param>
+/// <returns></returns>
+void LongUI::SVG::CUIPathCache::free_entry(Entry* entry) noexcept {
+    entry->~Entry();
+    LongUI::NormalFree(entry);
+}
+
+/// <summary>
+/// Clears all compiled paths, acquired ones are freed when released.
+/// </summary>
+/// <returns></returns>
+void LongUI::SVG::CUIPathCache::Clear() noexcept {
+    this->lock();
+    for (auto entry = m_pHead; entry; ) {
+        const auto next = entry->next;
+        this->drop(entry);
+        entry = next;
+    }
+    m_pHead = m_pTail = nullptr;
+    m_map.Clear();
+    assert(!m_cBytes && "bad cache");
+    this->unlock();
+}
@@ -0,0 +1,331 @@
+﻿#include "luibase.h"
+#include "luiconf.h"
+#include "Platless/luiPlPool.h"
+#include <cassert>
+#include <new>
+
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // slot size of size classes, header included
+    static const uint32_t POOL_CLASS_SIZE[] = {
+        256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096,
+    };
+    static_assert(
+        sizeof(POOL_CLASS_SIZE) / sizeof(POOL_CLASS_SIZE[0]) == CUIObjectPool::CLASS_LARGE,
+        "size class count not matched"
+    );
+    // current pool of this thread
+    static thread_local CUIObjectPool* s_current_pool = nullptr;
+    // get size class for slot size, CLASS_LARGE if too large
+    static inline auto get_size_class(size_t size) noexcept -> uint32_t {
+        uint32_t index = 0;
+        while (index < CUIObjectPool::CLASS_LARGE && POOL_CLASS_SIZE[index] < size) ++index;
+        return index;
+    }
+    // get slot count of slab for size class
+    static inline auto get_slot_count(uint32_t index) noexcept -> uint32_t {
+        const auto count = uint32_t(LongUIControlPoolSlabSize) / POOL_CLASS_SIZE[index];
+        return count < 4 ? 4 : count;
+    }
+}}
+
+// slab, slots follow
+struct alignas(16) LongUI::CUIObjectPool::Slab {
+    // pool
+    CUIObjectPool*  pool;
+    // prev slab in list
+    Slab*           prev;
+    // next slab in list
+    Slab*           next;
+    // free slot list
+    Header*         free;
+    // size class
+    uint32_t        size_class;
+    // count of used slots
+    uint32_t        used;
+    // count of slots ever used, rest are untouched
+    uint32_t        bump;
+    // count of slots
+    uint32_t        capacity;
+    // get slot
+    auto slot(uint32_t i) noexcept {
+        const auto base = reinterpret_cast<char*>(this + 1);
+        return reinterpret_cast<Header*>(base + size_t(impl::POOL_CLASS_SIZE[size_class]) * i);
+    }
+};
+
+// header of object
+struct alignas(16) LongUI::CUIObjectPool::Header {
+    // owner: slab for size class, pool for large object
+    union { Slab* slab; CUIObjectPool* pool; };
+    // size class
+    uint32_t        size_class;
+    // requested size
+    uint32_t        size;
+    // next free slot, stored in object zone of free slot
+    auto next_free() noexcept -> Header*& { return *reinterpret_cast<Header**>(this + 1); }
+};
+
+/// <summary>
+/// Gets slot size of the size class.
+/// </summary>
+/// <param name="index">The index of size class.</param>
+/// <returns>slot size in byte, 0 for large object</returns>
+auto LongUI::CUIObjectPool::GetClassSize(uint32_t index) noexcept -> size_t {
+    return index < CLASS_LARGE ? impl::POOL_CLASS_SIZE[index] : 0;
+}
+
+/// <summary>
+/// Creates a pool.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIObjectPool::Create() noexcept -> CUIObjectPool* {
+    const auto ptr = LongUI::NormalAlloc(sizeof(CUIObjectPool));
+    return ptr ? new(ptr) CUIObjectPool : nullptr;
+}
+
+/// <summary>
+/// Gets the default pool, never destroyed.
+/// 默认池: 不会析构, 避免退出时释放顺序问题; 空块直接释放, 退出时不残留
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIObjectPool::GetDefault() noexcept -> CUIObjectPool& {
+    alignas(CUIObjectPool) static char s_buffer[sizeof(CUIObjectPool)];
+    static auto s_pool = []() noexcept {
+        const auto pool = new(s_buffer) CUIObjectPool;
+        pool->m_bKeepSlab = false;
+        return pool;
+    }();
+    return *s_pool;
+}
+
+/// <summary>
+/// Gets the current pool of this thread.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIObjectPool::GetCurrent() noexcept -> CUIObjectPool& {
+    const auto pool = impl::s_current_pool;
+    return pool ? *pool : CUIObjectPool::GetDefault();
+}
+
+/// <summary>
+/// Frees the object allocated by any pool.
+/// </summary>
+/// <param name="address">The address.</param>
+/// <returns></returns>
+void LongUI::CUIObjectPool::Free(void* address) noexcept {
+    static_assert(sizeof(Header) == HEADER_SIZE, "bad size");
+    if (!address) return;
+    const auto header = reinterpret_cast<Header*>(address) - 1;
+    const auto pool = header->size_class == CLASS_LARGE ? header->pool : header->slab->pool;
+    pool->free_object(header);
+}
+
+/// <summary>
+/// Releases this pool by owner.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIObjectPool::Release() noexcept {
+    this->release_ref();
+}
+
+/// <summary>
+/// Releases the reference, destroys this if the last one.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIObjectPool::release_ref() noexcept {
+    if (m_cRef.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        assert(this != &CUIObjectPool::GetDefault() && "default pool released");
+        this->~CUIObjectPool();
+        LongUI::NormalFree(this);
+    }
+}
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUIObjectPool"/> class.
+/// 整体释放全部块
+/// </summary>
+/// <returns></returns>
+LongUI::CUIObjectPool::~CUIObjectPool() noexcept {
+    auto free_list = [](Slab* slab) noexcept {
+        while (slab) {
+            const auto next = slab->next;
+            assert(!slab->used && "object alive");
+            LongUI::NormalFree(slab);
+            slab = next;
+        }
+    };
+    for (auto slab : m_apPartial) free_list(slab);
+    for (auto slab : m_apFull) free_list(slab);
+}
+
+/// <summary>
+/// Allocates the object.
+/// </summary>
+/// <param name="size">The size.</param>
+/// <returns></returns>
+auto LongUI::CUIObjectPool::Alloc(size_t size) noexcept -> void* {
+    const auto index = impl::get_size_class(size + HEADER_SIZE);
+    Header* header = nullptr;
+    // 大对象直接分配
+    if (index == CLASS_LARGE) {
+        header = reinterpret_cast<Header*>(LongUI::NormalAlloc(size + HEADER_SIZE));
+        if (!header) return nullptr;
+        header->pool = this;
+        this->lock();
+        ++m_acSlab[index];
+        m_cTotalBytes += size + HEADER_SIZE;
+        m_cUsedBytes += size + HEADER_SIZE;
+    }
+    else {
+        this->lock();
+        auto slab = m_apPartial[index];
+        // 新建块
+        if (!slab) {
+            const auto capacity = impl::get_slot_count(index);
+            const auto bytes = sizeof(Slab) + size_t(impl::POOL_CLASS_SIZE[index]) * capacity;
+            slab = reinterpret_cast<Slab*>(LongUI::NormalAlloc(bytes));
+            if (!slab) { this->unlock(); return nullptr; }
+            slab->pool = this;
+            slab->prev = nullptr;
+            slab->next = nullptr;
+            slab->free = nullptr;
+            slab->size_class = index;
+            slab->used = 0;
+            slab->bump = 0;
+            slab->capacity = capacity;
+            m_apPartial[index] = slab;
+            ++m_acSlab[index];
+            m_cTotalBytes += bytes;
+        }
+        // 优先复用空闲槽
+        if (slab->free) {
+            header = slab->free;
+            slab->free = header->next_free();
+        }
+        else {
+            assert(slab->bump < slab->capacity && "full slab in partial list");
+            header = slab->slot(slab->bump++);
+        }
+        header->slab = slab;
+        // 已满: 移入满链表
+        if (++slab->used == slab->capacity) {
+            m_apPartial[index] = slab->next;
+            if (slab->next) slab->next->prev = nullptr;
+            slab->prev = nullptr;
+            slab->next = m_apFull[index];
+            if (slab->next) slab->next->prev = slab;
+            m_apFull[index] = slab;
+        }
+        m_cUsedBytes += impl::POOL_CLASS_SIZE[index];
+    }
+    header->size_class = index;
+    header->size = static_cast<uint32_t>(size);
+    ++m_acLive[index];
+    m_cLiveBytes += size;
+    m_cRef.fetch_add(1, std::memory_order_relaxed);
+    this->unlock();
+    return header + 1;
+}
+
+/// <summary>
+/// Frees the object.
+/// </summary>
+/// <param name="header">The header of object.</param>
+/// <returns></returns>
+void LongUI::CUIObjectPool::free_object(Header* header) noexcept {
+    const auto index = header->size_class;
+    this->lock();
+    assert(m_acLive[index] && "bad free");
+    --m_acLive[index];
+    m_cLiveBytes -= header->size;
+    // 大对象
+    if (index == CLASS_LARGE) {
+        const auto bytes = size_t(header->size) + HEADER_SIZE;
+        --m_acSlab[index];
+        m_cTotalBytes -= bytes;
+        m_cUsedBytes -= bytes;
+        this->unlock();
+        LongUI::NormalFree(header);
+        return this->release_ref();
+    }
+    const auto slab = header->slab;
+    m_cUsedBytes -= impl::POOL_CLASS_SIZE[index];
+    auto& partial = m_apPartial[index];
+    // 满块移回部分链表
+    if (slab->used-- == slab->capacity) {
+        if (slab->prev) slab->prev->next = slab->next;
+        else m_apFull[index] = slab->next;
+        if (slab->next) slab->next->prev = slab->prev;
+        slab->prev = nullptr;
+        slab->next = partial;
+        if (partial) partial->prev = slab;
+        partial = slab;
+    }
+    Slab* empty = nullptr;
+    // 空块: 保留该级最后一个块, 其余直接释放
+    if (!slab->used && (!m_bKeepSlab || m_acSlab[index] > 1)) {
+        if (slab->prev) slab->prev->next = slab->next;
+        else partial = slab->next;
+        if (slab->next) slab->next->prev = slab->prev;
+        --m_acSlab[index];
+        m_cTotalBytes -= sizeof(Slab) + size_t(impl::POOL_CLASS_SIZE[index]) * slab->capacity;
+        empty = slab;
+    }
+    else {
+        header->next_free() = slab->free;
+        slab->free = header;
+    }
+    this->unlock();
+    if (empty) LongUI::NormalFree(empty);
+    this->release_ref();
+}
+
+/// <summary>
+/// Gets the count of live objects.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIObjectPool::GetLiveCount() const noexcept -> uint32_t {
+    uint32_t count = 0;
+    this->lock();
+    for (auto live : m_acLive) count += live;
+    this->unlock();
+    return count;
+}
+
+/// <summary>
+/// Gets the statistics.
+/// </summary>
+/// <param name="stat">The stat.</param>
+/// <returns></returns>
+void LongUI::CUIObjectPool::GetStatistics(Statistics& stat) const noexcept {
+    this->lock();
+    for (uint32_t i = 0; i < CLASS_COUNT; ++i) {
+        stat.live_count[i] = m_acLive[i];
+        stat.slab_count[i] = m_acSlab[i];
+    }
+    stat.live_bytes = m_cLiveBytes;
+    stat.used_bytes = m_cUsedBytes;
+    stat.total_bytes = m_cTotalBytes;
+    this->unlock();
+    stat.fragmentation = stat.total_bytes ?
+        1.f - float(double(stat.live_bytes) / double(stat.total_bytes)) : 0.f;
+}
+
+/// <summary>
+/// Initializes a new instance of the <see cref="CUIObjectPoolScope"/> class.
+/// </summary>
+/// <param name="pool">The pool, keep current pool if null.</param>
+LongUI::CUIObjectPoolScope::CUIObjectPoolScope(CUIObjectPool* pool) noexcept
+    : m_pOld(impl::s_current_pool) {
+    if (pool) impl::s_current_pool = pool;
+}
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUIObjectPoolScope"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUIObjectPoolScope::~CUIObjectPoolScope() noexcept {
+    impl::s_current_pool = m_pOld;
+}
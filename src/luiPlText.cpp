@@ -0,0 +1,862 @@
+﻿#include "Platless/luiPlConf.h"
+#include "Platless/luiPlText.h"
+#include <algorithm>
+#include <cstring>
+
+// longui::impl
+namespace LongUI { namespace impl {
+    // lower bound in ascending array
+    inline auto lower_bound(const uint32_t* data, uint32_t size, uint32_t value) noexcept -> uint32_t {
+        return static_cast<uint32_t>(std::lower_bound(data, data + size, value) - data);
+    }
+    // bits of float
+    inline auto float_bits(float f) noexcept -> uint32_t {
+        uint32_t bits; std::memcpy(&bits, &f, sizeof(bits)); return bits;
+    }
+    // hash of text layout key
+    inline auto hash_layout_key(const TextLayoutKey& key) noexcept -> uint32_t {
+        constexpr uint32_t seed = 131;
+        uint32_t code = 0;
+        for (uint32_t i = 0; i != key.length; ++i) code = code * seed + uint16_t(key.text[i]);
+        const auto fmt = reinterpret_cast<size_t>(key.format);
+        code = code * seed + uint32_t(fmt) + uint32_t(uint64_t(fmt) >> 32);
+        code = code * seed + key.flags;
+        code = code * seed + float_bits(key.width);
+        code = code * seed + float_bits(key.height);
+        // 混合低位, 桶数为2的幂
+        code ^= code >> 16; code *= 0x85ebca6bu;
+        code ^= code >> 13; code *= 0xc2b2ae35u;
+        code ^= code >> 16;
+        return code;
+    }
+}}
+
+
+/// <summary>
+/// Initializes a new instance of the <see cref="CUITextBuffer"/> class.
+/// </summary>
+LongUI::CUITextBuffer::CUITextBuffer() noexcept {
+    // 空结点, 使用内联缓冲区, 不会失败
+    m_nodes.push_back(Node{ 0 });
+    assert(m_nodes.isok() && "bad action");
+}
+
+/// <summary>
+/// Counts the line feeds in buffer range.
+/// </summary>
+/// <param name="b">The buffer.</param>
+/// <param name="begin">The begin.</param>
+/// <param name="end">The end.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::count_lines(const Buffer& b, uint32_t begin, uint32_t end) noexcept -> uint32_t {
+    const auto data = b.feeds.data();
+    const auto size = b.feeds.size();
+    return impl::lower_bound(data, size, end) - impl::lower_bound(data, size, begin);
+}
+
+/// <summary>
+/// Appends text to the specified buffer.
+/// </summary>
+/// <param name="b">The buffer.</param>
+/// <param name="str">The string.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+bool LongUI::CUITextBuffer::append(Buffer& b, const wchar_t* str, uint32_t len) noexcept {
+    const auto old = b.text.size();
+    b.text.insert(old, str, len);
+    if (!b.text.isok()) return false;
+    // 记录换行位置
+    for (uint32_t i = 0; i != len; ++i) {
+        if (str[i] != L'\n') continue;
+        b.feeds.push_back(old + i);
+        if (!b.feeds.isok()) return false;
+    }
+    return true;
+}
+
+/// <summary>
+/// Updates the sum of node.
+/// </summary>
+/// <param name="i">The index.</param>
+/// <returns></returns>
+void LongUI::CUITextBuffer::update(Index i) noexcept {
+    assert(i && "bad argument");
+    auto& n = m_nodes[i];
+    const auto& l = m_nodes[n.left];
+    const auto& r = m_nodes[n.right];
+    n.sum_length = l.sum_length + n.length + r.sum_length;
+    n.sum_lines = l.sum_lines + n.lines + r.sum_lines;
+}
+
+/// <summary>
+/// Reserves nodes, new_node will not fail after this.
+/// </summary>
+/// <param name="count">The count.</param>
+/// <returns></returns>
+bool LongUI::CUITextBuffer::reserve_nodes(uint32_t count) noexcept {
+    if (m_free.size() >= count) return true;
+    const auto need = m_nodes.size() + count;
+    if (need <= m_nodes.capacity()) return true;
+    m_nodes.reserve(need + need / 2);
+    return m_nodes.capacity() >= need;
+}
+
+/// <summary>
+/// Creates a new node.
+/// </summary>
+/// <param name="add">if set to <c>true</c> [add].</param>
+/// <param name="start">The start.</param>
+/// <param name="length">The length.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::new_node(bool add, uint32_t start, uint32_t length) noexcept -> Index {
+    Index i;
+    if (m_free.size()) {
+        i = m_free[m_free.size() - 1];
+        m_free.pop_back();
+    }
+    else {
+        assert(m_nodes.size() < m_nodes.capacity() && "call reserve_nodes first");
+        i = m_nodes.size();
+        m_nodes.push_back();
+    }
+    // xorshift
+    m_seed ^= m_seed << 13; m_seed ^= m_seed >> 17; m_seed ^= m_seed << 5;
+    auto& n = m_nodes[i];
+    n.left = n.right = 0;
+    n.priority = m_seed;
+    n.start = start;
+    n.length = length;
+    n.lines = count_lines(add ? m_add : m_original, start, start + length);
+    n.add = add;
+    this->update(i);
+    return i;
+}
+
+/// <summary>
+/// Frees the subtree.
+/// </summary>
+/// <param name="i">The index.</param>
+/// <returns></returns>
+void LongUI::CUITextBuffer::free_tree(Index i) noexcept {
+    if (!i) return;
+    this->free_tree(m_nodes[i].left);
+    this->free_tree(m_nodes[i].right);
+    // 空闲链表申请失败只是浪费一个结点
+    m_free.push_back(i);
+}
+
+/// <summary>
+/// Splits the tree by position, left has [0, pos).
+/// </summary>
+/// <param name="t">The tree.</param>
+/// <param name="pos">The position.</param>
+/// <param name="l">The left tree.</param>
+/// <param name="r">The right tree.</param>
+/// <returns></returns>
+void LongUI::CUITextBuffer::split(Index t, uint32_t pos, Index& l, Index& r) noexcept {
+    if (!t) { l = r = 0; return; }
+    const auto leftlen = m_nodes[m_nodes[t].left].sum_length;
+    const auto length = m_nodes[t].length;
+    Index a, b;
+    // 在左子树
+    if (pos <= leftlen) {
+        this->split(m_nodes[t].left, pos, a, b);
+        m_nodes[t].left = b;
+        this->update(t);
+        l = a; r = t;
+    }
+    // 在右子树
+    else if (pos >= leftlen + length) {
+        this->split(m_nodes[t].right, pos - leftlen - length, a, b);
+        m_nodes[t].right = a;
+        this->update(t);
+        l = t; r = b;
+    }
+    // 在片段中间, 切为两个片段
+    else {
+        const auto offset = pos - leftlen;
+        const auto& n = m_nodes[t];
+        const auto right = this->new_node(n.add, n.start + offset, length - offset);
+        auto& lnode = m_nodes[t];
+        auto& rnode = m_nodes[right];
+        rnode.priority = lnode.priority;
+        rnode.right = lnode.right;
+        lnode.right = 0;
+        lnode.length = offset;
+        lnode.lines -= rnode.lines;
+        this->update(right);
+        this->update(t);
+        l = t; r = right;
+    }
+}
+
+/// <summary>
+/// Merges the specified trees.
+/// </summary>
+/// <param name="l">The left tree.</param>
+/// <param name="r">The right tree.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::merge(Index l, Index r) noexcept -> Index {
+    if (!l) return r;
+    if (!r) return l;
+    if (m_nodes[l].priority > m_nodes[r].priority) {
+        const auto right = this->merge(m_nodes[l].right, r);
+        m_nodes[l].right = right;
+        this->update(l);
+        return l;
+    }
+    else {
+        const auto left = this->merge(l, m_nodes[r].left);
+        m_nodes[r].left = left;
+        this->update(r);
+        return r;
+    }
+}
+
+/// <summary>
+/// Extends the last piece of tree if it ends at start of add buffer.
+/// 连续输入时直接扩展最后的片段
+/// </summary>
+/// <param name="t">The tree.</param>
+/// <param name="start">The start in add buffer.</param>
+/// <param name="len">The length.</param>
+/// <param name="lines">The count of line feed.</param>
+/// <returns></returns>
+bool LongUI::CUITextBuffer::extend_last(Index t, uint32_t start, uint32_t len, uint32_t lines) noexcept {
+    if (!t) return false;
+    auto& n = m_nodes[t];
+    if (n.right) {
+        if (!this->extend_last(n.right, start, len, lines)) return false;
+    }
+    else {
+        if (!n.add || n.start + n.length != start) return false;
+        n.length += len;
+        n.lines += lines;
+    }
+    this->update(t);
+    return true;
+}
+
+/// <summary>
+/// Sets the whole text.
+/// </summary>
+/// <param name="str">The string.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+bool LongUI::CUITextBuffer::SetText(const wchar_t* str, uint32_t len) noexcept {
+    m_nodes.resize(1);
+    m_free.clear();
+    m_original.text.clear(); m_original.feeds.clear();
+    m_add.text.clear(); m_add.feeds.clear();
+    m_root = 0;
+    if (!len) return true;
+    assert(str && "bad argument");
+    if (!append(m_original, str, len) || !this->reserve_nodes(1)) return false;
+    m_root = this->new_node(false, 0, len);
+    return true;
+}
+
+/// <summary>
+/// Inserts the text.
+/// </summary>
+/// <param name="pos">The position.</param>
+/// <param name="str">The string.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+bool LongUI::CUITextBuffer::Insert(uint32_t pos, const wchar_t* str, uint32_t len) noexcept {
+    assert(pos <= this->GetLength() && "out of range");
+    if (!len) return true;
+    assert(str && "bad argument");
+    pos = std::min(pos, this->GetLength());
+    // 追加到添加缓冲区
+    const auto start = m_add.text.size();
+    if (!this->reserve_nodes(2) || !append(m_add, str, len)) return false;
+    const auto lines = count_lines(m_add, start, start + len);
+    Index l, r;
+    this->split(m_root, pos, l, r);
+    if (!this->extend_last(l, start, len, lines)) {
+        l = this->merge(l, this->new_node(true, start, len));
+    }
+    m_root = this->merge(l, r);
+    return true;
+}
+
+/// <summary>
+/// Removes the text.
+/// </summary>
+/// <param name="pos">The position.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+void LongUI::CUITextBuffer::Remove(uint32_t pos, uint32_t len) noexcept {
+    const auto length = this->GetLength();
+    assert(pos <= length && len <= length - pos && "out of range");
+    pos = std::min(pos, length);
+    len = std::min(len, length - pos);
+    if (!len) return;
+    // 最多切开两个片段
+    if (!this->reserve_nodes(2)) return;
+    Index l, m, r;
+    this->split(m_root, pos, l, m);
+    this->split(m, len, m, r);
+    this->free_tree(m);
+    m_root = this->merge(l, r);
+}
+
+/// <summary>
+/// Gets the start position of line.
+/// </summary>
+/// <param name="line">The line.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::GetLineStart(uint32_t line) const noexcept -> uint32_t {
+    if (!line) return 0;
+    if (line >= this->GetLineCount()) return this->GetLength();
+    // 寻找第line个换行符
+    uint32_t base = 0;
+    auto t = m_root;
+    while (t) {
+        const auto& n = m_nodes[t];
+        const auto& l = m_nodes[n.left];
+        if (line <= l.sum_lines) { t = n.left; continue; }
+        line -= l.sum_lines;
+        base += l.sum_length;
+        if (line <= n.lines) {
+            const auto& b = this->buffer(n);
+            const auto index = impl::lower_bound(b.feeds.data(), b.feeds.size(), n.start) + line - 1;
+            return base + b.feeds[index] - n.start + 1;
+        }
+        line -= n.lines;
+        base += n.length;
+        t = n.right;
+    }
+    assert(!"bad action");
+    return this->GetLength();
+}
+
+/// <summary>
+/// Gets the end position of line, line feed not included.
+/// </summary>
+/// <param name="line">The line.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::GetLineEnd(uint32_t line) const noexcept -> uint32_t {
+    if (line + 1 >= this->GetLineCount()) return this->GetLength();
+    return this->GetLineStart(line + 1) - 1;
+}
+
+/// <summary>
+/// Gets the line from position.
+/// </summary>
+/// <param name="pos">The position.</param>
+/// <returns></returns>
+auto LongUI::CUITextBuffer::GetLineFromPosition(uint32_t pos) const noexcept -> uint32_t {
+    uint32_t lines = 0;
+    auto t = m_root;
+    while (t) {
+        const auto& n = m_nodes[t];
+        const auto& l = m_nodes[n.left];
+        if (pos < l.sum_length) { t = n.left; continue; }
+        pos -= l.sum_length;
+        lines += l.sum_lines;
+        if (pos < n.length) return lines + count_lines(this->buffer(n), n.start, n.start + pos);
+        pos -= n.length;
+        lines += n.lines;
+        t = n.right;
+    }
+    return lines;
+}
+
+/// <summary>
+/// Gets the char at position.
+/// </summary>
+/// <param name="pos">The position.</param>
+/// <returns>0 if out of range</returns>
+auto LongUI::CUITextBuffer::GetChar(uint32_t pos) const noexcept -> wchar_t {
+    auto t = m_root;
+    while (t) {
+        const auto& n = m_nodes[t];
+        const auto leftlen = m_nodes[n.left].sum_length;
+        if (pos < leftlen) { t = n.left; continue; }
+        pos -= leftlen;
+        if (pos < n.length) return this->buffer(n).text[n.start + pos];
+        pos -= n.length;
+        t = n.right;
+    }
+    return 0;
+}
+
+/// <summary>
+/// Copies text of subtree in [pos, end).
+/// </summary>
+/// <param name="t">The tree.</param>
+/// <param name="pos">The position.</param>
+/// <param name="end">The end.</param>
+/// <param name="out">The output.</param>
+/// <returns></returns>
+void LongUI::CUITextBuffer::copy_to(Index t, uint32_t pos, uint32_t end, wchar_t*& out) const noexcept {
+    if (!t || pos >= end) return;
+    const auto& n = m_nodes[t];
+    const auto leftlen = m_nodes[n.left].sum_length;
+    if (pos < leftlen) this->copy_to(n.left, pos, std::min(end, leftlen), out);
+    // 本片段
+    const auto begin = std::max(pos, leftlen), last = std::min(end, leftlen + n.length);
+    if (begin < last) {
+        const auto src = this->buffer(n).text.data() + n.start + (begin - leftlen);
+        std::memcpy(out, src, (last - begin) * sizeof(wchar_t));
+        out += last - begin;
+    }
+    const auto rightpos = leftlen + n.length;
+    if (end > rightpos) this->copy_to(n.right, pos > rightpos ? pos - rightpos : 0, end - rightpos, out);
+}
+
+/// <summary>
+/// Copies text in range.
+/// </summary>
+/// <param name="pos">The position.</param>
+/// <param name="len">The length.</param>
+/// <param name="buf">The buffer.</param>
+/// <returns>count copied</returns>
+auto LongUI::CUITextBuffer::CopyTo(uint32_t pos, uint32_t len, wchar_t* buf) const noexcept -> uint32_t {
+    assert(buf && "bad argument");
+    const auto length = this->GetLength();
+    if (pos >= length) return 0;
+    len = std::min(len, length - pos);
+    auto out = buf;
+    this->copy_to(m_root, pos, pos + len, out);
+    assert(uint32_t(out - buf) == len && "bad action");
+    return len;
+}
+
+
+/// <summary>
+/// Clears all layouts.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIParagraphLayouts::Clear() noexcept {
+    for (auto& p : m_paragraphs) {
+        if (p.layout) m_layouter.DestroyLayout(p.layout);
+    }
+    m_paragraphs.clear();
+    m_fHeight = 0.f;
+    m_uDirtyBegin = m_uDirtyEnd = 0;
+}
+
+/// <summary>
+/// Marks the range dirty.
+/// </summary>
+/// <param name="begin">The begin.</param>
+/// <param name="end">The end.</param>
+/// <returns></returns>
+void LongUI::CUIParagraphLayouts::mark_dirty(uint32_t begin, uint32_t end) noexcept {
+    if (m_uDirtyBegin >= m_uDirtyEnd) {
+        m_uDirtyBegin = begin;
+        m_uDirtyEnd = end;
+    }
+    else {
+        m_uDirtyBegin = std::min(m_uDirtyBegin, begin);
+        m_uDirtyEnd = std::max(m_uDirtyEnd, end);
+    }
+}
+
+/// <summary>
+/// Resets to the specified text buffer, all paragraphs dirty.
+/// </summary>
+/// <param name="buffer">The buffer.</param>
+/// <returns></returns>
+bool LongUI::CUIParagraphLayouts::Reset(const CUITextBuffer& buffer) noexcept {
+    this->Clear();
+    m_paragraphs.newsize(buffer.GetLineCount());
+    if (!m_paragraphs.isok()) return false;
+    for (auto& p : m_paragraphs) p = Paragraph{ nullptr, 0.f, 0.f, true };
+    this->mark_dirty(0, m_paragraphs.size());
+    return true;
+}
+
+/// <summary>
+/// Inserts text into buffer and invalidates affected paragraphs.
+/// </summary>
+/// <param name="buffer">The buffer.</param>
+/// <param name="pos">The position.</param>
+/// <param name="str">The string.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+bool LongUI::CUIParagraphLayouts::Insert(CUITextBuffer& buffer, uint32_t pos, const wchar_t* str, uint32_t len) noexcept {
+    assert(m_paragraphs.size() == buffer.GetLineCount() && "call Reset first");
+    const auto line = buffer.GetLineFromPosition(pos);
+    const auto feeds = static_cast<uint32_t>(std::count(str, str + len, L'\n'));
+    // 先为新段落申请空间
+    const auto count = m_paragraphs.size();
+    m_paragraphs.reserve(count + feeds);
+    if (m_paragraphs.capacity() < count + feeds) return false;
+    if (!buffer.Insert(pos, str, len)) return false;
+    m_paragraphs[line].dirty = true;
+    // 之后的脏区间后移
+    if (m_uDirtyEnd > line + 1) m_uDirtyEnd += feeds;
+    if (m_uDirtyBegin > line) m_uDirtyBegin += feeds;
+    this->mark_dirty(line, line + 1 + feeds);
+    // 插入新段落
+    if (feeds) {
+        m_paragraphs.newsize(count + feeds);
+        const auto data = m_paragraphs.data();
+        std::memmove(data + line + 1 + feeds, data + line + 1, sizeof(Paragraph) * (count - line - 1));
+        for (auto itr = data + line + 1; itr != data + line + 1 + feeds; ++itr) {
+            *itr = Paragraph{ nullptr, 0.f, 0.f, true };
+        }
+    }
+    return true;
+}
+
+/// <summary>
+/// Removes text from buffer and invalidates affected paragraphs.
+/// </summary>
+/// <param name="buffer">The buffer.</param>
+/// <param name="pos">The position.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+void LongUI::CUIParagraphLayouts::Remove(CUITextBuffer& buffer, uint32_t pos, uint32_t len) noexcept {
+    assert(m_paragraphs.size() == buffer.GetLineCount() && "call Reset first");
+    const auto first = buffer.GetLineFromPosition(pos);
+    const auto last = buffer.GetLineFromPosition(pos + len);
+    buffer.Remove(pos, len);
+    // 合并到第一个段落
+    for (auto i = first + 1; i <= last; ++i) {
+        if (const auto layout = m_paragraphs[i].layout) m_layouter.DestroyLayout(layout);
+    }
+    if (last > first) m_paragraphs.erase(first + 1, last - first);
+    m_paragraphs[first].dirty = true;
+    // 被删除段落之后的脏区间前移
+    const auto removed = last - first;
+    m_uDirtyEnd = m_uDirtyEnd > last ? m_uDirtyEnd - removed : std::min(m_uDirtyEnd, first + 1);
+    m_uDirtyBegin = m_uDirtyBegin > last ? m_uDirtyBegin - removed : std::min(m_uDirtyBegin, first);
+    this->mark_dirty(first, first + 1);
+}
+
+/// <summary>
+/// Relayouts dirty paragraphs.
+/// </summary>
+/// <param name="buffer">The buffer.</param>
+/// <returns>count of paragraphs relaid out</returns>
+auto LongUI::CUIParagraphLayouts::Relayout(const CUITextBuffer& buffer) noexcept -> uint32_t {
+    assert(m_paragraphs.size() == buffer.GetLineCount() && "call Reset first");
+    uint32_t count = 0;
+    if (m_uDirtyBegin >= m_uDirtyEnd) return count;
+    const auto begin = m_uDirtyBegin, end = m_uDirtyEnd;
+    assert(end <= m_paragraphs.size() && "bad dirty range");
+    m_uDirtyBegin = m_uDirtyEnd = 0;
+    const auto data = m_paragraphs.data();
+    float top = begin ? data[begin - 1].top + data[begin - 1].height : 0.f;
+    for (auto i = begin; i != m_paragraphs.size(); ++i) {
+        auto& p = data[i];
+        // 脏区间之后位置未变, 剩余段落无需更新
+        if (i >= end && p.top == top) return count;
+        if (p.dirty) {
+            // 段落文本, 不含换行
+            const auto start = buffer.GetLineStart(i);
+            auto last = buffer.GetLineEnd(i);
+            if (last > start && buffer.GetChar(last - 1) == L'\r') --last;
+            m_scratch.newsize(last - start + 1);
+            if (!m_scratch.isok()) { this->mark_dirty(i, std::max(end, i + 1)); break; }
+            const auto len = buffer.CopyTo(start, last - start, m_scratch.data());
+            m_scratch[len] = 0;
+            if (p.layout) m_layouter.DestroyLayout(p.layout);
+            p.layout = m_layouter.CreateLayout(m_scratch.data(), len);
+            // 新布局丢失了区间格式, 测量前重新应用
+            if (p.layout) m_layouter.FormatLayout(p.layout, start, len);
+            p.height = p.layout ? m_layouter.GetLayoutHeight(p.layout) : 0.f;
+            p.dirty = false;
+            ++count;
+        }
+        p.top = top;
+        top += p.height;
+    }
+    m_fHeight = top;
+    return count;
+}
+
+/// <summary>
+/// Remeasures heights of all layouts changed in place.
+/// 布局原地修改(如最大宽度)后重新计算高度, 无需重建
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIParagraphLayouts::Remeasure() noexcept {
+    float top = 0.f;
+    for (auto& p : m_paragraphs) {
+        if (p.layout) p.height = m_layouter.GetLayoutHeight(p.layout);
+        p.top = top;
+        top += p.height;
+    }
+    m_fHeight = top;
+}
+
+/// <summary>
+/// Finds paragraph at y.
+/// </summary>
+/// <param name="y">The y.</param>
+/// <returns></returns>
+auto LongUI::CUIParagraphLayouts::HitTest(float y) const noexcept -> uint32_t {
+    if (m_paragraphs.empty()) return 0;
+    const auto data = m_paragraphs.data();
+    const auto end = data + m_paragraphs.size();
+    const auto itr = std::upper_bound(data, end, y, [](float v, const Paragraph& p) noexcept {
+        return v < p.top;
+    });
+    return itr == data ? 0 : static_cast<uint32_t>(itr - data - 1);
+}
+
+
+/// <summary>
+/// Clears the history.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITextHistory::Clear() noexcept {
+    m_records.clear();
+    m_text.clear();
+    m_records.shrink_to_fit();
+    m_text.shrink_to_fit();
+    m_uCursor = 0;
+}
+
+/// <summary>
+/// Records the operation.
+/// </summary>
+/// <param name="op">The operation.</param>
+/// <param name="pos">The position.</param>
+/// <param name="text">The text.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+void LongUI::CUITextHistory::record(Operation op, uint32_t pos, const wchar_t* text, uint32_t len) noexcept {
+    if (m_bApplying || !len) return;
+    assert(text && "bad argument");
+    // 丢弃重做部分
+    if (m_uCursor < m_records.size()) {
+        m_text.resize(m_records[m_uCursor].offset);
+        m_records.resize(m_uCursor);
+    }
+    const bool head = m_bGroupHead;
+    m_bGroupHead = false;
+    // 尝试合并连续输入/删除
+    if (!this->merge(op, pos, text, len)) {
+        const auto chained = m_cGroup && !head;
+        m_records.push_back(Record{ pos, len, m_text.size(), op, uint16_t(chained ? Flag_Chained : Flag_None) });
+        m_text.insert(m_text.size(), text, len);
+        if (!m_records.isok() || !m_text.isok()) return this->Clear();
+        m_uCursor = m_records.size();
+    }
+    this->trim();
+}
+
+/// <summary>
+/// Merges the operation into last record.
+/// </summary>
+/// <param name="op">The operation.</param>
+/// <param name="pos">The position.</param>
+/// <param name="text">The text.</param>
+/// <param name="len">The length.</param>
+/// <returns></returns>
+bool LongUI::CUITextHistory::merge(Operation op, uint32_t pos, const wchar_t* text, uint32_t len) noexcept {
+    if (!m_uCursor) return false;
+    auto& last = m_records[m_uCursor - 1];
+    if ((last.flags & Flag_Sealed) || last.op != op) return false;
+    // 换行不合并
+    if (std::find(text, text + len, L'\n') != text + len) return false;
+    const auto white = [](wchar_t ch) noexcept { return ch == L' ' || ch == L'\t'; };
+    uint32_t at;
+    if (op == Op_Insert) {
+        // 连续输入, 新单词开始时断开
+        if (pos != last.position + last.length) return false;
+        if (white(m_text[last.offset + last.length - 1]) && !white(text[0])) return false;
+        at = last.offset + last.length;
+    }
+    // 退格
+    else if (pos + len == last.position) {
+        at = last.offset;
+        last.position = pos;
+    }
+    // 删除
+    else if (pos == last.position) {
+        at = last.offset + last.length;
+    }
+    else return false;
+    m_text.insert(at, text, len);
+    if (!m_text.isok()) { this->Clear(); return true; }
+    last.length += len;
+    return true;
+}
+
+/// <summary>
+/// Drops oldest records while over limit.
+/// 超出内存限制时丢弃最旧的记录, 一次丢到3/4以下, 摊还O(1)
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITextHistory::trim() noexcept {
+    auto usage = m_records.size() * sizeof(Record) + m_text.size() * sizeof(wchar_t);
+    if (usage <= m_cLimit) return;
+    const auto target = m_cLimit / 4 * 3;
+    uint32_t count = 0;
+    while (count < m_uCursor && usage > target) {
+        usage -= sizeof(Record) + m_records[count].length * sizeof(wchar_t);
+        ++count;
+    }
+    // 不拆开组
+    while (count < m_records.size() && (m_records[count].flags & Flag_Chained)) ++count;
+    const auto offset = count < m_records.size() ? m_records[count].offset : m_text.size();
+    m_text.erase(0, offset);
+    m_records.erase(0, count);
+    for (auto& r : m_records) r.offset -= offset;
+    m_uCursor = count < m_uCursor ? m_uCursor - count : 0;
+    // 释放多余的容量
+    if (m_text.capacity() > m_text.size() * 2) m_text.shrink_to_fit();
+    if (m_records.capacity() > m_records.size() * 2) m_records.shrink_to_fit();
+}
+
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUITextLayoutCache"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUITextLayoutCache::~CUITextLayoutCache() noexcept {
+    this->Clear();
+}
+
+/// <summary>
+/// Clears all layouts.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::Clear() noexcept {
+    while (m_pTail) this->remove(m_pTail);
+    m_buckets.clear();
+    m_buckets.shrink_to_fit();
+    assert(!m_cCount && !m_cBytes && "bad action");
+}
+
+/// <summary>
+/// Gets the layout with one reference for caller, create it if not found.
+/// 获取布局, 调用者负责释放一次引用
+/// </summary>
+/// <param name="key">The key.</param>
+/// <returns>null if failed</returns>
+auto LongUI::CUITextLayoutCache::Get(const TextLayoutKey& key) noexcept -> void* {
+    assert((key.text || !key.length) && key.format && "bad argument");
+    const auto hash = impl::hash_layout_key(key);
+    // 命中
+    if (const auto entry = this->find(key, hash)) {
+        ++m_cHit;
+        if (entry != m_pHead) { this->unlink(entry); this->push_front(entry); }
+        m_backend.Acquire(entry->layout);
+        return entry->layout;
+    }
+    ++m_cMiss;
+    const auto layout = m_backend.CreateLayout(key);
+    if (!layout) return nullptr;
+    const auto text_bytes = key.length * sizeof(wchar_t);
+    const size_t bytes = sizeof(Entry) + text_bytes + m_backend.MeasureLayout(layout, key);
+    // 超出预算的直接交给调用者
+    if (bytes > m_cBudget) return layout;
+    this->rehash();
+    if (!m_buckets.size()) return layout;
+    const auto entry = reinterpret_cast<Entry*>(LongUI::NormalAlloc(sizeof(Entry) + text_bytes));
+    if (!entry) return layout;
+    // 复制键
+    const auto text = reinterpret_cast<wchar_t*>(entry + 1);
+    if (text_bytes) std::memcpy(text, key.text, text_bytes);
+    entry->key = key;
+    entry->key.text = text;
+    entry->layout = layout;
+    entry->hash = hash;
+    entry->bytes = static_cast<uint32_t>(bytes);
+    m_backend.Acquire(key.format);
+    // 插入
+    auto& bucket = m_buckets[hash & (m_buckets.size() - 1)];
+    entry->bucket_next = bucket;
+    bucket = entry;
+    this->push_front(entry);
+    ++m_cCount;
+    m_cBytes += bytes;
+    // 缓存与调用者各持有一次引用
+    m_backend.Acquire(layout);
+    this->evict();
+    return layout;
+}
+
+/// <summary>
+/// Finds the entry.
+/// </summary>
+/// <param name="key">The key.</param>
+/// <param name="hash">The hash code.</param>
+/// <returns></returns>
+auto LongUI::CUITextLayoutCache::find(const TextLayoutKey& key, uint32_t hash) const noexcept -> Entry* {
+    if (!m_buckets.size()) return nullptr;
+    auto entry = m_buckets[hash & (m_buckets.size() - 1)];
+    for (; entry; entry = entry->bucket_next) {
+        const auto& k = entry->key;
+        if (entry->hash == hash && k.length == key.length && k.flags == key.flags
+            && k.format == key.format && k.width == key.width && k.height == key.height
+            && !std::memcmp(k.text, key.text, key.length * sizeof(wchar_t))) break;
+    }
+    return entry;
+}
+
+/// <summary>
+/// Unlinks the entry from lru list.
+/// </summary>
+/// <param name="entry">The entry.</param>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::unlink(Entry* entry) noexcept {
+    (entry->prev ? entry->prev->next : m_pHead) = entry->next;
+    (entry->next ? entry->next->prev : m_pTail) = entry->prev;
+}
+
+/// <summary>
+/// Pushes the entry to lru head.
+/// </summary>
+/// <param name="entry">The entry.</param>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::push_front(Entry* entry) noexcept {
+    entry->prev = nullptr;
+    entry->next = m_pHead;
+    (m_pHead ? m_pHead->prev : m_pTail) = entry;
+    m_pHead = entry;
+}
+
+/// <summary>
+/// Removes and frees the entry.
+/// </summary>
+/// <param name="entry">The entry.</param>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::remove(Entry* entry) noexcept {
+    auto itr = &m_buckets[entry->hash & (m_buckets.size() - 1)];
+    while (*itr != entry) itr = &(*itr)->bucket_next;
+    *itr = entry->bucket_next;
+    this->unlink(entry);
+    --m_cCount;
+    m_cBytes -= entry->bytes;
+    m_backend.Release(entry->layout);
+    m_backend.Release(entry->key.format);
+    LongUI::NormalFree(entry);
+}
+
+/// <summary>
+/// Evicts oldest entries while over budget.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::evict() noexcept {
+    while (m_cBytes > m_cBudget) this->remove(m_pTail);
+}
+
+/// <summary>
+/// Rehashes if too full, keeps old buckets if OOM.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITextLayoutCache::rehash() noexcept {
+    const auto size = m_buckets.size();
+    if (m_cCount < size) return;
+    const uint32_t cap = size ? size * 2 : 64;
+    EzContainer::EzVector<Entry*> buckets;
+    buckets.newsize(cap);
+    if (!buckets.isok()) return;
+    std::memset(buckets.data(), 0, cap * sizeof(Entry*));
+    for (auto entry = m_pHead; entry; entry = entry->next) {
+        auto& bucket = buckets[entry->hash & (cap - 1)];
+        entry->bucket_next = bucket;
+        bucket = entry;
+    }
+    m_buckets = std::move(buckets);
+}
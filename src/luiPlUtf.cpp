@@ -0,0 +1,339 @@
+﻿#include "Platless/luiPlUtf.h"
+#include <cassert>
+// SSE2 for UTF-8/UTF-16 ascii fast path, others use scalar version
+// LONGUI_UTF_NO_SIMD: force scalar version, for differential test
+#if !defined(LONGUI_UTF_NO_SIMD) && (defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define LONGUI_UTF_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// 平台无关: 不依赖 luibase/luiconf
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // char32 to char 16
+    inline auto char32_to_char16(char32_t ch, char16_t* str) noexcept -> char16_t* {
+        assert(str && "bad argment");
+        // 检查是否需要转换
+        if (ch > 0xFFFF) {
+            str[0] = char16_t(0xD800 + (ch >> 10) - (0x10000 >> 10));
+            str[1] = char16_t(0xDC00 + (ch & 0x3FF));
+            return str + 2;
+        }
+        else {
+            str[0] = char16_t(ch);
+            return str + 1;
+        }
+    }
+    // 2x char16 to char32
+    inline auto char16x2_to_char32(char16_t lead, char16_t trail) noexcept -> char32_t {
+        assert(IsHighSurrogate(lead) && "illegal utf-16 char");
+        assert(IsLowSurrogate(trail) && "illegal utf-16 char");
+        return char32_t((lead-0xD800) << 10 | (trail-0xDC00)) + (0x10000);
+    };
+    // replacement character for illegal sequence
+    enum : char32_t { REPLACEMENT_CHARACTER = 0xFFFD };
+    // UTF-8 解码一个码点, 非法序列返回U+FFFD并跳过一字节
+    inline auto utf8_decode(const char*& src) noexcept -> char32_t {
+        const auto s = reinterpret_cast<const uint8_t*>(src);
+        const char32_t c0 = s[0];
+        // 单字节
+        if (c0 < 0x80) { src += 1; return c0; }
+        // 双字节 [C2, DF]
+        if (c0 >= 0xC2 && c0 <= 0xDF) {
+            if ((s[1] & 0xC0) == 0x80) {
+                src += 2;
+                return ((c0 & 0x1F) << 6) | (s[1] & 0x3F);
+            }
+        }
+        // 三字节 [E0, EF], 排除过长编码与代理区
+        else if (c0 >= 0xE0 && c0 <= 0xEF) {
+            const uint8_t lo = c0 == 0xE0 ? 0xA0 : 0x80;
+            const uint8_t hi = c0 == 0xED ? 0x9F : 0xBF;
+            if (s[1] >= lo && s[1] <= hi && (s[2] & 0xC0) == 0x80) {
+                src += 3;
+                return ((c0 & 0x0F) << 12) | (char32_t(s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+            }
+        }
+        // 四字节 [F0, F4], 排除过长编码与超出U+10FFFF
+        else if (c0 >= 0xF0 && c0 <= 0xF4) {
+            const uint8_t lo = c0 == 0xF0 ? 0x90 : 0x80;
+            const uint8_t hi = c0 == 0xF4 ? 0x8F : 0xBF;
+            if (s[1] >= lo && s[1] <= hi && (s[2] & 0xC0) == 0x80 && (s[3] & 0xC0) == 0x80) {
+                src += 4;
+                return ((c0 & 0x07) << 18) | (char32_t(s[1] & 0x3F) << 12)
+                    | (char32_t(s[2] & 0x3F) << 6) | (s[3] & 0x3F);
+            }
+        }
+        // 非法
+        src += 1;
+        return REPLACEMENT_CHARACTER;
+    }
+    // UTF-16 解码一个码点, 孤立代理返回U+FFFD
+    inline auto utf16_decode(const char16_t*& src) noexcept -> char32_t {
+        const char16_t c0 = src[0];
+        // 基本多语言平面
+        if ((c0 & 0xF800) != 0xD800) { src += 1; return c0; }
+        // 代理对
+        if (IsHighSurrogate(c0) && IsLowSurrogate(src[1])) {
+            src += 2;
+            return char16x2_to_char32(c0, src[-1]);
+        }
+        // 孤立代理
+        src += 1;
+        return REPLACEMENT_CHARACTER;
+    }
+    // UTF-8 length of code point
+    inline auto utf8_length(char32_t ch) noexcept -> uint32_t {
+        return ch < 0x80 ? 1 : (ch < 0x800 ? 2 : (ch < 0x10000 ? 3 : 4));
+    }
+    // is ascii char but not null
+    template<typename T> inline bool is_ascii_nz(T ch) noexcept {
+        return uint32_t(ch) - 1u < 0x7Fu;
+    }
+#ifdef LONGUI_UTF_SSE2
+    // index of lowest set bit, mask must not be 0
+    inline auto lowest_bit(uint32_t mask) noexcept -> uint32_t {
+#ifdef _MSC_VER
+        unsigned long index; ::_BitScanForward(&index, mask); return uint32_t(index);
+#else
+        return uint32_t(__builtin_ctz(mask));
+#endif
+    }
+    // mask of non-ascii or null in 16 bytes
+    inline auto not_ascii8_mask(__m128i v) noexcept -> uint32_t {
+        const auto zero = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+        return uint32_t(_mm_movemask_epi8(_mm_or_si128(v, zero)));
+    }
+    // mask(2 bits per char) of non-ascii or null in 8 char16
+    inline auto not_ascii16_mask(__m128i v) noexcept -> uint32_t {
+        // 1 <= v <= 0x7F  <=>  0 <= v-1 < 0x7F (signed)
+        const auto w = _mm_sub_epi16(v, _mm_set1_epi16(1));
+        const auto ok = _mm_and_si128(
+            _mm_cmpgt_epi16(w, _mm_set1_epi16(-1)),
+            _mm_cmplt_epi16(w, _mm_set1_epi16(0x7F))
+        );
+        return uint32_t(_mm_movemask_epi8(ok)) ^ 0xFFFFu;
+    }
+#endif
+    // length of leading ascii chars(not null), aligned loads never cross page
+    inline auto ascii_length(const char* src) noexcept -> uint32_t {
+        const auto begin = src;
+#ifdef LONGUI_UTF_SSE2
+        // 短ASCII段(如CJK文本中的标点)不进入向量循环
+        for (uint32_t i = 0; i != 4; ++i, ++src) {
+            if (!is_ascii_nz(uint8_t(*src))) return uint32_t(src - begin);
+        }
+        while (reinterpret_cast<size_t>(src) & 15) {
+            if (!is_ascii_nz(uint8_t(*src))) return uint32_t(src - begin);
+            ++src;
+        }
+        while (true) {
+            const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(src));
+            if (const auto mask = not_ascii8_mask(v)) {
+                return uint32_t(src - begin) + lowest_bit(mask);
+            }
+            src += 16;
+        }
+#else
+        while (is_ascii_nz(uint8_t(*src))) ++src;
+        return uint32_t(src - begin);
+#endif
+    }
+    // length of leading ascii chars(not null), aligned loads never cross page
+    inline auto ascii_length(const char16_t* src) noexcept -> uint32_t {
+        const auto begin = src;
+#ifdef LONGUI_UTF_SSE2
+        if (!(reinterpret_cast<size_t>(src) & 1)) {
+            while (reinterpret_cast<size_t>(src) & 15) {
+                if (!is_ascii_nz(*src)) return uint32_t(src - begin);
+                ++src;
+            }
+            while (true) {
+                const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(src));
+                if (const auto mask = not_ascii16_mask(v)) {
+                    return uint32_t(src - begin) + lowest_bit(mask) / 2;
+                }
+                src += 8;
+            }
+        }
+#endif
+        while (is_ascii_nz(*src)) ++src;
+        return uint32_t(src - begin);
+    }
+    // copy leading ascii chars(not null) from utf-8 to utf-16
+    inline void ascii_widen(const char*& src, char16_t*& des) noexcept {
+#ifdef LONGUI_UTF_SSE2
+        // 短ASCII段不进入向量循环
+        for (uint32_t i = 0; i != 4; ++i) {
+            if (!is_ascii_nz(uint8_t(*src))) return;
+            *des++ = char16_t(*src++);
+        }
+        while (reinterpret_cast<size_t>(src) & 15) {
+            if (!is_ascii_nz(uint8_t(*src))) return;
+            *des++ = char16_t(*src++);
+        }
+        const auto zero = _mm_setzero_si128();
+        while (true) {
+            const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(src));
+            if (not_ascii8_mask(v)) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(des + 0), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(des + 8), _mm_unpackhi_epi8(v, zero));
+            src += 16; des += 16;
+        }
+#endif
+        while (is_ascii_nz(uint8_t(*src))) *des++ = char16_t(*src++);
+    }
+    // copy leading ascii chars(not null) from utf-16 to utf-8
+    inline void ascii_narrow(const char16_t*& src, char*& des) noexcept {
+#ifdef LONGUI_UTF_SSE2
+        if (!(reinterpret_cast<size_t>(src) & 1)) {
+            while (reinterpret_cast<size_t>(src) & 15) {
+                if (!is_ascii_nz(*src)) return;
+                *des++ = char(*src++);
+            }
+            while (true) {
+                const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(src));
+                if (not_ascii16_mask(v)) break;
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(des), _mm_packus_epi16(v, v));
+                src += 8; des += 8;
+            }
+        }
+#endif
+        while (is_ascii_nz(*src)) *des++ = char(*src++);
+    }
+    // mark for first byte
+    static const char32_t FIRST_BYTE_MARK[7] = { 
+        0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC 
+    };
+}}
+
+// longui namespace
+namespace LongUI {
+    // char32 转换 char16
+    auto Char32toChar16(char32_t ch, char16_t* str) -> char16_t* {
+        return impl::char32_to_char16(ch, str);
+    }
+    // 获取u16转换u8后u8所占长度(含0结尾符), 孤立代理按U+FFFD计算
+    auto UTF16toUTF8GetBufLen(const char16_t * src) noexcept -> uint32_t {
+        uint32_t length = 1;
+        while (true) {
+            // ASCII 快速通道
+            const auto ascii = impl::ascii_length(src);
+            src += ascii; length += ascii;
+            if (!*src) break;
+            length += impl::utf8_length(impl::utf16_decode(src));
+        }
+        return length;
+    }
+    // 获取u8转换u16后u16所占长度(含0结尾符), 非法序列按U+FFFD计算
+    auto UTF8toUTF16GetBufLen(const char* src) noexcept -> uint32_t {
+        uint32_t length = 1;
+        while (true) {
+            // ASCII 快速通道
+            const auto ascii = impl::ascii_length(src);
+            src += ascii; length += ascii;
+            if (!*src) break;
+            length += impl::utf8_decode(src) > 0xFFFF ? 2 : 1;
+        }
+        return length;
+    }
+    // 查找UTF8字符串中第一个非法序列, 全部合法则返回null
+    auto UTF8FindInvalid(const char* src) noexcept -> const char* {
+        assert(src && "bad argument");
+        while (true) {
+            src += impl::ascii_length(src);
+            if (!*src) return nullptr;
+            // 非ASCII: 非法序列只前进一字节
+            const auto pos = src;
+            impl::utf8_decode(src);
+            if (src == pos + 1) return pos;
+        }
+    }
+    // 查找UTF16字符串中第一个孤立代理, 全部合法则返回null
+    auto UTF16FindInvalid(const char16_t* src) noexcept -> const char16_t* {
+        assert(src && "bad argument");
+        while (true) {
+            src += impl::ascii_length(src);
+            if (!*src) return nullptr;
+            const auto pos = src;
+            const auto ch = impl::utf16_decode(src);
+            if (ch == impl::REPLACEMENT_CHARACTER && *pos != char16_t(ch)) return pos;
+        }
+    }
+    // UTF16字符串 转 UTF8字符串
+    // 定义处不带__restrict: 需要以引用传给辅助函数
+    auto UTF16toUTF8(
+        const char16_t* src,
+        char * des,
+        uint32_t buflen
+    ) noexcept -> char* {
+#ifdef _DEBUG
+        const auto olddes = des;
+        auto len = LongUI::UTF16toUTF8GetBufLen(src);
+        assert(buflen >= len && "buffer too small");
+#else
+        (void)buflen;
+#endif
+        // 遍历
+        while (true) {
+            // ASCII 快速通道
+            impl::ascii_narrow(src, des);
+            if (!*src) break;
+            // 初始数据
+            auto ch = impl::utf16_decode(src);
+            const auto move = impl::utf8_length(ch);
+            // 掩码
+            constexpr char32_t byteMask = 0xBF;
+            constexpr char32_t byteMark = 0x80;
+            des += move;
+            // 转换
+            switch (move) {
+            case 4: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
+            case 3: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
+            case 2: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
+            case 1: *--des = (char)(ch | impl::FIRST_BYTE_MARK[move]);
+            }
+            des += move;
+        }
+        // 收尾检查
+#ifdef _DEBUG
+        auto utf16len1 = size_t(len - 1);
+        auto utf16len2 = size_t(des - olddes);
+        assert((utf16len1 == utf16len2) && "bug!");
+#endif
+        return des;
+    }
+    //  UTF8字符串 转 UTF16字符串
+    auto UTF8toUTF16(
+        const char * src, 
+        char16_t * des, 
+        uint32_t buflen) noexcept -> char16_t* {
+#ifdef _DEBUG
+        const auto olddes = des;
+        auto len = LongUI::UTF8toUTF16GetBufLen(src);
+        assert(buflen >= len && "buffer too small");
+#else
+        (void)buflen;
+#endif
+        // 遍历字符串
+        while (true) {
+            // ASCII 快速通道
+            impl::ascii_widen(src, des);
+            if (!*src) break;
+            // 写入
+            des = impl::char32_to_char16(impl::utf8_decode(src), des);
+        }
+        // 收尾检查
+#ifdef _DEBUG
+        auto utf16len1 = size_t(len - 1);
+        auto utf16len2 = size_t(des - olddes);
+        assert((utf16len1 == utf16len2) && "bug!");
+#endif
+        return des;
+    }
+}
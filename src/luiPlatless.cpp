@@ -5,26 +5,6 @@
 
 // longui::implnamespace
 namespace LongUI { namespace impl {
-    // char32 to char 16
-    inline auto char32_to_char16(char32_t ch, char16_t* str) noexcept -> char16_t* {
-        assert(str && "bad argment");
-        // 检查是否需要转换
-        if (ch > 0xFFFF) {
-            str[0] = char16_t(0xD800 + (ch >> 10) - (0x10000 >> 10));
-            str[1] = char16_t(0xDC00 + (ch & 0x3FF));
-            return str + 2;
-        }
-        else {
-            str[0] = char16_t(ch);
-            return str + 1;
-        }
-    }
-    // 2x char16 to char32
-    inline auto char16x2_to_char32(char16_t lead, char16_t trail) noexcept -> char32_t {
-        assert(IsHighSurrogate(lead) && "illegal utf-16 char");
-        assert(IsLowSurrogate(trail) && "illegal utf-16 char");
-        return char32_t((lead-0xD800) << 10 | (trail-0xDC00)) + (0x10000);
-    };
     // 反弹渐出
     auto inline bounce_ease_out(float p) noexcept ->float {
         if (p < 4.f / 11.f) {
@@ -68,66 +48,6 @@ namespace LongUI { namespace impl {
         }
         return value;
     }
-    // 字符串转浮点
-    template<typename T> auto atof(const T* p) noexcept ->float {
-        assert(p && "bad argument");
-        bool negative = false;
-        float value, scale;
-        // 跳过空白
-        while (white_space(*p)) ++p;
-        // 检查符号
-        if (*p == '-') {
-            negative = true;
-            ++p;
-        }
-        else if (*p == '+') {
-            ++p;
-        }
-        // 获取小数点或者指数之前的数字(有的话)
-        for (value = 0.0f; valid_digit(*p); ++p) {
-            value = value * 10.0f + static_cast<float>(*p - static_cast<T>('0'));
-        }
-        // 获取小数点或者指数之后的数字(有的话)
-        if (*p == '.') {
-            float pow10 = 10.0f; ++p;
-            while (valid_digit(*p)) {
-                value += (*p - static_cast<T>('0')) / pow10;
-                pow10 *= 10.0f;
-                ++p;
-            }
-        }
-        // 处理指数(有的话)
-        bool frac = false;
-        scale = 1.0f;
-        if ((*p == 'e') || (*p == 'E')) {
-            // 获取指数的符号(有的话)
-            ++p;
-            if (*p == '-') {
-                frac = true;
-                ++p;
-            }
-            else if (*p == '+') {
-                ++p;
-            }
-            unsigned int expon;
-            // 获取指数的数字(有的话)
-            for (expon = 0; valid_digit(*p); ++p) {
-                expon = expon * 10 + (*p - static_cast<T>('0'));
-            }
-            // float 最大38 double 最大308
-            if (expon > 38) expon = 38;
-            // 计算比例因数
-            while (expon >= 8) { scale *= 1E8f;  expon -= 8; }
-            while (expon) { scale *= 10.0f; --expon; }
-        }
-        // 返回
-        float returncoude = (frac ? (value / scale) : (value * scale));
-        if (negative) {
-            // float
-            returncoude = -returncoude;
-        }
-        return returncoude;
-    }
 }}
 
 
@@ -170,10 +90,6 @@ namespace LongUI {
         0x00000000UL, 0x00003080UL, 0x000E2080UL, 
         0x03C82080UL, 0xFA082080UL, 0x82082080UL 
     };
-    // mark for first byte
-    static const char32_t FIRST_BYTE_MARK[7] = { 
-        0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC 
-    };
     // Base64 Encode 编码
     auto Base64Encode(
         const uint8_t*  __restrict  bindata,
@@ -242,10 +158,6 @@ namespace LongUI {
         }
         return bindata_index - bindata;
     }
-    // char32 转换 char16
-    auto Char32toChar16(char32_t ch, char16_t* str) -> char16_t* {
-        return impl::char32_to_char16(ch, str);
-    }
     // char8 转 char32
     auto LongUI::UTF8ChartoChar32(const char* src) -> char32_t {
         assert(src && "bad argument");
@@ -270,162 +182,15 @@ namespace LongUI {
         // 返回
         return ch;
     }
-    // 获取u16转换u8后u8所占长度(含0结尾符)
-    auto UTF16toUTF8GetBufLen(const char16_t * src) noexcept -> uint32_t {
-        static_assert(sizeof(char16_t) == sizeof(wchar_t), "bad action");
-        const wchar_t* src2 = reinterpret_cast<const wchar_t*>(src);
-        uint32_t length = 1;
-        char16_t ch = 0;
-        // 遍历字符串
-        while ((ch = *src)) {
-            src += 1;
-            // 1字节区域 [0-7F]
-            if (ch < 0x0080) {
-                length += 1;
-            }
-            // 四字节区
-            else if (LongUI::IsHighSurrogate(ch)) {
-                assert(IsHighSurrogate(src[0]) && "illegal utf-8");
-                src += 1;
-                length += 4;
-            }
-            // 3字节区域 > 2^11
-            else if (ch > 0x07FFF){
-                length += 3;
-            }
-            // 2字节区域 [80-7FF]
-            else /*if (ch < 0x0800) */{
-                length += 2;
-            }
-        }
-        return length;
-    }
-    // 获取u8转换u16后u16所占长度(含0结尾符)
-    auto UTF8toUTF16GetBufLen(const char* src) noexcept -> uint32_t {
-        uint32_t length = 1;
-        unsigned char ch = 0;
-        // 遍历字符串
-        while ((ch = *src)) {
-            auto blen = BYTES_FOR_UTF8[ch];
-            assert(blen > 0 && blen < 5 && "illegal utf-8");
-            src += blen;
-            length += 1 + (blen >> 2);
-        }
-        return length;
-    }
-    // UTF16字符串 转 UTF8字符串
-    auto UTF16toUTF8(
-        const char16_t* __restrict src,
-        char * __restrict des,
-        uint32_t buflen
-    ) noexcept -> char* {
-#ifdef _DEBUG
-        const auto olddes = des;
-        auto len = LongUI::UTF16toUTF8GetBufLen(src);
-        assert(buflen >= len && "buffer too small");
-#endif
-        // 遍历
-        while (*src) {
-            // 初始数据
-            char32_t ch = 0;
-            uint32_t move = 0;
-            // 辅助平面
-            if (((*src) & 0xD800) == 0xD800) {
-                ch = impl::char16x2_to_char32(src[0], src[1]);
-                assert(ch > 0xFFFF && ch <= 0x10FFFF && "bad utf32 char");
-                // UTF-16 x2 --- UTF-8  x4
-                src += 2;
-                move = 4;
-            }
-            // 基本多语言平面
-            else {
-                ch = char32_t(*src);
-                src += 1;
-                // 单字节
-                if (ch < char32_t(0x80)) {
-                    move = 1;
-                }
-                // 双字节
-                else if (ch < char32_t(0x0800)) {
-                    move = 2;
-                }
-                // 三字节
-                else {
-                    move = 3;
-                }
-            }
-            // 掩码
-            constexpr char32_t byteMask = 0xBF;
-            constexpr char32_t byteMark = 0x80;
-            des += move;
-            // 转换
-            switch (move) {
-            case 4: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
-            case 3: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
-            case 2: *--des = (char)((ch | byteMark) & byteMask); ch >>= 6;
-            case 1: *--des = (char)(ch | FIRST_BYTE_MARK[move]);
-            }
-            des += move;
-        }
-        // 收尾检查
-#ifdef _DEBUG
-        auto utf16len1 = size_t(len - 1);
-        auto utf16len2 = size_t(des - olddes);
-        assert((utf16len1 == utf16len2) && "bug!");
-#endif
-        return des;
-    }
-    //  UTF8字符串 转 UTF16字符串
-    auto UTF8toUTF16(
-        const char * __restrict src, 
-        char16_t * __restrict des, 
-        uint32_t buflen) noexcept -> char16_t* {
-#ifdef _DEBUG
-        const auto olddes = des;
-        auto len = LongUI::UTF8toUTF16GetBufLen(src);
-        assert(buflen >= len && "buffer too small");
-#else
-        buflen;
-#endif
-        // 遍历字符串
-        while (*src) {
-            // 初始数据
-            char32_t ch = 0;
-            unsigned char read = BYTES_FOR_UTF8[(unsigned char)(*src)] - 1;
-            // 读取
-            switch (read)
-            {
-#ifdef _DEBUG
-            default:assert(!"bug"); break;
-            case 5: 
-            case 4: assert(!"illegal utf-8");
-#endif
-            case 3: ch += (unsigned char)(*src++); ch <<= 6;
-            case 2: ch += (unsigned char)(*src++); ch <<= 6;
-            case 1: ch += (unsigned char)(*src++); ch <<= 6;
-            case 0: ch += (unsigned char)(*src++);
-            }
-            // 减去偏移量
-            ch -= OFFSETS_FROM_UTF8[read];
-            // 写入
-            des = impl::char32_to_char16(ch, des);
-        }
-        // 收尾检查
-#ifdef _DEBUG
-        auto utf16len1 = size_t(len - 1);
-        auto utf16len2 = size_t(des - olddes);
-        assert((utf16len1 == utf16len2) && "bug!");
-#endif
-        return des;
-    }
     /// <summary>
     /// string to float.字符串转浮点, std::atof自己实现版
     /// </summary>
     /// <param name="p">The string. in const char*</param>
     /// <returns></returns>
     auto AtoF(const char* __restrict p) noexcept -> float {
-        if (!p) return 0.0f;
-        return impl::atof(p);
+        float value = 0.0f;
+        if (p) LongUI::ParseFloat(p, nullptr, value);
+        return value;
     }
     /// <summary>
     /// string to float.字符串转浮点, std::atof自己实现版
@@ -433,8 +198,9 @@ namespace LongUI {
     /// <param name="p">The string.in const wchar_t*</param>
     /// <returns></returns>
     auto AtoF(const wchar_t* __restrict p) noexcept -> float {
-        if (!p) return 0.0f;
-        return impl::atof(p);
+        float value = 0.0f;
+        if (p) LongUI::ParseFloat(p, nullptr, value);
+        return value;
     }
     /// <summary>
     /// string to int, 字符串转整型, std::atoi自己实现版
@@ -240,10 +240,8 @@ namespace LongUI { namespace Helper {
         if (!str || !*str) return str;
         const char* rcode = str;
         impl::make_units<','>([&rcode](float* out, const char* begin, const char* end) noexcept {
-            auto len = static_cast<size_t>(end - begin);
-            char buf[128]; assert(len < lengthof(buf));
-            std::memcpy(buf, begin, len); len[buf] = 0;
-            *out = LongUI::AtoF(buf);
+            // 就地解析, 无需复制
+            LongUI::ParseFloat(begin, end, *out);
             rcode = end;
         }, str, fary, size);
         return rcode;
@@ -282,9 +280,10 @@ namespace LongUI { namespace Helper {
             color[State_Pushed]     = D2D1::ColorF(0x78787878ui32);
         }
         bool rc = false;
+        const Helper::AttributeView view(node, prefix);
         // 循环设置
         for (int i = 0; i < STATE_COUNT; ++i) {
-            rc = rc | Helper::MakeColor(Helper::XMLGetValue(node, COLOR_BUTTON[i], prefix), color[i]);
+            rc = rc | Helper::MakeColor(view.Get(COLOR_BUTTON[i]), color[i]);
         }
         return rc;
     }
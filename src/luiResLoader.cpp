@@ -194,18 +194,11 @@ namespace LongUI {
         auto get_brush(pugi::xml_node node) noexcept ->ID2D1Brush*;
         // get text format
         auto get_text_format(pugi::xml_node node) noexcept ->IDWriteTextFormat*;
-        // find node with index
-        static auto find_node_with_index(pugi::xml_node node, const size_t index) noexcept {
-            pugi::xml_node found_node;
-            size_t i = 0;
-            for (auto itr = node.first_child(); itr; itr = itr.next_sibling()) {
-                if (i == index) {
-                    found_node = itr;
-                    break;
-                }
-                ++i;
-            }
-            return found_node;
+        // find node with index, O(1) via index built in get_resource_count_from_xml
+        auto find_node_with_index(ResourceType type, const size_t index) const noexcept {
+            const auto& nodes = m_aIndex[type];
+            assert(index < nodes.size() && "out of range");
+            return index < nodes.size() ? nodes[uint32_t(index)] : pugi::xml_node();
         }
     public:
         // ctor
@@ -217,12 +210,10 @@ namespace LongUI {
         CUIManager&             m_manager;
         // WIC factory
         IWICImagingFactory2*    m_pWicFactory = nullptr;
-        // node for reource
-        pugi::xml_node          m_aNodes[RESOURCE_TYPE_COUNT];
         // xml doc for resource
         pugi::xml_document      m_docResource;
-        // resource count
-        uint32_t                m_aResourceCount[RESOURCE_TYPE_COUNT];
+        // node index for reource, built in one pass
+        EzContainer::EzVector<pugi::xml_node> m_aIndex[RESOURCE_TYPE_COUNT];
         // ref counter for this
         uint32_t                m_dwCounter = 1;
     };
@@ -235,8 +226,6 @@ namespace LongUI {
     // ctor for CUIResourceLoaderXML
     LongUI::CUIResourceLoaderXML::CUIResourceLoaderXML(
         CUIManager& manager, const char* xml)  noexcept : m_manager(manager) {
-        // 初始化
-        std::memset(m_aResourceCount, 0, sizeof(m_aResourceCount));
         auto hr = S_OK;
         // 创建 WIC 工厂.
         if (SUCCEEDED(hr)) {
@@ -273,12 +262,12 @@ namespace LongUI {
     // get reource count
     auto LongUI::CUIResourceLoaderXML::GetResourceCount(ResourceType type) const noexcept -> size_t {
         assert(type < this->RESOURCE_TYPE_COUNT);
-        return static_cast<size_t>(m_aResourceCount[type]);
+        return static_cast<size_t>(m_aIndex[type].size());
     }
     // get reource
     auto LongUI::CUIResourceLoaderXML::GetResourcePointer(ResourceType type, size_t index) noexcept -> void* {
         void* data = nullptr;
-        auto node = this->find_node_with_index(m_aNodes[type], index);
+        auto node = this->find_node_with_index(type, index);
         switch (type)
         {
         case LongUI::IUIResourceLoader::Type_Bitmap:
@@ -302,7 +291,7 @@ namespace LongUI {
     }
     // get meta
     auto LongUI::CUIResourceLoaderXML::GetMeta(size_t index, DeviceIndependentMeta& meta_raw) noexcept -> void {
-        auto node = this->find_node_with_index(m_aNodes[this->Type_Meta], index);
+        auto node = this->find_node_with_index(this->Type_Meta, index);
         assert(node && "node not found");
         meta_raw = {
             { 0.f, 0.f, 1.f, 1.f },
@@ -317,37 +306,37 @@ namespace LongUI {
     // get reource count from doc
     void LongUI::CUIResourceLoaderXML::get_resource_count_from_xml() noexcept {
         // 初始化
-        for (auto& node : m_aNodes) { node = pugi::xml_node(); }
+        for (auto& nodes : m_aIndex) { nodes.clear(); }
+        // 建立索引
+        auto make_index = [this](ResourceType type, pugi::xml_node node) noexcept {
+            auto& nodes = m_aIndex[type]; nodes.clear();
+            for (auto itr = node.first_child(); itr; itr = itr.next_sibling()) {
+                nodes.push_back(itr);
+            }
+            // 内存不足
+            if (!nodes.isok() && node.first_child()) {
+                m_manager.ShowError(E_OUTOFMEMORY);
+            }
+        };
         // pugixml 使用的是句柄式, 所以下面的代码是安全的.
         auto now_node = m_docResource.first_child().first_child();
         while (now_node) {
-            // 获取子结点数量
-            auto get_children_count = [](pugi::xml_node node) {
-                node = node.first_child();
-                auto count = 0ui32;
-                while (node) { node = node.next_sibling(); ++count; }
-                return count;
-            };
             // 位图?
             if (!std::strcmp(now_node.name(), "Bitmap")) {
-                m_aNodes[Type_Bitmap] = now_node;
-                m_aResourceCount[this->Type_Bitmap] = get_children_count(now_node);
+                make_index(this->Type_Bitmap, now_node);
             }
             // 笔刷?
             else if (!std::strcmp(now_node.name(), "Brush")) {
-                m_aNodes[Type_Brush] = now_node;
-                m_aResourceCount[this->Type_Brush] = get_children_count(now_node);
+                make_index(this->Type_Brush, now_node);
             }
             // 文本格式?
             else if (!std::strcmp(now_node.name(), "Font") ||
                 !std::strcmp(now_node.name(), "TextFormat")) {
-                m_aNodes[Type_TextFormat] = now_node;
-                m_aResourceCount[this->Type_TextFormat] = get_children_count(now_node);
+                make_index(this->Type_TextFormat, now_node);
             }
             // 图元?
             else if (!std::strcmp(now_node.name(), "Meta")) {
-                m_aNodes[Type_Meta] = now_node;
-                m_aResourceCount[this->Type_Meta] = get_children_count(now_node);
+                make_index(this->Type_Meta, now_node);
             }
             // 动画图元?
             else if (!std::strcmp(now_node.name(), "MetaEx")) {
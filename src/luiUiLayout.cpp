@@ -0,0 +1,265 @@
+﻿// compiled layout
+#include <LongUI/luiUiLayout.h>
+#include <Platless/luiPlUtil.h>
+#ifdef LONGUI_WITH_LZ4
+#include <../3rdParty/lz4/lib/lz4.h>
+#pragma comment(lib, "lz4")
+#endif
+
+
+// longui::layout namespace
+namespace LongUI { namespace Layout {
+    // align to 4 byte
+    static inline auto align4(uint32_t a) noexcept { return (a + 3) & ~uint32_t(3); }
+    /// <summary>
+    /// Compiles the specified window node.
+    /// 编译窗口结点
+    /// </summary>
+    /// <param name="window">The window node.</param>
+    /// <param name="templates">The parent node of control templates, could be null.</param>
+    /// <param name="flags">The flags.</param>
+    /// <param name="output">The output.</param>
+    /// <returns></returns>
+    auto Compile(pugi::xml_node window, pugi::xml_node templates, uint32_t flags,
+        EzContainer::EzVector<uint8_t>& output) noexcept ->HRESULT {
+        assert(window && "bad argument");
+        if (!window) return E_INVALIDARG;
+#ifndef LONGUI_WITH_LZ4
+        // 不支持压缩
+        if (flags & Flag_LZ4) return E_NOTIMPL;
+#endif
+        bool oom = false;
+        EzContainer::EzVector<pugi::xml_node> xmlnodes, tmplnodes;
+        EzContainer::EzVector<uint32_t> parents, classes;
+        EzContainer::EzVector<Node> nodes;
+        EzContainer::EzVector<Attribute> attributes;
+        EzContainer::EzVector<char> strings;
+        EzContainer::EzStringHash<char, uint32_t> strtable, classtable;
+        // 字符串驻留
+        auto intern = [&](const char* str) noexcept ->uint32_t {
+            if (const auto found = strtable.Find(str)) return *found;
+            const auto pos = strings.size();
+            const auto len = static_cast<uint32_t>(std::strlen(str)) + 1;
+            strings.newsize(pos + len);
+            if (!strings.isok() || !strtable.Insert(str, pos)) { oom = true; return 0; }
+            std::memcpy(strings.data() + pos, str, len);
+            return pos;
+        };
+        // 模板索引, 从1开始
+        tmplnodes.push_back(pugi::xml_node());
+        for (auto node = templates.first_child(); node; node = node.next_sibling()) {
+            tmplnodes.push_back(node);
+        }
+        // 广度优先展开
+        xmlnodes.push_back(window);
+        parents.push_back(NULL_INDEX);
+        for (uint32_t i = 0; i < xmlnodes.size(); ++i) {
+            for (auto node = xmlnodes[i].first_child(); node; node = node.next_sibling()) {
+                if (node.type() != pugi::node_element) continue;
+                xmlnodes.push_back(node);
+                parents.push_back(i);
+            }
+            if (!xmlnodes.isok() || !parents.isok()) return E_OUTOFMEMORY;
+        }
+        // 生成结点
+        nodes.newsize(xmlnodes.size());
+        if (!nodes.isok() || !tmplnodes.isok()) return E_OUTOFMEMORY;
+        for (uint32_t i = 0; i < xmlnodes.size(); ++i) {
+            const auto xml = xmlnodes[i];
+            auto& node = nodes[i];
+            node.name = intern(xml.name());
+            node.parent = parents[i];
+            node.first_attribute = attributes.size();
+            node.class_id = NULL_CLASS;
+            // 添加属性
+            auto push_attribute = [&](pugi::xml_attribute attr) noexcept {
+                attributes.push_back(Attribute{ intern(attr.name()), intern(attr.value()) });
+                if (!attributes.isok()) oom = true;
+            };
+            // 窗口结点保持原样
+            if (!i) {
+                for (auto attr = xml.first_attribute(); attr; attr = attr.next_attribute()) {
+                    push_attribute(attr);
+                }
+            }
+            else {
+                // 控件类
+                if (const auto found = classtable.Find(xml.name())) {
+                    node.class_id = static_cast<uint16_t>(*found);
+                }
+                else {
+                    assert(classes.size() < NULL_CLASS && "too many control classes");
+                    node.class_id = static_cast<uint16_t>(classes.size());
+                    classes.push_back(intern(xml.name()));
+                    if (!classes.isok() || !classtable.Insert(xml.name(), node.class_id)) oom = true;
+                }
+                // 自身属性, 去除模板ID
+                for (auto attr = xml.first_attribute(); attr; attr = attr.next_attribute()) {
+                    if (std::strcmp(attr.name(), XmlAttribute::TemplateID)) push_attribute(attr);
+                }
+                // 合并模板属性
+                auto tid = static_cast<uint32_t>(LongUI::AtoI(xml.attribute(XmlAttribute::TemplateID).value()));
+                assert(tid < tmplnodes.size() && "out of range");
+                if (tid >= tmplnodes.size()) tid = 0;
+                if (tid) {
+                    for (auto attr = tmplnodes[tid].first_attribute(); attr; attr = attr.next_attribute()) {
+                        if (!xml.attribute(attr.name())) push_attribute(attr);
+                    }
+                }
+            }
+            assert(attributes.size() - node.first_attribute <= 0xffff && "too many attributes");
+            node.attribute_count = static_cast<uint16_t>(attributes.size() - node.first_attribute);
+            if (oom) return E_OUTOFMEMORY;
+        }
+        // 计算布局
+        Payload payload;
+        payload.node_count = nodes.size();
+        payload.attribute_count = attributes.size();
+        payload.class_count = classes.size();
+        payload.string_length = strings.size();
+        uint32_t offset = align4(sizeof(Payload));
+        payload.node_offset = offset; offset += sizeof(Node) * nodes.size();
+        payload.attribute_offset = offset; offset += sizeof(Attribute) * attributes.size();
+        payload.class_offset = offset; offset += sizeof(uint32_t) * classes.size();
+        payload.string_offset = offset; offset += strings.size();
+        const auto raw_length = align4(offset);
+        // 写入数据
+        auto write_payload = [&](uint8_t* data) noexcept {
+            std::memset(data, 0, raw_length);
+            std::memcpy(data, &payload, sizeof(payload));
+            std::memcpy(data + payload.node_offset, nodes.data(), sizeof(Node) * nodes.size());
+            std::memcpy(data + payload.attribute_offset, attributes.data(), sizeof(Attribute) * attributes.size());
+            std::memcpy(data + payload.class_offset, classes.data(), sizeof(uint32_t) * classes.size());
+            std::memcpy(data + payload.string_offset, strings.data(), strings.size());
+        };
+        Header header = { MAGIC, VERSION, flags & Flag_LZ4, raw_length, raw_length };
+        // 无压缩
+        if (!(flags & Flag_LZ4)) {
+            output.newsize(sizeof(Header) + raw_length);
+            if (!output.isok()) return E_OUTOFMEMORY;
+            std::memcpy(output.data(), &header, sizeof(header));
+            write_payload(output.data() + sizeof(Header));
+            return S_OK;
+        }
+#ifdef LONGUI_WITH_LZ4
+        // LZ4 压缩
+        EzContainer::EzVector<uint8_t> raw;
+        raw.newsize(raw_length);
+        const auto bound = static_cast<uint32_t>(LZ4_compressBound(int(raw_length)));
+        output.newsize(sizeof(Header) + bound);
+        if (!raw.isok() || !output.isok()) return E_OUTOFMEMORY;
+        write_payload(raw.data());
+        const auto code = LZ4_compress_default(
+            reinterpret_cast<const char*>(raw.data()),
+            reinterpret_cast<char*>(output.data() + sizeof(Header)),
+            int(raw_length), int(bound)
+        );
+        if (code <= 0) return E_FAIL;
+        header.payload_length = static_cast<uint32_t>(code);
+        std::memcpy(output.data(), &header, sizeof(header));
+        output.resize(sizeof(Header) + header.payload_length);
+#endif
+        return S_OK;
+    }
+    /// <summary>
+    /// Loads the specified layout data.
+    /// 载入布局数据
+    /// </summary>
+    /// <param name="data">The data.</param>
+    /// <param name="length">The length.</param>
+    /// <param name="buffer">The buffer for decompressing.</param>
+    /// <param name="payload">The payload.</param>
+    /// <returns></returns>
+    auto Load(const void* data, size_t length, EzContainer::EzVector<uint8_t>& buffer,
+        const Payload*& payload) noexcept ->HRESULT {
+        payload = nullptr;
+        // 检查头
+        const auto header = reinterpret_cast<const Header*>(data);
+        if (!data || length < sizeof(Header)) return E_INVALIDARG;
+        assert((reinterpret_cast<size_t>(data) & 3) == 0 && "data must be 4-byte aligned");
+        if (header->magic != MAGIC || header->version != VERSION) return E_INVALIDARG;
+        if (header->payload_length > length - sizeof(Header)) return E_INVALIDARG;
+        if (header->raw_length < sizeof(Payload)) return E_INVALIDARG;
+        const auto src = reinterpret_cast<const uint8_t*>(header + 1);
+        // 解压
+        if (header->flags & Flag_LZ4) {
+#ifdef LONGUI_WITH_LZ4
+            buffer.newsize(header->raw_length);
+            if (!buffer.isok()) return E_OUTOFMEMORY;
+            const auto code = LZ4_decompress_safe(
+                reinterpret_cast<const char*>(src),
+                reinterpret_cast<char*>(buffer.data()),
+                int(header->payload_length), int(header->raw_length)
+            );
+            if (code != int(header->raw_length)) return E_INVALIDARG;
+            payload = reinterpret_cast<const Payload*>(buffer.data());
+#else
+            return E_NOTIMPL;
+#endif
+        }
+        // 直接使用
+        else {
+            if (header->payload_length != header->raw_length) return E_INVALIDARG;
+            payload = reinterpret_cast<const Payload*>(src);
+        }
+        // 检查范围
+        const uint64_t raw = header->raw_length;
+        const auto pl = payload;
+        bool ok = pl->node_count
+            && pl->node_offset + uint64_t(sizeof(Node)) * pl->node_count <= raw
+            && pl->attribute_offset + uint64_t(sizeof(Attribute)) * pl->attribute_count <= raw
+            && pl->class_offset + uint64_t(sizeof(uint32_t)) * pl->class_count <= raw
+            && pl->string_offset + uint64_t(pl->string_length) <= raw
+            && pl->string_length && !GetString(pl, pl->string_length - 1)[0]
+            && pl->class_count < NULL_CLASS;
+        // 检查结点
+        const auto nodes = GetNodes(pl);
+        for (uint32_t i = 0; ok && i < pl->node_count; ++i) {
+            const auto& node = nodes[i];
+            ok = node.name < pl->string_length
+                && (i ? node.parent < i : node.parent == NULL_INDEX)
+                && (i ? node.class_id < pl->class_count : true)
+                && uint64_t(node.first_attribute) + node.attribute_count <= pl->attribute_count;
+        }
+        // 检查属性
+        const auto attributes = GetAttributes(pl);
+        for (uint32_t i = 0; ok && i < pl->attribute_count; ++i) {
+            ok = attributes[i].name < pl->string_length && attributes[i].value < pl->string_length;
+        }
+        // 检查类名
+        const auto classes = GetClasses(pl);
+        for (uint32_t i = 0; ok && i < pl->class_count; ++i) {
+            ok = classes[i] < pl->string_length;
+        }
+        if (!ok) payload = nullptr;
+        return ok ? S_OK : E_INVALIDARG;
+    }
+    /// <summary>
+    /// Builds the xml nodes of layout.
+    /// 建立xml结点: 名称与值复制到文档自身的页内存, 不逐个申请堆内存
+    /// </summary>
+    /// <param name="payload">The payload.</param>
+    /// <param name="root">The root node.</param>
+    /// <param name="nodes">The output nodes, count of node.</param>
+    /// <returns></returns>
+    auto BuildXml(const Payload* payload, pugi::xml_node root, pugi::xml_node* nodes) noexcept ->HRESULT {
+        assert(payload && root && nodes && "bad argument");
+        const auto list = GetNodes(payload);
+        const auto attributes = GetAttributes(payload);
+        // 广度优先顺序, 父结点总在之前
+        for (uint32_t i = 0; i < payload->node_count; ++i) {
+            const auto& node = list[i];
+            auto parent = i ? nodes[node.parent] : root;
+            auto& xml = nodes[i];
+            xml = parent.append_child(GetString(payload, node.name));
+            if (!xml) return E_OUTOFMEMORY;
+            const auto end = attributes + node.first_attribute + node.attribute_count;
+            for (auto attr = attributes + node.first_attribute; attr != end; ++attr) {
+                const auto value = GetString(payload, attr->value);
+                auto xattr = xml.append_attribute(GetString(payload, attr->name));
+                if (!xattr || (*value && !xattr.set_value(value))) return E_OUTOFMEMORY;
+            }
+        }
+        return S_OK;
+    }
+}}
@@ -0,0 +1,152 @@
+﻿#include <LongUI/luiUiProfiler.h>
+#ifdef LONGUI_WITH_PROFILER
+#include <Platonly/luiPoUtil.h>
+#include <Platonly/luiPoFile.h>
+#include <Platless/luiPlEzC.h>
+#include <cstring>
+#include <cstdio>
+#include <new>
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // ring buffer of profile events for one thread
+    struct profile_ring {
+        // next ring
+        profile_ring*           next;
+        // thread id
+        uint32_t                thread_id;
+        // count of events written, never wraps in practice
+        std::atomic<uint32_t>   head;
+        // events
+        ProfileEvent            events[LongUIProfilerRingSize];
+    };
+    // ring list
+    static std::atomic<profile_ring*> s_rings{ nullptr };
+    // ring of this thread
+    static thread_local profile_ring* s_ring = nullptr;
+    // get ring of this thread, create if not exist
+    static auto get_profile_ring() noexcept -> profile_ring* {
+        if (s_ring) return s_ring;
+        const auto ring = reinterpret_cast<profile_ring*>(LongUI::NormalAlloc(sizeof(profile_ring)));
+        if (!ring) return nullptr;
+        ring->thread_id = ::GetCurrentThreadId();
+        new(&ring->head) std::atomic<uint32_t>(0);
+        // 无锁插入链表, 不会释放
+        auto old = s_rings.load();
+        do { ring->next = old; } while (!s_rings.compare_exchange_weak(old, ring));
+        return s_ring = ring;
+    }
+    // json-escape into buffer
+    static void json_escape(EzContainer::EzVector<char>& out, const char* str) noexcept {
+        for (; *str; ++str) {
+            const auto ch = *str;
+            if (ch == '"' || ch == '\\') out.push_back('\\');
+            if (uint8_t(ch) < 0x20) continue;
+            out.push_back(ch);
+        }
+    }
+}}
+
+// enabled?
+std::atomic_bool LongUI::CUIProfiler::s_bEnabled{ false };
+
+/// <summary>
+/// Now in QPC tick.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIProfiler::Now() noexcept -> int64_t {
+    LARGE_INTEGER counter;
+    ::QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+/// <summary>
+/// Records the event into ring buffer of this thread.
+/// </summary>
+/// <param name="name">The name.</param>
+/// <param name="tag">The tag, could be null.</param>
+/// <param name="begin">The begin time.</param>
+/// <param name="end">The end time.</param>
+/// <returns></returns>
+void LongUI::CUIProfiler::Record(const char* name, const char* tag, int64_t begin, int64_t end) noexcept {
+    const auto ring = impl::get_profile_ring();
+    if (!ring) return;
+    const auto head = ring->head.load(std::memory_order_relaxed);
+    auto& event = ring->events[head % LongUIProfilerRingSize];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.tag[0] = 0;
+    if (tag) {
+        std::strncpy(event.tag, tag, LongUIProfilerTagLength - 1);
+        event.tag[LongUIProfilerTagLength - 1] = 0;
+    }
+    // 发布
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+/// <summary>
+/// Clears all events.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIProfiler::Clear() noexcept {
+    for (auto ring = impl::s_rings.load(); ring; ring = ring->next) {
+        ring->head.store(0, std::memory_order_release);
+    }
+}
+
+/// <summary>
+/// Exports events of all threads as chrome trace-event json.
+/// 导出为 chrome://tracing 可读的 JSON
+/// </summary>
+/// <param name="file_name">Name of the file.</param>
+/// <returns></returns>
+auto LongUI::CUIProfiler::ExportChromeTrace(const wchar_t* file_name) noexcept -> HRESULT {
+    assert(file_name && "bad argument");
+    LARGE_INTEGER freq; ::QueryPerformanceFrequency(&freq);
+    const double us = 1000000.0 / double(freq.QuadPart);
+    EzContainer::EzVector<char> json;
+    char buffer[256];
+    auto append = [&json](const char* str) noexcept {
+        while (*str) json.push_back(*str++);
+    };
+    append("{\"traceEvents\":[\n");
+    bool first = true;
+    const auto pid = ::GetCurrentProcessId();
+    for (auto ring = impl::s_rings.load(); ring; ring = ring->next) {
+        // 复制后再检查, 跳过复制期间被覆盖的事件
+        const auto head = ring->head.load(std::memory_order_acquire);
+        const auto begin = head > LongUIProfilerRingSize ? head - LongUIProfilerRingSize : 0;
+        for (auto i = begin; i < head; ++i) {
+            const auto event = ring->events[i % LongUIProfilerRingSize];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const auto now = ring->head.load(std::memory_order_relaxed);
+            if (i + LongUIProfilerRingSize <= now) continue;
+            if (!first) append(",\n");
+            first = false;
+            append("{\"name\":\"");
+            impl::json_escape(json, event.name);
+            std::snprintf(
+                buffer, sizeof(buffer),
+                "\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                unsigned(pid), unsigned(ring->thread_id),
+                double(event.begin) * us, double(event.end - event.begin) * us
+            );
+            append(buffer);
+            if (event.tag[0]) {
+                append(",\"args\":{\"control\":\"");
+                impl::json_escape(json, event.tag);
+                append("\"}");
+            }
+            append("}");
+        }
+    }
+    append("\n]}\n");
+    if (!json.isok()) return E_OUTOFMEMORY;
+    // 写入文件
+    CUIFile file(file_name, CUIFile::Flag_Write | CUIFile::Flag_CreateAlways);
+    if (!file.IsOk()) return E_FAIL;
+    const auto length = uint32_t(json.size());
+    return file.Write(json.data(), length) == length ? S_OK : E_FAIL;
+}
+#endif
@@ -1,13 +1,17 @@
 #include <LongUI/luiUiTmCap.h>
 #include <algorithm>
+#include <cstring>
+#include <new>
 
 /// <summary>
 /// Initializes a new instance of the <see cref="CUITimeCapsule"/> class.
 /// </summary>
 /// <param name="call">The call.</param>
+/// <param name="id">The identifier.</param>
 /// <param name="time">The time.</param>
-LongUI::CUITimeCapsule::CUITimeCapsule(TimeCallBack && call, size_t id, float time) 
-    : m_call(std::move(call)), m_id(id), m_fTimeTotal(time) {
+/// <param name="period">The period, 0 for normal capsule.</param>
+LongUI::CUITimeCapsule::CUITimeCapsule(TimeCallBack && call, size_t id, float time, float period) noexcept
+    : m_id(id), m_call(std::move(call)), m_fTimeTotal(time), m_fPeriod(period) {
 }
 
 
@@ -21,4 +25,435 @@ bool LongUI::CUITimeCapsule::Update(float delta_time) noexcept {
     float i = m_fTimeDone / m_fTimeTotal;
     i = std::min(1.f, i);
     return m_call(i) || (i == 1.f);
-}
\ No newline at end of file
+}
+
+
+// longui::impl namespace
+namespace LongUI { namespace impl {
+    // pool slot for time capsule
+    union time_capsule_slot {
+        // next free slot
+        time_capsule_slot*  next;
+        // capsule memory
+        alignas(CUITimeCapsule) char data[sizeof(CUITimeCapsule)];
+    };
+    // pool chunk for time capsule
+    struct time_capsule_chunk {
+        // next chunk
+        time_capsule_chunk* next;
+        // slots
+        time_capsule_slot   slots[LongUITimeCapsulePoolChunk];
+    };
+    // hash for capsule id
+    static inline auto time_capsule_hash(size_t id) noexcept {
+        id ^= id >> 15; id *= size_t(0x2c1b3c6d); id ^= id >> 12;
+        return uint32_t(id);
+    }
+}}
+
+
+/// <summary>
+/// Initializes a new instance of the <see cref="CUITimeWheel"/> class.
+/// </summary>
+LongUI::CUITimeWheel::CUITimeWheel() noexcept {
+    for (auto& level : m_aWheel) for (auto& slot : level) slot.InitList();
+    m_oActive.InitList();
+    m_oPending.InitList();
+}
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUITimeWheel"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUITimeWheel::~CUITimeWheel() noexcept {
+    this->Clear();
+    // release pool
+    auto chunk = reinterpret_cast<impl::time_capsule_chunk*>(m_pChunkList);
+    while (chunk) {
+        const auto next = chunk->next;
+        LongUI::NormalFree(chunk);
+        chunk = next;
+    }
+    m_pChunkList = m_pFreeList = nullptr;
+    // release hash table
+    if (m_ppHash) LongUI::NormalFree(m_ppHash);
+    m_ppHash = nullptr;
+    m_cHashCap = 0;
+}
+
+/// <summary>
+/// Links the capsule at the tail of the specified list.
+/// </summary>
+/// <param name="list">The list.</param>
+/// <param name="cap">The capsule.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::link(TimeCapsuleLink& list, CUITimeCapsule* cap) noexcept {
+    assert(cap && !cap->prev && "bad argument");
+    cap->prev = list.prev;
+    cap->next = &list;
+    list.prev->next = cap;
+    list.prev = cap;
+}
+
+/// <summary>
+/// Unlinks the capsule from its list.
+/// </summary>
+/// <param name="cap">The capsule.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::unlink(CUITimeCapsule* cap) noexcept {
+    assert(cap && cap->prev && "not in list");
+    cap->prev->next = cap->next;
+    cap->next->prev = cap->prev;
+    cap->prev = nullptr;
+    cap->next = nullptr;
+}
+
+/// <summary>
+/// Moves whole list to the tail of another list.
+/// </summary>
+/// <param name="list">The list.</param>
+/// <param name="from">The list moved from.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::splice(TimeCapsuleLink& list, TimeCapsuleLink& from) noexcept {
+    if (from.IsEmptyList()) return;
+    from.next->prev = list.prev;
+    list.prev->next = from.next;
+    from.prev->next = &list;
+    list.prev = from.prev;
+    from.InitList();
+}
+
+/// <summary>
+/// Move whole list to pending list.
+/// </summary>
+/// <param name="list">The list.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::take_pending(TimeCapsuleLink& list) noexcept {
+    assert(m_oPending.IsEmptyList() && "pending list must be empty");
+    this->splice(m_oPending, list);
+}
+
+/// <summary>
+/// Schedules the specified capsule into wheel with m_uExpire.
+/// </summary>
+/// <param name="cap">The capsule.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::schedule(CUITimeCapsule* cap) noexcept {
+    auto delta = cap->m_uExpire - m_uNow;
+    // expired already: fire in this tick
+    if (int32_t(delta) < 0) { delta = 0; cap->m_uExpire = m_uNow; }
+    // too long: clamp
+    if (delta > MAX_TICKS) { delta = MAX_TICKS; cap->m_uExpire = m_uNow + MAX_TICKS; }
+    // choose level
+    uint32_t level = 0;
+    while (delta >= (1u << (SLOT_BITS * (level + 1)))) ++level;
+    const auto slot = (cap->m_uExpire >> (SLOT_BITS * level)) & SLOT_MASK;
+    this->link(m_aWheel[level][slot], cap);
+}
+
+/// <summary>
+/// Advance one tick: cascade upper levels, then run expired capsules.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITimeWheel::tick() noexcept {
+    const auto index = ++m_uNow & SLOT_MASK;
+    // cascade
+    if (!index) {
+        for (uint32_t level = 1; level < LEVEL_COUNT; ++level) {
+            const auto slot = (m_uNow >> (SLOT_BITS * level)) & SLOT_MASK;
+            // 保持先后顺序重新调度
+            TimeCapsuleLink list; list.InitList();
+            this->splice(list, m_aWheel[level][slot]);
+            while (!list.IsEmptyList()) {
+                const auto cap = this->capsule(list.next);
+                this->unlink(cap);
+                this->schedule(cap);
+            }
+            if (slot) break;
+        }
+    }
+    // expired
+    if (!m_aWheel[0][index].IsEmptyList()) {
+        this->take_pending(m_aWheel[0][index]);
+        this->run_pending(0.f, true);
+    }
+}
+
+/// <summary>
+/// Advances the specified ticks.
+/// 长时间停顿: 不逐个tick推进, 直接收集全部胶囊, 跳到目标时间后重新调度
+/// </summary>
+/// <param name="ticks">The ticks.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::advance(uint32_t ticks) noexcept {
+    // within one level-0 span: tick by tick
+    if (ticks <= SLOT_COUNT) {
+        for (uint32_t i = 0; i < ticks; ++i) this->tick();
+        return;
+    }
+    // gather in time order: lower level first, slots after current one first
+    TimeCapsuleLink list; list.InitList();
+    for (uint32_t level = 0; level < LEVEL_COUNT; ++level) {
+        const auto now = (m_uNow >> (SLOT_BITS * level)) + 1;
+        for (uint32_t i = 0; i < SLOT_COUNT; ++i) {
+            this->splice(list, m_aWheel[level][(now + i) & SLOT_MASK]);
+        }
+    }
+    // jump to the tick before target, overdue capsules fire in last tick
+    m_uNow += ticks - 1;
+    while (!list.IsEmptyList()) {
+        const auto cap = this->capsule(list.next);
+        this->unlink(cap);
+        if (int32_t(cap->m_uExpire - m_uNow) <= 0) cap->m_uExpire = m_uNow + 1;
+        this->schedule(cap);
+    }
+    this->tick();
+}
+
+/// <summary>
+/// Run capsules in pending list.
+/// </summary>
+/// <param name="delta_time">The delta time.</param>
+/// <param name="expired">if set to <c>true</c>, pending capsules are expired from wheel.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::run_pending(float delta_time, bool expired) noexcept {
+    while (!m_oPending.IsEmptyList()) {
+        const auto cap = this->capsule(m_oPending.next);
+        this->unlink(cap);
+        // deferred normal capsule: start running
+        if (expired && !cap->IsPeriodic()) {
+            this->link(m_oActive, cap);
+            continue;
+        }
+        // run it, the callback could add/remove capsules
+        m_pRunning = cap;
+        m_bRunningRemoved = false;
+        bool done;
+        if (expired) {
+            const auto elapsed = float(m_uNow - cap->m_uStart) / float(LongUITimeWheelTickRate);
+            done = cap->Fire(elapsed);
+        }
+        else {
+            done = cap->Update(delta_time);
+        }
+        m_pRunning = nullptr;
+        // removed in callback
+        if (m_bRunningRemoved) {
+            this->free_capsule(cap);
+        }
+        // finished
+        else if (done) {
+            const auto slot = this->hash_find(cap->GetId());
+            assert(slot && *slot == cap && "bad hash table");
+            this->hash_erase(slot);
+            this->free_capsule(cap);
+        }
+        // next period
+        else if (expired) {
+            cap->m_uStart = m_uNow;
+            cap->m_uExpire = m_uNow + std::max(this->to_ticks(cap->m_fPeriod), uint32_t(1));
+            this->schedule(cap);
+        }
+        // next frame
+        else {
+            this->link(m_oActive, cap);
+        }
+    }
+}
+
+/// <summary>
+/// Updates capsules with the specified delta time.
+/// </summary>
+/// <param name="delta_time">The delta time.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::Update(float delta_time) noexcept {
+    // advance wheel
+    m_fTickRemain += delta_time * float(LongUITimeWheelTickRate);
+    const auto ticks = uint32_t(m_fTickRemain);
+    m_fTickRemain -= float(ticks);
+    this->advance(ticks);
+    // running capsules
+    this->take_pending(m_oActive);
+    this->run_pending(delta_time, false);
+}
+
+/// <summary>
+/// Adds a capsule.
+/// </summary>
+/// <param name="call">The call.</param>
+/// <param name="id">The identifier.</param>
+/// <param name="time">The time for normal capsule.</param>
+/// <param name="delay">The delay before start.</param>
+/// <param name="period">The period, periodic capsule if greater than 0.</param>
+/// <returns>false if out of memory</returns>
+bool LongUI::CUITimeWheel::Add(TimeCallBack&& call, size_t id, float time, float delay, float period) noexcept {
+    assert(!this->hash_find(id) && "remove old capsule first");
+    const auto memory = this->alloc_capsule();
+    if (!memory) return false;
+    const auto cap = ::new(memory) CUITimeCapsule(std::move(call), id, time, period);
+    ++m_cCount;
+    if (!this->hash_insert(cap)) {
+        this->free_capsule(cap);
+        return false;
+    }
+    const auto delay_ticks = this->to_ticks(delay);
+    cap->m_uStart = m_uNow;
+    // periodic: first fire after delay or one period
+    if (cap->IsPeriodic()) {
+        const auto first = delay_ticks ? delay_ticks : this->to_ticks(period);
+        cap->m_uExpire = m_uNow + std::max(first, uint32_t(1));
+        this->schedule(cap);
+    }
+    // deferred start
+    else if (delay_ticks) {
+        cap->m_uExpire = m_uNow + delay_ticks;
+        this->schedule(cap);
+    }
+    // start now
+    else {
+        this->link(m_oActive, cap);
+    }
+    return true;
+}
+
+/// <summary>
+/// Removes the capsule with specified identifier.
+/// </summary>
+/// <param name="id">The identifier.</param>
+/// <returns>true if found</returns>
+bool LongUI::CUITimeWheel::Remove(size_t id) noexcept {
+    const auto slot = this->hash_find(id);
+    if (!slot) return false;
+    const auto cap = *slot;
+    this->hash_erase(slot);
+    // running: release after callback returned
+    if (cap == m_pRunning) {
+        m_bRunningRemoved = true;
+    }
+    else {
+        this->unlink(cap);
+        this->free_capsule(cap);
+    }
+    return true;
+}
+
+/// <summary>
+/// Clears all capsules.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUITimeWheel::Clear() noexcept {
+    assert(!m_pRunning && "cannot clear in callback");
+    auto clear_list = [this](TimeCapsuleLink& list) noexcept {
+        while (!list.IsEmptyList()) {
+            const auto cap = this->capsule(list.next);
+            this->unlink(cap);
+            this->free_capsule(cap);
+        }
+    };
+    for (auto& level : m_aWheel) for (auto& slot : level) clear_list(slot);
+    clear_list(m_oActive);
+    clear_list(m_oPending);
+    if (m_ppHash) std::memset(m_ppHash, 0, sizeof(m_ppHash[0]) * m_cHashCap);
+    assert(m_cCount == 0 && "capsule leaked");
+}
+
+/// <summary>
+/// Allocs capsule memory from pool.
+/// </summary>
+/// <returns>null if out of memory</returns>
+auto LongUI::CUITimeWheel::alloc_capsule() noexcept -> void* {
+    using slot_t = impl::time_capsule_slot;
+    // new chunk
+    if (!m_pFreeList) {
+        const auto chunk = reinterpret_cast<impl::time_capsule_chunk*>(
+            LongUI::NormalAlloc(sizeof(impl::time_capsule_chunk))
+            );
+        if (!chunk) return nullptr;
+        chunk->next = reinterpret_cast<impl::time_capsule_chunk*>(m_pChunkList);
+        m_pChunkList = chunk;
+        for (uint32_t i = 0; i < LongUITimeCapsulePoolChunk; ++i) {
+            chunk->slots[i].next = i + 1 < LongUITimeCapsulePoolChunk ? chunk->slots + i + 1 : nullptr;
+        }
+        m_pFreeList = chunk->slots;
+    }
+    const auto slot = reinterpret_cast<slot_t*>(m_pFreeList);
+    m_pFreeList = slot->next;
+    return slot;
+}
+
+/// <summary>
+/// Releases capsule to pool.
+/// </summary>
+/// <param name="cap">The capsule.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::free_capsule(CUITimeCapsule* cap) noexcept {
+    assert(cap && m_cCount && "bad argument");
+    cap->~CUITimeCapsule();
+    const auto slot = reinterpret_cast<impl::time_capsule_slot*>(cap);
+    slot->next = reinterpret_cast<impl::time_capsule_slot*>(m_pFreeList);
+    m_pFreeList = slot;
+    --m_cCount;
+}
+
+/// <summary>
+/// Finds the slot of capsule with specified identifier in hash table.
+/// </summary>
+/// <param name="id">The identifier.</param>
+/// <returns>null if not found</returns>
+auto LongUI::CUITimeWheel::hash_find(size_t id) const noexcept -> CUITimeCapsule** {
+    if (!m_cHashCap) return nullptr;
+    const auto mask = m_cHashCap - 1;
+    for (auto i = impl::time_capsule_hash(id) & mask; m_ppHash[i]; i = (i + 1) & mask) {
+        if (m_ppHash[i]->GetId() == id) return m_ppHash + i;
+    }
+    return nullptr;
+}
+
+/// <summary>
+/// Inserts the capsule into hash table, grow if load factor over 1/2.
+/// </summary>
+/// <param name="cap">The capsule.</param>
+/// <returns>false if out of memory</returns>
+bool LongUI::CUITimeWheel::hash_insert(CUITimeCapsule* cap) noexcept {
+    // m_cCount includes this capsule
+    if (m_cCount * 2 > m_cHashCap) {
+        const auto cap_new = std::max(m_cHashCap * 2, uint32_t(32));
+        const auto table = LongUI::NormalAllocT<CUITimeCapsule*>(cap_new);
+        if (!table) return false;
+        std::memset(table, 0, sizeof(table[0]) * cap_new);
+        const auto old = m_ppHash;
+        const auto old_cap = m_cHashCap;
+        m_ppHash = table;
+        m_cHashCap = cap_new;
+        for (uint32_t i = 0; i < old_cap; ++i) {
+            if (old[i]) this->hash_insert(old[i]);
+        }
+        if (old) LongUI::NormalFree(old);
+    }
+    const auto mask = m_cHashCap - 1;
+    auto i = impl::time_capsule_hash(cap->GetId()) & mask;
+    while (m_ppHash[i]) i = (i + 1) & mask;
+    m_ppHash[i] = cap;
+    return true;
+}
+
+/// <summary>
+/// Erases the slot from hash table, with backward shift.
+/// </summary>
+/// <param name="slot">The slot.</param>
+/// <returns></returns>
+void LongUI::CUITimeWheel::hash_erase(CUITimeCapsule** slot) noexcept {
+    const auto mask = m_cHashCap - 1;
+    auto i = uint32_t(slot - m_ppHash);
+    auto j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (!m_ppHash[j]) break;
+        const auto k = impl::time_capsule_hash(m_ppHash[j]->GetId()) & mask;
+        // k cyclically in (i, j]: keep it
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+        m_ppHash[i] = m_ppHash[j];
+        i = j;
+    }
+    m_ppHash[i] = nullptr;
+}
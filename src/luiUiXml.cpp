@@ -1,44 +1,123 @@
 ﻿// xml helper
 #include <LongUI/luiUiXml.h>
 #include <Platless/luiPlUtil.h>
+#include <Platless/luiPlEnum.h>
 
 
 // longui::helper name space
 namespace LongUI { namespace Helper {
+    // FNV-1a
+    static inline auto hash_name(const char* str) noexcept {
+        uint32_t code = 2166136261ui32;
+        for (; *str; ++str) code = (code ^ uint8_t(*str)) * 16777619ui32;
+        return code ^ (code >> 16);
+    }
     // 获取XML值
     auto XMLGetValue(pugi::xml_node node, const char* att, const char* pfx) noexcept -> const char* {
         if (!node) return nullptr;
         assert(att && "bad argument");
-        char buffer[LongUIStringBufferLength];
-#ifdef _DEBUG
-        auto lena = std::strlen(att);
-        auto lenb = pfx ? std::strlen(pfx) : 0;
-        auto lenc = lengthof(buffer);
-        assert(lenc > lena + lenb && "buffer too small");
-#endif
-        // 前缀有效?
-        if (pfx) {
-            std::strcpy(buffer, pfx);
-            std::strcat(buffer, att);
-            att = buffer;
+        if (!pfx) return node.attribute(att).value();
+        // 直接比较前缀与名称, 无需拼接
+        const auto len = std::strlen(pfx);
+        for (auto attr = node.first_attribute(); attr; attr = attr.next_attribute()) {
+            const auto name = attr.name();
+            if (name && !std::strncmp(name, pfx, len) && !std::strcmp(name + len, att)) return attr.value();
+        }
+        return nullptr;
+    }
+    /// <summary>
+    /// Initializes a new instance of the <see cref="AttributeView"/> class.
+    /// </summary>
+    /// <param name="node">The node, could be null.</param>
+    /// <param name="prefix">The prefix.</param>
+    AttributeView::AttributeView(pugi::xml_node node, const char* prefix) noexcept : m_node(node) {
+        m_pPrefix = prefix ? prefix : "";
+        m_cPrefix = static_cast<uint32_t>(std::strlen(m_pPrefix));
+        std::memset(m_aSlots, 0xff, sizeof(m_aSlots));
+        this->scan([this](const char* name, const char* value) noexcept { this->add(name, value); return false; });
+    }
+    /// <summary>
+    /// Initializes a new instance of the <see cref="AttributeView"/> class.
+    /// </summary>
+    /// <param name="payload">The payload of compiled layout.</param>
+    /// <param name="index">The index of node.</param>
+    /// <param name="prefix">The prefix.</param>
+    AttributeView::AttributeView(const Layout::Payload* payload, uint32_t index, const char* prefix) noexcept
+        : m_pPayload(payload), m_uIndex(index) {
+        assert(payload && index < payload->node_count && "bad argument");
+        m_pPrefix = prefix ? prefix : "";
+        m_cPrefix = static_cast<uint32_t>(std::strlen(m_pPrefix));
+        std::memset(m_aSlots, 0xff, sizeof(m_aSlots));
+        this->scan([this](const char* name, const char* value) noexcept { this->add(name, value); return false; });
+    }
+    /// <summary>
+    /// Initializes a new instance of the <see cref="PredefinedAttributes"/> class.
+    /// </summary>
+    /// <param name="node">The node, could be null.</param>
+    PredefinedAttributes::PredefinedAttributes(pugi::xml_node node) noexcept {
+        for (auto attr = node.first_attribute(); attr; attr = attr.next_attribute()) {
+            // 预定义原子id即为下标
+            const auto id = CUIAtom::Find(attr.name()).GetID();
+            // 同名取首个, 与 xml_node::attribute 一致
+            if (id && id < XmlAttribute::ATOM_PREDEFINED_COUNT && !m_aAttributes[id]) {
+                m_aAttributes[id] = attr;
+            }
+        }
+    }
+    /// <summary>
+    /// Adds the attribute, the first one wins for same name.
+    /// </summary>
+    /// <param name="name">The name without prefix.</param>
+    /// <param name="value">The value.</param>
+    /// <returns></returns>
+    void AttributeView::add(const char* name, const char* value) noexcept {
+        // 超出部分查找时遍历
+        if (m_cCount >= MAX_COUNT) { ++m_cCount; return; }
+        const auto code = hash_name(name);
+        auto index = code & (CAPACITY - 1);
+        for (; m_aSlots[index] != 0xff; index = (index + 1) & (CAPACITY - 1)) {
+            const auto& item = m_aItems[m_aSlots[index]];
+            if (item.hash == code && !std::strcmp(item.name, name)) return;
         }
-        return node.attribute(att).value();
+        m_aSlots[index] = static_cast<uint8_t>(m_cCount);
+        m_aItems[m_cCount++] = Item{ name, value, code };
+    }
+    /// <summary>
+    /// Gets the value with name without prefix.
+    /// </summary>
+    /// <param name="name">The name.</param>
+    /// <returns>null if not found</returns>
+    auto AttributeView::Get(const char* name) const noexcept -> const char* {
+        assert(name && "bad argument");
+        const auto code = hash_name(name);
+        for (auto index = code & (CAPACITY - 1); m_aSlots[index] != 0xff; index = (index + 1) & (CAPACITY - 1)) {
+            const auto& item = m_aItems[m_aSlots[index]];
+            if (item.hash == code && !std::strcmp(item.name, name)) return item.value;
+        }
+        const char* value = nullptr;
+        // 超出索引
+        if (m_cCount > MAX_COUNT) {
+            this->scan([name, &value](const char* n, const char* v) noexcept {
+                return std::strcmp(n, name) ? false : (value = v, true);
+            });
+        }
+        return value;
+    }
+    // 首个为数字?
+    static bool first_digital(const char* str) noexcept {
+        // 遍历
+        while (*str) {
+            // 空白: 跳过
+            if (white_space(*str))  ++str;
+            // 数字: true
+            else if (valid_digit(*str))  return true;
+            // 其他: false
+            else  break;
+        }
+        return false;
     }
     // 解析字符串数据作为枚举值
     auto GetEnumFromString(const char* value, const GetEnumProperties& prop) noexcept ->uint32_t {
-        // 首个为数字?
-        auto first_digital = [](const char* str) noexcept {
-            // 遍历
-            while (*str) {
-                // 空白: 跳过
-                if (white_space(*str))  ++str;
-                // 数字: true
-                else if (valid_digit(*str))  return true;
-                // 其他: false
-                else  break;
-            }
-            return false;
-        };
         // 有效
         if (value && *value) {
             // 数字?
@@ -56,153 +135,64 @@ namespace LongUI { namespace Helper {
         // 匹配无效
         return prop.bad_match;
     }
-    // 帮助器 GetEnumFromString
-    template<typename T, typename Ary> 
-    LongUIInline auto GetEnumFromStringHelper(const char* value, T bad_match, const Ary& ary) noexcept {
-        // 设置
-        Helper::GetEnumProperties prop;
-        prop.values_list = ary;
-        prop.values_length = lengthof<uint32_t>(ary);
-        prop.bad_match = static_cast<uint32_t>(bad_match);
-        // 调用
-        return static_cast<T>(GetEnumFromString(value, prop));
-    }
-    // 动画类型属性值列表
-    const char* const cg_listAnimationType[] = {
-        "linear",
-        "quadraticin",    "quadraticout",   "quadraticinout",
-        "cubicin",        "cubicout",       "cubicoinout",
-        "quarticin",      "quarticout",     "quarticinout",
-        "quinticcin",     "quinticcout",    "quinticinout",
-        "sincin",         "sincout",        "sininout",
-        "circularcin",    "circularcout",   "circularinout",
-        "exponentiacin",  "exponentiaout",  "exponentiainout",
-        "elasticin",      "elasticout",     "elasticinout",
-        "backin",         "backout",        "backinout",
-        "bouncein",       "bounceout",      "bounceinout",
-    };
-    // 位图渲染模式 属性值列表
-    const char* const cg_listBitmapRenderRule[] = {
-        "scale", "button",
-    };
-    // 渲染模式 属性值列表
-    const char* const cg_listRenderRule[] = {
-        "scale", "button",
-    };
-    // 渲染模式 属性值列表
-    const char* const cg_listBrushType[] = {
-        "solid", "linear", "radial", "bitmap"
-    };
-    // 富文本类型 属性值列表
-    const char* const cg_listRichType[] = {
-        "none", "core", "xml", "custom",
-    };
-    // D2D 插值模式 属性值列表
-    const char* const cg_listInterpolationMode[] = {
-        "neighbor", "linear",       "cubic",
-        "mslinear", "anisotropic",  "highcubic",
-    };
-    // D2D 扩展模式 属性值列表
-    const char* const cg_listExtendMode[] = {
-        "clamp", "wrap", "mirror",
-    };
-    // D2D 文本抗锯齿模式 属性值列表
-    const char* const cg_listTextAntialiasMode[] = {
-        "default",  "cleartype",  "grayscale", "aliased",
-    };
-    // DWrite 字体风格 属性值列表
-    const char* const cg_listFontStyle[] = {
-        "normal", "oblique", "italic",
-    };
-    // DWrite 字体拉伸 属性值列表
-    const char* const cg_listFontStretch[] = {
-        "undefined",
-        "ultracondensed",  "extracondensed",  "condensed",
-        "semicondensed",   "normal",          "semiexpanded",
-        "expanded",        "extraexpanded",   "ultraexpanded",
-    };
-    // DWrite 排列方向 属性值列表
-    const char* const cg_listFlowDirection[] = {
-        "top2bottom",  "bottom2top",  "left2right",  "right2left",
-    };
-    // DWrite 阅读方向 属性值列表
-    const char* const cg_listReadingDirection[] = {
-        "left2right",  "right2left",  "top2bottom",  "bottom2top",
-    };
-    // DWrite 换行方式 属性值列表
-    const char* const cg_listWordWrapping[] = {
-        "wrap", "nowrap",  "break",  "word",  "character",
-    };
-    // DWrite 段落对齐 属性值列表
-    const char* const cg_listParagraphAlignment[] = {
-        "top",  "bottom",  "middle",
-    };
-    // DWrite 文本对齐 属性值列表
-    const char* const cg_listTextAlignment[] = {
-        "left",  "right",  "center",  "justify",
-    };
-    // 复选框状态
-    const char* const cg_listCheckBoxState[] = {
-        "checked", "indeterminate", "unchecked"
-    };
     // 获取动画类型
     LongUINoinline auto GetEnumFromString(const char* value, AnimationType bad_match) noexcept ->AnimationType {
-        return GetEnumFromStringHelper(value, bad_match, cg_listAnimationType);
+        return static_cast<AnimationType>(LongUI::LookupEnum(value, EnumTable::Table_AnimationType, uint32_t(bad_match)));
     }
     // 获取笔刷类型
     LongUINoinline auto GetEnumFromString(const char* value, BrushType bad_match) noexcept ->BrushType {
-        return GetEnumFromStringHelper(value, bad_match, cg_listBrushType);
+        return static_cast<BrushType>(LongUI::LookupEnum(value, EnumTable::Table_BrushType, uint32_t(bad_match)));
     }
     // 获取插值模式
     LongUINoinline auto GetEnumFromString(const char* value, D2D1_INTERPOLATION_MODE bad_match) noexcept ->D2D1_INTERPOLATION_MODE {
-        return GetEnumFromStringHelper(value, bad_match, cg_listInterpolationMode);
+        return static_cast<D2D1_INTERPOLATION_MODE>(LongUI::LookupEnum(value, EnumTable::Table_InterpolationMode, uint32_t(bad_match)));
     }
     // 获取扩展模式
     LongUINoinline auto GetEnumFromString(const char* value, D2D1_EXTEND_MODE bad_match) noexcept ->D2D1_EXTEND_MODE {
-        return GetEnumFromStringHelper(value, bad_match, cg_listExtendMode);
+        return static_cast<D2D1_EXTEND_MODE>(LongUI::LookupEnum(value, EnumTable::Table_ExtendMode, uint32_t(bad_match)));
     }
     // 获取位图渲染规则
     LongUINoinline auto GetEnumFromString(const char* value, BitmapRenderRule bad_match) noexcept ->BitmapRenderRule {
-        return GetEnumFromStringHelper(value, bad_match, cg_listBitmapRenderRule);
+        return static_cast<BitmapRenderRule>(LongUI::LookupEnum(value, EnumTable::Table_BitmapRenderRule, uint32_t(bad_match)));
     }
     // 获取富文本类型
     LongUINoinline auto GetEnumFromString(const char* value, RichType bad_match) noexcept ->RichType {
-        return GetEnumFromStringHelper(value, bad_match, cg_listRichType);
+        return static_cast<RichType>(LongUI::LookupEnum(value, EnumTable::Table_RichType, uint32_t(bad_match)));
     }
     // 获取字体风格
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_FONT_STYLE bad_match) noexcept ->DWRITE_FONT_STYLE {
-        return GetEnumFromStringHelper(value, bad_match, cg_listFontStyle);
+        return static_cast<DWRITE_FONT_STYLE>(LongUI::LookupEnum(value, EnumTable::Table_FontStyle, uint32_t(bad_match)));
     }
     // 获取字体拉伸
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_FONT_STRETCH bad_match) noexcept ->DWRITE_FONT_STRETCH {
-        return GetEnumFromStringHelper(value, bad_match, cg_listFontStretch);
+        return static_cast<DWRITE_FONT_STRETCH>(LongUI::LookupEnum(value, EnumTable::Table_FontStretch, uint32_t(bad_match)));
     }
     // 获取排列方向
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_FLOW_DIRECTION bad_match) noexcept ->DWRITE_FLOW_DIRECTION {
-        return GetEnumFromStringHelper(value, bad_match, cg_listFlowDirection);
+        return static_cast<DWRITE_FLOW_DIRECTION>(LongUI::LookupEnum(value, EnumTable::Table_FlowDirection, uint32_t(bad_match)));
     }
     // 获取阅读方向
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_READING_DIRECTION bad_match) noexcept ->DWRITE_READING_DIRECTION {
-        return GetEnumFromStringHelper(value, bad_match, cg_listReadingDirection);
+        return static_cast<DWRITE_READING_DIRECTION>(LongUI::LookupEnum(value, EnumTable::Table_ReadingDirection, uint32_t(bad_match)));
     }
     // 获取换行方式
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_WORD_WRAPPING bad_match) noexcept ->DWRITE_WORD_WRAPPING {
-        return GetEnumFromStringHelper(value, bad_match, cg_listWordWrapping);
+        return static_cast<DWRITE_WORD_WRAPPING>(LongUI::LookupEnum(value, EnumTable::Table_WordWrapping, uint32_t(bad_match)));
     }
     // 获取段落对齐方式
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_PARAGRAPH_ALIGNMENT bad_match) noexcept ->DWRITE_PARAGRAPH_ALIGNMENT {
-        return GetEnumFromStringHelper(value, bad_match, cg_listParagraphAlignment);
+        return static_cast<DWRITE_PARAGRAPH_ALIGNMENT>(LongUI::LookupEnum(value, EnumTable::Table_ParagraphAlignment, uint32_t(bad_match)));
     }
     // 获取文本对齐方式
     LongUINoinline auto GetEnumFromString(const char* value, DWRITE_TEXT_ALIGNMENT bad_match) noexcept ->DWRITE_TEXT_ALIGNMENT {
-        return GetEnumFromStringHelper(value, bad_match, cg_listTextAlignment);
+        return static_cast<DWRITE_TEXT_ALIGNMENT>(LongUI::LookupEnum(value, EnumTable::Table_TextAlignment, uint32_t(bad_match)));
     }
     // 获取文本抗锯齿模式
     LongUINoinline auto GetEnumFromString(const char* value, D2D1_TEXT_ANTIALIAS_MODE bad_match) noexcept ->D2D1_TEXT_ANTIALIAS_MODE {
-        return GetEnumFromStringHelper(value, bad_match, cg_listTextAntialiasMode);
+        return static_cast<D2D1_TEXT_ANTIALIAS_MODE>(LongUI::LookupEnum(value, EnumTable::Table_TextAntialiasMode, uint32_t(bad_match)));
     }
     // 获取复选框状态
     LongUINoinline auto GetEnumFromString(const char* value, CheckBoxState bad_match) noexcept ->CheckBoxState {
-        return GetEnumFromStringHelper(value, bad_match, cg_listCheckBoxState);
+        return static_cast<CheckBoxState>(LongUI::LookupEnum(value, EnumTable::Table_CheckBoxState, uint32_t(bad_match)));
     }
 }}
\ No newline at end of file
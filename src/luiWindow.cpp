@@ -8,6 +8,7 @@
 #include "Control/UIViewport.h"
 #include <dcomp.h>
 #include <algorithm>
+#include <cfloat>
 
 // longui::impl
 namespace LongUI { namespace impl {
@@ -194,6 +195,8 @@ LongUI::XUIBaseWindow::~XUIBaseWindow() noexcept {
     LongUI::SafeRelease(m_pFocusedControl);
     LongUI::SafeRelease(m_pHoverTracked);
     LongUI::SafeRelease(m_pViewport);
+    // 控件全部释放后整体归还
+    if (m_pControlPool) m_pControlPool->Release();
 #ifdef _DEBUG
     auto wptr = reinterpret_cast<std::uintptr_t>(this);
     if (g_dbg_last_proc_window_pointer == wptr) {
@@ -278,7 +281,7 @@ auto LongUI::XUIBaseWindow::CreatePopup(const D2D1_RECT_L& pos, uint32_t height,
         child->LinkNewParent(viewport);
         viewport->Push(child);
 #ifdef _DEBUG
-        force_cast(viewport->name) = window->CopyString("PopupWindow");
+        force_cast(viewport->name) = CUIAtom::Intern("PopupWindow").c_str();
 #endif
     }
     // 重建资源
@@ -300,17 +303,24 @@ auto LongUI::XUIBaseWindow::CreatePopup(const D2D1_RECT_L& pos, uint32_t height,
 /// <returns></returns>
 auto LongUI::XUIBaseWindow::FindControl(const char* cname) noexcept -> UIControl * {
     assert(cname && (*cname) && "bad argument");
-    // 查找控件
-    auto result = m_hashStr2Ctrl.Find(cname);
+    // 未驻留的名称不可能是控件名
+    const auto result = this->FindControl(CUIAtom::Find(cname));
     // 未找到返回空
     if (!result) {
         // 给予警告
         UIManager << DL_Warning << L" Control Not Found: " << cname << LongUI::endl;
-        return nullptr;
-    }
-    else {
-        return reinterpret_cast<LongUI::UIControl*>(*result);
     }
+    return result;
+}
+
+/// <summary>
+/// Finds the control with interned name.
+/// </summary>
+/// <param name="name">The name atom.</param>
+/// <returns></returns>
+auto LongUI::XUIBaseWindow::FindControl(CUIAtom name) const noexcept -> UIControl * {
+    const auto result = m_hashAtom2Ctrl.Find(name);
+    return result ? *result : nullptr;
 }
 
 /// <summary>
@@ -394,14 +404,16 @@ void LongUI::XUIBaseWindow::AddNamedControl(UIControl* ctrl) noexcept {
     const auto cname = ctrl->name.c_str();
     // 有效
     if (cname[0]) {
+        // 控件名均已驻留, 此处仅为查找
+        const auto atom = CUIAtom::Intern(cname);
         // 插入
 #ifdef _DEBUG
         {
-            auto result = m_hashStr2Ctrl.Find(cname);
+            auto result = m_hashAtom2Ctrl.Find(atom);
             assert(result == nullptr && "control exsited!");
         }
 #endif
-        if (!m_hashStr2Ctrl.Insert(cname, ctrl)) {
+        if (!atom || !m_hashAtom2Ctrl.Insert(atom, ctrl)) {
             ShowErrorWithStr(L"Failed to add control");
         }
     }
@@ -510,6 +522,7 @@ void LongUI::XUIBaseWindow::Update() noexcept {
     //this->clear_do_caret();
     // 实现
     {
+        m_pViewport->NeedUpdateHandled();
         m_pViewport->Update();
         m_pViewport->AfterUpdate();
     }
@@ -517,9 +530,9 @@ void LongUI::XUIBaseWindow::Update() noexcept {
     for (auto inset : m_vInsets) {
         inset->Update();
     }
-    // 复制渲染数据以保证数据安全
-    m_uUnitLengthRender = m_uUnitLength;
-    std::memcpy(m_apUnitRender, m_apUnit, sizeof(m_apUnit[0]) * m_uUnitLengthRender);
+    // 复制渲染数据以保证数据安全: 渲染时只读取本快照, 不再访问窗口数据
+    this->make_render_units();
+    m_mxViewportRender = m_pViewport->world;
     m_baBoolWindow.SetTo<Index_FullRenderThisFrameRender>(this->is_full_render_this_frame());
     // 清理老数据
     this->clear_full_render_this_frame(); 
@@ -622,15 +635,15 @@ void LongUI::XUIBaseWindow::Invalidate(UIControl* ctrl) noexcept {
     ctrl = ctrl->prerender;
     assert(ctrl->prerender == ctrl && "bad argument");
     // 就是窗口 或者已满?
-    if (ctrl == m_pViewport || m_uUnitLength >= LongUIDirtyControlSize) {
-        assert(m_uUnitLength <= LongUIDirtyControlSize && "check it");
+    if (ctrl == m_pViewport || m_uUnitLength >= LongUIDirtyControlMaxSize) {
+        assert(m_uUnitLength <= LongUIDirtyControlMaxSize && "check it");
         this->set_full_render_this_frame();
         return;
     }
 #ifdef _DEBUG
     // 调试信息
     size_t  debug_backup_leng = m_uUnitLength;
-    UIControl*  debug_backup_unit[LongUIDirtyControlSize];
+    UIControl*  debug_backup_unit[LongUIDirtyControlMaxSize];
     std::memcpy(debug_backup_unit, m_apUnit, sizeof(debug_backup_unit));
 #endif
     // 一次检查
@@ -721,6 +734,145 @@ void LongUI::XUIBaseWindow::resized() noexcept {
     this->clear_new_size();
 }
 
+// longui::impl
+namespace LongUI { namespace impl {
+    // area of rect
+    inline auto rect_area(const D2D1_RECT_F& rc) noexcept {
+        return std::max(rc.right - rc.left, 0.f) * std::max(rc.bottom - rc.top, 0.f);
+    }
+    // union of rects
+    inline auto rect_union(const D2D1_RECT_F& a, const D2D1_RECT_F& b) noexcept {
+        return D2D1_RECT_F{
+            std::min(a.left, b.left), std::min(a.top, b.top),
+            std::max(a.right, b.right), std::max(a.bottom, b.bottom)
+        };
+    }
+    // cost for merging rects: extra area to render
+    inline auto merge_cost(const D2D1_RECT_F& a, const D2D1_RECT_F& b) noexcept {
+        return rect_area(rect_union(a, b)) - rect_area(a) - rect_area(b);
+    }
+    // common prerender of two controls
+    inline auto common_prerender(const UIControl* a, const UIControl* b) noexcept {
+        while (a->level > b->level) a = a->parent;
+        while (b->level > a->level) b = b->parent;
+        while (a != b) { a = a->parent; b = b->parent; }
+        assert(a && "not in same tree");
+        return static_cast<const UIControl*>(a->prerender);
+    }
+}}
+
+/// <summary>
+/// Merge dirty controls into bounded render units.
+/// 合并脏控件为有限个渲染区域: 每个区域渲染其内脏控件的共同预渲染控件
+/// </summary>
+/// <returns></returns>
+void LongUI::XUIBaseWindow::make_render_units() noexcept {
+    m_uUnitLengthRender = 0;
+    if (this->is_full_render_this_frame()) return;
+    const auto units = m_aUnitRender;
+    uint32_t count = 0;
+    // 合并区域
+    auto merge_unit = [](RenderUnit& a, const RenderUnit& b) noexcept {
+        a.visible_rect = impl::rect_union(a.visible_rect, b.visible_rect);
+        a.control = impl::common_prerender(a.control, b.control);
+    };
+    for (auto itr = m_apUnit; itr < m_apUnit + m_uUnitLength; ++itr) {
+        const RenderUnit unit = { *itr, (*itr)->world, (*itr)->visible_rect };
+        // 不可见
+        if (impl::rect_area(unit.visible_rect) <= 0.f) continue;
+        // 寻找合并代价最小的区域
+        uint32_t best = count;
+        float best_cost = FLT_MAX;
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto cost = impl::merge_cost(units[i].visible_rect, unit.visible_rect);
+            if (cost < best_cost) { best_cost = cost; best = i; }
+        }
+        // 仅在真正重叠或没有空位时合并, 否则新建区域
+        if (best == count || (best_cost >= 0.f && count < LongUIDirtyControlSize)) {
+            units[count++] = unit;
+            continue;
+        }
+        merge_unit(units[best], unit);
+        // 扩大后可能与其他区域重叠, 继续合并
+        for (uint32_t i = 0; i < count; ++i) {
+            if (i == best) continue;
+            if (impl::merge_cost(units[best].visible_rect, units[i].visible_rect) >= 0.f) continue;
+            merge_unit(units[best], units[i]);
+            units[i] = units[--count];
+            if (best == count) best = i;
+            i = uint32_t(-1);
+        }
+    }
+    // 检查代价: 共同预渲染控件为视口时仍只渲染该区域, 仅按面积决定全渲染
+    float total = 0.f;
+    for (auto itr = units; itr < units + count; ++itr) {
+        itr->world = itr->control->world;
+        total += impl::rect_area(itr->visible_rect);
+    }
+    const auto window = impl::rect_area(m_pViewport->visible_rect);
+    if (total * 100.f > window * float(LongUIDirtyAreaFullRenderPercent)) {
+        return this->set_full_render_this_frame();
+    }
+    m_uUnitLengthRender = uint16_t(count);
+}
+
+/// <summary>
+/// Render viewport or dirty controls in this frame.
+/// </summary>
+/// <returns></returns>
+void LongUI::XUIBaseWindow::render_this_frame() const noexcept {
+    // 全渲染
+    if (this->is_full_render_this_frame_render()) {
+        // 实现
+        m_pViewport->Render();
+    }
+    // 脏渲染
+    else {
+        // 遍历
+        for (auto itr = m_aUnitRender; itr < m_aUnitRender + m_uUnitLengthRender; ++itr) {
+            auto ctrl = itr->control;
+            // 子控件剔除: 与当前脏矩形不相交
+            force_cast(m_rcCullRender) = itr->visible_rect;
+            UIManager_RenderTarget->SetTransform(DX::Matrix3x2F::Identity());
+            UIManager_RenderTarget->PushAxisAlignedClip(&itr->visible_rect, D2D1_ANTIALIAS_MODE_ALIASED);
+            // 合并后为视口: 同全渲染先清空该区域
+            if (ctrl == m_pViewport) UIManager_RenderTarget->Clear(this->clear_color);
+            UIManager_RenderTarget->SetTransform(&itr->world);
+            // 渲染背景笔刷?
+            /*if (ctrl->backgroud != ctrl && ctrl->backgroud) {
+                auto bk = ctrl->backgroud;
+                UIManager_RenderTarget->SetTransform(&bk->world);
+                bk->RenderBackgroudBrush();
+                UIManager_RenderTarget->SetTransform(&ctrl->world);
+            }*/
+            // 正常渲染
+            LongUIProfileScopeTag(Render, ctrl->name.c_str());
+            ctrl->Render();
+            // 回来
+            UIManager_RenderTarget->PopAxisAlignedClip();
+        }
+        // 脏渲染外不剔除
+        force_cast(m_rcCullRender) = { -FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX };
+    }
+}
+
+/// <summary>
+/// Make dirty rects in this frame.
+/// </summary>
+/// <param name="rects">The rects, length must be m_uUnitLengthRender.</param>
+/// <returns></returns>
+void LongUI::XUIBaseWindow::make_dirty_rects(RECT rects[]) const noexcept {
+    auto unit = m_aUnitRender;
+    for (auto itr = rects; itr < rects + m_uUnitLengthRender; ++itr) {
+        const auto& vrt = unit->visible_rect;
+        itr->left = static_cast<LONG>(vrt.left);
+        itr->top = static_cast<LONG>(vrt.top);
+        itr->right = static_cast<LONG>(std::ceil(vrt.right));
+        itr->bottom = static_cast<LONG>(std::ceil(vrt.bottom));
+        ++unit;
+    }
+}
+
 
 // longui namesapce
 namespace LongUI {
@@ -808,6 +960,8 @@ namespace LongUI {
         D2D1_SIZE_U             m_szNew         = D2D1_SIZE_U{0};
         // caret
         D2D1_RECT_F             m_rcCaret       = D2D1_RECT_F{0.f};
+        // caret, in render, right is 0 if hidden
+        D2D1_RECT_F             m_rcCaretRender = D2D1_RECT_F{0.f};
         // track mouse event: end with DWORD
         TRACKMOUSEEVENT         m_csTME;
 #ifdef _DEBUG
@@ -823,6 +977,73 @@ namespace LongUI {
     const UINT CUIBuiltinSystemWindow::s_uTaskbarBtnCreatedMsg = ::RegisterWindowMessageW(L"TaskbarButtonCreated");
     // 任务按钮创建消息
     char16_t CUIBuiltinSystemWindow::s_cUtf16Backup = 0;
+    // system window -- headless, render into memory surface without swap chain
+    class CUIHeadlessWindow final : public XUISystemWindow,
+        public CUISingleNormalObject {
+        // super class
+        using Super = XUISystemWindow;
+    private:
+        // release data for this
+        void release_data() noexcept;
+        // recreate target bitmap and memory surface
+        auto recreate_surface() noexcept ->HRESULT;
+    public:
+        // ctor
+        CUIHeadlessWindow(const Config::Window& config) noexcept;
+        // dtor
+        ~CUIHeadlessWindow() noexcept;
+    public:
+        // dispose this
+        virtual void Dispose() noexcept { delete this; };
+        // render 
+        virtual void Render() const noexcept override;
+        // update 
+        virtual void Update() noexcept override;
+        // close window
+        virtual void Close() noexcept override;
+        // recreate
+        virtual auto Recreate() noexcept->HRESULT override;
+        // resize
+        void Resize(uint32_t w, uint32_t h) noexcept override;
+        // move window
+        virtual void MoveWindow(int32_t x, int32_t y) noexcept override { m_rcWindow.left = x; m_rcWindow.top = y; }
+        // set cursor, no cursor for headless window
+        virtual void SetCursor(Cursor) noexcept override { }
+        // show/hide window, always "shown" for headless window
+        virtual void ShowWindow(int) noexcept override { }
+        // set caret, no caret for headless window
+        virtual void SetCaret(UIControl*, const RectLTWH_F*) noexcept override { }
+        // set titlename, no title for headless window
+        virtual void SetTitleName(const wchar_t*) noexcept override { }
+    public:
+        // begin render
+        void BeginRender() const noexcept;
+        // end render
+        void EndRender() const noexcept;
+        // on resized
+        void OnResized() noexcept;
+        // get memory surface
+        void GetSurface(HeadlessSurface& surface) const noexcept;
+    private:
+        // target bitmap
+        ID2D1Bitmap1*           m_pTargetBitmap     = nullptr;
+        // readback bitmap, cpu readable
+        ID2D1Bitmap1*           m_pReadbackBitmap   = nullptr;
+        // memory surface, R8G8B8A8
+        uint8_t*                m_pPixels           = nullptr;
+        // new size
+        D2D1_SIZE_U             m_szNew             = D2D1_SIZE_U{0};
+        // count of rendered frames
+        uint32_t                m_cFrame            = 0;
+        // count of full-rendered frames
+        uint32_t                m_cFullRender       = 0;
+        // count of dirty-rendered frames
+        uint32_t                m_cDirtyRender      = 0;
+        // count of dirty rects in last frame
+        uint32_t                m_cDirtyRects       = 0;
+        // dirty rects in last frame
+        RECT                    m_aDirtyRects[LongUIDirtyControlSize];
+    };
 }
 
 /// <summary>
@@ -833,6 +1054,11 @@ namespace LongUI {
 auto LongUI::CreateBuiltinWindow(const Config::Window& config) noexcept -> XUIBaseWindow* {
     // 创建系统窗口?
     if (config.system) {
+        // 无头窗口: CPU渲染到内存表面
+        if ((UIManager.flag & IUIConfigure::Flag_RenderByCPU) &&
+            (UIManager.flag & IUIConfigure::Flag_RenderHeadless)) {
+            return new(std::nothrow) CUIHeadlessWindow(config);
+        }
         LongUI::CUIBuiltinSystemWindow::RegisterWindowClass();
         return new(std::nothrow) CUIBuiltinSystemWindow(config);
     }
@@ -1493,6 +1719,9 @@ void LongUI::CUIBuiltinSystemWindow::Update() noexcept {
         }
 #endif
     }
+    // 插入符号快照
+    m_rcCaretRender = m_rcCaret;
+    if (!this->is_caret_in()) m_rcCaretRender.right = 0.f;
 }
 
 /// <summary>
@@ -1510,7 +1739,7 @@ void LongUI::CUIBuiltinSystemWindow::BeginRender() const noexcept {
 #if 0
     UIManager_RenderTarget->SetTransform(DX::Matrix3x2F::Identity());
 #else
-    UIManager_RenderTarget->SetTransform(&m_pViewport->world);
+    UIManager_RenderTarget->SetTransform(&m_mxViewportRender);
 #endif
     // 清空背景
     UIManager_RenderTarget->Clear(this->clear_color);
@@ -1522,10 +1751,10 @@ void LongUI::CUIBuiltinSystemWindow::BeginRender() const noexcept {
 /// <returns></returns>
 void LongUI::CUIBuiltinSystemWindow::EndRender() const noexcept {
     // 渲染插入符号
-    if (this->is_caret_in() && m_rcCaret.right != 0.f) {
+    if (m_rcCaretRender.right != 0.f) {
         constexpr auto mode = D2D1_ANTIALIAS_MODE_ALIASED;
         UIManager_RenderTarget->SetTransform(DX::Matrix3x2F::Identity());
-        UIManager_RenderTarget->PushAxisAlignedClip(&m_rcCaret, mode);
+        UIManager_RenderTarget->PushAxisAlignedClip(&m_rcCaretRender, mode);
         UIManager_RenderTarget->Clear(D2D1::ColorF(D2D1::ColorF::Black));
         UIManager_RenderTarget->PopAxisAlignedClip();
     }
@@ -1551,15 +1780,7 @@ void LongUI::CUIBuiltinSystemWindow::EndRender() const noexcept {
             present_parameters.pScrollRect = &scroll;
             present_parameters.pScrollOffset = nullptr;
             // 设置参数
-            auto control = m_apUnitRender;
-            for (auto itr = rects; itr < rects + m_uUnitLengthRender; ++itr) {
-                const auto& vrt = (*control)->visible_rect;
-                itr->left = static_cast<LONG>(vrt.left);
-                itr->top = static_cast<LONG>(vrt.top);
-                itr->right = static_cast<LONG>(std::ceil(vrt.right));
-                itr->bottom = static_cast<LONG>(std::ceil(vrt.bottom));
-                ++control;
-            }
+            this->make_dirty_rects(rects);
             // 提交
             hr = m_pSwapChain->Present1(0, 0, &present_parameters);
             //if (hr == DXGI_ERROR_WAS_STILL_DRAWING) hr = S_FALSE;
@@ -1629,33 +1850,8 @@ void LongUI::CUIBuiltinSystemWindow::Render() const noexcept {
     ::WaitForSingleObjectEx(m_hVSync, 100, true);
     // 开始渲染
     this->BeginRender();
-    // 全渲染
-    if (this->is_full_render_this_frame_render()) {
-        // 实现
-        m_pViewport->Render();
-    }
-    // 脏渲染
-    else {
-        auto init_transfrom = DX::Matrix3x2F::Identity();
-        // 遍历
-        for (auto itr = m_apUnitRender; itr < m_apUnitRender + m_uUnitLengthRender; ++itr) {
-            auto ctrl = *itr; assert(ctrl != m_pViewport && "check the code");
-            UIManager_RenderTarget->SetTransform(DX::Matrix3x2F::Identity());
-            UIManager_RenderTarget->PushAxisAlignedClip(&ctrl->visible_rect, D2D1_ANTIALIAS_MODE_ALIASED);
-            UIManager_RenderTarget->SetTransform(&ctrl->world);
-            // 渲染背景笔刷?
-            /*if (ctrl->backgroud != ctrl && ctrl->backgroud) {
-                auto bk = ctrl->backgroud;
-                UIManager_RenderTarget->SetTransform(&bk->world);
-                bk->RenderBackgroudBrush();
-                UIManager_RenderTarget->SetTransform(&ctrl->world);
-            }*/
-            // 正常渲染
-            ctrl->Render();
-            // 回来
-            UIManager_RenderTarget->PopAxisAlignedClip();
-        }
-    }
+    // 渲染本帧
+    this->render_this_frame();
     // 渲染
     Super::Render();
     // 结束渲染
@@ -1874,3 +2070,315 @@ LongUI::CUIBuiltinSystemWindow::~CUIBuiltinSystemWindow() noexcept {
     UIManager.DataLock();
 #endif
 }
+
+
+/// <summary>
+/// Initializes a new instance of the <see cref="CUIHeadlessWindow"/> class.
+/// </summary>
+/// <param name="config">The configuration.</param>
+LongUI::CUIHeadlessWindow::CUIHeadlessWindow(const Config::Window& config) noexcept : Super(config) {
+    // 无头窗口
+    this->set_headless();
+    // 检查大小
+    float size[] = { float(config.width), float(config.height) };
+    if (config.node) {
+        Helper::MakeFloats(
+            config.node.attribute(LongUI::XmlAttribute::AllSize).value(),
+            size, lengthof<uint32_t>(size)
+        );
+    }
+    if (size[0] == 0.f) size[0] = float(LongUIDefaultWindowWidth);
+    if (size[1] == 0.f) size[1] = float(LongUIDefaultWindowHeight);
+    // 窗口
+    m_rcWindow.left = 0;
+    m_rcWindow.top = 0;
+    m_rcWindow.width = static_cast<LONG>(size[0]);
+    m_rcWindow.height = static_cast<LONG>(size[1]);
+}
+
+/// <summary>
+/// Finalizes an instance of the <see cref="CUIHeadlessWindow"/> class.
+/// </summary>
+/// <returns></returns>
+LongUI::CUIHeadlessWindow::~CUIHeadlessWindow() noexcept {
+    this->release_data();
+}
+
+/// <summary>
+/// Release_datas this instance.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::release_data() noexcept {
+    LongUI::SafeRelease(m_pTargetBitmap);
+    LongUI::SafeRelease(m_pReadbackBitmap);
+    if (m_pPixels) {
+        LongUI::NormalFree(m_pPixels);
+        m_pPixels = nullptr;
+    }
+}
+
+/// <summary>
+/// Recreate target bitmap and memory surface.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIHeadlessWindow::recreate_surface() noexcept -> HRESULT {
+    // 释放数据
+    this->release_data();
+    const auto width = static_cast<uint32_t>(this->GetWidth());
+    const auto height = static_cast<uint32_t>(this->GetHeight());
+    const auto format = D2D1::PixelFormat(
+        DXGI_FORMAT_R8G8B8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED
+    );
+    HRESULT hr = S_OK;
+    // 申请内存表面
+    if (SUCCEEDED(hr)) {
+        const size_t length = size_t(width) * size_t(height) * 4;
+        m_pPixels = LongUI::NormalAllocT<uint8_t>(length);
+        if (m_pPixels) std::memset(m_pPixels, 0, length);
+        else hr = E_OUTOFMEMORY;
+    }
+    // 创建目标位图
+    if (SUCCEEDED(hr)) {
+        D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_TARGET, format
+        );
+        hr = UIManager_RenderTarget->CreateBitmap(
+            D2D1::SizeU(width, height), nullptr, 0,
+            &bitmapProperties, &m_pTargetBitmap
+        );
+        longui_debug_hr(hr, L"UIManager_RenderTarget->CreateBitmap(target) faild");
+    }
+    // 创建回读位图
+    if (SUCCEEDED(hr)) {
+        D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW, format
+        );
+        hr = UIManager_RenderTarget->CreateBitmap(
+            D2D1::SizeU(width, height), nullptr, 0,
+            &bitmapProperties, &m_pReadbackBitmap
+        );
+        longui_debug_hr(hr, L"UIManager_RenderTarget->CreateBitmap(readback) faild");
+    }
+    return hr;
+}
+
+/// <summary>
+/// Recreates this instance.
+/// </summary>
+/// <returns></returns>
+auto LongUI::CUIHeadlessWindow::Recreate() noexcept -> HRESULT {
+    // 跳过
+    if (this->is_skip_render()) return S_OK;
+    // 渲染锁
+    CUIDxgiAutoLocker locker;
+    // 重建表面
+    auto hr = this->recreate_surface();
+    // 错误
+    if (FAILED(hr)) {
+        UIManager << L"Recreate Failed!" << LongUI::endl;
+        UIManager.ShowError(hr);
+    }
+    // 重建 子控件UI
+    return Super::Recreate();
+}
+
+/// <summary>
+/// Closes this instance.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::Close() noexcept {
+    // 允许退出
+    if (m_pViewport->CanbeClosedNow()) {
+        this->on_close();
+    }
+}
+
+/// <summary>
+/// Resizes the window.
+/// </summary>
+/// <param name="w">The w.</param>
+/// <param name="h">The h.</param>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::Resize(uint32_t w, uint32_t h) noexcept {
+    assert(w && h && "bad argument");
+    if (w != this->GetWidth() || h != this->GetHeight()) {
+        m_szNew.width = w;
+        m_szNew.height = h;
+        this->set_new_size();
+    }
+}
+
+/// <summary>
+/// Called when [resized].
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::OnResized() noexcept {
+    CUIDxgiAutoLocker locker;
+    // 修改大小, 需要取消目标
+    UIManager_RenderTarget->SetTarget(nullptr);
+    m_rcWindow.width = m_szNew.width;
+    m_rcWindow.height = m_szNew.height;
+    // 重建表面
+    auto hr = this->recreate_surface();
+    if (FAILED(hr)) {
+        UIManager << DL_Error << L" Recreate FAILED!" << LongUI::endl;
+        UIManager.ShowError(hr);
+    }
+    // 父类调用
+    this->resized();
+}
+
+/// <summary>
+/// Updates this instance.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::Update() noexcept {
+    // 重置大小?
+    if (this->is_new_size()) this->OnResized();
+    // 父类
+    Super::Update();
+}
+
+/// <summary>
+/// Begins the render.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::BeginRender() const noexcept {
+    // 设置文本渲染策略
+    UIManager_RenderTarget->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE(m_textAntiMode));
+    // 设为当前渲染对象
+    UIManager_RenderTarget->SetTarget(m_pTargetBitmap);
+    // 开始渲染
+    UIManager_RenderTarget->BeginDraw();
+    // 设置转换矩阵
+    UIManager_RenderTarget->SetTransform(&m_mxViewportRender);
+    // 清空背景
+    UIManager_RenderTarget->Clear(this->clear_color);
+}
+
+/// <summary>
+/// Ends the render, copy rendered rects into memory surface.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::EndRender() const noexcept {
+    // 结束渲染
+    auto hr = UIManager_RenderTarget->EndDraw();
+    longui_debug_hr(hr, L"UIManager_RenderTarget->EndDraw faild");
+    const auto self = const_cast<CUIHeadlessWindow*>(this);
+    const auto width = this->GetWidth();
+    const auto height = this->GetHeight();
+    // 本帧需要复制的矩形
+    RECT full_rect = { 0, 0, width, height };
+    const RECT* rects = &full_rect;
+    uint32_t count = 1;
+    ++self->m_cFrame;
+    // 全渲染
+    if (this->is_full_render_this_frame_render()) {
+        ++self->m_cFullRender;
+        self->m_cDirtyRects = 0;
+    }
+    // 脏渲染
+    else {
+        ++self->m_cDirtyRender;
+        this->make_dirty_rects(self->m_aDirtyRects);
+        // 限制在表面内
+        for (auto itr = self->m_aDirtyRects; itr < self->m_aDirtyRects + m_uUnitLengthRender; ++itr) {
+            itr->left = std::max(itr->left, LONG(0));
+            itr->top = std::max(itr->top, LONG(0));
+            itr->right = std::max(std::min(itr->right, width), itr->left);
+            itr->bottom = std::max(std::min(itr->bottom, height), itr->top);
+        }
+        rects = m_aDirtyRects;
+        count = m_uUnitLengthRender;
+        self->m_cDirtyRects = count;
+    }
+    // 复制到回读位图
+    for (auto itr = rects; itr < rects + count && SUCCEEDED(hr); ++itr) {
+        if (itr->right == itr->left || itr->bottom == itr->top) continue;
+        D2D1_POINT_2U pt = { uint32_t(itr->left), uint32_t(itr->top) };
+        D2D1_RECT_U src = { 
+            uint32_t(itr->left), uint32_t(itr->top),
+            uint32_t(itr->right), uint32_t(itr->bottom) 
+        };
+        hr = m_pReadbackBitmap->CopyFromBitmap(&pt, m_pTargetBitmap, &src);
+        longui_debug_hr(hr, L"m_pReadbackBitmap->CopyFromBitmap faild");
+    }
+    // 映射并复制到内存表面
+    D2D1_MAPPED_RECT mapped;
+    if (SUCCEEDED(hr)) {
+        hr = m_pReadbackBitmap->Map(D2D1_MAP_OPTIONS_READ, &mapped);
+        longui_debug_hr(hr, L"m_pReadbackBitmap->Map faild");
+    }
+    if (SUCCEEDED(hr)) {
+        const auto pitch = size_t(width) * 4;
+        for (auto itr = rects; itr < rects + count; ++itr) {
+            const auto line = size_t(itr->right - itr->left) * 4;
+            for (auto y = itr->top; y < itr->bottom; ++y) {
+                std::memcpy(
+                    m_pPixels + pitch * y + itr->left * 4,
+                    mapped.bits + mapped.pitch * y + itr->left * 4,
+                    line
+                );
+            }
+        }
+        hr = m_pReadbackBitmap->Unmap();
+    }
+    // 收到重建消息/设备丢失时 重建UI
+    if (hr == D2DERR_RECREATE_TARGET || hr == DXGI_ERROR_DEVICE_REMOVED) {
+        UIManager << DL_Hint << L"D2DERR_RECREATE_TARGET!" << LongUI::endl;
+        hr = UIManager.RecreateResources();
+    }
+    // 检查
+    if (FAILED(hr)) {
+        UIManager.ShowError(hr);
+    }
+}
+
+/// <summary>
+/// Renders this instance.
+/// </summary>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::Render() const noexcept {
+    // 跳过渲染?
+    if (this->is_skip_render() || !m_pTargetBitmap) return;
+    // 无需渲染?
+    if (!this->is_full_render_this_frame_render() && !m_uUnitLengthRender) return;
+    // 开始渲染
+    this->BeginRender();
+    // 渲染本帧
+    this->render_this_frame();
+    // 渲染
+    Super::Render();
+    // 结束渲染
+    this->EndRender();
+}
+
+/// <summary>
+/// Gets the memory surface.
+/// </summary>
+/// <param name="surface">The surface.</param>
+/// <returns></returns>
+void LongUI::CUIHeadlessWindow::GetSurface(HeadlessSurface& surface) const noexcept {
+    surface.pixels = m_pPixels;
+    surface.pitch = static_cast<uint32_t>(this->GetWidth()) * 4;
+    surface.width = static_cast<uint32_t>(this->GetWidth());
+    surface.height = static_cast<uint32_t>(this->GetHeight());
+    surface.frame_count = m_cFrame;
+    surface.full_render_count = m_cFullRender;
+    surface.dirty_render_count = m_cDirtyRender;
+    surface.dirty_rects_count = m_cDirtyRects;
+    std::memcpy(surface.dirty_rects, m_aDirtyRects, sizeof(RECT) * m_cDirtyRects);
+}
+
+/// <summary>
+/// Gets the memory surface of headless window.
+/// </summary>
+/// <param name="window">The window.</param>
+/// <param name="surface">The surface.</param>
+/// <returns>false if not a headless window</returns>
+bool LongUI::GetHeadlessSurface(const XUIBaseWindow* window, HeadlessSurface& surface) noexcept {
+    assert(window && "bad argument");
+    if (!window->IsHeadless()) return false;
+    static_cast<const CUIHeadlessWindow*>(window)->GetSurface(surface);
+    return true;
+}